@@ -0,0 +1,580 @@
+#include "AssetCooker.h"
+
+#include "Config.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "PakFile.h"
+#include "Utils.h"
+#include "Texture2D.h"
+#include "TextureCube.h"
+#include "TextureCache.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "GLTFImporter.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <system_error>
+#include <algorithm>
+#include <set>
+#include <cctype>
+#include <cstdlib>
+
+// Bumped when the cooker itself changes what it produces.
+static constexpr uint32_t CookerVersion = 1;
+
+static const char* ShaderCompileCommand = "glslang -g -V";
+
+enum class ECookResult : uint8_t
+{
+	Failed,
+	UpToDate,
+	Cooked,
+};
+
+static std::string ToLower(std::string InString)
+{
+	std::transform(InString.begin(), InString.end(), InString.begin(), [](unsigned char InChar) { return static_cast<char>(std::tolower(InChar)); });
+	return InString;
+}
+
+static bool IsImageExtension(const std::string& InExtension)
+{
+	return InExtension == ".png" || InExtension == ".jpg" || InExtension == ".jpeg" || InExtension == ".tga" || InExtension == ".bmp";
+}
+
+static bool IsMeshExtension(const std::string& InExtension)
+{
+	return InExtension == ".obj" || InExtension == ".fbx" || InExtension == ".gltf" || InExtension == ".glb" || InExtension == ".dae" || InExtension == ".3ds";
+}
+
+static bool IsShaderExtension(const std::string& InExtension)
+{
+	return InExtension == ".vert" || InExtension == ".frag" || InExtension == ".geom" || InExtension == ".comp" || InExtension == ".tesc" || InExtension == ".tese";
+}
+
+// Faces of a cube map are named <Name>_0 to <Name>_5. Returns <Name>_ for the first face and an empty string otherwise.
+static std::string GetCubeFaceBase(const std::filesystem::path& InPath)
+{
+	std::string Stem = InPath.stem().string();
+	if (Stem.size() < 3 || Stem[Stem.size() - 2] != '_' || Stem.back() != '0')
+	{
+		return std::string();
+	}
+
+	return Stem.substr(0, Stem.size() - 1);
+}
+
+// Finds the files named on lines that start with InKeyword, e.g. "mtllib" in OBJ files or "#include" in shaders.
+static void FindReferencedFiles(const std::string& InFilename, const std::string& InSourcePath, const std::string& InKeyword, std::vector<std::string>& OutReferences)
+{
+	std::ifstream File(InFilename);
+	if (File.is_open() == false)
+	{
+		return;
+	}
+
+	std::filesystem::path SourceDirectory = std::filesystem::path(InSourcePath).parent_path();
+
+	std::string Line;
+	while (std::getline(File, Line))
+	{
+		size_t Start = Line.find_first_not_of(" \t");
+		if (Start == std::string::npos || Line.compare(Start, InKeyword.size(), InKeyword) != 0)
+		{
+			continue;
+		}
+
+		std::string Name = Line.substr(Start + InKeyword.size());
+		Name.erase(0, Name.find_first_not_of(" \t\"<"));
+		Name.erase(Name.find_last_not_of(" \t\r\">") + 1);
+		if (Name.empty())
+		{
+			continue;
+		}
+
+		std::string Reference = (SourceDirectory / Name).lexically_normal().generic_string();
+		if (std::find(OutReferences.begin(), OutReferences.end(), Reference) == OutReferences.end())
+		{
+			OutReferences.push_back(Reference);
+		}
+	}
+}
+
+FAssetCooker::FAssetCooker(const FCookSettings& InSettings)
+	: Settings(InSettings)
+{
+	std::replace(Settings.ContentDirectory.begin(), Settings.ContentDirectory.end(), '\\', '/');
+	while (Settings.ContentDirectory.size() > 1 && Settings.ContentDirectory.back() == '/')
+	{
+		Settings.ContentDirectory.pop_back();
+	}
+
+	if (Settings.OutputFilename.empty())
+	{
+		Settings.OutputFilename = Settings.ContentDirectory + ".pak";
+	}
+
+	ManifestFilename = Settings.OutputFilename + ".manifest";
+}
+
+bool FAssetCooker::Run()
+{
+	GatherItems();
+
+	if (Settings.bForce == false)
+	{
+		PreviousManifest.Load(ManifestFilename);
+	}
+
+	std::vector<FCookRecord> Records(Items.size());
+	std::vector<ECookResult> Results(Items.size(), ECookResult::Failed);
+
+	auto CookRange = [&](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+		{
+			const FCookItem& Item = Items[Idx];
+			FCookRecord& Record = Records[Idx];
+
+			Record.Type = Item.Type;
+			Record.SettingsHash = GetSettingsHash(Item.Type);
+			Record.Outputs = Item.Outputs;
+
+			bool bSourcesFound = true;
+			for (const std::string& Source : Item.Sources)
+			{
+				FCookInput Input;
+				bSourcesFound &= HashInput(Source, Input);
+				Record.Inputs.push_back(Input);
+			}
+
+			if (bSourcesFound == false)
+			{
+				continue;
+			}
+
+			// References only depend on the contents of the sources, so unchanged sources reference the same files as before.
+			const FCookRecord* PreviousRecord = PreviousManifest.Find(Item.Sources[0]);
+
+			bool bSourcesChanged = PreviousRecord == nullptr || PreviousRecord->Inputs.size() < Record.Inputs.size();
+			for (size_t InputIdx = 0; bSourcesChanged == false && InputIdx < Record.Inputs.size(); ++InputIdx)
+			{
+				bSourcesChanged = PreviousRecord->Inputs[InputIdx].Path != Record.Inputs[InputIdx].Path || PreviousRecord->Inputs[InputIdx].Hash != Record.Inputs[InputIdx].Hash;
+			}
+
+			std::vector<std::string> References;
+			if (bSourcesChanged)
+			{
+				References = FindReferences(Item);
+			}
+			else
+			{
+				for (size_t InputIdx = Item.Sources.size(); InputIdx < PreviousRecord->Inputs.size(); ++InputIdx)
+				{
+					References.push_back(PreviousRecord->Inputs[InputIdx].Path);
+				}
+			}
+
+			for (const std::string& Reference : References)
+			{
+				FCookInput Input;
+				HashInput(Reference, Input);
+				Record.Inputs.push_back(Input);
+			}
+
+			if (IsUpToDate(Record, PreviousRecord))
+			{
+				Results[Idx] = ECookResult::UpToDate;
+			}
+			else if (Cook(Item))
+			{
+				Results[Idx] = ECookResult::Cooked;
+			}
+		}
+	};
+
+	GJobSystem->ParallelForBackground(static_cast<uint32_t>(Items.size()), 1, CookRange);
+
+	FCookManifest Manifest;
+	uint32_t NumCooked = 0;
+	uint32_t NumFailed = 0;
+
+	for (size_t Idx = 0; Idx < Items.size(); ++Idx)
+	{
+		const std::string& Path = Items[Idx].Sources[0];
+
+		switch (Results[Idx])
+		{
+		case ECookResult::Failed:
+			std::cerr << "Failed to cook " << Path << std::endl;
+			++NumFailed;
+			// Left out of the manifest so it is tried again next time.
+			continue;
+		case ECookResult::Cooked:
+			std::cout << "Cooked " << Path << std::endl;
+			++NumCooked;
+			break;
+		default:
+			break;
+		}
+
+		Manifest.Add(Path, Records[Idx]);
+	}
+
+	std::cout << Items.size() << " assets: " << NumCooked << " cooked, " << NumFailed << " failed, " << Items.size() - NumCooked - NumFailed << " up to date" << std::endl;
+
+	bool bAssetsChanged = NumCooked > 0 || Manifest.GetRecords().size() != PreviousManifest.GetRecords().size();
+	for (auto Iter = Manifest.GetRecords().begin(); bAssetsChanged == false && Iter != Manifest.GetRecords().end(); ++Iter)
+	{
+		bAssetsChanged = PreviousManifest.Find(Iter->first) == nullptr;
+	}
+
+	// The manifest only goes out with the pak it describes.
+	if (bAssetsChanged || std::filesystem::exists(Settings.OutputFilename) == false)
+	{
+		if (WritePak() == false)
+		{
+			std::cerr << "Failed to write " << Settings.OutputFilename << std::endl;
+			return false;
+		}
+	}
+
+	if (Manifest.Save(ManifestFilename) == false)
+	{
+		std::cerr << "Failed to write " << ManifestFilename << std::endl;
+		return false;
+	}
+
+	return NumFailed == 0;
+}
+
+void FAssetCooker::GatherItems()
+{
+	Items.clear();
+
+	std::set<std::string> Files;
+
+	std::error_code ErrorCode;
+	std::filesystem::recursive_directory_iterator Iter(Settings.ContentDirectory, ErrorCode);
+	std::filesystem::recursive_directory_iterator End;
+
+	while (ErrorCode.value() == 0 && Iter != End)
+	{
+		std::error_code FileErrorCode;
+		if (Iter->is_regular_file(FileErrorCode))
+		{
+			Files.insert(std::filesystem::relative(Iter->path(), Settings.ContentDirectory, FileErrorCode).generic_string());
+		}
+
+		Iter.increment(ErrorCode);
+	}
+
+	std::set<std::string> CubeFaces;
+
+	for (const std::string& File : Files)
+	{
+		if (CubeFaces.count(File) > 0)
+		{
+			continue;
+		}
+
+		std::filesystem::path Path(File);
+		std::string Extension = ToLower(Path.extension().string());
+
+		FCookItem Item;
+
+		if (IsImageExtension(Extension))
+		{
+			std::string CubeBase = GetCubeFaceBase(Path);
+			std::filesystem::path Directory = Path.parent_path();
+
+			std::vector<std::string> Faces;
+			for (char Face = '0'; CubeBase.empty() == false && Face < '6'; ++Face)
+			{
+				std::string FacePath = (Directory / (CubeBase + Face + Path.extension().string())).generic_string();
+				if (Files.count(FacePath) > 0)
+				{
+					Faces.push_back(FacePath);
+				}
+			}
+
+			if (Faces.size() == 6)
+			{
+				Item.Type = ECookAssetType::TextureCube;
+				for (const std::string& Face : Faces)
+				{
+					Item.Sources.push_back(Face);
+					Item.Outputs.push_back(UTextureCube::GetFaceCachePath(Face));
+					CubeFaces.insert(Face);
+				}
+			}
+			else
+			{
+				// Same rule the samples follow when they call SetIsNormal.
+				bool bIsNormal = ToLower(Path.stem().string()).find("normal") != std::string::npos;
+
+				Item.Type = bIsNormal ? ECookAssetType::NormalTexture : ECookAssetType::Texture;
+				Item.Sources.push_back(File);
+				Item.Outputs.push_back(FTextureCache::GetCachePath(File));
+			}
+		}
+		else if (IsMeshExtension(Extension))
+		{
+			Item.Type = ECookAssetType::Mesh;
+			Item.Sources.push_back(File);
+			Item.Outputs.push_back(FMeshCache::GetCachePath(File));
+		}
+		else if (IsShaderExtension(Extension))
+		{
+			Item.Type = ECookAssetType::Shader;
+			Item.Sources.push_back(File);
+			Item.Outputs.push_back(File + ".spv");
+		}
+		else
+		{
+			continue;
+		}
+
+		Items.push_back(std::move(Item));
+	}
+}
+
+std::vector<std::string> FAssetCooker::FindReferences(const FCookItem& InItem) const
+{
+	std::vector<std::string> References;
+
+	const std::string& Source = InItem.Sources[0];
+	std::string Extension = ToLower(std::filesystem::path(Source).extension().string());
+
+	if (InItem.Type == ECookAssetType::Mesh && Extension == ".obj")
+	{
+		FindReferencedFiles(GetAbsolutePath(Source), Source, "mtllib", References);
+	}
+	else if (InItem.Type == ECookAssetType::Mesh && Extension == ".gltf")
+	{
+		std::vector<std::string> BufferURIs;
+		FGLTFImporter::GetBufferURIs(GetAbsolutePath(Source), BufferURIs);
+
+		std::filesystem::path SourceDirectory = std::filesystem::path(Source).parent_path();
+		for (const std::string& BufferURI : BufferURIs)
+		{
+			References.push_back((SourceDirectory / BufferURI).lexically_normal().generic_string());
+		}
+	}
+	else if (InItem.Type == ECookAssetType::Shader)
+	{
+		FindReferencedFiles(GetAbsolutePath(Source), Source, "#include", References);
+	}
+
+	return References;
+}
+
+bool FAssetCooker::HashInput(const std::string& InPath, FCookInput& OutInput) const
+{
+	OutInput.Path = InPath;
+	OutInput.Size = 0;
+	OutInput.WriteTime = 0;
+	OutInput.Hash = 0;
+
+	std::string Filename = GetAbsolutePath(InPath);
+
+	std::error_code ErrorCode;
+	uint64_t Size = std::filesystem::file_size(Filename, ErrorCode);
+	if (ErrorCode)
+	{
+		return false;
+	}
+
+	std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(Filename, ErrorCode);
+	if (ErrorCode)
+	{
+		return false;
+	}
+
+	OutInput.Size = Size;
+	OutInput.WriteTime = static_cast<int64_t>(WriteTime.time_since_epoch().count());
+
+	// Files that kept their size and write time are taken to be unchanged, so they are not read again.
+	const FCookInput* PreviousInput = PreviousManifest.FindInput(InPath);
+	if (PreviousInput != nullptr && PreviousInput->Size == OutInput.Size && PreviousInput->WriteTime == OutInput.WriteTime)
+	{
+		OutInput.Hash = PreviousInput->Hash;
+		return true;
+	}
+
+	FMappedFile File;
+	if (File.Open(Filename))
+	{
+		OutInput.Hash = HashBytes(File.GetData(), File.GetSize());
+	}
+	else
+	{
+		OutInput.Hash = HashBytes(nullptr, 0);
+	}
+
+	return true;
+}
+
+uint64_t FAssetCooker::GetSettingsHash(ECookAssetType InType) const
+{
+	std::ostringstream Key;
+	Key << CookerVersion << " " << static_cast<uint32_t>(InType);
+
+	switch (InType)
+	{
+	case ECookAssetType::Texture:
+	case ECookAssetType::NormalTexture:
+	{
+		std::string Compression = "Default";
+		bool bMipsOnGPU = false;
+		GConfig->Get("TextureCompression", Compression);
+		GConfig->Get("TextureMipsOnGPU", bMipsOnGPU);
+
+		Key << " " << FTextureCache::Version << " " << Compression << " " << bMipsOnGPU;
+		break;
+	}
+	case ECookAssetType::TextureCube:
+		Key << " " << FTextureCache::Version;
+		break;
+	case ECookAssetType::Mesh:
+		Key << " " << FMeshCache::Version;
+		break;
+	case ECookAssetType::Shader:
+		Key << " " << ShaderCompileCommand;
+		break;
+	}
+
+	std::string KeyString = Key.str();
+	return HashBytes(KeyString.data(), KeyString.size());
+}
+
+bool FAssetCooker::IsUpToDate(const FCookRecord& InRecord, const FCookRecord* InPreviousRecord) const
+{
+	if (InPreviousRecord == nullptr ||
+		InPreviousRecord->Type != InRecord.Type ||
+		InPreviousRecord->SettingsHash != InRecord.SettingsHash ||
+		InPreviousRecord->Inputs.size() != InRecord.Inputs.size() ||
+		InPreviousRecord->Outputs != InRecord.Outputs)
+	{
+		return false;
+	}
+
+	for (size_t Idx = 0; Idx < InRecord.Inputs.size(); ++Idx)
+	{
+		if (InPreviousRecord->Inputs[Idx].Path != InRecord.Inputs[Idx].Path || InPreviousRecord->Inputs[Idx].Hash != InRecord.Inputs[Idx].Hash)
+		{
+			return false;
+		}
+	}
+
+	for (const std::string& Output : InRecord.Outputs)
+	{
+		std::error_code ErrorCode;
+		if (std::filesystem::exists(GetAbsolutePath(Output), ErrorCode) == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FAssetCooker::Cook(const FCookItem& InItem) const
+{
+	// The engine reuses caches that match their source, so stale outputs are removed to import again when only a
+	// referenced file or a setting changed.
+	for (const std::string& Output : InItem.Outputs)
+	{
+		std::error_code ErrorCode;
+		std::filesystem::remove(GetAbsolutePath(Output), ErrorCode);
+	}
+
+	bool bCooked = false;
+
+	switch (InItem.Type)
+	{
+	case ECookAssetType::Texture:
+	case ECookAssetType::NormalTexture:
+	{
+		UTexture2D* Texture = UTexture2D::StaticCreateObject();
+		Texture->SetIsNormal(InItem.Type == ECookAssetType::NormalTexture);
+		bCooked = Texture->LoadData(GetAbsolutePath(InItem.Sources[0]));
+		delete Texture;
+		break;
+	}
+	case ECookAssetType::TextureCube:
+	{
+		std::vector<std::string> Faces;
+		for (const std::string& Source : InItem.Sources)
+		{
+			Faces.push_back(GetAbsolutePath(Source));
+		}
+
+		UTextureCube* Texture = UTextureCube::StaticCreateObject();
+		bCooked = Texture->LoadData(Faces);
+		delete Texture;
+		break;
+	}
+	case ECookAssetType::Mesh:
+	{
+		UMesh* Mesh = UMesh::StaticCreateObject();
+		bCooked = Mesh->LoadData(GetAbsolutePath(InItem.Sources[0]));
+		delete Mesh;
+		break;
+	}
+	case ECookAssetType::Shader:
+	{
+		std::string Command = ShaderCompileCommand;
+		Command += " \"" + GetAbsolutePath(InItem.Sources[0]) + "\"";
+		Command += " -o \"" + GetAbsolutePath(InItem.Outputs[0]) + "\"";
+
+		bCooked = system(Command.c_str()) == 0;
+		break;
+	}
+	}
+
+	for (const std::string& Output : InItem.Outputs)
+	{
+		std::error_code ErrorCode;
+		bCooked = bCooked && std::filesystem::exists(GetAbsolutePath(Output), ErrorCode);
+	}
+
+	return bCooked;
+}
+
+bool FAssetCooker::WritePak() const
+{
+	std::vector<FPakWriteEntry> Entries;
+
+	for (const FCookItem& Item : Items)
+	{
+		for (const std::string& Output : Item.Outputs)
+		{
+			FMappedFile File;
+			if (File.Open(GetAbsolutePath(Output)) == false)
+			{
+				continue;
+			}
+
+			FPakWriteEntry Entry;
+			Entry.Path = Output;
+			Entry.Data.assign(File.GetData(), File.GetData() + File.GetSize());
+
+			// Texture data is mapped straight from the pak and uploaded, and block-compressed texels hardly shrink anyway.
+			bool bIsTexture = Item.Type == ECookAssetType::Texture || Item.Type == ECookAssetType::NormalTexture || Item.Type == ECookAssetType::TextureCube;
+			Entry.Compression = bIsTexture ? EPakCompression::None : EPakCompression::LZ4;
+
+			Entries.push_back(std::move(Entry));
+		}
+	}
+
+	return FPakFile::Write(Settings.OutputFilename, Entries);
+}
+
+std::string FAssetCooker::GetAbsolutePath(const std::string& InPath) const
+{
+	return Settings.ContentDirectory + "/" + InPath;
+}
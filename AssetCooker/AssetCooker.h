@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CookManifest.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct FCookSettings
+{
+	std::string ContentDirectory;
+	// The pak the cooked files are written to. Mounted at runtime over ContentDirectory when it sits next to it
+	// under the same name, e.g. resources.pak for resources/.
+	std::string OutputFilename;
+	// Ignores the manifest and cooks every asset.
+	bool bForce = false;
+};
+
+struct FCookItem
+{
+	ECookAssetType Type;
+	// The asset's own files, relative to the content directory. Referenced files are found while cooking.
+	std::vector<std::string> Sources;
+	std::vector<std::string> Outputs;
+};
+
+// Converts everything under a content directory into the formats the engine loads directly: texture and mesh caches,
+// cube face caches and SPIR-V. Assets are cooked in parallel, and only those whose inputs or settings changed since
+// the last cook. The outputs are then packed into a single pak.
+class FAssetCooker
+{
+public:
+	FAssetCooker(const FCookSettings& InSettings);
+
+	// Returns false when an asset failed to cook or the pak could not be written.
+	bool Run();
+
+private:
+	void GatherItems();
+
+	std::vector<std::string> FindReferences(const FCookItem& InItem) const;
+	bool HashInput(const std::string& InPath, FCookInput& OutInput) const;
+	uint64_t GetSettingsHash(ECookAssetType InType) const;
+
+	bool IsUpToDate(const FCookRecord& InRecord, const FCookRecord* InPreviousRecord) const;
+	bool Cook(const FCookItem& InItem) const;
+	bool WritePak() const;
+
+	std::string GetAbsolutePath(const std::string& InPath) const;
+
+	FCookSettings Settings;
+	std::string ManifestFilename;
+
+	FCookManifest PreviousManifest;
+	std::vector<FCookItem> Items;
+};
@@ -0,0 +1,147 @@
+#include "CookManifest.h"
+
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <system_error>
+
+// Paths go last on their line since they may contain spaces.
+static std::string ReadPath(std::istringstream& InStream)
+{
+	std::string Path;
+	std::getline(InStream >> std::ws, Path);
+	return Path;
+}
+
+bool FCookManifest::Load(const std::string& InFilename)
+{
+	Records.clear();
+	Inputs.clear();
+
+	std::ifstream File(InFilename);
+	if (File.is_open() == false)
+	{
+		return false;
+	}
+
+	std::string Line;
+	std::getline(File, Line);
+
+	std::istringstream HeaderStream(Line);
+	std::string Magic;
+	uint32_t FileVersion = 0;
+	HeaderStream >> Magic >> FileVersion;
+	if (Magic != "VKCOOK" || FileVersion != Version)
+	{
+		return false;
+	}
+
+	FCookRecord* Record = nullptr;
+
+	while (std::getline(File, Line))
+	{
+		std::istringstream Stream(Line);
+		std::string Tag;
+		Stream >> Tag;
+
+		if (Tag == "asset")
+		{
+			uint32_t Type = 0;
+			FCookRecord NewRecord;
+			Stream >> Type >> std::hex >> NewRecord.SettingsHash >> std::dec;
+			NewRecord.Type = static_cast<ECookAssetType>(Type);
+
+			std::string Path = ReadPath(Stream);
+			if (Stream.fail() || Path.empty())
+			{
+				Records.clear();
+				Inputs.clear();
+				return false;
+			}
+
+			Record = &(Records[Path] = NewRecord);
+		}
+		else if (Tag == "in" && Record != nullptr)
+		{
+			FCookInput Input;
+			Stream >> Input.Size >> Input.WriteTime >> std::hex >> Input.Hash >> std::dec;
+			Input.Path = ReadPath(Stream);
+
+			Record->Inputs.push_back(Input);
+			Inputs[Input.Path] = Input;
+		}
+		else if (Tag == "out" && Record != nullptr)
+		{
+			Record->Outputs.push_back(ReadPath(Stream));
+		}
+	}
+
+	return true;
+}
+
+bool FCookManifest::Save(const std::string& InFilename) const
+{
+	std::string TempFilename = InFilename + ".tmp";
+
+	{
+		std::ofstream File(TempFilename, std::ios::trunc);
+		if (File.is_open() == false)
+		{
+			return false;
+		}
+
+		File << "VKCOOK " << Version << "\n";
+
+		for (const auto& [Path, Record] : Records)
+		{
+			File << "asset " << static_cast<uint32_t>(Record.Type) << " " << std::hex << Record.SettingsHash << std::dec << " " << Path << "\n";
+
+			for (const FCookInput& Input : Record.Inputs)
+			{
+				File << "in " << Input.Size << " " << Input.WriteTime << " " << std::hex << Input.Hash << std::dec << " " << Input.Path << "\n";
+			}
+
+			for (const std::string& Output : Record.Outputs)
+			{
+				File << "out " << Output << "\n";
+			}
+		}
+
+		if (File.good() == false)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ErrorCode;
+	std::filesystem::rename(TempFilename, InFilename, ErrorCode);
+	if (ErrorCode)
+	{
+		std::filesystem::remove(TempFilename, ErrorCode);
+		return false;
+	}
+
+	return true;
+}
+
+const FCookRecord* FCookManifest::Find(const std::string& InPath) const
+{
+	auto Iter = Records.find(InPath);
+	return Iter != Records.end() ? &Iter->second : nullptr;
+}
+
+const FCookInput* FCookManifest::FindInput(const std::string& InPath) const
+{
+	auto Iter = Inputs.find(InPath);
+	return Iter != Inputs.end() ? &Iter->second : nullptr;
+}
+
+void FCookManifest::Add(const std::string& InPath, const FCookRecord& InRecord)
+{
+	Records[InPath] = InRecord;
+
+	for (const FCookInput& Input : InRecord.Inputs)
+	{
+		Inputs[Input.Path] = Input;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+enum class ECookAssetType : uint32_t
+{
+	Texture,
+	NormalTexture,
+	TextureCube,
+	Mesh,
+	Shader,
+};
+
+struct FCookInput
+{
+	// Relative to the content directory, with forward slashes.
+	std::string Path;
+	uint64_t Size = 0;
+	int64_t WriteTime = 0;
+	// 0 for a referenced file that does not exist, so the asset is cooked again once it appears.
+	uint64_t Hash = 0;
+};
+
+struct FCookRecord
+{
+	ECookAssetType Type = ECookAssetType::Texture;
+	// Hash of every setting the cooked data depends on, so changing one of them cooks the asset again.
+	uint64_t SettingsHash = 0;
+	// The asset's own files first, then the files they reference.
+	std::vector<FCookInput> Inputs;
+	std::vector<std::string> Outputs;
+};
+
+// What the last cook of a content directory consumed and produced, keyed by the first input of each asset. An asset
+// is cooked again only when its settings, the content hash of any of its inputs, or its outputs changed.
+class FCookManifest
+{
+public:
+	static constexpr uint32_t Version = 1;
+
+	bool Load(const std::string& InFilename);
+	bool Save(const std::string& InFilename) const;
+
+	const FCookRecord* Find(const std::string& InPath) const;
+	// The last known size, write time and hash of a file, whichever asset read it.
+	const FCookInput* FindInput(const std::string& InPath) const;
+
+	void Add(const std::string& InPath, const FCookRecord& InRecord);
+
+	const std::map<std::string, FCookRecord>& GetRecords() const { return Records; }
+
+private:
+	std::map<std::string, FCookRecord> Records;
+	// Every input by path, so files whose size and write time did not change are not hashed again.
+	std::map<std::string, FCookInput> Inputs;
+};
@@ -0,0 +1,75 @@
+#include "AssetCooker.h"
+
+#include "Config.h"
+#include "JobSystem.h"
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+static void PrintUsage()
+{
+	std::cout << "Usage: AssetCooker <ContentDirectory> [options]" << std::endl;
+	std::cout << "  -output <File>        Pak to write. Defaults to <ContentDirectory>.pak, which the engine mounts over the directory." << std::endl;
+	std::cout << "  -compression <Mode>   TextureCompression to cook with: None, Default or HighQuality." << std::endl;
+	std::cout << "  -mipsongpu            Cook for TextureMipsOnGPU." << std::endl;
+	std::cout << "  -jobs <Count>         Worker threads besides the main thread." << std::endl;
+	std::cout << "  -force                Cook every asset, even those that are up to date." << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	FConfig::Startup();
+
+	FCookSettings Settings;
+	Settings.ContentDirectory = argv[1];
+
+	for (int Idx = 2; Idx < argc; ++Idx)
+	{
+		std::string Option = argv[Idx];
+		bool bHasValue = Idx + 1 < argc;
+
+		if (Option == "-output" && bHasValue)
+		{
+			Settings.OutputFilename = argv[++Idx];
+		}
+		else if (Option == "-compression" && bHasValue)
+		{
+			GConfig->Set("TextureCompression", std::string(argv[++Idx]));
+		}
+		else if (Option == "-mipsongpu")
+		{
+			GConfig->Set("TextureMipsOnGPU", true);
+		}
+		else if (Option == "-jobs" && bHasValue)
+		{
+			GConfig->Set("JobWorkerCount", atoi(argv[++Idx]));
+		}
+		else if (Option == "-force")
+		{
+			Settings.bForce = true;
+		}
+		else
+		{
+			PrintUsage();
+			FConfig::Shutdown();
+			return EXIT_FAILURE;
+		}
+	}
+
+	FJobSystem::Startup();
+
+	FAssetCooker Cooker(Settings);
+	bool bSucceeded = Cooker.Run();
+
+	FJobSystem::Shutdown();
+	FConfig::Shutdown();
+
+	return bSucceeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
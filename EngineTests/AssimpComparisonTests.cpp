@@ -0,0 +1,65 @@
+#include "TestFramework.h"
+
+#include "GLTFImporter.h"
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+static size_t CountAssimpTriangles(const aiScene* InScene, const aiNode* InNode)
+{
+	size_t NumTriangles = 0;
+	for (uint32_t Idx = 0; Idx < InNode->mNumMeshes; ++Idx)
+	{
+		NumTriangles += InScene->mMeshes[InNode->mMeshes[Idx]]->mNumFaces;
+	}
+	for (uint32_t Idx = 0; Idx < InNode->mNumChildren; ++Idx)
+	{
+		NumTriangles += CountAssimpTriangles(InScene, InNode->mChildren[Idx]);
+	}
+
+	return NumTriangles;
+}
+
+// Both sides stop where UMesh::Import hands the geometry to the mesh optimizer, so the ratio is what the native
+// importer saves on a mesh load.
+TEST_CASE(GLTFImporterVersusAssimp)
+{
+	const std::string Filename = GetMeshDirectory() + "monkey.gltf";
+	constexpr uint32_t NumIterations = 20;
+
+	size_t NativeTriangles = 0;
+	bool bNativeImported = true;
+	double NativeMs = MeasureBestMilliseconds(NumIterations, [&Filename, &NativeTriangles, &bNativeImported]()
+	{
+		FGLTFImporter Importer;
+		std::vector<FGLTFPrimitive> Primitives;
+		bNativeImported &= Importer.Open(Filename) && Importer.ImportPrimitives(Primitives);
+
+		NativeTriangles = 0;
+		for (const FGLTFPrimitive& Primitive : Primitives)
+		{
+			NativeTriangles += Primitive.Indices.size() / 3;
+		}
+	});
+
+	// Same post-processing as ImportWithAssimp in Mesh.cpp.
+	size_t AssimpTriangles = 0;
+	bool bAssimpImported = true;
+	double AssimpMs = MeasureBestMilliseconds(NumIterations, [&Filename, &AssimpTriangles, &bAssimpImported]()
+	{
+		Assimp::Importer Importer;
+		const aiScene* Scene = Importer.ReadFile(Filename, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_SortByPType);
+		bAssimpImported &= Scene != nullptr && Scene->mRootNode != nullptr;
+
+		AssimpTriangles = bAssimpImported ? CountAssimpTriangles(Scene, Scene->mRootNode) : 0;
+	});
+
+	CHECK(bNativeImported);
+	CHECK(bAssimpImported);
+	CHECK(NativeTriangles > 0);
+	CHECK(NativeTriangles == AssimpTriangles);
+
+	std::cout << "  Importing " << Filename << " (" << NativeTriangles << " triangles): FGLTFImporter " << NativeMs
+		<< " ms, assimp " << AssimpMs << " ms, " << AssimpMs / NativeMs << "x" << std::endl;
+}
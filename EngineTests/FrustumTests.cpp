@@ -0,0 +1,101 @@
+#include "TestFramework.h"
+
+#include "Frustum.h"
+
+#include <algorithm>
+
+// 90 degree square frustum looking down -Z from the origin, with the near plane at 1 and the far plane at 10.
+static FFrustum MakeFrustum()
+{
+	return FFrustum::FromMatrix(glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 10.0f));
+}
+
+struct FPlaneSample
+{
+	glm::vec3 Point;
+	glm::vec3 InwardNormal;
+};
+
+// A point on each plane of MakeFrustum and the direction into the frustum, in FFrustum::EPlane order.
+static const FPlaneSample PlaneSamples[FFrustum::NumPlanes] =
+{
+	{ glm::vec3(-5.0f, 0.0f, -5.0f), glm::vec3(1.0f, 0.0f, -1.0f) / std::sqrt(2.0f) },
+	{ glm::vec3(5.0f, 0.0f, -5.0f), glm::vec3(-1.0f, 0.0f, -1.0f) / std::sqrt(2.0f) },
+	{ glm::vec3(0.0f, -5.0f, -5.0f), glm::vec3(0.0f, 1.0f, -1.0f) / std::sqrt(2.0f) },
+	{ glm::vec3(0.0f, 5.0f, -5.0f), glm::vec3(0.0f, -1.0f, -1.0f) / std::sqrt(2.0f) },
+	{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+	{ glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(0.0f, 0.0f, 1.0f) },
+};
+
+TEST_CASE(FrustumExtractsNormalizedPlanes)
+{
+	FFrustum Frustum = MakeFrustum();
+
+	for (int PlaneIdx = 0; PlaneIdx < FFrustum::NumPlanes; ++PlaneIdx)
+	{
+		const glm::vec4& Plane = Frustum.GetPlanes()[PlaneIdx];
+		const FPlaneSample& Sample = PlaneSamples[PlaneIdx];
+
+		CHECK_NEAR(glm::length(glm::vec3(Plane)), 1.0f, 1e-5f);
+		CHECK_NEAR(glm::dot(glm::vec3(Plane), Sample.InwardNormal), 1.0f, 1e-5f);
+		CHECK_NEAR(glm::dot(glm::vec3(Plane), Sample.Point) + Plane.w, 0.0f, 1e-4f);
+	}
+}
+
+TEST_CASE(FrustumNearPlaneUsesZeroToOneDepth)
+{
+	// With a -1..1 depth range the near plane would be row 3 + row 2 instead, which passes through z = -10 / 19 here.
+	FFrustum Frustum = MakeFrustum();
+
+	const glm::vec4& Near = Frustum.GetPlanes()[FFrustum::Near];
+	CHECK_NEAR(Near.z, -1.0f, 1e-5f);
+	CHECK_NEAR(Near.w, -1.0f, 1e-5f);
+
+	CHECK(Frustum.Intersects(FBoundingSphere(glm::vec3(0.0f, 0.0f, -0.5f), 0.4f)) == false);
+	CHECK(Frustum.Intersects(FBoundingSphere(glm::vec3(0.0f, 0.0f, -0.95f), 0.1f)));
+}
+
+TEST_CASE(FrustumCullsSpheresAgainstEachPlane)
+{
+	FFrustum Frustum = MakeFrustum();
+
+	// Per plane: inside, outside and straddling it. 18 spheres leave a scalar tail of 2 after the 4-wide loop.
+	std::vector<FBoundingSphere> Spheres;
+	std::vector<uint32_t> ExpectedVisible;
+
+	for (const FPlaneSample& Sample : PlaneSamples)
+	{
+		ExpectedVisible.push_back(static_cast<uint32_t>(Spheres.size()));
+		Spheres.emplace_back(Sample.Point + Sample.InwardNormal * 2.0f, 1.0f);
+
+		Spheres.emplace_back(Sample.Point - Sample.InwardNormal * 2.0f, 1.0f);
+
+		ExpectedVisible.push_back(static_cast<uint32_t>(Spheres.size()));
+		Spheres.emplace_back(Sample.Point - Sample.InwardNormal * 0.5f, 1.0f);
+	}
+
+	for (uint32_t Idx = 0; Idx < Spheres.size(); ++Idx)
+	{
+		bool bExpected = std::find(ExpectedVisible.begin(), ExpectedVisible.end(), Idx) != ExpectedVisible.end();
+		CHECK(Frustum.Intersects(Spheres[Idx]) == bExpected);
+	}
+
+	// Every count from 0 to 18 so both the SIMD groups and each tail length are covered.
+	for (uint32_t NumSpheres = 0; NumSpheres <= Spheres.size(); ++NumSpheres)
+	{
+		std::vector<uint32_t> Visible(NumSpheres);
+		uint32_t NumVisible = Frustum.CullSpheres(Spheres.data(), NumSpheres, Visible.data());
+		Visible.resize(NumVisible);
+
+		std::vector<uint32_t> Expected;
+		for (uint32_t Idx : ExpectedVisible)
+		{
+			if (Idx < NumSpheres)
+			{
+				Expected.push_back(Idx);
+			}
+		}
+
+		CHECK(Visible == Expected);
+	}
+}
@@ -0,0 +1,101 @@
+#include "TestFramework.h"
+
+#include "GLTFImporter.h"
+
+#include <filesystem>
+#include <fstream>
+
+// One triangle in the XY plane with a left-handed tangent frame, placed once as is and once mirrored along X.
+static std::string WriteMirroredTriangle()
+{
+	const float Positions[] = { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+	const float Normals[] = { 0, 0, 1, 0, 0, 1, 0, 0, 1 };
+	const float Tangents[] = { 1, 0, 0, -1, 1, 0, 0, -1, 1, 0, 0, -1 };
+
+	std::filesystem::path Directory = std::filesystem::temp_directory_path();
+
+	std::ofstream Buffer(Directory / "EngineTests_Mirrored.bin", std::ios::binary);
+	Buffer.write(reinterpret_cast<const char*>(Positions), sizeof(Positions));
+	Buffer.write(reinterpret_cast<const char*>(Normals), sizeof(Normals));
+	Buffer.write(reinterpret_cast<const char*>(Tangents), sizeof(Tangents));
+	Buffer.close();
+
+	std::filesystem::path Filename = Directory / "EngineTests_Mirrored.gltf";
+	std::ofstream Document(Filename);
+	Document << R"({
+		"asset": { "version": "2.0" },
+		"scene": 0,
+		"scenes": [ { "nodes": [ 0, 1 ] } ],
+		"nodes": [ { "mesh": 0 }, { "mesh": 0, "scale": [ -1, 1, 1 ] } ],
+		"meshes": [ { "primitives": [ { "attributes": { "POSITION": 0, "NORMAL": 1, "TANGENT": 2 }, "material": 0 } ] } ],
+		"materials": [ { "name": "Clay", "pbrMetallicRoughness": { "baseColorFactor": [ 0.8, 0.4, 0.2, 1 ], "metallicFactor": 0, "roughnessFactor": 0.5 } } ],
+		"buffers": [ { "uri": "EngineTests_Mirrored.bin", "byteLength": 120 } ],
+		"bufferViews": [
+			{ "buffer": 0, "byteOffset": 0, "byteLength": 36 },
+			{ "buffer": 0, "byteOffset": 36, "byteLength": 36 },
+			{ "buffer": 0, "byteOffset": 72, "byteLength": 48 }
+		],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [ 0, 0, 0 ], "max": [ 1, 1, 0 ] },
+			{ "bufferView": 1, "componentType": 5126, "count": 3, "type": "VEC3" },
+			{ "bufferView": 2, "componentType": 5126, "count": 3, "type": "VEC4" }
+		]
+	})";
+
+	return Filename.string();
+}
+
+TEST_CASE(GLTFImporterKeepsTangentHandedness)
+{
+	FGLTFImporter Importer;
+	CHECK(Importer.Open(WriteMirroredTriangle()));
+
+	std::vector<FGLTFPrimitive> Primitives;
+	CHECK(Importer.ImportPrimitives(Primitives));
+	CHECK(Primitives.size() == 2);
+	if (Primitives.size() != 2)
+	{
+		return;
+	}
+
+	for (const FGLTFPrimitive& Primitive : Primitives)
+	{
+		CHECK(Primitive.bHasTangents);
+		CHECK(Primitive.Indices.size() == 3);
+		CHECK(Primitive.MaterialIndex == 0);
+	}
+
+	for (const FVertex& Vertex : Primitives[0].Vertices)
+	{
+		CHECK(Vertex.Tangent == glm::vec4(1.0f, 0.0f, 0.0f, -1.0f));
+	}
+
+	// The mirrored copy flips both the tangent and its handedness, so the bitangent is left alone like the Y axis.
+	for (const FVertex& Vertex : Primitives[1].Vertices)
+	{
+		CHECK(Vertex.Tangent == glm::vec4(-1.0f, 0.0f, 0.0f, 1.0f));
+
+		glm::vec3 Bitangent = glm::cross(Vertex.Normal, glm::vec3(Vertex.Tangent)) * Vertex.Tangent.w;
+		CHECK_NEAR(Bitangent.y, -1.0f, 1e-6f);
+	}
+}
+
+TEST_CASE(GLTFImporterReadsMaterialFactors)
+{
+	FGLTFImporter Importer;
+	CHECK(Importer.Open(WriteMirroredTriangle()));
+
+	std::vector<FGLTFMaterial> Materials;
+	Importer.ImportMaterials(Materials);
+	CHECK(Materials.size() == 1);
+	if (Materials.empty())
+	{
+		return;
+	}
+
+	CHECK(Materials[0].Name == "Clay");
+	CHECK(Materials[0].BaseColorFactor == glm::vec4(0.8f, 0.4f, 0.2f, 1.0f));
+	CHECK(Materials[0].MetallicFactor == 0.0f);
+	CHECK(Materials[0].RoughnessFactor == 0.5f);
+	CHECK(Materials[0].BaseColorTexture.empty());
+}
@@ -0,0 +1,169 @@
+#include "TestFramework.h"
+
+#include "JobSystem.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <execution>
+
+static uint32_t GetNumBenchmarkWorkers()
+{
+	uint32_t NumHardwareThreads = std::thread::hardware_concurrency();
+	return NumHardwareThreads > 1 ? NumHardwareThreads - 1 : 0;
+}
+
+TEST_CASE(JobSystemParallelForCoversEveryIndexOnce)
+{
+	FJobSystem JobSystem(GetNumBenchmarkWorkers());
+
+	constexpr uint32_t Count = 10007;
+
+	for (uint32_t ChunkSize : { 1U, 64U, 1000U, Count, 2 * Count })
+	{
+		std::vector<std::atomic<uint32_t>> Visits(Count);
+
+		JobSystem.ParallelFor(Count, ChunkSize, [&Visits](uint32_t InBegin, uint32_t InEnd)
+		{
+			for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+			{
+				Visits[Idx].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		bool bVisitedOnce = true;
+		for (const std::atomic<uint32_t>& Visit : Visits)
+		{
+			bVisitedOnce &= Visit.load() == 1;
+		}
+		CHECK(bVisitedOnce);
+	}
+
+	bool bCalled = false;
+	JobSystem.ParallelFor(0, 16, [&bCalled](uint32_t, uint32_t) { bCalled = true; });
+	CHECK(bCalled == false);
+}
+
+// The per-instance work of FVulkanMeshRenderer::UpdateInstanceBuffer: models whose generation changed get their
+// instance and normal matrices rebuilt.
+struct FBenchmarkModel
+{
+	glm::mat4 ModelMatrix;
+	uint64_t Generation;
+};
+
+struct FBenchmarkInstance
+{
+	glm::mat4 Model;
+	glm::mat3 NormalMatrix;
+};
+
+struct FInstanceRefreshWorkload
+{
+	std::vector<FBenchmarkModel> Models;
+	std::vector<FBenchmarkInstance> Instances;
+	std::vector<uint64_t> InstanceGenerations;
+	glm::mat4 DequantizationMatrix;
+
+	explicit FInstanceRefreshWorkload(uint32_t InNumModels)
+		: Models(InNumModels)
+		, Instances(InNumModels)
+		, InstanceGenerations(InNumModels, 0)
+		, DequantizationMatrix(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / 32767.0f)))
+	{
+		for (uint32_t Idx = 0; Idx < InNumModels; ++Idx)
+		{
+			glm::vec3 Position(static_cast<float>(Idx % 100), static_cast<float>(Idx / 100 % 100), static_cast<float>(Idx / 10000));
+			glm::mat4 Rotation = glm::rotate(glm::mat4(1.0f), static_cast<float>(Idx) * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+			Models[Idx].ModelMatrix = glm::translate(glm::mat4(1.0f), Position) * Rotation * glm::scale(glm::mat4(1.0f), glm::vec3(1.0f + Idx % 3));
+			Models[Idx].Generation = 1;
+		}
+	}
+
+	void Invalidate()
+	{
+		std::fill(InstanceGenerations.begin(), InstanceGenerations.end(), 0);
+	}
+
+	void Refresh(uint32_t InIdx)
+	{
+		const FBenchmarkModel& Model = Models[InIdx];
+		if (InstanceGenerations[InIdx] != Model.Generation)
+		{
+			FBenchmarkInstance& Instance = Instances[InIdx];
+			Instance.Model = Model.ModelMatrix * DequantizationMatrix;
+			Instance.NormalMatrix = glm::transpose(glm::inverse(glm::mat3(Model.ModelMatrix)));
+			InstanceGenerations[InIdx] = Model.Generation;
+		}
+	}
+
+	bool HasSameInstances(const FInstanceRefreshWorkload& InOther) const
+	{
+		for (size_t Idx = 0; Idx < Instances.size(); ++Idx)
+		{
+			if (Instances[Idx].Model != InOther.Instances[Idx].Model || Instances[Idx].NormalMatrix != InOther.Instances[Idx].NormalMatrix)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
+TEST_CASE(JobSystemParallelForVersusParallelExecutionPolicy)
+{
+	FJobSystem JobSystem(GetNumBenchmarkWorkers());
+
+	constexpr uint32_t NumModels = 100000;
+	constexpr uint32_t NumIterations = 10;
+	// Same chunk size as FVulkanMeshRenderer::UpdateInstanceBuffer.
+	constexpr uint32_t InstanceRefreshChunkSize = 256;
+
+	FInstanceRefreshWorkload Serial(NumModels);
+	FInstanceRefreshWorkload JobSystemWorkload(NumModels);
+	FInstanceRefreshWorkload ExecutionPolicyWorkload(NumModels);
+
+	std::vector<uint32_t> Indices(NumModels);
+	std::iota(Indices.begin(), Indices.end(), 0);
+
+	double SerialMs = MeasureBestMilliseconds(NumIterations, [&Serial]()
+	{
+		Serial.Invalidate();
+		for (uint32_t Idx = 0; Idx < NumModels; ++Idx)
+		{
+			Serial.Refresh(Idx);
+		}
+	});
+
+	double JobSystemMs = MeasureBestMilliseconds(NumIterations, [&JobSystem, &JobSystemWorkload]()
+	{
+		JobSystemWorkload.Invalidate();
+		JobSystem.ParallelFor(NumModels, InstanceRefreshChunkSize, [&JobSystemWorkload](uint32_t InBegin, uint32_t InEnd)
+		{
+			for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+			{
+				JobSystemWorkload.Refresh(Idx);
+			}
+		});
+	});
+
+	double ExecutionPolicyMs = MeasureBestMilliseconds(NumIterations, [&Indices, &ExecutionPolicyWorkload]()
+	{
+		ExecutionPolicyWorkload.Invalidate();
+		std::for_each(std::execution::par, Indices.begin(), Indices.end(), [&ExecutionPolicyWorkload](uint32_t InIdx)
+		{
+			ExecutionPolicyWorkload.Refresh(InIdx);
+		});
+	});
+
+	CHECK(JobSystemWorkload.HasSameInstances(Serial));
+	CHECK(ExecutionPolicyWorkload.HasSameInstances(Serial));
+
+	std::cout << "  Refreshing " << NumModels << " instances on " << JobSystem.GetNumThreads() << " threads: serial " << SerialMs
+		<< " ms, FJobSystem::ParallelFor " << JobSystemMs << " ms, std::execution::par " << ExecutionPolicyMs << " ms" << std::endl;
+}
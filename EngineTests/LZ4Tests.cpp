@@ -0,0 +1,57 @@
+#include "TestFramework.h"
+
+#include "LZ4.h"
+
+static bool RoundTrip(const std::vector<uint8_t>& InData)
+{
+	std::vector<uint8_t> Compressed(FLZ4::GetMaxCompressedSize(InData.size()));
+	size_t CompressedSize = FLZ4::Compress(InData.data(), InData.size(), Compressed.data(), Compressed.size());
+	if (CompressedSize == 0)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> Decompressed(InData.size());
+	return FLZ4::Decompress(Compressed.data(), CompressedSize, Decompressed.data(), Decompressed.size()) && Decompressed == InData;
+}
+
+TEST_CASE(LZ4RoundTripsEmptyInput)
+{
+	// Empty vectors hand out null data pointers.
+	std::vector<uint8_t> Compressed(FLZ4::GetMaxCompressedSize(0));
+	CHECK(FLZ4::Compress(nullptr, 0, Compressed.data(), Compressed.size()) == 1);
+	CHECK(FLZ4::Decompress(Compressed.data(), 1, nullptr, 0));
+	CHECK(FLZ4::Decompress(nullptr, 0, nullptr, 0));
+	CHECK(RoundTrip({}));
+}
+
+TEST_CASE(LZ4RoundTripsRepetitiveAndRandomInput)
+{
+	std::vector<uint8_t> Repetitive(100000);
+	for (size_t Idx = 0; Idx < Repetitive.size(); ++Idx)
+	{
+		Repetitive[Idx] = static_cast<uint8_t>(Idx % 7);
+	}
+	CHECK(RoundTrip(Repetitive));
+
+	std::vector<uint8_t> Random(100000);
+	uint32_t Seed = 1;
+	for (uint8_t& Byte : Random)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		Byte = static_cast<uint8_t>(Seed >> 24);
+	}
+	CHECK(RoundTrip(Random));
+
+	CHECK(RoundTrip({ 1, 2, 3 }));
+}
+
+TEST_CASE(LZ4RejectsTruncatedInput)
+{
+	std::vector<uint8_t> Data(4096, 42);
+	std::vector<uint8_t> Compressed(FLZ4::GetMaxCompressedSize(Data.size()));
+	size_t CompressedSize = FLZ4::Compress(Data.data(), Data.size(), Compressed.data(), Compressed.size());
+
+	std::vector<uint8_t> Decompressed(Data.size());
+	CHECK(FLZ4::Decompress(Compressed.data(), CompressedSize - 1, Decompressed.data(), Decompressed.size()) == false);
+}
@@ -0,0 +1,185 @@
+#include "TestFramework.h"
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+static FVertex MakeVertex(float InX, float InY, float InZ)
+{
+	FVertex Vertex{};
+	Vertex.Position = glm::vec3(InX, InY, InZ);
+	Vertex.Normal = glm::vec3(0.0f, 0.0f, 1.0f);
+	Vertex.TexCoords = glm::vec2(InX, InY);
+	return Vertex;
+}
+
+// InWidth x InHeight quads in row major order, two triangles each.
+static void MakeGrid(uint32_t InWidth, uint32_t InHeight, std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices)
+{
+	OutVertices.clear();
+	OutIndices.clear();
+
+	for (uint32_t Y = 0; Y <= InHeight; ++Y)
+	{
+		for (uint32_t X = 0; X <= InWidth; ++X)
+		{
+			OutVertices.push_back(MakeVertex(static_cast<float>(X), static_cast<float>(Y), 0.0f));
+		}
+	}
+
+	for (uint32_t Y = 0; Y < InHeight; ++Y)
+	{
+		for (uint32_t X = 0; X < InWidth; ++X)
+		{
+			uint32_t TopLeft = Y * (InWidth + 1) + X;
+			uint32_t BottomLeft = TopLeft + InWidth + 1;
+
+			OutIndices.insert(OutIndices.end(), { TopLeft, BottomLeft, TopLeft + 1 });
+			OutIndices.insert(OutIndices.end(), { TopLeft + 1, BottomLeft, BottomLeft + 1 });
+		}
+	}
+}
+
+// Triangles by corner position, each rotated to start at its smallest corner so winding is kept, sorted.
+static std::vector<std::array<float, 9>> GetTriangles(const std::vector<FVertex>& InVertices, const std::vector<uint32_t>& InIndices)
+{
+	std::vector<std::array<float, 9>> Triangles;
+
+	for (size_t Idx = 0; Idx < InIndices.size(); Idx += 3)
+	{
+		std::array<std::array<float, 3>, 3> Corners;
+		for (size_t Corner = 0; Corner < 3; ++Corner)
+		{
+			const glm::vec3& Position = InVertices[InIndices[Idx + Corner]].Position;
+			Corners[Corner] = { Position.x, Position.y, Position.z };
+		}
+
+		std::rotate(Corners.begin(), std::min_element(Corners.begin(), Corners.end()), Corners.end());
+
+		std::array<float, 9> Triangle;
+		for (size_t Corner = 0; Corner < 3; ++Corner)
+		{
+			std::copy(Corners[Corner].begin(), Corners[Corner].end(), Triangle.begin() + Corner * 3);
+		}
+
+		Triangles.push_back(Triangle);
+	}
+
+	std::sort(Triangles.begin(), Triangles.end());
+	return Triangles;
+}
+
+static void Optimize(std::vector<FVertex>& InOutVertices, std::vector<uint32_t>& InOutIndices)
+{
+	FMeshOptimizer::WeldVertices(InOutVertices, InOutIndices);
+
+	uint32_t NumVertices = static_cast<uint32_t>(InOutVertices.size());
+	FMeshOptimizer::OptimizeVertexCache(InOutIndices.data(), InOutIndices.size(), NumVertices);
+	FMeshOptimizer::OptimizeOverdraw(InOutIndices.data(), InOutIndices.size(), InOutVertices.data(), NumVertices);
+	FMeshOptimizer::OptimizeVertexFetch(InOutVertices, InOutIndices.data(), InOutIndices.size());
+}
+
+// A grid whose triangles are shuffled with a fixed seed, so the passes have real work to do.
+static void MakeShuffledGrid(std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices)
+{
+	MakeGrid(24, 24, OutVertices, OutIndices);
+
+	uint32_t Seed = 12345;
+	for (size_t Triangle = OutIndices.size() / 3 - 1; Triangle > 0; --Triangle)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		size_t Other = Seed % (Triangle + 1);
+		std::swap_ranges(OutIndices.begin() + Triangle * 3, OutIndices.begin() + Triangle * 3 + 3, OutIndices.begin() + Other * 3);
+	}
+}
+
+TEST_CASE(WeldVerticesMergesDuplicatesAndDropsUnused)
+{
+	FVertex A = MakeVertex(0.0f, 0.0f, 0.0f);
+	FVertex B = MakeVertex(1.0f, 0.0f, 0.0f);
+	FVertex C = MakeVertex(0.0f, 1.0f, 0.0f);
+	FVertex D = MakeVertex(1.0f, 1.0f, 0.0f);
+	FVertex Unused = MakeVertex(5.0f, 5.0f, 5.0f);
+
+	// A quad written as two triangles with their own corners.
+	std::vector<FVertex> Vertices = { Unused, A, C, B, B, C, D };
+	std::vector<uint32_t> Indices = { 1, 2, 3, 4, 5, 6 };
+
+	FMeshOptimizer::WeldVertices(Vertices, Indices);
+
+	CHECK(Vertices.size() == 4);
+	CHECK(Indices == std::vector<uint32_t>({ 0, 1, 2, 2, 1, 3 }));
+
+	if (Vertices.size() == 4)
+	{
+		CHECK(Vertices[0] == A);
+		CHECK(Vertices[1] == C);
+		CHECK(Vertices[2] == B);
+		CHECK(Vertices[3] == D);
+	}
+}
+
+TEST_CASE(OptimizationPreservesTriangles)
+{
+	std::vector<FVertex> Vertices;
+	std::vector<uint32_t> Indices;
+	MakeShuffledGrid(Vertices, Indices);
+
+	std::vector<std::array<float, 9>> SourceTriangles = GetTriangles(Vertices, Indices);
+
+	uint32_t NumVertices = static_cast<uint32_t>(Vertices.size());
+	FMeshOptimizer::OptimizeVertexCache(Indices.data(), Indices.size(), NumVertices);
+	CHECK(GetTriangles(Vertices, Indices) == SourceTriangles);
+
+	FMeshOptimizer::OptimizeOverdraw(Indices.data(), Indices.size(), Vertices.data(), NumVertices);
+	CHECK(GetTriangles(Vertices, Indices) == SourceTriangles);
+
+	FMeshOptimizer::OptimizeVertexFetch(Vertices, Indices.data(), Indices.size());
+	CHECK(Vertices.size() == NumVertices);
+	CHECK(GetTriangles(Vertices, Indices) == SourceTriangles);
+}
+
+TEST_CASE(OptimizationIsDeterministic)
+{
+	std::vector<FVertex> FirstVertices;
+	std::vector<uint32_t> FirstIndices;
+	MakeShuffledGrid(FirstVertices, FirstIndices);
+
+	std::vector<FVertex> SecondVertices = FirstVertices;
+	std::vector<uint32_t> SecondIndices = FirstIndices;
+
+	Optimize(FirstVertices, FirstIndices);
+	Optimize(SecondVertices, SecondIndices);
+
+	CHECK(FirstIndices == SecondIndices);
+	CHECK(FirstVertices.size() == SecondVertices.size());
+	CHECK(FirstVertices.size() == SecondVertices.size() && memcmp(FirstVertices.data(), SecondVertices.data(), FirstVertices.size() * sizeof(FVertex)) == 0);
+}
+
+TEST_CASE(AnalyzeVertexCacheOnGrid)
+{
+	std::vector<FVertex> Vertices;
+	std::vector<uint32_t> Indices;
+
+	// Rows of 33 vertices do not fit a 16 entry FIFO, so every row transforms its top and bottom vertices once each.
+	MakeGrid(32, 8, Vertices, Indices);
+
+	uint32_t NumVertices = static_cast<uint32_t>(Vertices.size());
+	FVertexCacheStats SourceStats = FMeshOptimizer::AnalyzeVertexCache(Indices.data(), Indices.size(), NumVertices, 16);
+
+	CHECK(SourceStats.NumTriangles == 512);
+	CHECK(SourceStats.NumVertices == 297);
+	CHECK(SourceStats.NumTransformedVertices == 8 * 66);
+	CHECK_NEAR(SourceStats.ACMR, 528.0f / 512.0f, 1e-5f);
+	CHECK_NEAR(SourceStats.ATVR, 528.0f / 297.0f, 1e-5f);
+
+	FMeshOptimizer::OptimizeVertexCache(Indices.data(), Indices.size(), NumVertices);
+	FVertexCacheStats OptimizedStats = FMeshOptimizer::AnalyzeVertexCache(Indices.data(), Indices.size(), NumVertices, 16);
+
+	CHECK(OptimizedStats.NumTriangles == SourceStats.NumTriangles);
+	CHECK(OptimizedStats.NumVertices == SourceStats.NumVertices);
+	CHECK(OptimizedStats.ACMR < 0.7f);
+	CHECK(OptimizedStats.ATVR < 1.2f);
+}
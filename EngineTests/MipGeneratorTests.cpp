@@ -0,0 +1,108 @@
+#include "TestFramework.h"
+
+#include "MipGenerator.h"
+
+// Allocates a full mip chain for an RGBA8 image and fills the first level with InTexel(X, Y).
+template <typename TexelFunction>
+static std::vector<uint8_t> MakeMipChain(uint32_t InWidth, uint32_t InHeight, std::vector<FTextureMip>& OutMips, TexelFunction&& InTexel)
+{
+	uint64_t ChainSize = FMipGenerator::GetMipChainLayout(InWidth, InHeight, FMipGenerator::GetNumMipLevels(InWidth, InHeight), OutMips);
+
+	std::vector<uint8_t> Chain(static_cast<size_t>(ChainSize), 0);
+	for (uint32_t Y = 0; Y < InHeight; ++Y)
+	{
+		for (uint32_t X = 0; X < InWidth; ++X)
+		{
+			uint8_t Value = InTexel(X, Y);
+			uint8_t* Texel = &Chain[(static_cast<size_t>(Y) * InWidth + X) * 4];
+			Texel[0] = Value;
+			Texel[1] = Value;
+			Texel[2] = Value;
+			Texel[3] = 255;
+		}
+	}
+
+	return Chain;
+}
+
+static uint8_t GetRed(const std::vector<uint8_t>& InChain, const FTextureMip& InMip, uint32_t InX, uint32_t InY)
+{
+	return InChain[static_cast<size_t>(InMip.Offset) + (static_cast<size_t>(InY) * InMip.Width + InX) * 4];
+}
+
+TEST_CASE(MipGeneratorLaysOutChain)
+{
+	CHECK(FMipGenerator::GetNumMipLevels(1, 1) == 1);
+	CHECK(FMipGenerator::GetNumMipLevels(4, 4) == 3);
+	CHECK(FMipGenerator::GetNumMipLevels(5, 3) == 3);
+	CHECK(FMipGenerator::GetNumMipLevels(1, 8) == 4);
+
+	std::vector<FTextureMip> Mips;
+	uint64_t ChainSize = FMipGenerator::GetMipChainLayout(5, 3, 3, Mips);
+	CHECK(Mips.size() == 3);
+	CHECK(Mips[1].Width == 2 && Mips[1].Height == 1);
+	CHECK(Mips[2].Width == 1 && Mips[2].Height == 1);
+	CHECK(Mips[1].Offset == 5 * 3 * 4);
+	CHECK(ChainSize == (5 * 3 + 2 * 1 + 1 * 1) * 4);
+}
+
+TEST_CASE(MipGeneratorAveragesEvenFootprints)
+{
+	std::vector<FTextureMip> Mips;
+	std::vector<uint8_t> Chain = MakeMipChain(4, 4, Mips, [](uint32_t X, uint32_t Y) { return static_cast<uint8_t>((X + Y * 4) * 10); });
+
+	FMipGenerator::GenerateMips(Chain.data(), Mips, EMipFilter::Linear);
+
+	// Each texel is the mean of its 2x2 footprint, e.g. (0 + 10 + 40 + 50) / 4.
+	CHECK(GetRed(Chain, Mips[1], 0, 0) == 25);
+	CHECK(GetRed(Chain, Mips[1], 1, 0) == 45);
+	CHECK(GetRed(Chain, Mips[1], 0, 1) == 105);
+	CHECK(GetRed(Chain, Mips[1], 1, 1) == 125);
+	CHECK(GetRed(Chain, Mips[2], 0, 0) == 75);
+}
+
+TEST_CASE(MipGeneratorKeepsLastTexelOfOddSources)
+{
+	std::vector<FTextureMip> Mips;
+
+	// A 3x1 source maps to a single texel that must see all three source texels.
+	std::vector<uint8_t> Row = MakeMipChain(3, 1, Mips, [](uint32_t X, uint32_t) { return X == 2 ? 255 : 0; });
+	FMipGenerator::GenerateMips(Row.data(), Mips, EMipFilter::Linear);
+	CHECK(GetRed(Row, Mips[1], 0, 0) == 85);
+
+	std::vector<uint8_t> Column = MakeMipChain(1, 3, Mips, [](uint32_t, uint32_t Y) { return Y == 2 ? 255 : 0; });
+	FMipGenerator::GenerateMips(Column.data(), Mips, EMipFilter::Linear);
+	CHECK(GetRed(Column, Mips[1], 0, 0) == 85);
+
+	// Only the last row and column of a 5x5 source are lit; they land in the last destination row and column.
+	std::vector<uint8_t> Edges = MakeMipChain(5, 5, Mips, [](uint32_t X, uint32_t Y) { return X == 4 || Y == 4 ? 255 : 0; });
+	FMipGenerator::GenerateMips(Edges.data(), Mips, EMipFilter::Linear);
+	CHECK(GetRed(Edges, Mips[1], 0, 0) == 0);
+	CHECK(GetRed(Edges, Mips[1], 1, 0) == 85);
+	CHECK(GetRed(Edges, Mips[1], 0, 1) == 85);
+	CHECK(GetRed(Edges, Mips[1], 1, 1) == 142);
+}
+
+TEST_CASE(MipGeneratorPreservesConstantOddImages)
+{
+	for (EMipFilter Filter : { EMipFilter::Linear, EMipFilter::SRGB })
+	{
+		std::vector<FTextureMip> Mips;
+		std::vector<uint8_t> Chain = MakeMipChain(7, 5, Mips, [](uint32_t, uint32_t) { return 100; });
+
+		FMipGenerator::GenerateMips(Chain.data(), Mips, Filter);
+
+		bool bConstant = true;
+		for (const FTextureMip& Mip : Mips)
+		{
+			for (uint32_t Y = 0; Y < Mip.Height; ++Y)
+			{
+				for (uint32_t X = 0; X < Mip.Width; ++X)
+				{
+					bConstant &= GetRed(Chain, Mip, X, Y) == 100;
+				}
+			}
+		}
+		CHECK(bConstant);
+	}
+}
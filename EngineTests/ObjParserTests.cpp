@@ -0,0 +1,158 @@
+#include "TestFramework.h"
+
+#include "ObjParser.h"
+#include "JobSystem.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <filesystem>
+#include <fstream>
+
+static bool ParseText(const char* InText, FObjParser& OutParser)
+{
+	std::filesystem::path Filename = std::filesystem::temp_directory_path() / "EngineTests.obj";
+
+	std::ofstream File(Filename, std::ios::binary);
+	File << InText;
+	File.close();
+
+	return OutParser.Parse(Filename.string());
+}
+
+TEST_CASE(ObjParserReadsPositionsOnlyTriangle)
+{
+	// Every face corner is its own position, so the parser takes the aligned path without a vertex table.
+	FObjParser Parser;
+	CHECK(ParseText("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n", Parser));
+
+	CHECK(Parser.GetVertices().size() == 3);
+	CHECK(Parser.GetIndices() == std::vector<uint32_t>({ 0, 1, 2 }));
+	CHECK(Parser.HasNormals() == false);
+	CHECK(Parser.HasTexCoords() == false);
+
+	if (Parser.GetVertices().size() == 3)
+	{
+		CHECK(Parser.GetVertices()[1].Position == glm::vec3(1.0f, 0.0f, 0.0f));
+		CHECK(Parser.GetVertices()[2].Position == glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+}
+
+TEST_CASE(ObjParserReadsAlignedAttributes)
+{
+	FObjParser Parser;
+	CHECK(ParseText(
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+		"vt 0 0\nvt 1 0\nvt 0 1\n"
+		"vn 0 0 1\nvn 0 0 1\nvn 0 0 1\n"
+		"f 1/1/1 2/2/2 3/3/3\n", Parser));
+
+	CHECK(Parser.GetVertices().size() == 3);
+	CHECK(Parser.GetIndices() == std::vector<uint32_t>({ 0, 1, 2 }));
+	CHECK(Parser.HasNormals());
+	CHECK(Parser.HasTexCoords());
+
+	if (Parser.GetVertices().size() == 3)
+	{
+		CHECK(Parser.GetVertices()[2].TexCoords == glm::vec2(0.0f, 1.0f));
+		CHECK(Parser.GetVertices()[2].Normal == glm::vec3(0.0f, 0.0f, 1.0f));
+	}
+}
+
+TEST_CASE(ObjParserDeduplicatesCornersAndTriangulatesFans)
+{
+	// A quad whose first corner uses two texture coordinates, split over two materials.
+	FObjParser Parser;
+	CHECK(ParseText(
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvt 0.5 0.5\n"
+		"usemtl A\n"
+		"f 1/1 2/2 3/3 4/4\n"
+		"usemtl B\n"
+		"f -4/-1 -3/-4 -2/-3\n", Parser));
+
+	CHECK(Parser.GetVertices().size() == 5);
+	CHECK(Parser.GetIndices() == std::vector<uint32_t>({ 0, 1, 2, 0, 2, 3, 4, 1, 2 }));
+	CHECK(Parser.HasTexCoords());
+	CHECK(Parser.HasNormals() == false);
+
+	CHECK(Parser.GetGroups().size() == 2);
+	if (Parser.GetGroups().size() == 2)
+	{
+		CHECK(Parser.GetGroups()[0].Material == "A");
+		CHECK(Parser.GetGroups()[0].FirstIndex == 0 && Parser.GetGroups()[0].NumIndices == 6);
+		CHECK(Parser.GetGroups()[1].Material == "B");
+		CHECK(Parser.GetGroups()[1].FirstIndex == 6 && Parser.GetGroups()[1].NumIndices == 3);
+	}
+}
+
+TEST_CASE(ObjParserRejectsOutOfRangeIndices)
+{
+	FObjParser Parser;
+	CHECK(ParseText("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n", Parser) == false);
+}
+
+// The benchmark against tinyobj, which the samples load their meshes with.
+static size_t CountTinyObjTriangles(const std::string& InFilename, bool& OutLoaded)
+{
+	tinyobj::attrib_t Attributes;
+	std::vector<tinyobj::shape_t> Shapes;
+	std::vector<tinyobj::material_t> Materials;
+	std::string Warn, Error;
+
+	OutLoaded = tinyobj::LoadObj(&Attributes, &Shapes, &Materials, &Warn, &Error, InFilename.c_str());
+
+	size_t NumTriangles = 0;
+	for (const tinyobj::shape_t& Shape : Shapes)
+	{
+		NumTriangles += Shape.mesh.num_face_vertices.size();
+	}
+
+	return NumTriangles;
+}
+
+TEST_CASE(ObjParserVersusTinyObj)
+{
+	constexpr uint32_t NumIterations = 5;
+
+	FJobSystem JobSystem(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+
+	for (const char* Mesh : { "viking_room.obj", "airboat.obj" })
+	{
+		const std::string Filename = GetMeshDirectory() + Mesh;
+
+		size_t NumTriangles = 0;
+		bool bParsed = true;
+		auto ParseMesh = [&Filename, &NumTriangles, &bParsed]()
+		{
+			FObjParser Parser;
+			bParsed &= Parser.Parse(Filename);
+			NumTriangles = Parser.GetIndices().size() / 3;
+		};
+
+		// Without GJobSystem the parser runs its chunks on the calling thread.
+		double SerialMs = MeasureBestMilliseconds(NumIterations, ParseMesh);
+
+		GJobSystem = &JobSystem;
+		double ParallelMs = MeasureBestMilliseconds(NumIterations, ParseMesh);
+		GJobSystem = nullptr;
+
+		size_t NumTinyObjTriangles = 0;
+		bool bTinyObjLoaded = true;
+		double TinyObjMs = MeasureBestMilliseconds(NumIterations, [&Filename, &NumTinyObjTriangles, &bTinyObjLoaded]()
+		{
+			bool bLoaded = false;
+			NumTinyObjTriangles = CountTinyObjTriangles(Filename, bLoaded);
+			bTinyObjLoaded &= bLoaded;
+		});
+
+		CHECK(bParsed);
+		CHECK(bTinyObjLoaded);
+		CHECK(NumTriangles > 0);
+		CHECK(NumTriangles == NumTinyObjTriangles);
+
+		std::cout << "  Parsing " << Mesh << " (" << NumTriangles << " triangles): FObjParser " << SerialMs << " ms serial, "
+			<< ParallelMs << " ms on " << JobSystem.GetNumThreads() << " threads, tinyobj " << TinyObjMs << " ms, "
+			<< TinyObjMs / ParallelMs << "x" << std::endl;
+	}
+}
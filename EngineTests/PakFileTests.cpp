@@ -0,0 +1,171 @@
+#include "TestFramework.h"
+
+#include "PakFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <cstddef>
+#include <cstring>
+
+static std::vector<uint8_t> MakeBytes(size_t InSize, uint32_t InSeed)
+{
+	std::vector<uint8_t> Bytes(InSize);
+	for (size_t Idx = 0; Idx < InSize; ++Idx)
+	{
+		Bytes[Idx] = static_cast<uint8_t>((Idx / 16) * InSeed);
+	}
+
+	return Bytes;
+}
+
+static bool ReadEntryData(const FPakFile& InPak, std::string_view InPath, std::vector<uint8_t>& OutData)
+{
+	const FPakEntry* Entry = InPak.FindEntry(InPath);
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	OutData.assign(static_cast<size_t>(Entry->UncompressedSize), 0);
+	return InPak.ReadEntry(*Entry, OutData.data());
+}
+
+// Overwrites InSize bytes at InOffset of an existing file.
+static void PatchFile(const std::string& InFilename, uint64_t InOffset, const void* InData, size_t InSize)
+{
+	std::fstream File(InFilename, std::ios::binary | std::ios::in | std::ios::out);
+	File.seekp(static_cast<std::streamoff>(InOffset));
+	File.write(static_cast<const char*>(InData), static_cast<std::streamsize>(InSize));
+}
+
+TEST_CASE(PakFileRoundTripsEntries)
+{
+	const std::string Filename = (std::filesystem::temp_directory_path() / "EngineTests_RoundTrip.pak").string();
+
+	std::vector<FPakWriteEntry> WriteEntries(4);
+	WriteEntries[0] = { "Textures\\Albedo.ktx", MakeBytes(5000, 3), EPakCompression::LZ4 };
+	WriteEntries[1] = { "/Meshes/Rock.mesh", MakeBytes(123, 7), EPakCompression::None };
+	WriteEntries[2] = { "Empty.bin", {}, EPakCompression::LZ4 };
+	WriteEntries[3] = { "Shaders/Mesh.spv", MakeBytes(64, 0), EPakCompression::None };
+
+	CHECK(FPakFile::Write(Filename, WriteEntries, 64));
+	CHECK(FPakFile::Write(Filename, WriteEntries, 48) == false);
+
+	FPakFile Pak;
+	CHECK(Pak.Open(Filename));
+	CHECK(Pak.GetNumEntries() == 4);
+
+	for (const FPakWriteEntry& WriteEntry : WriteEntries)
+	{
+		std::vector<uint8_t> Data;
+		CHECK(ReadEntryData(Pak, FPakFile::NormalizePath(WriteEntry.Path), Data));
+		CHECK(Data == WriteEntry.Data);
+	}
+
+	// The repetitive entry is stored compressed; stored entries start at the requested alignment.
+	const FPakEntry* Albedo = Pak.FindEntry("Textures/Albedo.ktx");
+	CHECK(Albedo != nullptr && Albedo->Compression == EPakCompression::LZ4 && Albedo->Size < Albedo->UncompressedSize);
+
+	const FPakEntry* Rock = Pak.FindEntry("Meshes/Rock.mesh");
+	CHECK(Rock != nullptr && Rock->Compression == EPakCompression::None && Rock->Offset % 64 == 0);
+	if (Rock != nullptr)
+	{
+		CHECK(Pak.GetEntryName(*Rock) == "Meshes/Rock.mesh");
+		CHECK(memcmp(Pak.GetEntryData(*Rock), WriteEntries[1].Data.data(), WriteEntries[1].Data.size()) == 0);
+	}
+
+	CHECK(Pak.FindEntry("Meshes/Missing.mesh") == nullptr);
+	CHECK(Pak.FindEntry("/Meshes/Rock.mesh") == nullptr);
+
+	Pak.Close();
+	CHECK(Pak.IsOpen() == false);
+	CHECK(Pak.FindEntry("Meshes/Rock.mesh") == nullptr);
+}
+
+TEST_CASE(PakFileKeepsLastDuplicatePath)
+{
+	const std::string Filename = (std::filesystem::temp_directory_path() / "EngineTests_Duplicates.pak").string();
+
+	// The same path three times, spelled differently; the last one wins.
+	std::vector<FPakWriteEntry> WriteEntries(4);
+	WriteEntries[0] = { "Data/File.bin", MakeBytes(100, 1), EPakCompression::None };
+	WriteEntries[1] = { "Data\\File.bin", MakeBytes(200, 2), EPakCompression::LZ4 };
+	WriteEntries[2] = { "Other.bin", MakeBytes(10, 5), EPakCompression::None };
+	WriteEntries[3] = { "/Data/File.bin", MakeBytes(300, 3), EPakCompression::None };
+
+	CHECK(FPakFile::Write(Filename, WriteEntries));
+
+	FPakFile Pak;
+	CHECK(Pak.Open(Filename));
+	CHECK(Pak.GetNumEntries() == 2);
+
+	std::vector<uint8_t> Data;
+	CHECK(ReadEntryData(Pak, "Data/File.bin", Data));
+	CHECK(Data == WriteEntries[3].Data);
+	CHECK(ReadEntryData(Pak, "Other.bin", Data));
+	CHECK(Data == WriteEntries[2].Data);
+}
+
+TEST_CASE(PakFileRejectsCorruptTables)
+{
+	const std::string Filename = (std::filesystem::temp_directory_path() / "EngineTests_Corrupt.pak").string();
+
+	std::vector<FPakWriteEntry> WriteEntries(2);
+	WriteEntries[0] = { "A.bin", MakeBytes(1000, 3), EPakCompression::None };
+	WriteEntries[1] = { "B.bin", MakeBytes(1000, 5), EPakCompression::None };
+
+	FPakHeader Header{};
+	FPakFile Pak;
+
+	auto WriteValidPak = [&]()
+	{
+		CHECK(FPakFile::Write(Filename, WriteEntries));
+		CHECK(Pak.Open(Filename));
+		Pak.Close();
+
+		std::ifstream File(Filename, std::ios::binary);
+		File.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+	};
+
+	// Truncated in the middle of the table of contents.
+	WriteValidPak();
+	std::filesystem::resize_file(Filename, Header.TocOffset + sizeof(FPakEntry) + sizeof(FPakEntry) / 2);
+	CHECK(Pak.Open(Filename) == false);
+	CHECK(Pak.IsOpen() == false);
+
+	// Too short for a header.
+	std::filesystem::resize_file(Filename, sizeof(FPakHeader) - 1);
+	CHECK(Pak.Open(Filename) == false);
+
+	// More entries than the table holds.
+	WriteValidPak();
+	uint32_t NumEntries = 1000;
+	PatchFile(Filename, offsetof(FPakHeader, NumEntries), &NumEntries, sizeof(NumEntries));
+	CHECK(Pak.Open(Filename) == false);
+
+	// An entry pointing past the end of the file.
+	WriteValidPak();
+	uint64_t Offset = std::filesystem::file_size(Filename);
+	PatchFile(Filename, Header.TocOffset + sizeof(FPakEntry) + offsetof(FPakEntry, Offset), &Offset, sizeof(Offset));
+	CHECK(Pak.Open(Filename) == false);
+
+	// A name outside the name table.
+	WriteValidPak();
+	uint32_t NameLength = static_cast<uint32_t>(Header.NamesSize) + 1;
+	PatchFile(Filename, Header.TocOffset + offsetof(FPakEntry, NameLength), &NameLength, sizeof(NameLength));
+	CHECK(Pak.Open(Filename) == false);
+
+	// An unknown compression.
+	WriteValidPak();
+	uint32_t Compression = 7;
+	PatchFile(Filename, Header.TocOffset + offsetof(FPakEntry, Compression), &Compression, sizeof(Compression));
+	CHECK(Pak.Open(Filename) == false);
+
+	// A wrong magic.
+	WriteValidPak();
+	uint32_t Magic = 0;
+	PatchFile(Filename, offsetof(FPakHeader, Magic), &Magic, sizeof(Magic));
+	CHECK(Pak.Open(Filename) == false);
+
+	CHECK(Pak.Open((std::filesystem::temp_directory_path() / "EngineTests_Missing.pak").string()) == false);
+}
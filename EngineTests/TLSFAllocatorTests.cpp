@@ -0,0 +1,137 @@
+#include "TestFramework.h"
+
+#include "TLSFAllocator.h"
+
+TEST_CASE(TLSFAllocatorAlignsOffsets)
+{
+	FTLSFAllocator Allocator(1024);
+
+	uint64_t Offset = UINT64_MAX;
+	uint32_t Unaligned = Allocator.Allocate(3, 1, Offset);
+	CHECK(Unaligned != FTLSFAllocator::InvalidHandle);
+	CHECK(Offset == 0);
+
+	// The padding in front of the aligned allocation stays free, so there are now two free ranges.
+	uint32_t Aligned = Allocator.Allocate(16, 64, Offset);
+	CHECK(Aligned != FTLSFAllocator::InvalidHandle);
+	CHECK(Offset == 64);
+	CHECK(Allocator.GetStats().NumFreeBlocks == 2);
+
+	for (uint64_t Alignment : { 2, 8, 32, 256 })
+	{
+		uint32_t Handle = Allocator.Allocate(5, Alignment, Offset);
+		CHECK(Handle != FTLSFAllocator::InvalidHandle);
+		CHECK(Offset % Alignment == 0);
+		CHECK(Allocator.GetOffset(Handle) == Offset);
+		CHECK(Allocator.GetSize(Handle) == 5);
+	}
+
+	// Zero-sized requests still get a distinct range.
+	uint32_t Empty = Allocator.Allocate(0, 1, Offset);
+	CHECK(Empty != FTLSFAllocator::InvalidHandle);
+	CHECK(Allocator.GetSize(Empty) == 1);
+}
+
+TEST_CASE(TLSFAllocatorSplitsAndMergesNeighbours)
+{
+	FTLSFAllocator Allocator(1024);
+
+	uint64_t OffsetA = 0;
+	uint64_t OffsetB = 0;
+	uint64_t OffsetC = 0;
+	uint32_t A = Allocator.Allocate(256, 1, OffsetA);
+	uint32_t B = Allocator.Allocate(256, 1, OffsetB);
+	uint32_t C = Allocator.Allocate(256, 1, OffsetC);
+
+	CHECK(OffsetA == 0);
+	CHECK(OffsetB == 256);
+	CHECK(OffsetC == 512);
+
+	FTLSFAllocator::FStats Stats = Allocator.GetStats();
+	CHECK(Stats.NumFreeBlocks == 1);
+	CHECK(Stats.LargestFreeBlock == 256);
+
+	// B has allocated neighbours on both sides and stays a range of its own.
+	Allocator.Free(B);
+	Stats = Allocator.GetStats();
+	CHECK(Stats.NumFreeBlocks == 2);
+	CHECK(Stats.LargestFreeBlock == 256);
+
+	Allocator.Free(A);
+	Stats = Allocator.GetStats();
+	CHECK(Stats.NumFreeBlocks == 2);
+	CHECK(Stats.LargestFreeBlock == 512);
+
+	Allocator.Free(C);
+	Stats = Allocator.GetStats();
+	CHECK(Stats.NumFreeBlocks == 1);
+	CHECK(Stats.LargestFreeBlock == 1024);
+	CHECK(Allocator.IsEmpty());
+
+	uint64_t Offset = UINT64_MAX;
+	CHECK(Allocator.Allocate(1024, 1, Offset) != FTLSFAllocator::InvalidHandle);
+	CHECK(Offset == 0);
+}
+
+TEST_CASE(TLSFAllocatorReusesFreedRanges)
+{
+	FTLSFAllocator Allocator(1024);
+
+	uint32_t Handles[4];
+	for (uint32_t Idx = 0; Idx < 4; ++Idx)
+	{
+		uint64_t Offset = 0;
+		Handles[Idx] = Allocator.Allocate(256, 1, Offset);
+		CHECK(Handles[Idx] != FTLSFAllocator::InvalidHandle);
+	}
+
+	uint64_t Offset = UINT64_MAX;
+	CHECK(Allocator.Allocate(1, 1, Offset) == FTLSFAllocator::InvalidHandle);
+
+	Allocator.Free(Handles[1]);
+	CHECK(Allocator.Allocate(512, 1, Offset) == FTLSFAllocator::InvalidHandle);
+	CHECK(Allocator.Allocate(256, 1, Offset) != FTLSFAllocator::InvalidHandle);
+	CHECK(Offset == 256);
+
+	// Freeing a range twice must not release it again.
+	Allocator.Free(Handles[2]);
+	Allocator.Free(Handles[2]);
+	CHECK(Allocator.GetNumAllocations() == 3);
+	CHECK(Allocator.GetUsedSize() == 768);
+}
+
+TEST_CASE(TLSFAllocatorReportsStats)
+{
+	FTLSFAllocator Empty;
+	FTLSFAllocator::FStats Stats = Empty.GetStats();
+	CHECK(Stats.Capacity == 0);
+	CHECK(Stats.NumFreeBlocks == 0);
+
+	uint64_t Offset = 0;
+	CHECK(Empty.Allocate(1, 1, Offset) == FTLSFAllocator::InvalidHandle);
+
+	FTLSFAllocator Allocator(4096);
+	uint32_t A = Allocator.Allocate(100, 1, Offset);
+	Allocator.Allocate(200, 128, Offset);
+
+	Stats = Allocator.GetStats();
+	CHECK(Stats.Capacity == 4096);
+	CHECK(Stats.NumAllocations == 2);
+	CHECK(Stats.UsedSize == 300);
+	CHECK(Stats.NumFreeBlocks == 2);
+	CHECK(Stats.LargestFreeBlock == 4096 - 128 - 200);
+
+	Allocator.Free(A);
+	Stats = Allocator.GetStats();
+	CHECK(Stats.NumAllocations == 1);
+	CHECK(Stats.UsedSize == 200);
+	CHECK(Stats.NumFreeBlocks == 2);
+	CHECK(Stats.LargestFreeBlock == 4096 - 128 - 200);
+
+	Allocator.Reset(512);
+	Stats = Allocator.GetStats();
+	CHECK(Stats.Capacity == 512);
+	CHECK(Stats.NumAllocations == 0);
+	CHECK(Stats.UsedSize == 0);
+	CHECK(Stats.LargestFreeBlock == 512);
+}
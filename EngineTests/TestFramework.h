@@ -0,0 +1,89 @@
+#pragma once
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+
+// Minimal self-registering test cases. A test fails when any of its checks does; main runs them all and returns
+// EXIT_FAILURE if one failed, so the executable can gate a build.
+struct FTestCase
+{
+	const char* Name;
+	void (*Function)();
+};
+
+class FTestRegistry
+{
+public:
+	static std::vector<FTestCase>& GetTests()
+	{
+		static std::vector<FTestCase> Tests;
+		return Tests;
+	}
+
+	static uint32_t& GetNumFailedChecks()
+	{
+		static uint32_t NumFailedChecks = 0;
+		return NumFailedChecks;
+	}
+};
+
+struct FTestRegistrar
+{
+	FTestRegistrar(const char* InName, void (*InFunction)())
+	{
+		FTestRegistry::GetTests().push_back({ InName, InFunction });
+	}
+};
+
+#define TEST_CASE(Name) \
+	static void Name(); \
+	static FTestRegistrar Name##Registrar(#Name, &Name); \
+	static void Name()
+
+#define CHECK(Condition) \
+	do \
+	{ \
+		if ((Condition) == false) \
+		{ \
+			++FTestRegistry::GetNumFailedChecks(); \
+			std::cerr << __FILE__ << "(" << __LINE__ << "): check failed: " << #Condition << std::endl; \
+		} \
+	} \
+	while (false)
+
+#define CHECK_NEAR(Value, Expected, Tolerance) CHECK(std::abs((Value) - (Expected)) <= (Tolerance))
+
+// Runs InFunction InIterations times and returns the fastest run in milliseconds. Benchmarks print their timings instead
+// of checking them, since those depend on the machine; their checks cover the results being identical.
+template <typename FunctionType>
+double MeasureBestMilliseconds(uint32_t InIterations, FunctionType&& InFunction)
+{
+	double Best = HUGE_VAL;
+
+	for (uint32_t Iteration = 0; Iteration < InIterations; ++Iteration)
+	{
+		auto Start = std::chrono::steady_clock::now();
+		InFunction();
+		std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - Start;
+
+		Best = std::min(Best, Elapsed.count());
+	}
+
+	return Best;
+}
+
+// The meshes in resources/, for benchmarks on real assets. Configurations without SOLUTION_DIRECTORY run from the
+// project directory.
+inline std::string GetMeshDirectory()
+{
+#ifdef SOLUTION_DIRECTORY
+	return std::string(SOLUTION_DIRECTORY) + "resources/meshes/";
+#else
+	return "../resources/meshes/";
+#endif
+}
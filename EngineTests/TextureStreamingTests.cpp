@@ -0,0 +1,148 @@
+#include "TestFramework.h"
+
+#include "TextureStreaming.h"
+
+#include <limits>
+
+static FStreamingTexture MakeTexture(const std::vector<FTextureMip>& InMips, float InScreenSize, uint32_t InResidentMip = 0)
+{
+	FStreamingTexture Texture;
+	Texture.Mips = InMips.data();
+	Texture.NumMips = static_cast<uint32_t>(InMips.size());
+	Texture.ScreenSize = InScreenSize;
+	Texture.ResidentMip = InResidentMip;
+	Texture.WantedMip = InResidentMip;
+
+	return Texture;
+}
+
+static std::vector<FTextureMip> MakeMips(uint32_t InWidth, uint32_t InHeight)
+{
+	std::vector<FTextureMip> Mips;
+	FMipGenerator::GetMipChainLayout(InWidth, InHeight, FMipGenerator::GetNumMipLevels(InWidth, InHeight), Mips);
+
+	return Mips;
+}
+
+TEST_CASE(TextureStreamingRequiredMipAtBoundaries)
+{
+	// 1024x1024 has 11 levels; a level is kept until it has two texels per pixel.
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 2048.0f) == 0);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 1024.0f) == 0);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 513.0f) == 0);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 512.0f) == 1);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 511.0f) == 1);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 256.0f) == 2);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 1.0f) == 10);
+
+	// Clamped to the last level, which is also used when nothing is visible.
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 0.25f) == 10);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 0.0f) == 10);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 4, 1.0f) == 3);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 0, 1.0f) == 0);
+
+	// The larger dimension decides, and the bias shifts the result by whole levels.
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 256, 11, 256.0f) == 2);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(256, 1024, 11, 256.0f) == 2);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 1024.0f, 1.0f) == 1);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 512.0f, -1.0f) == 0);
+	CHECK(FTextureStreamingPolicy::GetRequiredMip(1024, 1024, 11, 1024.0f, -1.0f) == 0);
+}
+
+TEST_CASE(TextureStreamingScreenSize)
+{
+	CHECK(FTextureStreamingPolicy::GetScreenSize(1.0f, 0.5f, 1.0f, 1080.0f) == std::numeric_limits<float>::max());
+
+	// A sphere that exactly fills a 90 degree view spans the viewport.
+	float Distance = std::sqrt(2.0f);
+	CHECK_NEAR(FTextureStreamingPolicy::GetScreenSize(1.0f, Distance, 3.14159265f * 0.5f, 1000.0f), 1000.0f, 0.1f);
+	CHECK(FTextureStreamingPolicy::GetScreenSize(1.0f, 20.0f, 1.0f, 1000.0f) < FTextureStreamingPolicy::GetScreenSize(1.0f, 10.0f, 1.0f, 1000.0f));
+}
+
+TEST_CASE(TextureStreamingHysteresisDelaysStreamOut)
+{
+	uint32_t StreamOutFrames = 0;
+
+	// Held for exactly StreamOutDelay frames, then released.
+	for (uint32_t Frame = 1; Frame <= 3; ++Frame)
+	{
+		CHECK(FTextureStreamingPolicy::ApplyHysteresis(0, 2, 3, StreamOutFrames) == 0);
+		CHECK(StreamOutFrames == Frame);
+	}
+	CHECK(FTextureStreamingPolicy::ApplyHysteresis(0, 2, 3, StreamOutFrames) == 2);
+	CHECK(StreamOutFrames == 4);
+
+	// Needing the resident levels again resets the counter.
+	CHECK(FTextureStreamingPolicy::ApplyHysteresis(0, 0, 3, StreamOutFrames) == 0);
+	CHECK(StreamOutFrames == 0);
+	CHECK(FTextureStreamingPolicy::ApplyHysteresis(0, 1, 3, StreamOutFrames) == 0);
+	CHECK(StreamOutFrames == 1);
+
+	// Streaming in is never delayed.
+	CHECK(FTextureStreamingPolicy::ApplyHysteresis(3, 1, 3, StreamOutFrames) == 1);
+	CHECK(StreamOutFrames == 0);
+
+	// Without a delay levels go as soon as they are not needed.
+	CHECK(FTextureStreamingPolicy::ApplyHysteresis(0, 2, 0, StreamOutFrames) == 2);
+}
+
+TEST_CASE(TextureStreamingFitToBudgetDropsMostBytesPerPixel)
+{
+	std::vector<FTextureMip> Mips = MakeMips(256, 256);
+	const uint32_t NumMips = static_cast<uint32_t>(Mips.size());
+	const uint64_t FullSize = FTextureStreamingPolicy::GetResidentSize(Mips.data(), NumMips, 0);
+
+	std::vector<FStreamingTexture> Textures = { MakeTexture(Mips, 1000.0f), MakeTexture(Mips, 10.0f) };
+
+	CHECK(FTextureStreamingPolicy::FitToBudget(Textures, 2 * FullSize) == 2 * FullSize);
+	CHECK(Textures[0].WantedMip == 0 && Textures[1].WantedMip == 0);
+
+	// The small on-screen texture loses its top level first, having the most bytes per pixel.
+	uint64_t Size = FTextureStreamingPolicy::FitToBudget(Textures, 2 * FullSize - 1);
+	CHECK(Textures[0].WantedMip == 0);
+	CHECK(Textures[1].WantedMip == 1);
+	CHECK(Size == FullSize + FTextureStreamingPolicy::GetResidentSize(Mips.data(), NumMips, 1));
+
+	// It keeps losing levels while they cost more per pixel than the other texture's top level (262144 bytes over
+	// 1000 pixels), down to level 4 (1024 bytes over 10 pixels). Then the other texture's top level goes.
+	Size = FTextureStreamingPolicy::FitToBudget(Textures, FullSize + 1);
+	CHECK(Size <= FullSize + 1);
+	CHECK(Textures[0].WantedMip == 1);
+	CHECK(Textures[1].WantedMip == 4);
+
+	// An impossible budget leaves every texture at its last level.
+	Size = FTextureStreamingPolicy::FitToBudget(Textures, 0);
+	CHECK(Textures[0].WantedMip == NumMips - 1);
+	CHECK(Textures[1].WantedMip == NumMips - 1);
+	CHECK(Size == 2 * Mips.back().Size);
+}
+
+TEST_CASE(TextureStreamingUpdateDropsHysteresisLevelsFirst)
+{
+	std::vector<FTextureMip> Mips = MakeMips(1024, 1024);
+	const uint32_t NumMips = static_cast<uint32_t>(Mips.size());
+
+	// The first texture needs level 3 but still has level 0 resident; the second needs everything.
+	std::vector<FStreamingTexture> Textures = { MakeTexture(Mips, 128.0f), MakeTexture(Mips, 1024.0f) };
+
+	FTextureStreamingSettings Settings;
+	Settings.StreamOutDelay = 60;
+
+	uint64_t Size = FTextureStreamingPolicy::Update(Textures, Settings);
+	CHECK(Textures[0].WantedMip == 0);
+	CHECK(Textures[0].StreamOutFrames == 1);
+	CHECK(Size == 2 * FTextureStreamingPolicy::GetResidentSize(Mips.data(), NumMips, 0));
+
+	// Exactly enough room for what is required: only the levels held by the hysteresis go.
+	Settings.BudgetBytes = FTextureStreamingPolicy::GetResidentSize(Mips.data(), NumMips, 3) + FTextureStreamingPolicy::GetResidentSize(Mips.data(), NumMips, 0);
+	Size = FTextureStreamingPolicy::Update(Textures, Settings);
+	CHECK(Textures[0].WantedMip == 3);
+	CHECK(Textures[0].StreamOutFrames == 0);
+	CHECK(Textures[1].WantedMip == 0);
+	CHECK(Size == Settings.BudgetBytes);
+
+	// Textures without levels are left alone.
+	std::vector<FStreamingTexture> Empty(1);
+	CHECK(FTextureStreamingPolicy::Update(Empty, Settings) == 0);
+	CHECK(Empty[0].WantedMip == 0);
+}
@@ -0,0 +1,224 @@
+#include "TestFramework.h"
+
+#include "VulkanDescriptorAllocator.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+// Stands in for the device: pools hold up to maxSets sets and report VK_ERROR_OUT_OF_POOL_MEMORY beyond that.
+struct FMockDescriptorDevice
+{
+	std::unordered_map<VkDescriptorPool, uint32_t> PoolCapacities;
+	std::unordered_map<VkDescriptorSet, VkDescriptorPool> SetPools;
+	uint64_t NextHandle = 1;
+	uint32_t NumCreatedPools = 0;
+	uint32_t NumFreedIntoWrongPool = 0;
+	VkResult AllocateResult = VK_SUCCESS;
+	bool bFailPoolCreation = false;
+
+	uint32_t CountSets(VkDescriptorPool InPool) const
+	{
+		uint32_t NumSets = 0;
+		for (const auto& SetPool : SetPools)
+		{
+			NumSets += SetPool.second == InPool ? 1 : 0;
+		}
+
+		return NumSets;
+	}
+};
+
+static FMockDescriptorDevice MockDescriptors;
+
+// Non-dispatchable handles are pointers on 64-bit targets and integers on 32-bit ones; a C-style cast covers both.
+template <typename HandleType>
+static HandleType MakeMockHandle()
+{
+	return (HandleType)(uintptr_t)MockDescriptors.NextHandle++;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL MockCreateDescriptorPool(VkDevice, const VkDescriptorPoolCreateInfo* InCreateInfo, const VkAllocationCallbacks*, VkDescriptorPool* OutPool)
+{
+	if (MockDescriptors.bFailPoolCreation)
+	{
+		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	}
+
+	*OutPool = MakeMockHandle<VkDescriptorPool>();
+	MockDescriptors.PoolCapacities[*OutPool] = InCreateInfo->maxSets;
+	++MockDescriptors.NumCreatedPools;
+
+	return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL MockDestroyDescriptorPool(VkDevice, VkDescriptorPool InPool, const VkAllocationCallbacks*)
+{
+	for (auto Iter = MockDescriptors.SetPools.begin(); Iter != MockDescriptors.SetPools.end();)
+	{
+		Iter = Iter->second == InPool ? MockDescriptors.SetPools.erase(Iter) : std::next(Iter);
+	}
+
+	MockDescriptors.PoolCapacities.erase(InPool);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL MockAllocateDescriptorSets(VkDevice, const VkDescriptorSetAllocateInfo* InAllocateInfo, VkDescriptorSet* OutSets)
+{
+	if (MockDescriptors.AllocateResult != VK_SUCCESS)
+	{
+		return MockDescriptors.AllocateResult;
+	}
+
+	VkDescriptorPool Pool = InAllocateInfo->descriptorPool;
+	if (MockDescriptors.CountSets(Pool) + InAllocateInfo->descriptorSetCount > MockDescriptors.PoolCapacities[Pool])
+	{
+		return VK_ERROR_OUT_OF_POOL_MEMORY;
+	}
+
+	for (uint32_t Idx = 0; Idx < InAllocateInfo->descriptorSetCount; ++Idx)
+	{
+		OutSets[Idx] = MakeMockHandle<VkDescriptorSet>();
+		MockDescriptors.SetPools[OutSets[Idx]] = Pool;
+	}
+
+	return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL MockFreeDescriptorSets(VkDevice, VkDescriptorPool InPool, uint32_t InCount, const VkDescriptorSet* InSets)
+{
+	for (uint32_t Idx = 0; Idx < InCount; ++Idx)
+	{
+		auto Iter = MockDescriptors.SetPools.find(InSets[Idx]);
+		if (Iter == MockDescriptors.SetPools.end() || Iter->second != InPool)
+		{
+			++MockDescriptors.NumFreedIntoWrongPool;
+			continue;
+		}
+
+		MockDescriptors.SetPools.erase(Iter);
+	}
+
+	return VK_SUCCESS;
+}
+
+static void InitializeMockAllocator(FVulkanDescriptorAllocator& OutAllocator, uint32_t InSetsPerPool)
+{
+	MockDescriptors = FMockDescriptorDevice();
+
+	FVulkanDescriptorFunctions Functions;
+	Functions.CreateDescriptorPool = MockCreateDescriptorPool;
+	Functions.DestroyDescriptorPool = MockDestroyDescriptorPool;
+	Functions.AllocateDescriptorSets = MockAllocateDescriptorSets;
+	Functions.FreeDescriptorSets = MockFreeDescriptorSets;
+
+	OutAllocator.Initialize(VK_NULL_HANDLE, InSetsPerPool, 4, Functions);
+}
+
+// Mirrors FVulkanMeshRenderer::CreateDescriptorSets: one set per frame in flight for every material slot.
+static bool AllocateMeshSets(FVulkanDescriptorAllocator& InAllocator, uint32_t InNumSlots, uint32_t InNumFrames, std::vector<std::vector<VkDescriptorSet>>& OutSlotSets)
+{
+	bool bAllocated = true;
+
+	OutSlotSets.assign(InNumSlots, std::vector<VkDescriptorSet>(InNumFrames, VK_NULL_HANDLE));
+	for (std::vector<VkDescriptorSet>& Sets : OutSlotSets)
+	{
+		bAllocated &= InAllocator.Allocate(VK_NULL_HANDLE, InNumFrames, Sets.data());
+	}
+
+	return bAllocated;
+}
+
+TEST_CASE(DescriptorAllocatorGrowsForManySlotMeshes)
+{
+	FVulkanDescriptorAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator, 16);
+
+	constexpr uint32_t NumSlots = 40;
+	constexpr uint32_t NumFrames = 3;
+
+	// Five slots fit in a pool of 16 sets, so 40 slots take eight pools.
+	std::vector<std::vector<VkDescriptorSet>> SlotSets;
+	CHECK(AllocateMeshSets(Allocator, NumSlots, NumFrames, SlotSets));
+	CHECK(Allocator.GetNumPools() == 8);
+	CHECK(MockDescriptors.NumCreatedPools == 8);
+
+	std::unordered_set<VkDescriptorSet> UniqueSets;
+	for (const std::vector<VkDescriptorSet>& Sets : SlotSets)
+	{
+		for (VkDescriptorSet Set : Sets)
+		{
+			CHECK(Set != VK_NULL_HANDLE);
+			UniqueSets.insert(Set);
+		}
+	}
+	CHECK(UniqueSets.size() == NumSlots * NumFrames);
+
+	// A second mesh keeps growing the list instead of failing.
+	std::vector<std::vector<VkDescriptorSet>> SecondMeshSets;
+	CHECK(AllocateMeshSets(Allocator, NumSlots, NumFrames, SecondMeshSets));
+	CHECK(Allocator.GetNumPools() == 16);
+
+	Allocator.Destroy();
+	CHECK(MockDescriptors.PoolCapacities.empty());
+}
+
+TEST_CASE(DescriptorAllocatorReturnsSetsToTheirPools)
+{
+	FVulkanDescriptorAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator, 16);
+
+	std::vector<std::vector<VkDescriptorSet>> SlotSets;
+	CHECK(AllocateMeshSets(Allocator, 20, 3, SlotSets));
+	CHECK(Allocator.GetNumPools() == 4);
+
+	for (const std::vector<VkDescriptorSet>& Sets : SlotSets)
+	{
+		Allocator.Free(Sets.data(), static_cast<uint32_t>(Sets.size()));
+	}
+	CHECK(MockDescriptors.NumFreedIntoWrongPool == 0);
+	CHECK(MockDescriptors.SetPools.empty());
+
+	// Freed sets are reused from the older pools once the newest one is full.
+	CHECK(AllocateMeshSets(Allocator, 20, 3, SlotSets));
+	CHECK(Allocator.GetNumPools() == 4);
+
+	// Sets the allocator does not know are ignored.
+	VkDescriptorSet Unknown = MakeMockHandle<VkDescriptorSet>();
+	Allocator.Free(&Unknown, 1);
+	CHECK(MockDescriptors.NumFreedIntoWrongPool == 0);
+}
+
+TEST_CASE(DescriptorAllocatorReportsDeviceFailures)
+{
+	FVulkanDescriptorAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator, 4);
+
+	VkDescriptorSet Sets[3] = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
+
+	MockDescriptors.bFailPoolCreation = true;
+	CHECK(Allocator.Allocate(VK_NULL_HANDLE, 3, Sets) == false);
+	CHECK(Sets[0] == VK_NULL_HANDLE);
+	CHECK(Allocator.GetNumPools() == 0);
+
+	MockDescriptors.bFailPoolCreation = false;
+	CHECK(Allocator.Allocate(VK_NULL_HANDLE, 3, Sets));
+	CHECK(Allocator.GetNumPools() == 1);
+
+	// A fragmented pool is treated like a full one.
+	MockDescriptors.AllocateResult = VK_ERROR_FRAGMENTED_POOL;
+	VkDescriptorSet Fragmented[3] = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
+	CHECK(Allocator.Allocate(VK_NULL_HANDLE, 3, Fragmented) == false);
+	CHECK(Allocator.GetNumPools() == 2);
+
+	// Any other error is returned without trying further pools.
+	MockDescriptors.AllocateResult = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	VkDescriptorSet OutOfMemory[3] = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
+	CHECK(Allocator.Allocate(VK_NULL_HANDLE, 3, OutOfMemory) == false);
+	CHECK(OutOfMemory[0] == VK_NULL_HANDLE);
+	CHECK(Allocator.GetNumPools() == 2);
+
+	// Requests larger than a pool can never succeed, so they must not add pools.
+	MockDescriptors.AllocateResult = VK_SUCCESS;
+	VkDescriptorSet TooMany[5] = {};
+	CHECK(Allocator.Allocate(VK_NULL_HANDLE, 5, TooMany) == false);
+	CHECK(Allocator.GetNumPools() == 2);
+}
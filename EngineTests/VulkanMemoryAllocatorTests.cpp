@@ -0,0 +1,233 @@
+#include "TestFramework.h"
+
+#include "VulkanMemoryAllocator.h"
+
+#include <unordered_map>
+
+// Stands in for the device: every allocation is backed by host memory so mapped pointers can be written through.
+struct FMockDeviceMemory
+{
+	std::unordered_map<VkDeviceMemory, std::vector<uint8_t>> Allocations;
+	std::vector<uint32_t> AllocatedTypes;
+	uint64_t NextHandle = 1;
+	uint32_t NumMapped = 0;
+	uint32_t NumFreed = 0;
+	bool bFailAllocations = false;
+};
+
+static FMockDeviceMemory MockMemory;
+
+static VKAPI_ATTR VkResult VKAPI_CALL MockAllocateMemory(VkDevice, const VkMemoryAllocateInfo* InAllocateInfo, const VkAllocationCallbacks*, VkDeviceMemory* OutMemory)
+{
+	if (MockMemory.bFailAllocations)
+	{
+		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	}
+
+	// Non-dispatchable handles are pointers on 64-bit targets and integers on 32-bit ones; a C-style cast covers both.
+	*OutMemory = (VkDeviceMemory)(uintptr_t)MockMemory.NextHandle++;
+
+	MockMemory.Allocations[*OutMemory].resize(static_cast<size_t>(InAllocateInfo->allocationSize));
+	MockMemory.AllocatedTypes.push_back(InAllocateInfo->memoryTypeIndex);
+
+	return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL MockFreeMemory(VkDevice, VkDeviceMemory InMemory, const VkAllocationCallbacks*)
+{
+	MockMemory.Allocations.erase(InMemory);
+	++MockMemory.NumFreed;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL MockMapMemory(VkDevice, VkDeviceMemory InMemory, VkDeviceSize, VkDeviceSize, VkMemoryMapFlags, void** OutData)
+{
+	*OutData = MockMemory.Allocations[InMemory].data();
+	++MockMemory.NumMapped;
+
+	return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL MockUnmapMemory(VkDevice, VkDeviceMemory)
+{
+	--MockMemory.NumMapped;
+}
+
+static constexpr VkDeviceSize MockBlockSize = 64 * 1024;
+
+// Type 0 is device local, type 1 host visible and type 2 both, like a discrete GPU with a resizable BAR.
+static void InitializeMockAllocator(FVulkanMemoryAllocator& OutAllocator)
+{
+	MockMemory = FMockDeviceMemory();
+
+	VkPhysicalDeviceMemoryProperties MemoryProperties{};
+	MemoryProperties.memoryTypeCount = 3;
+	MemoryProperties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	MemoryProperties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	MemoryProperties.memoryTypes[2].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+	MemoryProperties.memoryHeapCount = 1;
+	MemoryProperties.memoryHeaps[0].size = 256 * 1024 * 1024;
+
+	FVulkanMemoryFunctions Functions;
+	Functions.AllocateMemory = MockAllocateMemory;
+	Functions.FreeMemory = MockFreeMemory;
+	Functions.MapMemory = MockMapMemory;
+	Functions.UnmapMemory = MockUnmapMemory;
+
+	OutAllocator.Initialize(VK_NULL_HANDLE, MemoryProperties, MockBlockSize, Functions);
+}
+
+static VkMemoryRequirements MakeRequirements(VkDeviceSize InSize, VkDeviceSize InAlignment, uint32_t InTypeBits)
+{
+	VkMemoryRequirements Requirements{};
+	Requirements.size = InSize;
+	Requirements.alignment = InAlignment;
+	Requirements.memoryTypeBits = InTypeBits;
+
+	return Requirements;
+}
+
+TEST_CASE(MemoryAllocatorSelectsFirstMatchingType)
+{
+	FVulkanMemoryAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator);
+
+	FVulkanAllocation DeviceLocal;
+	CHECK(Allocator.Allocate(MakeRequirements(256, 256, 0x7), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Optimal, DeviceLocal));
+	CHECK(DeviceLocal.MemoryTypeIndex == 0);
+	CHECK(DeviceLocal.Mapped == nullptr);
+
+	FVulkanAllocation HostVisible;
+	CHECK(Allocator.Allocate(MakeRequirements(256, 256, 0x7), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, EVulkanResourceKind::Linear, HostVisible));
+	CHECK(HostVisible.MemoryTypeIndex == 1);
+	CHECK(HostVisible.Mapped != nullptr);
+
+	// The resource rules out type 1, so the host visible request falls through to type 2.
+	FVulkanAllocation Restricted;
+	CHECK(Allocator.Allocate(MakeRequirements(256, 256, 0x5), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, EVulkanResourceKind::Linear, Restricted));
+	CHECK(Restricted.MemoryTypeIndex == 2);
+	CHECK(Restricted.Mapped != nullptr);
+
+	FVulkanAllocation Both;
+	CHECK(Allocator.Allocate(MakeRequirements(256, 256, 0x7), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, EVulkanResourceKind::Linear, Both));
+	CHECK(Both.MemoryTypeIndex == 2);
+
+	CHECK(MockMemory.AllocatedTypes == std::vector<uint32_t>({ 0, 1, 2 }));
+
+	Allocator.Free(DeviceLocal);
+	Allocator.Free(HostVisible);
+	Allocator.Free(Restricted);
+	Allocator.Free(Both);
+	CHECK(DeviceLocal.IsValid() == false);
+}
+
+TEST_CASE(MemoryAllocatorSeparatesResourceKinds)
+{
+	FVulkanMemoryAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator);
+
+	FVulkanAllocation BufferA;
+	FVulkanAllocation BufferB;
+	FVulkanAllocation Image;
+	CHECK(Allocator.Allocate(MakeRequirements(100, 16, 0x1), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Linear, BufferA));
+	CHECK(Allocator.Allocate(MakeRequirements(100, 256, 0x1), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Linear, BufferB));
+	CHECK(Allocator.Allocate(MakeRequirements(100, 16, 0x1), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Optimal, Image));
+
+	// Buffers share a block, the image gets a block of its own in the same memory type.
+	CHECK(BufferA.Memory == BufferB.Memory);
+	CHECK(BufferA.Offset + BufferA.Size <= BufferB.Offset);
+	CHECK(BufferB.Offset % 256 == 0);
+	CHECK(Image.Memory != BufferA.Memory);
+	CHECK(Image.PoolIndex != BufferA.PoolIndex);
+	CHECK(Image.MemoryTypeIndex == BufferA.MemoryTypeIndex);
+
+	FVulkanMemoryStats Stats = Allocator.GetStats(0);
+	CHECK(Stats.NumBlocks == 2);
+	CHECK(Stats.NumAllocations == 3);
+	CHECK(Stats.BlockBytes == 2 * MockBlockSize);
+	CHECK(Stats.UsedBytes == 300);
+	CHECK(Allocator.GetStats(1).NumBlocks == 0);
+}
+
+TEST_CASE(MemoryAllocatorGrowsAndReleasesBlocks)
+{
+	FVulkanMemoryAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator);
+
+	const VkMemoryRequirements Quarter = MakeRequirements(MockBlockSize / 4, 256, 0x2);
+
+	std::vector<FVulkanAllocation> Allocations(6);
+	for (FVulkanAllocation& Allocation : Allocations)
+	{
+		CHECK(Allocator.Allocate(Quarter, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, EVulkanResourceKind::Linear, Allocation));
+	}
+
+	CHECK(Allocations[3].Memory == Allocations[0].Memory);
+	CHECK(Allocations[4].Memory != Allocations[0].Memory);
+	CHECK(Allocator.GetStats(1).NumBlocks == 2);
+
+	// Mapped pointers of sub-allocations point at their own offset in the block.
+	CHECK(Allocations[1].Mapped == Allocations[0].Mapped - Allocations[0].Offset + Allocations[1].Offset);
+
+	Allocator.Free(Allocations[4]);
+	Allocator.Free(Allocations[5]);
+	CHECK(Allocator.GetStats(1).NumBlocks == 1);
+	CHECK(MockMemory.NumFreed == 1);
+
+	// The last block is kept even when empty, and the next allocation reuses it.
+	for (uint32_t Idx = 0; Idx < 4; ++Idx)
+	{
+		Allocator.Free(Allocations[Idx]);
+	}
+	CHECK(Allocator.GetStats(1).NumBlocks == 1);
+	CHECK(Allocator.GetStats(1).NumAllocations == 0);
+
+	FVulkanAllocation Reused;
+	CHECK(Allocator.Allocate(Quarter, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, EVulkanResourceKind::Linear, Reused));
+	CHECK(MockMemory.AllocatedTypes.size() == 2);
+
+	Allocator.Destroy();
+	CHECK(MockMemory.Allocations.empty());
+	CHECK(MockMemory.NumMapped == 0);
+}
+
+TEST_CASE(MemoryAllocatorDedicatesLargeAllocations)
+{
+	FVulkanMemoryAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator);
+
+	FVulkanAllocation Large;
+	CHECK(Allocator.Allocate(MakeRequirements(MockBlockSize / 2 + 1, 256, 0x1), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Optimal, Large));
+	CHECK(Large.bDedicated);
+	CHECK(Large.Offset == 0);
+	CHECK(MockMemory.Allocations[Large.Memory].size() == MockBlockSize / 2 + 1);
+
+	FVulkanMemoryStats Stats = Allocator.GetTotalStats();
+	CHECK(Stats.NumBlocks == 0);
+	CHECK(Stats.NumDedicatedAllocations == 1);
+	CHECK(Stats.DedicatedBytes == MockBlockSize / 2 + 1);
+
+	Allocator.Free(Large);
+	Stats = Allocator.GetTotalStats();
+	CHECK(Stats.NumDedicatedAllocations == 0);
+	CHECK(Stats.DedicatedBytes == 0);
+	CHECK(MockMemory.Allocations.empty());
+}
+
+TEST_CASE(MemoryAllocatorReportsDeviceFailures)
+{
+	FVulkanMemoryAllocator Allocator(nullptr);
+	InitializeMockAllocator(Allocator);
+
+	MockMemory.bFailAllocations = true;
+
+	FVulkanAllocation Small;
+	CHECK(Allocator.Allocate(MakeRequirements(256, 256, 0x1), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Linear, Small) == false);
+	CHECK(Small.IsValid() == false);
+
+	FVulkanAllocation Large;
+	CHECK(Allocator.Allocate(MakeRequirements(MockBlockSize, 256, 0x1), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanResourceKind::Linear, Large) == false);
+	CHECK(Large.IsValid() == false);
+
+	CHECK(Allocator.GetTotalStats().NumBlocks == 0);
+	CHECK(Allocator.GetTotalStats().NumDedicatedAllocations == 0);
+}
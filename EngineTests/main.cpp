@@ -0,0 +1,23 @@
+#include "TestFramework.h"
+
+#include <cstdlib>
+
+int main()
+{
+	uint32_t NumFailedTests = 0;
+
+	for (const FTestCase& Test : FTestRegistry::GetTests())
+	{
+		uint32_t NumFailedChecks = FTestRegistry::GetNumFailedChecks();
+		Test.Function();
+
+		bool bPassed = FTestRegistry::GetNumFailedChecks() == NumFailedChecks;
+		NumFailedTests += bPassed ? 0 : 1;
+
+		std::cout << (bPassed ? "[PASS] " : "[FAIL] ") << Test.Name << std::endl;
+	}
+
+	std::cout << FTestRegistry::GetTests().size() - NumFailedTests << " of " << FTestRegistry::GetTests().size() << " tests passed." << std::endl;
+
+	return NumFailedTests == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
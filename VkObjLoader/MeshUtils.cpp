@@ -12,7 +12,7 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
 
-bool LoadModel(const std::string& InFilename, std::vector<FVertex>& OutVertices, std::vector<uint16_t>& OutIndices)
+bool LoadModel(const std::string& InFilename, std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices)
 {
 	tinyobj::attrib_t Attributes;
 	std::vector<tinyobj::shape_t> Shapes;
@@ -24,7 +24,7 @@ bool LoadModel(const std::string& InFilename, std::vector<FVertex>& OutVertices,
 		return false;
 	}
 
-	std::unordered_map<FVertex, uint16_t> UniqueVertices;
+	std::unordered_map<FVertex, uint32_t> UniqueVertices;
 
 	for (const tinyobj::shape_t& Shape : Shapes)
 	{
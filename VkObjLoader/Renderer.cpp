@@ -168,7 +168,7 @@ void FSingleObjectRenderer::RecordCommandBuffer(VkCommandBuffer InCommandBuffer,
 	VkDeviceSize Offsets[] = { 0 };
 	vkCmdBindVertexBuffers(InCommandBuffer, 0, 1, VertexBuffers, Offsets);
 
-	vkCmdBindIndexBuffer(InCommandBuffer, IndexBuffer, 0, VK_INDEX_TYPE_UINT16);
+	vkCmdBindIndexBuffer(InCommandBuffer, IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 	vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayout, 0, 1, &DescriptorSets[GCurrentFrame], 0, nullptr);
 
@@ -896,7 +896,7 @@ void FSingleObjectRenderer::CreateVertexBuffer()
 
 void FSingleObjectRenderer::CreateIndexBuffer()
 {
-	VkDeviceSize BufferSize = sizeof(uint16_t) * Indices.size();
+	VkDeviceSize BufferSize = sizeof(uint32_t) * Indices.size();
 
 	VkBuffer StagingBuffer;
 	VkDeviceMemory StagingBufferMemory;
@@ -74,7 +74,9 @@ void main()
     vec3 N = normalize(inNormal);
     vec3 V = normalize(-inPosition.xyz);
 
-    vec3 tangentNormal = normalize(texture(normalSampler, inTexCoord).rgb * 2.0 - 1.0);
+    // Normal maps may be BC5 with only X and Y stored, so Z is always rebuilt.
+    vec2 tangentNormalXY = texture(normalSampler, inTexCoord).rg * 2.0 - 1.0;
+    vec3 tangentNormal = vec3(tangentNormalXY, sqrt(max(1.0 - dot(tangentNormalXY, tangentNormalXY), 0.0)));
     N = normalize(inTBN * tangentNormal);
 
     vec4 baseColor = texture(baseColorSampler, inTexCoord);
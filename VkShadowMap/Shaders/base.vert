@@ -7,30 +7,59 @@ layout(std140, binding = 0) uniform TransformBuffer
     vec3 cameraPosition;
 } transformBuffer;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
+// 0: float vertices, 1: packed vertices (see EVertexFormat).
+layout(constant_id = 0) const uint vertexFormat = 0;
+
+// Packed positions are dequantized by the instance model matrix. Their w holds the tangent handedness, which
+// float vertices keep in the tangent's w instead.
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec4 inNormal;
 layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inTangent;
+layout(location = 3) in vec4 inTangent;
 
 layout(location = 4) in mat4 inModel;
-layout(location = 8) in mat4 inModelView;
-layout(location = 12) in mat4 inNormalMatrix;
+layout(location = 8) in mat4 inNormalMatrix;
 
 layout(location = 0) out vec4 outPosition;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outTexCoord;
 layout(location = 3) out mat3 outTBN;
 
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0)
+    {
+        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(v);
+}
+
+vec3 decodeNormal()
+{
+    return vertexFormat == 1 ? decodeOctahedral(inNormal.xy) : inNormal.xyz;
+}
+
+vec3 decodeTangent()
+{
+    return vertexFormat == 1 ? decodeOctahedral(inTangent.xy) : inTangent.xyz;
+}
+
+float decodeHandedness()
+{
+    return (vertexFormat == 1 ? inPosition.w : inTangent.w) < 0.0 ? -1.0 : 1.0;
+}
+
 void main()
 {
-    mat3 normalMatrix = mat3(inNormalMatrix);
+    mat3 normalMatrix = mat3(transformBuffer.view) * mat3(inNormalMatrix);
 
-    outPosition = inModelView * vec4(inPosition, 1.0);
-    outNormal = normalize(normalMatrix * inNormal);
+    outPosition = transformBuffer.view * inModel * vec4(inPosition.xyz, 1.0);
+    outNormal = normalize(normalMatrix * decodeNormal());
     outTexCoord = inTexCoord;
 
-    vec3 tangent = normalize(normalMatrix * inTangent);
-    vec3 bitangent = normalize(normalMatrix * cross(outNormal, tangent));
+    vec3 tangent = normalize(normalMatrix * decodeTangent());
+    vec3 bitangent = normalize(normalMatrix * cross(outNormal, tangent)) * decodeHandedness();
     outTBN = mat3(tangent, bitangent, outNormal);
 
     gl_Position = transformBuffer.projection * outPosition;
@@ -7,18 +7,22 @@ layout(std140, binding = 0) uniform TransformBuffer
     vec3 cameraPosition;
 } transformBuffer;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
+// 0: float vertices, 1: packed vertices (see EVertexFormat).
+layout(constant_id = 0) const uint vertexFormat = 0;
+
+// Packed positions are dequantized by the instance model matrix. Their w holds the tangent handedness, which
+// float vertices keep in the tangent's w instead.
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec4 inNormal;
 layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inTangent;
+layout(location = 3) in vec4 inTangent;
 
 layout(location = 4) in mat4 inModel;
-layout(location = 8) in mat4 inModelView;
-layout(location = 12) in mat4 inNormalMatrix;
+layout(location = 8) in mat4 inNormalMatrix;
 
 layout(location = 0) out vec4 outPosition;
 
 void main()
 {
-    gl_Position = transformBuffer.projection * inModelView * vec4(inPosition, 1.0);
+    gl_Position = transformBuffer.projection * transformBuffer.view * inModel * vec4(inPosition.xyz, 1.0);
 }
\ No newline at end of file
@@ -407,8 +407,8 @@ void FVulkanSkyRenderer::Render()
 	VkDeviceSize Offsets[] = { 0 };
 	vkCmdBindVertexBuffers(CommandBuffer, 0, 1, VertexBuffers, Offsets);
 
-	vkCmdBindIndexBuffer(CommandBuffer, SkyMesh->GetIndexBuffer()->GetHandle(), 0, VK_INDEX_TYPE_UINT32);
+	vkCmdBindIndexBuffer(CommandBuffer, SkyMesh->GetIndexBuffer()->GetHandle(), 0, SkyMesh->GetIndexType());
 
-	vkCmdDrawIndexed(CommandBuffer, static_cast<uint32_t>(SkyMesh->GetMeshAsset()->GetIndices().size()), 1, 0, 0, 0);
+	vkCmdDrawIndexed(CommandBuffer, SkyMesh->GetMeshAsset()->GetNumIndices(), 1, 0, 0, 0);
 }
 
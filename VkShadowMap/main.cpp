@@ -2,6 +2,7 @@
 #include "Mesh.h"
 #include "Material.h"
 #include "AssetManager.h"
+#include "JobSystem.h"
 #include "Texture2D.h"
 #include "TextureCube.h"
 #include "Widget.h"
@@ -188,6 +189,17 @@ void Run(int argc, char** argv)
 	GConfig->Set("ShaderDirectory", ProjectDirectory + "shaders/");
 	GConfig->Set("ImageDirectory", SolutionDirectory + "resources/images/");
 	GConfig->Set("MeshDirectory", SolutionDirectory + "resources/meshes/");
+	GConfig->Set("PipelineCachePath", ProjectDirectory + "pipeline.cache");
+	// Written by AssetCooker. With -cooked only the cooked data in them is loaded.
+	GConfig->Set("PakFiles", std::vector<std::string>{ SolutionDirectory + "resources.pak", ProjectDirectory + "shaders.pak" });
+
+	for (int Idx = 1; Idx < argc; ++Idx)
+	{
+		if (std::string(argv[Idx]) == "-cooked")
+		{
+			GConfig->Set("CookedDataOnly", true);
+		}
+	}
 
 	FEngine::Init();
 
@@ -206,27 +218,40 @@ void Run(int argc, char** argv)
 	GConfig->Get("ImageDirectory", ImageDirectory);
 
 	UTexture2D* BrickBaseColorTexture = FAssetManager::CreateAsset<UTexture2D>("T_BrickBaseColor");
-	BrickBaseColorTexture->Load(ImageDirectory + "Brick_BaseColor.jpg");
 
 	UTexture2D* BrickNormalTexture = FAssetManager::CreateAsset<UTexture2D>("T_BrickNormal");
-	BrickNormalTexture->Load(ImageDirectory + "Brick_Normal.png", true);
+	BrickNormalTexture->SetIsNormal(true);
 
 	UTexture2D* WhiteTexture = FAssetManager::CreateAsset<UTexture2D>("T_White");
-	WhiteTexture->Load(ImageDirectory + "white.png");
 
 	UTexture2D* PlaneNormalTexture = FAssetManager::CreateAsset<UTexture2D>("T_PlaneNormal");
-	PlaneNormalTexture->Load(ImageDirectory + "normal.png", true);
+	PlaneNormalTexture->SetIsNormal(true);
 
 	UTextureCube* SkyTexture = FAssetManager::CreateAsset<UTextureCube>("T_Sky");
+
+	std::vector<std::string> SkyTextureFilenames(6);
+	for (int Idx = 0; Idx < SkyTextureFilenames.size(); ++Idx)
 	{
-		std::array<std::string, 6> SkyTextureFilenames;
-		for (int Idx = 0; Idx < SkyTextureFilenames.size(); ++Idx)
-		{
-			SkyTextureFilenames[Idx] = ImageDirectory + "Skybox_" + std::string(1, '0' + Idx) + ".jpg";
-		}
-		SkyTexture->Load(SkyTextureFilenames);
+		SkyTextureFilenames[Idx] = ImageDirectory + "Skybox_" + std::string(1, '0' + Idx) + ".jpg";
+	}
+
+	// The textures are decoded side by side on the workers; only their uploads happen on this thread.
+	{
+		FJobCounter DecodeCounter;
+		GJobSystem->ScheduleBackground([=]() { BrickBaseColorTexture->LoadData(ImageDirectory + "Brick_BaseColor.jpg"); }, &DecodeCounter);
+		GJobSystem->ScheduleBackground([=]() { BrickNormalTexture->LoadData(ImageDirectory + "Brick_Normal.png"); }, &DecodeCounter);
+		GJobSystem->ScheduleBackground([=]() { WhiteTexture->LoadData(ImageDirectory + "white.png"); }, &DecodeCounter);
+		GJobSystem->ScheduleBackground([=]() { PlaneNormalTexture->LoadData(ImageDirectory + "normal.png"); }, &DecodeCounter);
+		GJobSystem->ScheduleBackground([=]() { SkyTexture->LoadData(SkyTextureFilenames); }, &DecodeCounter);
+		GJobSystem->Wait(DecodeCounter);
 	}
 
+	BrickBaseColorTexture->CreateRenderResources();
+	BrickNormalTexture->CreateRenderResources();
+	WhiteTexture->CreateRenderResources();
+	PlaneNormalTexture->CreateRenderResources();
+	SkyTexture->CreateRenderResources();
+
 	std::string ShaderDirectory;
 	GConfig->Get("ShaderDirectory", ShaderDirectory);
 
@@ -321,10 +346,12 @@ void Run(int argc, char** argv)
 	}
 
 	UMesh* SphereMesh = FAssetManager::CreateAsset<UMesh>("SM_Sphere");
+	SphereMesh->SetVertexFormat(EVertexFormat::Packed);
 	SphereMesh->Load(MeshDirectory + "sphere.fbx");
 	SphereMesh->SetMaterial(BaseMaterial);
 
 	UMesh* LightSourceMesh = FAssetManager::CreateAsset<UMesh>("SM_LightSource");
+	LightSourceMesh->SetVertexFormat(EVertexFormat::Packed);
 	LightSourceMesh->Load(MeshDirectory + "sphere.fbx");
 	LightSourceMesh->SetMaterial(LightSourceMaterial);
 
@@ -332,6 +359,12 @@ void Run(int argc, char** argv)
 	SkyMesh->Load(MeshDirectory + "sphere.fbx");
 	SkyMesh->SetMaterial(SkyMaterial);
 
+	// The glTF brings its own materials, which use the base shaders. Slots without one fall back to the base material.
+	UMesh* MonkeyMesh = FAssetManager::CreateAsset<UMesh>("SM_Monkey");
+	MonkeyMesh->Load(MeshDirectory + "monkey.gltf");
+	MonkeyMesh->SetMaterial(BaseMaterial);
+	MonkeyMesh->ImportMaterials(BaseMaterial->GetShaderPath(), WhiteTexture, PlaneNormalTexture);
+
 	FWorld* World = GEngine->GetWorld();
 
 	PointLight = World->SpawnActor<APointLightActor>();
@@ -351,6 +384,11 @@ void Run(int argc, char** argv)
 	SphereActor2->SetLocation(glm::vec3(4.0f, 0.0f, -2.0f));
 	SphereActor2->SetScale(glm::vec3(0.5f, 0.5f, 0.5f));
 
+	AMeshActor* MonkeyActor = World->SpawnActor<AMeshActor>();
+	MonkeyActor->SetMesh(MonkeyMesh);
+	MonkeyActor->SetLocation(glm::vec3(-4.0f, 0.0f, -2.0f));
+	MonkeyActor->SetScale(glm::vec3(0.5f, 0.5f, 0.5f));
+
 	ASkyActor* SkyActor = World->GetSky();
 	SkyActor->SetMesh(SkyMesh);
 
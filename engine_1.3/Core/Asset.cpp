@@ -1,10 +1,45 @@
 #include "Asset.h"
+#include "AssetManager.h"
+#include "Config.h"
+
+bool UAsset::bPurging = false;
 
 UAsset::UAsset()
+	: RefCount(0)
+	, LastReleasedFrame(0)
+	, bEvicted(false)
 {
 
 }
 
 UAsset::~UAsset()
 {	
-}
\ No newline at end of file
+}
+
+void UAsset::AddRef()
+{
+	// Pairs with the check in FAssetManager::EvictAssets: either the evictor sees this reference or this sees the eviction.
+	if (RefCount.fetch_add(1) == 0 && bEvicted.load())
+	{
+		FAssetManager::RequestReload(this);
+	}
+}
+
+void UAsset::Release()
+{
+	if (RefCount.fetch_sub(1) == 1)
+	{
+		LastReleasedFrame.store(FAssetManager::GetFrameNumber(), std::memory_order_relaxed);
+	}
+}
+
+bool UAsset::IsCookedDataOnly()
+{
+	bool bCookedDataOnly = false;
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("CookedDataOnly", bCookedDataOnly);
+	}
+
+	return bCookedDataOnly;
+}
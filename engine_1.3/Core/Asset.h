@@ -3,6 +3,9 @@
 #include "Object.h"
 
 #include <string>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 
 class UAsset : public UObject
 {
@@ -12,9 +15,50 @@ public:
 	UAsset();
 	virtual ~UAsset();
 
-	std::string GetName() const { return Name; }
+	const std::string& GetName() const { return Name; }
 	void SetName(const std::string& InName) { Name = InName; }
 
+	// Loading is split so FAssetManager can run the first half on a worker thread. LoadData reads and decodes
+	// the file without touching the GPU; CreateRenderResources then runs on the render thread.
+	virtual bool LoadData(const std::string& InFilename) { return false; }
+	virtual void CreateRenderResources() { }
+	virtual void Unload() { }
+
+	// File the data was last loaded from. Only assets that have one can be evicted, since they must be reloadable.
+	const std::string& GetSourceFilename() const { return SourceFilename; }
+
+	// Bytes held in system memory and in device memory.
+	virtual size_t GetCPUMemorySize() const { return 0; }
+	virtual size_t GetGPUMemorySize() const { return 0; }
+
+	// Counted by TAssetPtr.
+	void AddRef();
+	void Release();
+	int32_t GetRefCount() const { return RefCount.load(); }
+
+	// Frame on which the last reference went away; eviction goes from the oldest.
+	uint64_t GetLastReleasedFrame() const { return LastReleasedFrame.load(std::memory_order_relaxed); }
+
+	bool IsEvicted() const { return bEvicted.load(); }
+
+	// True while FAssetManager deletes every asset at shutdown, when references are no longer counted.
+	static bool IsPurging() { return bPurging; }
+
+	// Set by the CookedDataOnly config for shipping: assets load from the caches made by the cooker and never read
+	// or import their sources.
+	static bool IsCookedDataOnly();
+
+protected:
+	std::string SourceFilename;
+
 private:
+	friend class FAssetManager;
+
 	std::string Name;
+
+	std::atomic<int32_t> RefCount;
+	std::atomic<uint64_t> LastReleasedFrame;
+	std::atomic<bool> bEvicted;
+
+	static bool bPurging;
 };
@@ -1,12 +1,30 @@
 #include "AssetManager.h"
 #include "Asset.h"
+#include "Config.h"
 
 #include <cassert>
+#include <utility>
+#include <iostream>
+#include <algorithm>
 
 FAssetManager* FAssetManager::Instance;
 
+FAssetLoadRequest::FAssetLoadRequest(UAsset* InAsset, const std::string& InFilename, EAssetLoadPriority InPriority, uint64_t InSequence)
+	: Asset(InAsset)
+	, Filename(InFilename)
+	, Sequence(InSequence)
+	, Priority(InPriority)
+	, State(EAssetLoadState::Queued)
+	, bCancelRequested(false)
+	, bDataLoaded(false)
+	, bDestroyAssetWhenDone(false)
+{
+
+}
+
 void FAssetManager::Startup()
 {
+	UAsset::bPurging = false;
 	Instance = new FAssetManager();
 }
 
@@ -19,32 +37,270 @@ void FAssetManager::Shutdown()
 	}
 }
 
-UAsset* FAssetManager::FindAsset(const std::string& InAssetName)
+void FAssetManager::Tick()
+{
+	if (Instance == nullptr)
+	{
+		return;
+	}
+
+	Instance->FrameNumber.fetch_add(1, std::memory_order_relaxed);
+
+	std::vector<UAsset*> Reloads;
+	{
+		std::lock_guard<std::mutex> Lock(Instance->ReloadMutex);
+		Reloads.swap(Instance->ReloadRequests);
+	}
+
+	for (UAsset* Asset : Reloads)
+	{
+		// The eviction may have been rolled back, or another request may have already started the reload.
+		if (Asset->bEvicted.exchange(false))
+		{
+			LoadAsync(Asset, Asset->GetSourceFilename(), EAssetLoadPriority::High);
+		}
+	}
+
+	// Only loads that create GPU resources count against the budget; failed and cancelled ones are cheap to finish.
+	int32_t NumUploads = 0;
+
+	while (true)
+	{
+		FAssetLoadHandle Request;
+		{
+			std::lock_guard<std::mutex> Lock(Instance->LoadMutex);
+			if (Instance->DecodedLoads.empty())
+			{
+				break;
+			}
+
+			const FAssetLoadHandle& Front = Instance->DecodedLoads.front();
+			if (Front->bDataLoaded && Front->IsCancelRequested() == false)
+			{
+				if (NumUploads >= Instance->MaxUploadsPerFrame)
+				{
+					break;
+				}
+
+				++NumUploads;
+			}
+
+			Request = std::move(Instance->DecodedLoads.front());
+			Instance->DecodedLoads.pop_front();
+		}
+
+		Instance->FinishLoad(Request);
+	}
+
+	if (Instance->MemoryBudgetMB > 0)
+	{
+		Instance->EvictAssets();
+	}
+}
+
+uint64_t FAssetManager::GetFrameNumber()
 {
+	return Instance != nullptr ? Instance->FrameNumber.load(std::memory_order_relaxed) : 0;
+}
+
+FAssetMemoryStats FAssetManager::GetMemoryStats()
+{
+	FAssetMemoryStats Stats;
 	if (Instance == nullptr)
+	{
+		return Stats;
+	}
+
+	Instance->Registry.ForEach([&Stats](UAsset* InAsset)
+	{
+		++Stats.NumAssets;
+
+		if (Instance->PendingLoads.find(InAsset) != Instance->PendingLoads.end())
+		{
+			++Stats.NumLoading;
+			return;
+		}
+
+		if (InAsset->IsEvicted())
+		{
+			++Stats.NumEvicted;
+		}
+
+		Stats.CPUBytes += InAsset->GetCPUMemorySize();
+		Stats.GPUBytes += InAsset->GetGPUMemorySize();
+	});
+
+	return Stats;
+}
+
+void FAssetManager::RequestReload(UAsset* InAsset)
+{
+	if (Instance == nullptr || InAsset == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> Lock(Instance->ReloadMutex);
+	Instance->ReloadRequests.push_back(InAsset);
+}
+
+void FAssetManager::EvictAssets()
+{
+	size_t Budget = static_cast<size_t>(MemoryBudgetMB) * 1024 * 1024;
+	uint64_t CurrentFrame = FrameNumber.load(std::memory_order_relaxed);
+
+	size_t TotalBytes = 0;
+	EvictionCandidates.clear();
+
+	Registry.ForEach([this, &TotalBytes, CurrentFrame](UAsset* InAsset)
+	{
+		// A loading asset belongs to its worker until the load is done.
+		if (PendingLoads.find(InAsset) != PendingLoads.end())
+		{
+			return;
+		}
+
+		size_t Bytes = InAsset->GetCPUMemorySize() + InAsset->GetGPUMemorySize();
+		TotalBytes += Bytes;
+
+		if (Bytes > 0
+			&& InAsset->GetRefCount() == 0
+			&& InAsset->GetSourceFilename().empty() == false
+			&& InAsset->GetLastReleasedFrame() + EvictionFrameDelay < CurrentFrame)
+		{
+			EvictionCandidates.push_back(InAsset);
+		}
+	});
+
+	if (TotalBytes <= Budget)
+	{
+		return;
+	}
+
+	std::sort(EvictionCandidates.begin(), EvictionCandidates.end(), [](const UAsset* A, const UAsset* B)
+	{
+		return A->GetLastReleasedFrame() < B->GetLastReleasedFrame();
+	});
+
+	for (UAsset* Asset : EvictionCandidates)
+	{
+		if (TotalBytes <= Budget)
+		{
+			break;
+		}
+
+		// Marked before the reference count is checked again, so a reference taken meanwhile either shows up here
+		// or sees the flag and requests a reload.
+		Asset->bEvicted = true;
+		if (Asset->GetRefCount() != 0)
+		{
+			Asset->bEvicted = false;
+			continue;
+		}
+
+		size_t Bytes = Asset->GetCPUMemorySize() + Asset->GetGPUMemorySize();
+		Asset->Unload();
+		TotalBytes -= std::min(Bytes, TotalBytes);
+	}
+}
+
+FAssetLoadHandle FAssetManager::LoadAsync(UAsset* InAsset, const std::string& InFilename, EAssetLoadPriority InPriority, FAssetLoadCallback InCallback)
+{
+	if (Instance == nullptr || InAsset == nullptr)
 	{
 		return nullptr;
 	}
 
-	std::unordered_map<std::string, UAsset*> LiveAssets = Instance->LiveAssets;
-	if (auto Itr = LiveAssets.find(InAssetName); Itr != LiveAssets.end())
+	std::unordered_map<UAsset*, FAssetLoadHandle>& PendingLoads = Instance->PendingLoads;
+
+	auto Itr = PendingLoads.find(InAsset);
+	if (Itr != PendingLoads.end())
 	{
-		return Itr->second;
+		FAssetLoadHandle& Pending = Itr->second;
+		if (Pending->Filename == InFilename && Pending->IsCancelRequested() == false)
+		{
+			if (InPriority > Pending->GetPriority())
+			{
+				Pending->SetPriority(InPriority);
+			}
+
+			if (InCallback != nullptr)
+			{
+				Pending->Callback = [PreviousCallback = std::move(Pending->Callback), NewCallback = std::move(InCallback)](const FAssetLoadRequest& InRequest)
+				{
+					if (PreviousCallback != nullptr)
+					{
+						PreviousCallback(InRequest);
+					}
+
+					NewCallback(InRequest);
+				};
+			}
+
+			return Pending;
+		}
 	}
 
-	return nullptr;
+	FAssetLoadHandle Request = std::make_shared<FAssetLoadRequest>(InAsset, InFilename, InPriority, Instance->NextLoadSequence++);
+	Request->Callback = std::move(InCallback);
+
+	if (Itr != PendingLoads.end())
+	{
+		// The older load is superseded. It may still be decoding into the asset, so the new one waits for it.
+		FAssetLoadHandle& Pending = Itr->second;
+		Pending->Cancel();
+		Pending->NextLoad = Request;
+		Pending = Request;
+
+		return Request;
+	}
+
+	PendingLoads.insert({ InAsset, Request });
+	Instance->QueueLoad(Request);
+
+	return Request;
 }
 
-void FAssetManager::DestroyAsset(const std::string& InAssetName)
+UAsset* FAssetManager::FindAsset(std::string_view InAssetName)
+{
+	return FindAsset(FAssetRegistry::HashName(InAssetName), InAssetName);
+}
+
+UAsset* FAssetManager::FindAsset(uint64_t InNameHash, std::string_view InAssetName)
+{
+	if (Instance == nullptr)
+	{
+		return nullptr;
+	}
+
+	return Instance->Registry.Find(InNameHash, InAssetName);
+}
+
+void FAssetManager::DestroyAsset(std::string_view InAssetName)
 {
 	assert(Instance != nullptr);
 
-	std::unordered_map<std::string, UAsset*>& LiveAssets = Instance->LiveAssets;
-	if (auto Itr = LiveAssets.find(InAssetName); Itr != LiveAssets.end())
+	UAsset* Asset = Instance->Registry.Remove(FAssetRegistry::HashName(InAssetName), InAssetName);
+	if (Asset == nullptr)
 	{
-		LiveAssets.erase(Itr);
-		delete Itr->second;
+		return;
 	}
+
+	{
+		std::lock_guard<std::mutex> Lock(Instance->ReloadMutex);
+		std::vector<UAsset*>& ReloadRequests = Instance->ReloadRequests;
+		ReloadRequests.erase(std::remove(ReloadRequests.begin(), ReloadRequests.end(), Asset), ReloadRequests.end());
+	}
+
+	// An asset that is still loading may be in use by a worker; it is deleted once its last load is done.
+	if (auto LoadItr = Instance->PendingLoads.find(Asset); LoadItr != Instance->PendingLoads.end())
+	{
+		LoadItr->second->Cancel();
+		LoadItr->second->bDestroyAssetWhenDone = true;
+		return;
+	}
+
+	delete Asset;
 }
 
 void FAssetManager::DestroyAsset(UAsset* InAsset)
@@ -53,22 +309,155 @@ void FAssetManager::DestroyAsset(UAsset* InAsset)
 	{
 		return;
 	}
-	
+
 	DestroyAsset(InAsset->GetName());
 }
 
-FAssetManager::FAssetManager()
+void FAssetManager::QueueLoad(const FAssetLoadHandle& InRequest)
+{
+	{
+		std::lock_guard<std::mutex> Lock(LoadMutex);
+		QueuedLoads.push_back(InRequest);
+	}
+
+	// Jobs do not carry their request; each one takes whatever load has the highest priority when it starts.
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ScheduleBackground([this]() { ProcessNextLoad(); }, &LoadCounter);
+	}
+	else
+	{
+		ProcessNextLoad();
+	}
+}
+
+void FAssetManager::ProcessNextLoad()
+{
+	FAssetLoadHandle Request;
+	{
+		std::lock_guard<std::mutex> Lock(LoadMutex);
+		if (QueuedLoads.empty())
+		{
+			return;
+		}
+
+		auto Best = QueuedLoads.begin();
+		for (auto Itr = QueuedLoads.begin() + 1; Itr != QueuedLoads.end(); ++Itr)
+		{
+			EAssetLoadPriority Priority = (*Itr)->GetPriority();
+			EAssetLoadPriority BestPriority = (*Best)->GetPriority();
+			if (Priority > BestPriority || (Priority == BestPriority && (*Itr)->Sequence < (*Best)->Sequence))
+			{
+				Best = Itr;
+			}
+		}
+
+		std::swap(*Best, QueuedLoads.back());
+		Request = std::move(QueuedLoads.back());
+		QueuedLoads.pop_back();
+	}
+
+	if (Request->IsCancelRequested() == false)
+	{
+		Request->State.store(EAssetLoadState::Loading, std::memory_order_release);
+		Request->bDataLoaded = Request->Asset->LoadData(Request->Filename);
+	}
+
+	std::lock_guard<std::mutex> Lock(LoadMutex);
+	DecodedLoads.push_back(std::move(Request));
+}
+
+void FAssetManager::FinishLoad(const FAssetLoadHandle& InRequest)
 {
+	UAsset* Asset = InRequest->Asset;
+
+	EAssetLoadState FinalState;
+	if (InRequest->IsCancelRequested())
+	{
+		if (InRequest->bDataLoaded)
+		{
+			Asset->Unload();
+		}
 
+		FinalState = EAssetLoadState::Cancelled;
+	}
+	else if (InRequest->bDataLoaded)
+	{
+		Asset->CreateRenderResources();
+		FinalState = EAssetLoadState::Loaded;
+	}
+	else
+	{
+		std::cerr << "Failed to load " << InRequest->Filename << std::endl;
+		FinalState = EAssetLoadState::Failed;
+	}
+
+	InRequest->State.store(FinalState, std::memory_order_release);
+
+	bool bDestroyAsset = false;
+	if (InRequest->NextLoad != nullptr)
+	{
+		QueueLoad(InRequest->NextLoad);
+		InRequest->NextLoad = nullptr;
+	}
+	else
+	{
+		PendingLoads.erase(Asset);
+		bDestroyAsset = InRequest->bDestroyAssetWhenDone;
+	}
+
+	if (InRequest->Callback != nullptr)
+	{
+		InRequest->Callback(*InRequest);
+	}
+
+	if (bDestroyAsset)
+	{
+		delete Asset;
+	}
+}
+
+FAssetManager::FAssetManager()
+	: NextLoadSequence(0)
+	, MaxUploadsPerFrame(4)
+	, MemoryBudgetMB(0)
+	, EvictionFrameDelay(2)
+	, FrameNumber(0)
+{
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("AssetUploadsPerFrame", MaxUploadsPerFrame);
+		GConfig->Get("AssetMemoryBudgetMB", MemoryBudgetMB);
+		GConfig->Get("MaxConcurrentFrames", EvictionFrameDelay);
+	}
 }
 
 FAssetManager::~FAssetManager()
 {
-	for (const auto& Pair : LiveAssets)
+	// Loads still queued are skipped; the ones already decoding have to finish before their assets can go.
+	for (const auto& Pair : PendingLoads)
+	{
+		Pair.second->Cancel();
+	}
+
+	if (GJobSystem != nullptr)
 	{
-		if (Pair.second != nullptr)
+		GJobSystem->Wait(LoadCounter);
+	}
+
+	UAsset::bPurging = true;
+
+	for (const auto& Pair : PendingLoads)
+	{
+		if (Pair.second->bDestroyAssetWhenDone)
 		{
-			delete Pair.second;
+			delete Pair.first;
 		}
 	}
-}
\ No newline at end of file
+
+	Registry.ForEach([](UAsset* InAsset)
+	{
+		delete InAsset;
+	});
+	Registry.Clear();
+}
@@ -2,17 +2,121 @@
 
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <functional>
 
+#include "Object.h"
 #include "Utils.h"
+#include "JobSystem.h"
+#include "AssetRegistry.h"
 
 class UAsset;
 
+enum class EAssetLoadPriority : uint8_t
+{
+	Low,
+	Normal,
+	High,
+};
+
+enum class EAssetLoadState : uint8_t
+{
+	Queued,
+	Loading,
+	Loaded,
+	Failed,
+	Cancelled,
+};
+
+class FAssetLoadRequest;
+
+using FAssetLoadCallback = std::function<void(const FAssetLoadRequest&)>;
+
+// Progress of one asynchronous load. Loaded, Failed and Cancelled are only entered on the render thread,
+// so once IsDone returns true the asset may be used right away.
+class FAssetLoadRequest
+{
+public:
+	FAssetLoadRequest(UAsset* InAsset, const std::string& InFilename, EAssetLoadPriority InPriority, uint64_t InSequence);
+
+	UAsset* GetAsset() const { return Asset; }
+
+	template <typename T>
+	T* GetAsset() const { return Cast<T>(Asset); }
+
+	const std::string& GetFilename() const { return Filename; }
+
+	EAssetLoadState GetState() const { return State.load(std::memory_order_acquire); }
+	bool IsDone() const { return GetState() >= EAssetLoadState::Loaded; }
+
+	// Only reorders the load while it is still queued.
+	EAssetLoadPriority GetPriority() const { return Priority.load(std::memory_order_relaxed); }
+	void SetPriority(EAssetLoadPriority InPriority) { Priority.store(InPriority, std::memory_order_relaxed); }
+
+	// A queued load never starts; one that is already decoding is unloaded again instead of reaching the GPU.
+	void Cancel() { bCancelRequested.store(true, std::memory_order_release); }
+	bool IsCancelRequested() const { return bCancelRequested.load(std::memory_order_acquire); }
+
+private:
+	friend class FAssetManager;
+
+	UAsset* Asset;
+	std::string Filename;
+	uint64_t Sequence;
+
+	std::atomic<EAssetLoadPriority> Priority;
+	std::atomic<EAssetLoadState> State;
+	std::atomic<bool> bCancelRequested;
+
+	// Written by the worker before the request is handed back to the render thread.
+	bool bDataLoaded;
+
+	// The rest is only touched on the render thread.
+	bool bDestroyAssetWhenDone;
+	FAssetLoadCallback Callback;
+
+	// A later load of the same asset. It is queued once this one is done so an asset is never decoded twice at once.
+	std::shared_ptr<FAssetLoadRequest> NextLoad;
+};
+
+using FAssetLoadHandle = std::shared_ptr<FAssetLoadRequest>;
+
+struct FAssetMemoryStats
+{
+	size_t CPUBytes = 0;
+	size_t GPUBytes = 0;
+	uint32_t NumAssets = 0;
+	uint32_t NumEvicted = 0;
+	// Loading assets are counted but not measured.
+	uint32_t NumLoading = 0;
+};
+
 class FAssetManager
 {
 public:
 	static void Startup();
 	static void Shutdown();
 
+	// Finishes loads whose data is ready: creates their GPU resources and runs their callbacks. Then, if the assets
+	// take more than AssetMemoryBudgetMB, unloads unreferenced ones in least recently released order.
+	// Called once per frame on the render thread.
+	static void Tick();
+
+	static uint64_t GetFrameNumber();
+
+	// Walks every asset, so meant for tools and statistics rather than per-frame use.
+	static FAssetMemoryStats GetMemoryStats();
+
+	// Queues an evicted asset to be loaded again on the next Tick. Safe to call from any thread.
+	static void RequestReload(UAsset* InAsset);
+
+	// CreateAsset and FindAsset may be called from any thread; DestroyAsset and the loading functions only on the render thread.
 	template <typename T = UAsset>
 	static T* CreateAsset(const std::string& InAssetName)
 	{
@@ -21,24 +125,42 @@ public:
 			return nullptr;
 		}
 
-		std::unordered_map<std::string, UAsset*>& LiveAssets = Instance->LiveAssets;
+		uint64_t NameHash = FAssetRegistry::HashName(InAssetName);
 
-		auto Itr = LiveAssets.find(InAssetName);
-		if (Itr != LiveAssets.end())
+		if (UAsset* ExistingAsset = Instance->Registry.Find(NameHash, InAssetName))
 		{
-			return Cast<T>(Itr->second);
+			return Cast<T>(ExistingAsset);
 		}
 
 		T* NewAsset = T::StaticCreateObject();
 		NewAsset->SetName(InAssetName);
 
-		LiveAssets[InAssetName] = NewAsset;
+		// Another thread may have registered the same name since the lookup above.
+		UAsset* RegisteredAsset = Instance->Registry.Add(NameHash, NewAsset);
+		if (RegisteredAsset != NewAsset)
+		{
+			delete NewAsset;
+			return Cast<T>(RegisteredAsset);
+		}
 
 		return NewAsset;
 	}
 
-	static UAsset* FindAsset(const std::string& InAssetName);
-	static void DestroyAsset(const std::string& InAssetName);
+	template <typename T>
+	static FAssetLoadHandle LoadAssetAsync(const std::string& InAssetName, const std::string& InFilename, EAssetLoadPriority InPriority = EAssetLoadPriority::Normal, FAssetLoadCallback InCallback = nullptr)
+	{
+		return LoadAsync(CreateAsset<T>(InAssetName), InFilename, InPriority, std::move(InCallback));
+	}
+
+	// Decodes InFilename on a worker thread and creates the GPU resources on a later Tick. The asset must not be
+	// read or modified until the handle is done. Loading an asset that is already in flight returns the same handle.
+	// InCallback runs on the render thread when the load is done, whatever the outcome.
+	static FAssetLoadHandle LoadAsync(UAsset* InAsset, const std::string& InFilename, EAssetLoadPriority InPriority = EAssetLoadPriority::Normal, FAssetLoadCallback InCallback = nullptr);
+
+	static UAsset* FindAsset(std::string_view InAssetName);
+	// For hot lookups with a name hashed once by FAssetRegistry::HashName.
+	static UAsset* FindAsset(uint64_t InNameHash, std::string_view InAssetName);
+	static void DestroyAsset(std::string_view InAssetName);
 	static void DestroyAsset(UAsset* InAsset);
 
 private:
@@ -47,9 +169,36 @@ private:
 private:
 	FAssetManager();
 
+	void EvictAssets();
+
+	void QueueLoad(const FAssetLoadHandle& InRequest);
+	void ProcessNextLoad();
+	void FinishLoad(const FAssetLoadHandle& InRequest);
+
 public:
 	virtual ~FAssetManager();
 
 private:
-	std::unordered_map<std::string, class UAsset*> LiveAssets;
+	FAssetRegistry Registry;
+
+	// Owned by the render thread. Holds the newest load of every asset that is in flight.
+	std::unordered_map<UAsset*, FAssetLoadHandle> PendingLoads;
+	uint64_t NextLoadSequence;
+	int32_t MaxUploadsPerFrame;
+
+	int32_t MemoryBudgetMB;
+	// Frames that may still be reading the GPU resources of an asset after its last reference went away.
+	int32_t EvictionFrameDelay;
+	std::vector<UAsset*> EvictionCandidates;
+
+	std::atomic<uint64_t> FrameNumber;
+
+	std::mutex ReloadMutex;
+	std::vector<UAsset*> ReloadRequests;
+
+	// Shared with the loader jobs.
+	std::mutex LoadMutex;
+	std::vector<FAssetLoadHandle> QueuedLoads;
+	std::deque<FAssetLoadHandle> DecodedLoads;
+	FJobCounter LoadCounter;
 };
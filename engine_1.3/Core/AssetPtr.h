@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Asset.h"
+
+#include <cstddef>
+#include <utility>
+
+// Counted reference to an asset. Assets without any TAssetPtr to them may be evicted by FAssetManager once it is
+// over its memory budget, and are reloaded in the background when a new reference is taken.
+template <typename T>
+class TAssetPtr
+{
+public:
+	TAssetPtr()
+		: Asset(nullptr)
+	{
+	}
+
+	TAssetPtr(std::nullptr_t)
+		: Asset(nullptr)
+	{
+	}
+
+	template <typename U>
+	TAssetPtr(U* InAsset)
+		: Asset(InAsset)
+	{
+		AddRef();
+	}
+
+	TAssetPtr(const TAssetPtr& InOther)
+		: Asset(InOther.Asset)
+	{
+		AddRef();
+	}
+
+	template <typename U>
+	TAssetPtr(const TAssetPtr<U>& InOther)
+		: Asset(InOther.Get())
+	{
+		AddRef();
+	}
+
+	TAssetPtr(TAssetPtr&& InOther) noexcept
+		: Asset(InOther.Asset)
+	{
+		InOther.Asset = nullptr;
+	}
+
+	~TAssetPtr()
+	{
+		Release();
+	}
+
+	TAssetPtr& operator=(const TAssetPtr& InOther)
+	{
+		TAssetPtr(InOther).Swap(*this);
+		return *this;
+	}
+
+	TAssetPtr& operator=(TAssetPtr&& InOther) noexcept
+	{
+		TAssetPtr(std::move(InOther)).Swap(*this);
+		return *this;
+	}
+
+	T* Get() const { return Asset; }
+	T* operator->() const { return Asset; }
+	T& operator*() const { return *Asset; }
+	operator T*() const { return Asset; }
+
+	void Swap(TAssetPtr& InOther) noexcept { std::swap(Asset, InOther.Asset); }
+
+private:
+	void AddRef()
+	{
+		if (Asset != nullptr)
+		{
+			static_cast<UAsset*>(Asset)->AddRef();
+		}
+	}
+
+	void Release()
+	{
+		// Assets are deleted in no particular order at shutdown, so the one referenced here may already be gone.
+		if (Asset != nullptr && UAsset::IsPurging() == false)
+		{
+			static_cast<UAsset*>(Asset)->Release();
+		}
+	}
+
+	T* Asset;
+};
@@ -0,0 +1,80 @@
+#include "AssetRegistry.h"
+#include "Asset.h"
+
+#include <mutex>
+
+UAsset* FAssetRegistry::Find(uint64_t InNameHash, std::string_view InName) const
+{
+	const FShard& Shard = GetShard(InNameHash);
+	std::shared_lock<std::shared_mutex> Lock(Shard.Mutex);
+
+	auto Range = Shard.Assets.equal_range(InNameHash);
+	for (auto Itr = Range.first; Itr != Range.second; ++Itr)
+	{
+		if (Itr->second->GetName() == InName)
+		{
+			return Itr->second;
+		}
+	}
+
+	return nullptr;
+}
+
+UAsset* FAssetRegistry::Add(uint64_t InNameHash, UAsset* InAsset)
+{
+	FShard& Shard = GetShard(InNameHash);
+	std::unique_lock<std::shared_mutex> Lock(Shard.Mutex);
+
+	auto Range = Shard.Assets.equal_range(InNameHash);
+	for (auto Itr = Range.first; Itr != Range.second; ++Itr)
+	{
+		if (Itr->second->GetName() == InAsset->GetName())
+		{
+			return Itr->second;
+		}
+	}
+
+	Shard.Assets.insert({ InNameHash, InAsset });
+
+	return InAsset;
+}
+
+UAsset* FAssetRegistry::Remove(uint64_t InNameHash, std::string_view InName)
+{
+	FShard& Shard = GetShard(InNameHash);
+	std::unique_lock<std::shared_mutex> Lock(Shard.Mutex);
+
+	auto Range = Shard.Assets.equal_range(InNameHash);
+	for (auto Itr = Range.first; Itr != Range.second; ++Itr)
+	{
+		if (Itr->second->GetName() == InName)
+		{
+			UAsset* Asset = Itr->second;
+			Shard.Assets.erase(Itr);
+			return Asset;
+		}
+	}
+
+	return nullptr;
+}
+
+void FAssetRegistry::ForEach(const std::function<void(UAsset*)>& InFunction) const
+{
+	for (const FShard& Shard : Shards)
+	{
+		std::shared_lock<std::shared_mutex> Lock(Shard.Mutex);
+		for (const auto& Pair : Shard.Assets)
+		{
+			InFunction(Pair.second);
+		}
+	}
+}
+
+void FAssetRegistry::Clear()
+{
+	for (FShard& Shard : Shards)
+	{
+		std::unique_lock<std::shared_mutex> Lock(Shard.Mutex);
+		Shard.Assets.clear();
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Utils.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdint>
+
+class UAsset;
+
+// Name to asset map that loader threads can read while the render thread creates and destroys assets.
+// Names are hashed once up front: the hash picks one of a fixed set of shards and is the key inside it, so a
+// lookup takes a shared lock on a single shard, allocates nothing and only compares names on a hash match.
+class FAssetRegistry
+{
+public:
+	static uint64_t HashName(std::string_view InName) { return HashBytes(InName.data(), InName.size()); }
+
+	UAsset* Find(std::string_view InName) const { return Find(HashName(InName), InName); }
+	UAsset* Find(uint64_t InNameHash, std::string_view InName) const;
+
+	// Registers InAsset under its name unless another asset already holds it. Returns whichever asset is registered.
+	UAsset* Add(uint64_t InNameHash, UAsset* InAsset);
+
+	// Unregisters the asset with the given name and returns it, or nullptr if there was none.
+	UAsset* Remove(uint64_t InNameHash, std::string_view InName);
+
+	// Visits every asset with its shard locked. InFunction must not call back into the registry.
+	void ForEach(const std::function<void(UAsset*)>& InFunction) const;
+
+	void Clear();
+
+private:
+	static constexpr uint32_t NumShards = 16;
+
+	// The key already is a hash, so the buckets use it directly.
+	struct FIdentityHash
+	{
+		size_t operator()(uint64_t InHash) const { return static_cast<size_t>(InHash); }
+	};
+
+	struct FShard
+	{
+		mutable std::shared_mutex Mutex;
+		std::unordered_multimap<uint64_t, UAsset*, FIdentityHash> Assets;
+	};
+
+	// The shard comes from the high bits so it does not correlate with the bucket the low bits select.
+	FShard& GetShard(uint64_t InNameHash) { return Shards[(InNameHash >> 48) % NumShards]; }
+	const FShard& GetShard(uint64_t InNameHash) const { return Shards[(InNameHash >> 48) % NumShards]; }
+
+	std::array<FShard, NumShards> Shards;
+};
@@ -0,0 +1,167 @@
+#include "FileSystem.h"
+#include "Config.h"
+
+#include <fstream>
+#include <algorithm>
+#include <mutex>
+
+FFileSystem* GFileSystem;
+
+static std::string NormalizeSlashes(const std::string& InPath)
+{
+	std::string Path = InPath;
+	std::replace(Path.begin(), Path.end(), '\\', '/');
+	return Path;
+}
+
+FFileView::FFileView()
+	: Data(nullptr)
+	, Size(0)
+	, bOpen(false)
+{
+}
+
+bool FFileView::Open(const std::string& InFilename)
+{
+	Close();
+
+	const FPakFile* Pak;
+	const FPakEntry* Entry;
+
+	if (GFileSystem != nullptr && GFileSystem->FindEntry(InFilename, Pak, Entry))
+	{
+		if (Entry->Compression == EPakCompression::None)
+		{
+			Data = Pak->GetEntryData(*Entry);
+		}
+		else
+		{
+			Buffer.resize(static_cast<size_t>(Entry->UncompressedSize));
+			if (Pak->ReadEntry(*Entry, Buffer.data()) == false)
+			{
+				Close();
+				return false;
+			}
+
+			Data = Buffer.data();
+		}
+
+		Size = static_cast<size_t>(Entry->UncompressedSize);
+		bOpen = true;
+
+		return true;
+	}
+
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	Data = File.GetData();
+	Size = File.GetSize();
+	bOpen = true;
+
+	return true;
+}
+
+void FFileView::Close()
+{
+	File.Close();
+	Buffer.clear();
+	Buffer.shrink_to_fit();
+
+	Data = nullptr;
+	Size = 0;
+	bOpen = false;
+}
+
+void FFileSystem::Startup()
+{
+	GFileSystem = new FFileSystem();
+
+	std::vector<std::string> PakFiles;
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("PakFiles", PakFiles);
+	}
+
+	for (const std::string& PakFile : PakFiles)
+	{
+		GFileSystem->Mount(PakFile);
+	}
+}
+
+void FFileSystem::Shutdown()
+{
+	delete GFileSystem;
+	GFileSystem = nullptr;
+}
+
+bool FFileSystem::Mount(const std::string& InPakFilename, const std::string& InMountPoint)
+{
+	std::unique_ptr<FPakFile> Pak = std::make_unique<FPakFile>();
+	if (Pak->Open(InPakFilename) == false)
+	{
+		return false;
+	}
+
+	std::string MountPoint = NormalizeSlashes(InMountPoint);
+	if (MountPoint.empty())
+	{
+		MountPoint = NormalizeSlashes(InPakFilename);
+
+		size_t Extension = MountPoint.find_last_of("./");
+		if (Extension != std::string::npos && MountPoint[Extension] == '.')
+		{
+			MountPoint.resize(Extension);
+		}
+	}
+
+	if (MountPoint.empty() == false && MountPoint.back() != '/')
+	{
+		MountPoint += '/';
+	}
+
+	std::unique_lock<std::shared_mutex> Lock(Mutex);
+	Mounts.push_back({ std::move(MountPoint), std::move(Pak) });
+
+	return true;
+}
+
+bool FFileSystem::FindEntry(const std::string& InFilename, const FPakFile*& OutPak, const FPakEntry*& OutEntry) const
+{
+	std::string Filename = NormalizeSlashes(InFilename);
+
+	std::shared_lock<std::shared_mutex> Lock(Mutex);
+
+	for (auto It = Mounts.rbegin(); It != Mounts.rend(); ++It)
+	{
+		if (Filename.compare(0, It->MountPoint.size(), It->MountPoint) != 0)
+		{
+			continue;
+		}
+
+		std::string RelativePath = FPakFile::NormalizePath(std::string_view(Filename).substr(It->MountPoint.size()));
+		if (const FPakEntry* Entry = It->Pak->FindEntry(RelativePath))
+		{
+			OutPak = It->Pak.get();
+			OutEntry = Entry;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FFileSystem::Exists(const std::string& InFilename) const
+{
+	const FPakFile* Pak;
+	const FPakEntry* Entry;
+	if (FindEntry(InFilename, Pak, Entry))
+	{
+		return true;
+	}
+
+	std::ifstream File(InFilename, std::ios::binary);
+	return File.is_open();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PakFile.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+#include <cstdint>
+
+// Read-only view of a whole file resolved through GFileSystem. Stored pak entries are viewed in place, compressed
+// ones are decompressed into the view, and loose files are mapped.
+class FFileView
+{
+public:
+	FFileView();
+
+	FFileView(const FFileView&) = delete;
+	FFileView& operator=(const FFileView&) = delete;
+
+	bool Open(const std::string& InFilename);
+	void Close();
+
+	bool IsOpen() const { return bOpen; }
+
+	const uint8_t* GetData() const { return Data; }
+	size_t GetSize() const { return Size; }
+
+private:
+	FMappedFile File;
+	std::vector<uint8_t> Buffer;
+	const uint8_t* Data;
+	size_t Size;
+	bool bOpen;
+};
+
+// Virtual file system over mounted pak files. A path under a mount point is looked up in that pak, the most recently
+// mounted first, and falls back to the loose file on disk. Paks stay mounted until Shutdown.
+class FFileSystem
+{
+public:
+	// Mounts every pak listed in the PakFiles config. Paks that do not exist are skipped.
+	static void Startup();
+	static void Shutdown();
+
+	// InMountPoint defaults to the pak path without its extension, so "Data/Resources.pak" serves "Data/Resources/".
+	bool Mount(const std::string& InPakFilename, const std::string& InMountPoint = "");
+
+	// Finds the pak entry that serves InFilename. The pak outlives every lookup.
+	bool FindEntry(const std::string& InFilename, const FPakFile*& OutPak, const FPakEntry*& OutEntry) const;
+
+	bool Exists(const std::string& InFilename) const;
+
+private:
+	struct FMount
+	{
+		std::string MountPoint;
+		std::unique_ptr<FPakFile> Pak;
+	};
+
+	mutable std::shared_mutex Mutex;
+	std::vector<FMount> Mounts;
+};
+
+extern FFileSystem* GFileSystem;
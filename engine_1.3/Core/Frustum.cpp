@@ -0,0 +1,177 @@
+#include "Frustum.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define FRUSTUM_USE_SSE 1
+#include <xmmintrin.h>
+#else
+#define FRUSTUM_USE_SSE 0
+#endif
+
+FBoundingSphere::FBoundingSphere()
+	: Center(0.0f)
+	, Radius(0.0f)
+{
+}
+
+FBoundingSphere::FBoundingSphere(const glm::vec3& InCenter, float InRadius)
+	: Center(InCenter)
+	, Radius(InRadius)
+{
+}
+
+FBoundingSphere FBoundingSphere::FromVertices(const std::vector<FVertex>& InVertices)
+{
+	return FromVertices(InVertices.data(), InVertices.size());
+}
+
+FBoundingSphere FBoundingSphere::FromVertices(const FVertex* InVertices, size_t InNumVertices)
+{
+	if (InNumVertices == 0)
+	{
+		return FBoundingSphere();
+	}
+
+	glm::vec3 Min(FLT_MAX);
+	glm::vec3 Max(-FLT_MAX);
+
+	for (size_t Idx = 0; Idx < InNumVertices; ++Idx)
+	{
+		Min = glm::min(Min, InVertices[Idx].Position);
+		Max = glm::max(Max, InVertices[Idx].Position);
+	}
+
+	glm::vec3 Center = (Min + Max) * 0.5f;
+
+	float RadiusSquared = 0.0f;
+	for (size_t Idx = 0; Idx < InNumVertices; ++Idx)
+	{
+		glm::vec3 Delta = InVertices[Idx].Position - Center;
+		RadiusSquared = std::max(RadiusSquared, glm::dot(Delta, Delta));
+	}
+
+	return FBoundingSphere(Center, std::sqrt(RadiusSquared));
+}
+
+FBoundingSphere FBoundingSphere::TransformBy(const glm::mat4& InMatrix) const
+{
+	glm::vec3 NewCenter = glm::vec3(InMatrix * glm::vec4(Center, 1.0f));
+
+	float MaxScaleSquared = std::max(
+		glm::dot(glm::vec3(InMatrix[0]), glm::vec3(InMatrix[0])),
+		std::max(
+			glm::dot(glm::vec3(InMatrix[1]), glm::vec3(InMatrix[1])),
+			glm::dot(glm::vec3(InMatrix[2]), glm::vec3(InMatrix[2]))));
+
+	return FBoundingSphere(NewCenter, Radius * std::sqrt(MaxScaleSquared));
+}
+
+FFrustum::FFrustum()
+{
+	Planes.fill(glm::vec4(0.0f, 0.0f, 0.0f, FLT_MAX));
+}
+
+FFrustum FFrustum::FromMatrix(const glm::mat4& InViewProjection)
+{
+	glm::vec4 Row0(InViewProjection[0][0], InViewProjection[1][0], InViewProjection[2][0], InViewProjection[3][0]);
+	glm::vec4 Row1(InViewProjection[0][1], InViewProjection[1][1], InViewProjection[2][1], InViewProjection[3][1]);
+	glm::vec4 Row2(InViewProjection[0][2], InViewProjection[1][2], InViewProjection[2][2], InViewProjection[3][2]);
+	glm::vec4 Row3(InViewProjection[0][3], InViewProjection[1][3], InViewProjection[2][3], InViewProjection[3][3]);
+
+	FFrustum Frustum;
+	Frustum.Planes[Left] = Row3 + Row0;
+	Frustum.Planes[Right] = Row3 - Row0;
+	Frustum.Planes[Bottom] = Row3 + Row1;
+	Frustum.Planes[Top] = Row3 - Row1;
+	Frustum.Planes[Near] = Row2;
+	Frustum.Planes[Far] = Row3 - Row2;
+
+	for (glm::vec4& Plane : Frustum.Planes)
+	{
+		float Length = glm::length(glm::vec3(Plane));
+		if (Length > FLT_EPSILON)
+		{
+			Plane /= Length;
+		}
+	}
+
+	return Frustum;
+}
+
+bool FFrustum::Intersects(const FBoundingSphere& InSphere) const
+{
+	for (const glm::vec4& Plane : Planes)
+	{
+		if (glm::dot(glm::vec3(Plane), InSphere.Center) + Plane.w < -InSphere.Radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t FFrustum::CullSpheres(const FBoundingSphere* InSpheres, uint32_t InNumSpheres, uint32_t* OutVisibleIndices) const
+{
+	uint32_t NumVisible = 0;
+	uint32_t Idx = 0;
+
+#if FRUSTUM_USE_SSE
+	__m128 PlaneX[NumPlanes];
+	__m128 PlaneY[NumPlanes];
+	__m128 PlaneZ[NumPlanes];
+	__m128 PlaneW[NumPlanes];
+
+	for (int PlaneIdx = 0; PlaneIdx < NumPlanes; ++PlaneIdx)
+	{
+		PlaneX[PlaneIdx] = _mm_set1_ps(Planes[PlaneIdx].x);
+		PlaneY[PlaneIdx] = _mm_set1_ps(Planes[PlaneIdx].y);
+		PlaneZ[PlaneIdx] = _mm_set1_ps(Planes[PlaneIdx].z);
+		PlaneW[PlaneIdx] = _mm_set1_ps(Planes[PlaneIdx].w);
+	}
+
+	const __m128 Zero = _mm_setzero_ps();
+
+	for (; Idx + 4 <= InNumSpheres; Idx += 4)
+	{
+		__m128 X = _mm_loadu_ps(&InSpheres[Idx + 0].Center.x);
+		__m128 Y = _mm_loadu_ps(&InSpheres[Idx + 1].Center.x);
+		__m128 Z = _mm_loadu_ps(&InSpheres[Idx + 2].Center.x);
+		__m128 R = _mm_loadu_ps(&InSpheres[Idx + 3].Center.x);
+		_MM_TRANSPOSE4_PS(X, Y, Z, R);
+
+		__m128 NegativeRadius = _mm_sub_ps(Zero, R);
+		__m128 Inside = _mm_cmpeq_ps(Zero, Zero);
+
+		for (int PlaneIdx = 0; PlaneIdx < NumPlanes; ++PlaneIdx)
+		{
+			__m128 Distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(PlaneX[PlaneIdx], X), _mm_mul_ps(PlaneY[PlaneIdx], Y)),
+				_mm_add_ps(_mm_mul_ps(PlaneZ[PlaneIdx], Z), PlaneW[PlaneIdx]));
+
+			Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Distance, NegativeRadius));
+		}
+
+		int Mask = _mm_movemask_ps(Inside);
+		for (uint32_t Lane = 0; Lane < 4; ++Lane)
+		{
+			if (Mask & (1 << Lane))
+			{
+				OutVisibleIndices[NumVisible++] = Idx + Lane;
+			}
+		}
+	}
+#endif
+
+	for (; Idx < InNumSpheres; ++Idx)
+	{
+		if (Intersects(InSpheres[Idx]))
+		{
+			OutVisibleIndices[NumVisible++] = Idx;
+		}
+	}
+
+	return NumVisible;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+struct alignas(16) FBoundingSphere
+{
+public:
+	FBoundingSphere();
+	FBoundingSphere(const glm::vec3& InCenter, float InRadius);
+
+	static FBoundingSphere FromVertices(const std::vector<FVertex>& InVertices);
+	static FBoundingSphere FromVertices(const FVertex* InVertices, size_t InNumVertices);
+
+	FBoundingSphere TransformBy(const glm::mat4& InMatrix) const;
+
+	glm::vec3 Center;
+	float Radius;
+};
+
+static_assert(sizeof(FBoundingSphere) == sizeof(glm::vec4), "FBoundingSphere must be tightly packed for SIMD loads.");
+
+class FFrustum
+{
+public:
+	enum EPlane
+	{
+		Left,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+		NumPlanes
+	};
+
+	FFrustum();
+
+	// Extracts the planes from a combined projection * view matrix. Planes point inward and are normalized.
+	static FFrustum FromMatrix(const glm::mat4& InViewProjection);
+
+	const std::array<glm::vec4, NumPlanes>& GetPlanes() const { return Planes; }
+
+	bool Intersects(const FBoundingSphere& InSphere) const;
+
+	// Writes the indices of the spheres that intersect the frustum into OutVisibleIndices
+	// and returns how many were written. OutVisibleIndices must hold at least InNumSpheres entries.
+	uint32_t CullSpheres(const FBoundingSphere* InSpheres, uint32_t InNumSpheres, uint32_t* OutVisibleIndices) const;
+
+private:
+	std::array<glm::vec4, NumPlanes> Planes;
+};
@@ -0,0 +1,1164 @@
+#include "GLTFImporter.h"
+
+#include "AssetManager.h"
+#include "Texture2D.h"
+
+#include "glm/gtc/type_ptr.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <cctype>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define GLTF_IMPORTER_USE_SSE 1
+#include <emmintrin.h>
+#else
+#define GLTF_IMPORTER_USE_SSE 0
+#endif
+
+static constexpr uint32_t GLBMagic = 0x46546c67; // "glTF"
+static constexpr uint32_t GLBVersion = 2;
+static constexpr uint32_t GLBChunkJSON = 0x4e4f534a; // "JSON"
+static constexpr uint32_t GLBChunkBIN = 0x004e4942; // "BIN\0"
+
+enum EGLTFComponentType : uint32_t
+{
+	GLTFByte = 5120,
+	GLTFUnsignedByte = 5121,
+	GLTFShort = 5122,
+	GLTFUnsignedShort = 5123,
+	GLTFUnsignedInt = 5125,
+	GLTFFloat = 5126,
+};
+
+enum EGLTFPrimitiveMode : int64_t
+{
+	GLTFTriangles = 4,
+	GLTFTriangleStrip = 5,
+	GLTFTriangleFan = 6,
+};
+
+static uint32_t GetComponentSize(uint32_t InComponentType)
+{
+	switch (InComponentType)
+	{
+	case GLTFByte:
+	case GLTFUnsignedByte:
+		return 1;
+	case GLTFShort:
+	case GLTFUnsignedShort:
+		return 2;
+	case GLTFUnsignedInt:
+	case GLTFFloat:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static uint32_t GetNumComponents(const std::string& InType)
+{
+	if (InType == "SCALAR") return 1;
+	if (InType == "VEC2") return 2;
+	if (InType == "VEC3") return 3;
+	if (InType == "VEC4") return 4;
+	// Matrices are never vertex attributes or indices.
+	return 0;
+}
+
+static uint32_t ReadUInt32(const uint8_t* InData)
+{
+	uint32_t Value;
+	memcpy(&Value, InData, sizeof(Value));
+	return Value;
+}
+
+static std::string GetDirectory(const std::string& InFilename)
+{
+	size_t Separator = InFilename.find_last_of("/\\");
+	return Separator != std::string::npos ? InFilename.substr(0, Separator + 1) : std::string();
+}
+
+static bool IsDataURI(const std::string& InURI)
+{
+	return InURI.compare(0, 5, "data:") == 0;
+}
+
+// URIs in glTF are percent-encoded, e.g. spaces in file names are written as %20.
+static std::string DecodeURI(const std::string& InURI)
+{
+	std::string Decoded;
+	Decoded.reserve(InURI.size());
+
+	for (size_t Idx = 0; Idx < InURI.size(); ++Idx)
+	{
+		if (InURI[Idx] == '%' && Idx + 2 < InURI.size() && isxdigit(static_cast<unsigned char>(InURI[Idx + 1])) && isxdigit(static_cast<unsigned char>(InURI[Idx + 2])))
+		{
+			Decoded += static_cast<char>(std::stoi(InURI.substr(Idx + 1, 2), nullptr, 16));
+			Idx += 2;
+		}
+		else
+		{
+			Decoded += InURI[Idx];
+		}
+	}
+
+	return Decoded;
+}
+
+static bool DecodeBase64(const char* InData, size_t InSize, std::vector<uint8_t>& OutBytes)
+{
+	auto DecodeChar = [](char InChar) -> int32_t
+	{
+		if (InChar >= 'A' && InChar <= 'Z') return InChar - 'A';
+		if (InChar >= 'a' && InChar <= 'z') return InChar - 'a' + 26;
+		if (InChar >= '0' && InChar <= '9') return InChar - '0' + 52;
+		if (InChar == '+') return 62;
+		if (InChar == '/') return 63;
+		return -1;
+	};
+
+	while (InSize > 0 && InData[InSize - 1] == '=')
+	{
+		--InSize;
+	}
+
+	OutBytes.clear();
+	OutBytes.reserve(InSize * 3 / 4);
+
+	uint32_t Bits = 0;
+	uint32_t NumBits = 0;
+
+	for (size_t Idx = 0; Idx < InSize; ++Idx)
+	{
+		int32_t Value = DecodeChar(InData[Idx]);
+		if (Value < 0)
+		{
+			return false;
+		}
+
+		Bits = (Bits << 6) | static_cast<uint32_t>(Value);
+		NumBits += 6;
+
+		if (NumBits >= 8)
+		{
+			NumBits -= 8;
+			OutBytes.push_back(static_cast<uint8_t>(Bits >> NumBits));
+		}
+	}
+
+	return true;
+}
+
+#if GLTF_IMPORTER_USE_SSE
+static __m128 LoadElementSSE(const uint8_t* InData, uint32_t InComponentType, uint32_t InNumComponents, bool bInNormalized)
+{
+	const __m128i Zero = _mm_setzero_si128();
+
+	switch (InComponentType)
+	{
+	case GLTFUnsignedByte:
+	{
+		uint32_t Packed = 0;
+		memcpy(&Packed, InData, InNumComponents);
+		__m128i Ints = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int32_t>(Packed)), Zero), Zero);
+		__m128 Floats = _mm_cvtepi32_ps(Ints);
+		return bInNormalized ? _mm_mul_ps(Floats, _mm_set1_ps(1.0f / 255.0f)) : Floats;
+	}
+	case GLTFByte:
+	{
+		uint32_t Packed = 0;
+		memcpy(&Packed, InData, InNumComponents);
+		// Replicating each byte into the top of its lane lets the arithmetic shift sign extend it.
+		__m128i Bytes = _mm_cvtsi32_si128(static_cast<int32_t>(Packed));
+		Bytes = _mm_unpacklo_epi8(Bytes, Bytes);
+		__m128i Ints = _mm_srai_epi32(_mm_unpacklo_epi16(Bytes, Bytes), 24);
+		__m128 Floats = _mm_cvtepi32_ps(Ints);
+		return bInNormalized ? _mm_max_ps(_mm_mul_ps(Floats, _mm_set1_ps(1.0f / 127.0f)), _mm_set1_ps(-1.0f)) : Floats;
+	}
+	case GLTFUnsignedShort:
+	{
+		uint64_t Packed = 0;
+		memcpy(&Packed, InData, InNumComponents * sizeof(uint16_t));
+		__m128i Ints = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Packed)), Zero);
+		__m128 Floats = _mm_cvtepi32_ps(Ints);
+		return bInNormalized ? _mm_mul_ps(Floats, _mm_set1_ps(1.0f / 65535.0f)) : Floats;
+	}
+	default:
+	{
+		uint64_t Packed = 0;
+		memcpy(&Packed, InData, InNumComponents * sizeof(int16_t));
+		__m128i Shorts = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Packed));
+		__m128i Ints = _mm_srai_epi32(_mm_unpacklo_epi16(Shorts, Shorts), 16);
+		__m128 Floats = _mm_cvtepi32_ps(Ints);
+		return bInNormalized ? _mm_max_ps(_mm_mul_ps(Floats, _mm_set1_ps(1.0f / 32767.0f)), _mm_set1_ps(-1.0f)) : Floats;
+	}
+	}
+}
+#endif
+
+// Widens one element of up to four components to floats with the normalization rules of glTF: unsigned values map
+// to [0, 1] and signed values to [-1, 1], with the most negative value clamped. Writes all four values.
+static void LoadElement(const uint8_t* InData, uint32_t InComponentType, uint32_t InNumComponents, bool bInNormalized, float* OutValues)
+{
+	OutValues[0] = OutValues[1] = OutValues[2] = OutValues[3] = 0.0f;
+
+	if (InComponentType == GLTFFloat)
+	{
+		memcpy(OutValues, InData, InNumComponents * sizeof(float));
+		return;
+	}
+
+	if (InComponentType == GLTFUnsignedInt)
+	{
+		for (uint32_t Idx = 0; Idx < InNumComponents; ++Idx)
+		{
+			uint32_t Value;
+			memcpy(&Value, InData + Idx * sizeof(uint32_t), sizeof(Value));
+			OutValues[Idx] = static_cast<float>(Value);
+		}
+		return;
+	}
+
+#if GLTF_IMPORTER_USE_SSE
+	_mm_storeu_ps(OutValues, LoadElementSSE(InData, InComponentType, InNumComponents, bInNormalized));
+#else
+	for (uint32_t Idx = 0; Idx < InNumComponents; ++Idx)
+	{
+		switch (InComponentType)
+		{
+		case GLTFUnsignedByte:
+			OutValues[Idx] = bInNormalized ? InData[Idx] / 255.0f : InData[Idx];
+			break;
+		case GLTFByte:
+		{
+			float Value = static_cast<int8_t>(InData[Idx]);
+			OutValues[Idx] = bInNormalized ? std::max(Value / 127.0f, -1.0f) : Value;
+			break;
+		}
+		case GLTFUnsignedShort:
+		{
+			uint16_t Value;
+			memcpy(&Value, InData + Idx * sizeof(uint16_t), sizeof(Value));
+			OutValues[Idx] = bInNormalized ? Value / 65535.0f : Value;
+			break;
+		}
+		case GLTFShort:
+		{
+			int16_t Value;
+			memcpy(&Value, InData + Idx * sizeof(int16_t), sizeof(Value));
+			OutValues[Idx] = bInNormalized ? std::max(Value / 32767.0f, -1.0f) : Value;
+			break;
+		}
+		}
+	}
+#endif
+}
+
+// Widens InCount indices of InComponentType from a tightly packed array.
+static void WidenIndices(const uint8_t* InData, uint32_t InComponentType, size_t InCount, uint32_t* OutIndices)
+{
+	switch (InComponentType)
+	{
+	case GLTFUnsignedInt:
+		memcpy(OutIndices, InData, InCount * sizeof(uint32_t));
+		break;
+	case GLTFUnsignedShort:
+	{
+		size_t Idx = 0;
+
+#if GLTF_IMPORTER_USE_SSE
+		const __m128i Zero = _mm_setzero_si128();
+
+		for (; Idx + 8 <= InCount; Idx += 8)
+		{
+			__m128i Shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InData + Idx * sizeof(uint16_t)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(OutIndices + Idx), _mm_unpacklo_epi16(Shorts, Zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(OutIndices + Idx + 4), _mm_unpackhi_epi16(Shorts, Zero));
+		}
+#endif
+
+		for (; Idx < InCount; ++Idx)
+		{
+			uint16_t Index;
+			memcpy(&Index, InData + Idx * sizeof(uint16_t), sizeof(Index));
+			OutIndices[Idx] = Index;
+		}
+		break;
+	}
+	case GLTFUnsignedByte:
+		for (size_t Idx = 0; Idx < InCount; ++Idx)
+		{
+			OutIndices[Idx] = InData[Idx];
+		}
+		break;
+	}
+}
+
+static glm::mat4 GetNodeTransform(const FJsonValue& InNode)
+{
+	const FJsonValue& Matrix = InNode["matrix"];
+	if (Matrix.GetSize() == 16)
+	{
+		// Column-major, like glm.
+		float Values[16];
+		for (size_t Idx = 0; Idx < 16; ++Idx)
+		{
+			Values[Idx] = static_cast<float>(Matrix[Idx].GetNumber());
+		}
+
+		return glm::make_mat4(Values);
+	}
+
+	glm::vec3 Translation(0.0f);
+	glm::quat Rotation(1.0f, 0.0f, 0.0f, 0.0f);
+	glm::vec3 Scale(1.0f);
+
+	const FJsonValue& TranslationValue = InNode["translation"];
+	if (TranslationValue.GetSize() == 3)
+	{
+		Translation = glm::vec3(TranslationValue[0].GetNumber(), TranslationValue[1].GetNumber(), TranslationValue[2].GetNumber());
+	}
+
+	// Stored as x, y, z, w.
+	const FJsonValue& RotationValue = InNode["rotation"];
+	if (RotationValue.GetSize() == 4)
+	{
+		Rotation = glm::quat(
+			static_cast<float>(RotationValue[3].GetNumber()),
+			static_cast<float>(RotationValue[0].GetNumber()),
+			static_cast<float>(RotationValue[1].GetNumber()),
+			static_cast<float>(RotationValue[2].GetNumber()));
+	}
+
+	const FJsonValue& ScaleValue = InNode["scale"];
+	if (ScaleValue.GetSize() == 3)
+	{
+		Scale = glm::vec3(ScaleValue[0].GetNumber(), ScaleValue[1].GetNumber(), ScaleValue[2].GetNumber());
+	}
+
+	return glm::translate(glm::mat4(1.0f), Translation) * glm::mat4_cast(Rotation) * glm::scale(glm::mat4(1.0f), Scale);
+}
+
+bool FGLTFImporter::IsGLTFFile(const std::string& InFilename)
+{
+	size_t Dot = InFilename.find_last_of('.');
+	if (Dot == std::string::npos)
+	{
+		return false;
+	}
+
+	std::string Extension = InFilename.substr(Dot);
+	std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](unsigned char InChar) { return static_cast<char>(tolower(InChar)); });
+
+	return Extension == ".gltf" || Extension == ".glb";
+}
+
+bool FGLTFImporter::GetBufferURIs(const std::string& InFilename, std::vector<std::string>& OutURIs)
+{
+	OutURIs.clear();
+
+	FFileView SourceFile;
+	if (SourceFile.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	FJsonValue SourceDocument;
+	FBuffer BinaryChunk;
+	if (ParseDocument(SourceFile.GetData(), SourceFile.GetSize(), SourceDocument, BinaryChunk) == false)
+	{
+		return false;
+	}
+
+	const FJsonValue& BufferValues = SourceDocument["buffers"];
+	for (size_t Idx = 0; Idx < BufferValues.GetSize(); ++Idx)
+	{
+		const std::string& URI = BufferValues[Idx]["uri"].GetString();
+		if (URI.empty() == false && IsDataURI(URI) == false)
+		{
+			OutURIs.push_back(DecodeURI(URI));
+		}
+	}
+
+	return true;
+}
+
+FGLTFImporter::FGLTFImporter()
+{
+}
+
+bool FGLTFImporter::ParseDocument(const uint8_t* InData, size_t InSize, FJsonValue& OutDocument, FBuffer& OutBinaryChunk)
+{
+	OutBinaryChunk = FBuffer();
+
+	if (InSize >= 12 && ReadUInt32(InData) == GLBMagic)
+	{
+		if (ReadUInt32(InData + 4) != GLBVersion)
+		{
+			return false;
+		}
+
+		size_t Length = std::min<size_t>(ReadUInt32(InData + 8), InSize);
+		size_t Offset = 12;
+
+		const uint8_t* JSONData = nullptr;
+		size_t JSONSize = 0;
+
+		while (Offset + 8 <= Length)
+		{
+			size_t ChunkLength = ReadUInt32(InData + Offset);
+			uint32_t ChunkType = ReadUInt32(InData + Offset + 4);
+			Offset += 8;
+
+			if (ChunkLength > Length - Offset)
+			{
+				return false;
+			}
+
+			// The JSON chunk comes first and at most one binary chunk follows it; others are extensions.
+			if (ChunkType == GLBChunkJSON && JSONData == nullptr)
+			{
+				JSONData = InData + Offset;
+				JSONSize = ChunkLength;
+			}
+			else if (ChunkType == GLBChunkBIN && OutBinaryChunk.Data == nullptr)
+			{
+				OutBinaryChunk.Data = InData + Offset;
+				OutBinaryChunk.Size = ChunkLength;
+			}
+
+			Offset += (ChunkLength + 3) & ~static_cast<size_t>(3);
+		}
+
+		return JSONData != nullptr && FJsonValue::Parse(reinterpret_cast<const char*>(JSONData), JSONSize, OutDocument) && OutDocument.IsObject();
+	}
+
+	// A .gltf may start with a byte order mark.
+	if (InSize >= 3 && InData[0] == 0xef && InData[1] == 0xbb && InData[2] == 0xbf)
+	{
+		InData += 3;
+		InSize -= 3;
+	}
+
+	return FJsonValue::Parse(reinterpret_cast<const char*>(InData), InSize, OutDocument) && OutDocument.IsObject();
+}
+
+bool FGLTFImporter::Open(const std::string& InFilename)
+{
+	Close();
+
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	FBuffer BinaryChunk;
+	if (ParseDocument(File.GetData(), File.GetSize(), Document, BinaryChunk) == false)
+	{
+		Close();
+		return false;
+	}
+
+	Directory = GetDirectory(InFilename);
+
+	if (LoadBuffers(BinaryChunk) == false)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FGLTFImporter::Close()
+{
+	Buffers.clear();
+	BufferFiles.clear();
+	EmbeddedBuffers.clear();
+	Document = FJsonValue();
+	Directory.clear();
+	File.Close();
+}
+
+bool FGLTFImporter::LoadBuffers(const FBuffer& InBinaryChunk)
+{
+	const FJsonValue& BufferValues = Document["buffers"];
+
+	Buffers.resize(BufferValues.GetSize());
+
+	for (size_t Idx = 0; Idx < BufferValues.GetSize(); ++Idx)
+	{
+		const FJsonValue& BufferValue = BufferValues[Idx];
+		const std::string& URI = BufferValue["uri"].GetString();
+
+		int64_t ByteLength = BufferValue["byteLength"].GetInt(-1);
+		if (ByteLength < 0)
+		{
+			return false;
+		}
+
+		FBuffer Buffer;
+
+		if (URI.empty())
+		{
+			// Only the first buffer of a .glb may live in its binary chunk.
+			if (Idx != 0 || InBinaryChunk.Data == nullptr)
+			{
+				return false;
+			}
+
+			Buffer = InBinaryChunk;
+		}
+		else if (IsDataURI(URI))
+		{
+			size_t Comma = URI.find(',');
+			if (Comma == std::string::npos || Comma < 7 || URI.compare(Comma - 7, 7, ";base64") != 0)
+			{
+				return false;
+			}
+
+			EmbeddedBuffers.emplace_back();
+			if (DecodeBase64(URI.data() + Comma + 1, URI.size() - Comma - 1, EmbeddedBuffers.back()) == false)
+			{
+				return false;
+			}
+
+			Buffer.Data = EmbeddedBuffers.back().data();
+			Buffer.Size = EmbeddedBuffers.back().size();
+		}
+		else
+		{
+			std::unique_ptr<FFileView> BufferFile = std::make_unique<FFileView>();
+			if (BufferFile->Open(Directory + DecodeURI(URI)) == false)
+			{
+				return false;
+			}
+
+			Buffer.Data = BufferFile->GetData();
+			Buffer.Size = BufferFile->GetSize();
+			BufferFiles.push_back(std::move(BufferFile));
+		}
+
+		if (Buffer.Size < static_cast<uint64_t>(ByteLength))
+		{
+			return false;
+		}
+
+		Buffer.Size = static_cast<size_t>(ByteLength);
+		Buffers[Idx] = Buffer;
+	}
+
+	return true;
+}
+
+bool FGLTFImporter::GetBufferView(int64_t InIndex, uint64_t InOffset, FBuffer& OutView, size_t& OutStride) const
+{
+	const FJsonValue& BufferViews = Document["bufferViews"];
+	if (InIndex < 0 || static_cast<size_t>(InIndex) >= BufferViews.GetSize())
+	{
+		return false;
+	}
+
+	const FJsonValue& BufferView = BufferViews[static_cast<size_t>(InIndex)];
+
+	int64_t BufferIndex = BufferView["buffer"].GetInt(-1);
+	int64_t ByteOffset = BufferView["byteOffset"].GetInt(0);
+	int64_t ByteLength = BufferView["byteLength"].GetInt(-1);
+	if (BufferIndex < 0 || static_cast<size_t>(BufferIndex) >= Buffers.size() || ByteOffset < 0 || ByteLength < 0)
+	{
+		return false;
+	}
+
+	const FBuffer& Buffer = Buffers[static_cast<size_t>(BufferIndex)];
+	if (static_cast<uint64_t>(ByteOffset) > Buffer.Size || static_cast<uint64_t>(ByteLength) > Buffer.Size - static_cast<uint64_t>(ByteOffset)
+		|| InOffset > static_cast<uint64_t>(ByteLength))
+	{
+		return false;
+	}
+
+	OutView.Data = Buffer.Data + ByteOffset + InOffset;
+	OutView.Size = static_cast<size_t>(ByteLength - InOffset);
+	OutStride = static_cast<size_t>(BufferView["byteStride"].GetInt(0));
+
+	return true;
+}
+
+bool FGLTFImporter::GetAccessor(int64_t InIndex, FAccessor& OutAccessor) const
+{
+	const FJsonValue& Accessors = Document["accessors"];
+	if (InIndex < 0 || static_cast<size_t>(InIndex) >= Accessors.GetSize())
+	{
+		return false;
+	}
+
+	const FJsonValue& Accessor = Accessors[static_cast<size_t>(InIndex)];
+
+	int64_t Count = Accessor["count"].GetInt(-1);
+	int64_t ByteOffset = Accessor["byteOffset"].GetInt(0);
+
+	OutAccessor = FAccessor();
+	OutAccessor.ComponentType = static_cast<uint32_t>(Accessor["componentType"].GetInt(0));
+	OutAccessor.NumComponents = GetNumComponents(Accessor["type"].GetString());
+	OutAccessor.bNormalized = Accessor["normalized"].GetBool();
+
+	uint32_t ComponentSize = GetComponentSize(OutAccessor.ComponentType);
+	if (Count < 0 || ByteOffset < 0 || ComponentSize == 0 || OutAccessor.NumComponents == 0)
+	{
+		return false;
+	}
+
+	OutAccessor.Count = static_cast<size_t>(Count);
+
+	size_t ElementSize = ComponentSize * OutAccessor.NumComponents;
+	OutAccessor.Stride = ElementSize;
+
+	const FJsonValue* BufferViewIndex = Accessor.Find("bufferView");
+	if (BufferViewIndex == nullptr)
+	{
+		return true;
+	}
+
+	FBuffer View;
+	size_t ByteStride = 0;
+	if (GetBufferView(BufferViewIndex->GetInt(-1), static_cast<uint64_t>(ByteOffset), View, ByteStride) == false)
+	{
+		return false;
+	}
+
+	if (ByteStride != 0)
+	{
+		if (ByteStride < ElementSize)
+		{
+			return false;
+		}
+
+		OutAccessor.Stride = ByteStride;
+	}
+
+	// The last element only has to fit, not its stride.
+	if (OutAccessor.Count > 0 && (View.Size < ElementSize || (OutAccessor.Count - 1) > (View.Size - ElementSize) / OutAccessor.Stride))
+	{
+		return false;
+	}
+
+	OutAccessor.Data = View.Data;
+
+	return true;
+}
+
+bool FGLTFImporter::ReadFloats(int64_t InAccessor, uint32_t InNumComponents, size_t InCount, float* OutData, size_t OutStride) const
+{
+	FAccessor Accessor;
+	if (GetAccessor(InAccessor, Accessor) == false || Accessor.Count != InCount)
+	{
+		return false;
+	}
+
+	uint32_t NumComponents = std::min(Accessor.NumComponents, InNumComponents);
+	uint8_t* Output = reinterpret_cast<uint8_t*>(OutData);
+
+	auto WriteElement = [&](const uint8_t* InElement, size_t InIndex)
+	{
+		float Values[4];
+		LoadElement(InElement, Accessor.ComponentType, Accessor.NumComponents, Accessor.bNormalized, Values);
+		memcpy(Output + InIndex * OutStride, Values, NumComponents * sizeof(float));
+	};
+
+	if (Accessor.Data != nullptr)
+	{
+		if (Accessor.ComponentType == GLTFFloat)
+		{
+			for (size_t Idx = 0; Idx < Accessor.Count; ++Idx)
+			{
+				memcpy(Output + Idx * OutStride, Accessor.Data + Idx * Accessor.Stride, NumComponents * sizeof(float));
+			}
+		}
+		else
+		{
+			for (size_t Idx = 0; Idx < Accessor.Count; ++Idx)
+			{
+				WriteElement(Accessor.Data + Idx * Accessor.Stride, Idx);
+			}
+		}
+	}
+	else
+	{
+		for (size_t Idx = 0; Idx < Accessor.Count; ++Idx)
+		{
+			memset(Output + Idx * OutStride, 0, NumComponents * sizeof(float));
+		}
+	}
+
+	// Sparse accessors replace some of the elements above.
+	const FJsonValue& Sparse = Document["accessors"][static_cast<size_t>(InAccessor)]["sparse"];
+	if (Sparse.IsObject())
+	{
+		int64_t SparseCount = Sparse["count"].GetInt(-1);
+		const FJsonValue& SparseIndices = Sparse["indices"];
+		const FJsonValue& SparseValues = Sparse["values"];
+
+		uint32_t IndexType = static_cast<uint32_t>(SparseIndices["componentType"].GetInt(0));
+		uint32_t IndexSize = GetComponentSize(IndexType);
+		size_t ValueSize = GetComponentSize(Accessor.ComponentType) * Accessor.NumComponents;
+
+		FBuffer IndexView;
+		FBuffer ValueView;
+		size_t IgnoredStride = 0;
+		if (SparseCount < 0 || IndexSize == 0 || IndexType == GLTFByte || IndexType == GLTFShort || IndexType == GLTFFloat
+			|| GetBufferView(SparseIndices["bufferView"].GetInt(-1), static_cast<uint64_t>(SparseIndices["byteOffset"].GetInt(0)), IndexView, IgnoredStride) == false
+			|| GetBufferView(SparseValues["bufferView"].GetInt(-1), static_cast<uint64_t>(SparseValues["byteOffset"].GetInt(0)), ValueView, IgnoredStride) == false
+			|| IndexView.Size / IndexSize < static_cast<uint64_t>(SparseCount) || ValueView.Size / ValueSize < static_cast<uint64_t>(SparseCount))
+		{
+			return false;
+		}
+
+		std::vector<uint32_t> Indices(static_cast<size_t>(SparseCount));
+		WidenIndices(IndexView.Data, IndexType, Indices.size(), Indices.data());
+
+		for (size_t Idx = 0; Idx < Indices.size(); ++Idx)
+		{
+			if (Indices[Idx] >= Accessor.Count)
+			{
+				return false;
+			}
+
+			WriteElement(ValueView.Data + Idx * ValueSize, Indices[Idx]);
+		}
+	}
+
+	return true;
+}
+
+bool FGLTFImporter::ReadIndices(int64_t InAccessor, std::vector<uint32_t>& OutIndices) const
+{
+	FAccessor Accessor;
+	if (GetAccessor(InAccessor, Accessor) == false || Accessor.Data == nullptr || Accessor.NumComponents != 1
+		|| (Accessor.ComponentType != GLTFUnsignedByte && Accessor.ComponentType != GLTFUnsignedShort && Accessor.ComponentType != GLTFUnsignedInt))
+	{
+		return false;
+	}
+
+	OutIndices.resize(Accessor.Count);
+
+	uint32_t ComponentSize = GetComponentSize(Accessor.ComponentType);
+	if (Accessor.Stride == ComponentSize)
+	{
+		WidenIndices(Accessor.Data, Accessor.ComponentType, Accessor.Count, OutIndices.data());
+	}
+	else
+	{
+		for (size_t Idx = 0; Idx < Accessor.Count; ++Idx)
+		{
+			WidenIndices(Accessor.Data + Idx * Accessor.Stride, Accessor.ComponentType, 1, &OutIndices[Idx]);
+		}
+	}
+
+	return true;
+}
+
+bool FGLTFImporter::ImportPrimitive(const FJsonValue& InPrimitive, const glm::mat4& InTransform, FGLTFPrimitive& OutPrimitive) const
+{
+	int64_t Mode = InPrimitive["mode"].GetInt(GLTFTriangles);
+	if (Mode != GLTFTriangles && Mode != GLTFTriangleStrip && Mode != GLTFTriangleFan)
+	{
+		return false;
+	}
+
+	const FJsonValue& Attributes = InPrimitive["attributes"];
+
+	FAccessor PositionAccessor;
+	const FJsonValue* PositionIndex = Attributes.Find("POSITION");
+	if (PositionIndex == nullptr || GetAccessor(PositionIndex->GetInt(-1), PositionAccessor) == false
+		|| PositionAccessor.Count == 0 || PositionAccessor.Count > std::numeric_limits<uint32_t>::max())
+	{
+		return false;
+	}
+
+	size_t NumVertices = PositionAccessor.Count;
+
+	std::vector<FVertex>& Vertices = OutPrimitive.Vertices;
+	Vertices.assign(NumVertices, FVertex{});
+
+	if (ReadFloats(PositionIndex->GetInt(-1), 3, NumVertices, &Vertices[0].Position.x, sizeof(FVertex)) == false)
+	{
+		return false;
+	}
+
+	const FJsonValue* NormalIndex = Attributes.Find("NORMAL");
+	if (NormalIndex != nullptr && ReadFloats(NormalIndex->GetInt(-1), 3, NumVertices, &Vertices[0].Normal.x, sizeof(FVertex)) == false)
+	{
+		return false;
+	}
+
+	const FJsonValue* TexCoordsIndex = Attributes.Find("TEXCOORD_0");
+	if (TexCoordsIndex != nullptr && ReadFloats(TexCoordsIndex->GetInt(-1), 2, NumVertices, &Vertices[0].TexCoords.x, sizeof(FVertex)) == false)
+	{
+		return false;
+	}
+
+	const FJsonValue* TangentIndex = Attributes.Find("TANGENT");
+	if (TangentIndex != nullptr && ReadFloats(TangentIndex->GetInt(-1), 4, NumVertices, &Vertices[0].Tangent.x, sizeof(FVertex)) == false)
+	{
+		return false;
+	}
+
+	std::vector<uint32_t> SourceIndices;
+	const FJsonValue* IndicesIndex = InPrimitive.Find("indices");
+	if (IndicesIndex != nullptr)
+	{
+		if (ReadIndices(IndicesIndex->GetInt(-1), SourceIndices) == false)
+		{
+			return false;
+		}
+
+		for (uint32_t Index : SourceIndices)
+		{
+			if (Index >= NumVertices)
+			{
+				return false;
+			}
+		}
+	}
+	else
+	{
+		SourceIndices.resize(NumVertices);
+		for (size_t Idx = 0; Idx < NumVertices; ++Idx)
+		{
+			SourceIndices[Idx] = static_cast<uint32_t>(Idx);
+		}
+	}
+
+	// A mirroring transform turns the winding around, so it is flipped back.
+	glm::mat3 LinearTransform(InTransform);
+	bool bFlipWinding = glm::determinant(LinearTransform) < 0.0f;
+
+	std::vector<uint32_t>& Indices = OutPrimitive.Indices;
+	Indices.clear();
+
+	auto AddTriangle = [&](uint32_t InIndex0, uint32_t InIndex1, uint32_t InIndex2)
+	{
+		if (InIndex0 == InIndex1 || InIndex1 == InIndex2 || InIndex0 == InIndex2)
+		{
+			return;
+		}
+
+		Indices.push_back(InIndex0);
+		Indices.push_back(bFlipWinding ? InIndex2 : InIndex1);
+		Indices.push_back(bFlipWinding ? InIndex1 : InIndex2);
+	};
+
+	if (Mode == GLTFTriangles)
+	{
+		Indices.reserve(SourceIndices.size());
+		for (size_t Idx = 0; Idx + 2 < SourceIndices.size(); Idx += 3)
+		{
+			AddTriangle(SourceIndices[Idx], SourceIndices[Idx + 1], SourceIndices[Idx + 2]);
+		}
+	}
+	else if (Mode == GLTFTriangleStrip)
+	{
+		for (size_t Idx = 0; Idx + 2 < SourceIndices.size(); ++Idx)
+		{
+			size_t Odd = Idx % 2;
+			AddTriangle(SourceIndices[Idx], SourceIndices[Idx + 1 + Odd], SourceIndices[Idx + 2 - Odd]);
+		}
+	}
+	else
+	{
+		for (size_t Idx = 1; Idx + 1 < SourceIndices.size(); ++Idx)
+		{
+			AddTriangle(SourceIndices[Idx], SourceIndices[Idx + 1], SourceIndices[0]);
+		}
+	}
+
+	if (Indices.empty())
+	{
+		return false;
+	}
+
+	if (InTransform != glm::mat4(1.0f))
+	{
+		glm::mat3 NormalMatrix = glm::transpose(glm::inverse(LinearTransform));
+
+		for (FVertex& Vertex : Vertices)
+		{
+			Vertex.Position = glm::vec3(InTransform * glm::vec4(Vertex.Position, 1.0f));
+
+			if (NormalIndex != nullptr)
+			{
+				Vertex.Normal = glm::normalize(NormalMatrix * Vertex.Normal);
+			}
+
+			// A mirroring transform flips the handedness along with the winding.
+			Vertex.Tangent = glm::vec4(LinearTransform * glm::vec3(Vertex.Tangent), bFlipWinding ? -Vertex.Tangent.w : Vertex.Tangent.w);
+		}
+	}
+
+	// Without normals the primitive is shaded flat, so every triangle gets its own corners.
+	if (NormalIndex == nullptr)
+	{
+		std::vector<FVertex> FlatVertices(Indices.size());
+
+		for (size_t Idx = 0; Idx < Indices.size(); Idx += 3)
+		{
+			FVertex& V0 = FlatVertices[Idx] = Vertices[Indices[Idx]];
+			FVertex& V1 = FlatVertices[Idx + 1] = Vertices[Indices[Idx + 1]];
+			FVertex& V2 = FlatVertices[Idx + 2] = Vertices[Indices[Idx + 2]];
+
+			glm::vec3 FaceNormal = glm::cross(V1.Position - V0.Position, V2.Position - V0.Position);
+			float Length = glm::length(FaceNormal);
+			FaceNormal = Length > 0.0f ? FaceNormal / Length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+			V0.Normal = FaceNormal;
+			V1.Normal = FaceNormal;
+			V2.Normal = FaceNormal;
+		}
+
+		Vertices = std::move(FlatVertices);
+		for (size_t Idx = 0; Idx < Indices.size(); ++Idx)
+		{
+			Indices[Idx] = static_cast<uint32_t>(Idx);
+		}
+	}
+
+	const FJsonValue* MaterialIndex = InPrimitive.Find("material");
+	int64_t Material = MaterialIndex != nullptr ? MaterialIndex->GetInt(-1) : -1;
+	OutPrimitive.MaterialIndex = Material >= 0 && static_cast<uint32_t>(Material) < GetNumMaterials() ? static_cast<uint32_t>(Material) : GetNumMaterials();
+	OutPrimitive.bHasTangents = TangentIndex != nullptr;
+
+	return true;
+}
+
+bool FGLTFImporter::ImportPrimitives(std::vector<FGLTFPrimitive>& OutPrimitives) const
+{
+	OutPrimitives.clear();
+
+	const FJsonValue& Nodes = Document["nodes"];
+	const FJsonValue& Meshes = Document["meshes"];
+
+	struct FPendingNode
+	{
+		int64_t Index;
+		glm::mat4 ParentTransform;
+		size_t Depth;
+	};
+
+	std::vector<FPendingNode> PendingNodes;
+
+	const FJsonValue& Scenes = Document["scenes"];
+	if (Scenes.GetSize() > 0)
+	{
+		const FJsonValue& RootNodes = Scenes[static_cast<size_t>(std::max<int64_t>(Document["scene"].GetInt(0), 0))]["nodes"];
+		for (size_t Idx = RootNodes.GetSize(); Idx > 0; --Idx)
+		{
+			PendingNodes.push_back({ RootNodes[Idx - 1].GetInt(-1), glm::mat4(1.0f), 0 });
+		}
+	}
+	else
+	{
+		// Without scenes every node that is nobody's child is a root.
+		std::vector<bool> bIsChild(Nodes.GetSize(), false);
+		for (size_t Idx = 0; Idx < Nodes.GetSize(); ++Idx)
+		{
+			const FJsonValue& Children = Nodes[Idx]["children"];
+			for (size_t ChildIdx = 0; ChildIdx < Children.GetSize(); ++ChildIdx)
+			{
+				int64_t Child = Children[ChildIdx].GetInt(-1);
+				if (Child >= 0 && static_cast<size_t>(Child) < bIsChild.size())
+				{
+					bIsChild[static_cast<size_t>(Child)] = true;
+				}
+			}
+		}
+
+		for (size_t Idx = Nodes.GetSize(); Idx > 0; --Idx)
+		{
+			if (bIsChild[Idx - 1] == false)
+			{
+				PendingNodes.push_back({ static_cast<int64_t>(Idx - 1), glm::mat4(1.0f), 0 });
+			}
+		}
+	}
+
+	while (PendingNodes.empty() == false)
+	{
+		FPendingNode Pending = PendingNodes.back();
+		PendingNodes.pop_back();
+
+		// The hierarchy must be a forest; the depth bound keeps a malformed cycle from looping forever.
+		if (Pending.Index < 0 || static_cast<size_t>(Pending.Index) >= Nodes.GetSize() || Pending.Depth > Nodes.GetSize())
+		{
+			continue;
+		}
+
+		const FJsonValue& Node = Nodes[static_cast<size_t>(Pending.Index)];
+		glm::mat4 Transform = Pending.ParentTransform * GetNodeTransform(Node);
+
+		int64_t MeshIndex = Node["mesh"].GetInt(-1);
+		if (MeshIndex >= 0 && static_cast<size_t>(MeshIndex) < Meshes.GetSize())
+		{
+			const FJsonValue& Primitives = Meshes[static_cast<size_t>(MeshIndex)]["primitives"];
+			for (size_t Idx = 0; Idx < Primitives.GetSize(); ++Idx)
+			{
+				FGLTFPrimitive Primitive;
+				if (ImportPrimitive(Primitives[Idx], Transform, Primitive))
+				{
+					OutPrimitives.push_back(std::move(Primitive));
+				}
+			}
+		}
+
+		const FJsonValue& Children = Node["children"];
+		for (size_t Idx = Children.GetSize(); Idx > 0; --Idx)
+		{
+			PendingNodes.push_back({ Children[Idx - 1].GetInt(-1), Transform, Pending.Depth + 1 });
+		}
+	}
+
+	return OutPrimitives.empty() == false;
+}
+
+std::string FGLTFImporter::ResolveImage(int64_t InTextureIndex) const
+{
+	const FJsonValue& Textures = Document["textures"];
+	if (InTextureIndex < 0 || static_cast<size_t>(InTextureIndex) >= Textures.GetSize())
+	{
+		return std::string();
+	}
+
+	int64_t ImageIndex = Textures[static_cast<size_t>(InTextureIndex)]["source"].GetInt(-1);
+	const FJsonValue& Images = Document["images"];
+	if (ImageIndex < 0 || static_cast<size_t>(ImageIndex) >= Images.GetSize())
+	{
+		return std::string();
+	}
+
+	const std::string& URI = Images[static_cast<size_t>(ImageIndex)]["uri"].GetString();
+	if (URI.empty() || IsDataURI(URI))
+	{
+		return std::string();
+	}
+
+	return Directory + DecodeURI(URI);
+}
+
+void FGLTFImporter::ImportMaterials(std::vector<FGLTFMaterial>& OutMaterials) const
+{
+	const FJsonValue& Materials = Document["materials"];
+
+	OutMaterials.clear();
+	OutMaterials.resize(Materials.GetSize());
+
+	for (size_t Idx = 0; Idx < Materials.GetSize(); ++Idx)
+	{
+		const FJsonValue& Material = Materials[Idx];
+		const FJsonValue& PBR = Material["pbrMetallicRoughness"];
+
+		FGLTFMaterial& OutMaterial = OutMaterials[Idx];
+		OutMaterial.Name = Material["name"].GetString();
+
+		const FJsonValue& BaseColorFactor = PBR["baseColorFactor"];
+		if (BaseColorFactor.GetSize() == 4)
+		{
+			OutMaterial.BaseColorFactor = glm::vec4(BaseColorFactor[0].GetNumber(), BaseColorFactor[1].GetNumber(), BaseColorFactor[2].GetNumber(), BaseColorFactor[3].GetNumber());
+		}
+
+		OutMaterial.MetallicFactor = static_cast<float>(PBR["metallicFactor"].GetNumber(1.0));
+		OutMaterial.RoughnessFactor = static_cast<float>(PBR["roughnessFactor"].GetNumber(1.0));
+		OutMaterial.BaseColorTexture = ResolveImage(PBR["baseColorTexture"]["index"].GetInt(-1));
+		OutMaterial.NormalTexture = ResolveImage(Material["normalTexture"]["index"].GetInt(-1));
+	}
+}
+
+// Textures are shared between materials and files by path and load in the background. The renderer skips a material
+// slot until its descriptor set has been written, which needs a view of both of its textures.
+static UTexture* LoadMaterialTexture(const std::string& InFilename, bool bInIsNormal, UTexture* InDefaultTexture)
+{
+	if (InFilename.empty())
+	{
+		return InDefaultTexture;
+	}
+
+	if (UAsset* ExistingAsset = FAssetManager::FindAsset(InFilename))
+	{
+		UTexture2D* ExistingTexture = Cast<UTexture2D>(ExistingAsset);
+		return ExistingTexture != nullptr ? ExistingTexture : InDefaultTexture;
+	}
+
+	UTexture2D* Texture = FAssetManager::CreateAsset<UTexture2D>(InFilename);
+	if (Texture == nullptr)
+	{
+		return InDefaultTexture;
+	}
+
+	Texture->SetIsNormal(bInIsNormal);
+	FAssetManager::LoadAsync(Texture, InFilename);
+
+	return Texture;
+}
+
+std::vector<UMaterial*> FGLTFImporter::CreateMaterials(const std::string& InFilename, const FShaderPath& InShaderPath, UTexture* InDefaultBaseColor, UTexture* InDefaultNormal)
+{
+	std::vector<UMaterial*> Materials;
+
+	FGLTFImporter Importer;
+	if (Importer.Open(InFilename) == false)
+	{
+		return Materials;
+	}
+
+	std::vector<FGLTFMaterial> SourceMaterials;
+	Importer.ImportMaterials(SourceMaterials);
+
+	for (size_t Idx = 0; Idx < SourceMaterials.size(); ++Idx)
+	{
+		const FGLTFMaterial& SourceMaterial = SourceMaterials[Idx];
+
+		UMaterial* Material = FAssetManager::CreateAsset<UMaterial>(InFilename + ":" + std::to_string(Idx));
+		Materials.push_back(Material);
+
+		if (Material == nullptr || Material->GetRenderMaterial() != nullptr)
+		{
+			continue;
+		}
+
+		Material->SetShaderPath(InShaderPath);
+
+		FShaderParameter BaseColorParameter{};
+		BaseColorParameter.Type = EShaderParameterType::Texture;
+		BaseColorParameter.TexParam = LoadMaterialTexture(SourceMaterial.BaseColorTexture, false, InDefaultBaseColor);
+		Material->SetBaseColor(BaseColorParameter);
+
+		FShaderParameter NormalParameter{};
+		NormalParameter.Type = EShaderParameterType::Texture;
+		NormalParameter.TexParam = LoadMaterialTexture(SourceMaterial.NormalTexture, true, InDefaultNormal);
+		Material->SetNormal(NormalParameter);
+
+		// The shaders are Blinn-Phong, so the metallic-roughness parameters are approximated: metals tint their
+		// highlights with the base color and rough surfaces dim them.
+		glm::vec3 BaseColor = glm::vec3(SourceMaterial.BaseColorFactor);
+		glm::vec3 SpecularColor = glm::mix(glm::vec3(0.04f), BaseColor, SourceMaterial.MetallicFactor) * (1.0f - SourceMaterial.RoughnessFactor);
+
+		FShaderParameter AmbientParameter{};
+		AmbientParameter.Type = EShaderParameterType::Vector3;
+		AmbientParameter.Vec3Param = BaseColor * 0.05f;
+		Material->SetAmbient(AmbientParameter);
+
+		FShaderParameter DiffuseParameter{};
+		DiffuseParameter.Type = EShaderParameterType::Vector3;
+		DiffuseParameter.Vec3Param = BaseColor * (1.0f - SourceMaterial.MetallicFactor);
+		Material->SetDiffuse(DiffuseParameter);
+
+		FShaderParameter SpecularParameter{};
+		SpecularParameter.Type = EShaderParameterType::Vector3;
+		SpecularParameter.Vec3Param = SpecularColor;
+		Material->SetSpecular(SpecularParameter);
+
+		Material->CreateRenderMaterial();
+	}
+
+	return Materials;
+}
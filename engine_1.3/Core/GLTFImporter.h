@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Vertex.h"
+#include "Material.h"
+#include "FileSystem.h"
+#include "Json.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+class UTexture;
+
+// Triangles of one glTF primitive as placed by one node, with the node transform baked in.
+struct FGLTFPrimitive
+{
+	std::vector<FVertex> Vertices;
+	std::vector<uint32_t> Indices;
+	// Index into the file's materials. Primitives without a material use the slot after the last one.
+	uint32_t MaterialIndex = 0;
+	bool bHasTangents = false;
+};
+
+struct FGLTFMaterial
+{
+	std::string Name;
+	glm::vec4 BaseColorFactor = glm::vec4(1.0f);
+	float MetallicFactor = 1.0f;
+	float RoughnessFactor = 1.0f;
+	// Image files resolved against the glTF file. Empty when there is no such texture or its image is embedded in a
+	// buffer, which textures cannot load from.
+	std::string BaseColorTexture;
+	std::string NormalTexture;
+};
+
+// Reads glTF 2.0 files, both .gltf with external or data URI buffers and .glb, without building an intermediate
+// scene. The file and its buffers are viewed through GFileSystem and accessors are converted straight from them into
+// FVertex and 32-bit indices.
+class FGLTFImporter
+{
+public:
+	static bool IsGLTFFile(const std::string& InFilename);
+
+	// External buffers of InFilename, as their URIs relative to it. The mesh imported from a .gltf depends on them.
+	static bool GetBufferURIs(const std::string& InFilename, std::vector<std::string>& OutURIs);
+
+	FGLTFImporter();
+
+	FGLTFImporter(const FGLTFImporter&) = delete;
+	FGLTFImporter& operator=(const FGLTFImporter&) = delete;
+
+	bool Open(const std::string& InFilename);
+	void Close();
+
+	// Every triangle, strip and fan primitive placed by the nodes of the default scene. Primitives with malformed
+	// accessors are skipped.
+	bool ImportPrimitives(std::vector<FGLTFPrimitive>& OutPrimitives) const;
+
+	uint32_t GetNumMaterials() const { return static_cast<uint32_t>(Document["materials"].GetSize()); }
+	void ImportMaterials(std::vector<FGLTFMaterial>& OutMaterials) const;
+
+	// Creates one material asset per material of InFilename, named after the file and the material index, and queues
+	// their textures to load. Materials without a texture use the defaults. The result is indexed like the mesh's
+	// material slots. Render thread only.
+	static std::vector<UMaterial*> CreateMaterials(const std::string& InFilename, const FShaderPath& InShaderPath, UTexture* InDefaultBaseColor, UTexture* InDefaultNormal);
+
+private:
+	struct FBuffer
+	{
+		const uint8_t* Data = nullptr;
+		size_t Size = 0;
+	};
+
+	struct FAccessor
+	{
+		// Null for an accessor without a buffer view, whose elements are all zero.
+		const uint8_t* Data = nullptr;
+		size_t Count = 0;
+		size_t Stride = 0;
+		uint32_t ComponentType = 0;
+		uint32_t NumComponents = 0;
+		bool bNormalized = false;
+	};
+
+	static bool ParseDocument(const uint8_t* InData, size_t InSize, FJsonValue& OutDocument, FBuffer& OutBinaryChunk);
+
+	bool LoadBuffers(const FBuffer& InBinaryChunk);
+	bool GetBufferView(int64_t InIndex, uint64_t InOffset, FBuffer& OutView, size_t& OutStride) const;
+	bool GetAccessor(int64_t InIndex, FAccessor& OutAccessor) const;
+
+	bool ReadFloats(int64_t InAccessor, uint32_t InNumComponents, size_t InCount, float* OutData, size_t OutStride) const;
+	bool ReadIndices(int64_t InAccessor, std::vector<uint32_t>& OutIndices) const;
+
+	bool ImportPrimitive(const FJsonValue& InPrimitive, const glm::mat4& InTransform, FGLTFPrimitive& OutPrimitive) const;
+
+	std::string ResolveImage(int64_t InTextureIndex) const;
+
+	std::string Directory;
+	FFileView File;
+	FJsonValue Document;
+
+	std::vector<FBuffer> Buffers;
+	std::vector<std::unique_ptr<FFileView>> BufferFiles;
+	// Decoded data URIs.
+	std::vector<std::vector<uint8_t>> EmbeddedBuffers;
+};
@@ -0,0 +1,214 @@
+#include "ImageDecoder.h"
+
+#include "JobSystem.h"
+#include "FileSystem.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <atomic>
+#include <climits>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define IMAGE_DECODER_USE_SSE 1
+#include <emmintrin.h>
+#else
+#define IMAGE_DECODER_USE_SSE 0
+#endif
+
+static void ConvertRow(const uint8_t* InTexels, uint32_t InNumChannels, uint32_t InWidth, uint8_t* OutTexels)
+{
+	switch (InNumChannels)
+	{
+	case 1:
+		FImageDecoder::ConvertGrayToRGBA(InTexels, InWidth, OutTexels);
+		break;
+	case 2:
+		FImageDecoder::ConvertGrayAlphaToRGBA(InTexels, InWidth, OutTexels);
+		break;
+	case 3:
+		FImageDecoder::ConvertRGBToRGBA(InTexels, InWidth, OutTexels);
+		break;
+	default:
+		memcpy(OutTexels, InTexels, static_cast<size_t>(InWidth) * 4);
+		break;
+	}
+}
+
+bool FImageDecoder::Decode(const uint8_t* InData, size_t InSize, bool bInFlipVertically, FDecodedImage& OutImage)
+{
+	if (InData == nullptr || InSize == 0 || InSize > INT_MAX)
+	{
+		return false;
+	}
+
+	// The flip is done while converting rows, so stb's own flip is kept off for this thread whatever was set globally.
+	stbi_set_flip_vertically_on_load_thread(0);
+
+	int Width, Height, NumChannels;
+	stbi_uc* Texels = stbi_load_from_memory(InData, static_cast<int>(InSize), &Width, &Height, &NumChannels, 0);
+	if (Texels == nullptr)
+	{
+		return false;
+	}
+
+	OutImage.Width = static_cast<uint32_t>(Width);
+	OutImage.Height = static_cast<uint32_t>(Height);
+	OutImage.NumChannels = static_cast<uint32_t>(NumChannels);
+	OutImage.Pixels.resize(static_cast<size_t>(OutImage.Width) * OutImage.Height * 4);
+
+	const size_t SrcRowSize = static_cast<size_t>(OutImage.Width) * OutImage.NumChannels;
+	const size_t DstRowSize = static_cast<size_t>(OutImage.Width) * 4;
+
+	for (uint32_t Y = 0; Y < OutImage.Height; ++Y)
+	{
+		uint32_t DstY = bInFlipVertically ? OutImage.Height - 1 - Y : Y;
+		ConvertRow(Texels + Y * SrcRowSize, OutImage.NumChannels, OutImage.Width, OutImage.Pixels.data() + DstY * DstRowSize);
+	}
+
+	stbi_image_free(Texels);
+
+	return true;
+}
+
+bool FImageDecoder::DecodeFile(const std::string& InFilename, bool bInFlipVertically, FDecodedImage& OutImage)
+{
+	FFileView File;
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	return Decode(File.GetData(), File.GetSize(), bInFlipVertically, OutImage);
+}
+
+bool FImageDecoder::DecodeFiles(const std::vector<std::string>& InFilenames, bool bInFlipVertically, std::vector<FDecodedImage>& OutImages)
+{
+	OutImages.clear();
+	OutImages.resize(InFilenames.size());
+
+	std::atomic<bool> bFailed(false);
+
+	auto DecodeRange = [&](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+		{
+			if (DecodeFile(InFilenames[Idx], bInFlipVertically, OutImages[Idx]) == false)
+			{
+				bFailed = true;
+			}
+		}
+	};
+
+	uint32_t NumFiles = static_cast<uint32_t>(InFilenames.size());
+
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelForBackground(NumFiles, 1, DecodeRange);
+	}
+	else
+	{
+		DecodeRange(0, NumFiles);
+	}
+
+	return bFailed == false;
+}
+
+void FImageDecoder::ConvertGrayToRGBA(const uint8_t* InTexels, size_t InNumPixels, uint8_t* OutTexels)
+{
+	size_t Idx = 0;
+
+#if IMAGE_DECODER_USE_SSE
+	const __m128i Opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+
+	for (; Idx + 16 <= InNumPixels; Idx += 16)
+	{
+		__m128i Gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InTexels + Idx));
+
+		// Pairs of (gray, gray) and (gray, 255) are interleaved into (gray, gray, gray, 255).
+		__m128i GrayGrayLo = _mm_unpacklo_epi8(Gray, Gray);
+		__m128i GrayGrayHi = _mm_unpackhi_epi8(Gray, Gray);
+		__m128i GrayAlphaLo = _mm_unpacklo_epi8(Gray, Opaque);
+		__m128i GrayAlphaHi = _mm_unpackhi_epi8(Gray, Opaque);
+
+		__m128i* Out = reinterpret_cast<__m128i*>(OutTexels + Idx * 4);
+		_mm_storeu_si128(Out + 0, _mm_unpacklo_epi16(GrayGrayLo, GrayAlphaLo));
+		_mm_storeu_si128(Out + 1, _mm_unpackhi_epi16(GrayGrayLo, GrayAlphaLo));
+		_mm_storeu_si128(Out + 2, _mm_unpacklo_epi16(GrayGrayHi, GrayAlphaHi));
+		_mm_storeu_si128(Out + 3, _mm_unpackhi_epi16(GrayGrayHi, GrayAlphaHi));
+	}
+#endif
+
+	for (; Idx < InNumPixels; ++Idx)
+	{
+		uint8_t* Out = OutTexels + Idx * 4;
+		Out[0] = InTexels[Idx];
+		Out[1] = InTexels[Idx];
+		Out[2] = InTexels[Idx];
+		Out[3] = 0xFF;
+	}
+}
+
+void FImageDecoder::ConvertGrayAlphaToRGBA(const uint8_t* InTexels, size_t InNumPixels, uint8_t* OutTexels)
+{
+	size_t Idx = 0;
+
+#if IMAGE_DECODER_USE_SSE
+	const __m128i GrayMask = _mm_set1_epi16(0x00FF);
+
+	for (; Idx + 8 <= InNumPixels; Idx += 8)
+	{
+		__m128i GrayAlpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InTexels + Idx * 2));
+
+		__m128i Gray = _mm_and_si128(GrayAlpha, GrayMask);
+		__m128i GrayGray = _mm_or_si128(Gray, _mm_slli_epi16(Gray, 8));
+
+		__m128i* Out = reinterpret_cast<__m128i*>(OutTexels + Idx * 4);
+		_mm_storeu_si128(Out + 0, _mm_unpacklo_epi16(GrayGray, GrayAlpha));
+		_mm_storeu_si128(Out + 1, _mm_unpackhi_epi16(GrayGray, GrayAlpha));
+	}
+#endif
+
+	for (; Idx < InNumPixels; ++Idx)
+	{
+		uint8_t* Out = OutTexels + Idx * 4;
+		Out[0] = InTexels[Idx * 2];
+		Out[1] = InTexels[Idx * 2];
+		Out[2] = InTexels[Idx * 2];
+		Out[3] = InTexels[Idx * 2 + 1];
+	}
+}
+
+void FImageDecoder::ConvertRGBToRGBA(const uint8_t* InTexels, size_t InNumPixels, uint8_t* OutTexels)
+{
+	size_t Idx = 0;
+
+#if IMAGE_DECODER_USE_SSE
+	const __m128i ColorMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i AlphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+	// Each iteration reads 16 bytes for 4 texels, so the last few texels are left to the scalar loop.
+	for (; Idx + 6 <= InNumPixels; Idx += 4)
+	{
+		__m128i RGB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InTexels + Idx * 3));
+
+		// Texel N starts at byte 3 * N; shifting it down to byte 0 and gathering the low dwords places one texel per dword.
+		__m128i Texels01 = _mm_unpacklo_epi32(RGB, _mm_srli_si128(RGB, 3));
+		__m128i Texels23 = _mm_unpacklo_epi32(_mm_srli_si128(RGB, 6), _mm_srli_si128(RGB, 9));
+		__m128i RGBA = _mm_unpacklo_epi64(Texels01, Texels23);
+
+		RGBA = _mm_or_si128(_mm_and_si128(RGBA, ColorMask), AlphaMask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(OutTexels + Idx * 4), RGBA);
+	}
+#endif
+
+	for (; Idx < InNumPixels; ++Idx)
+	{
+		uint8_t* Out = OutTexels + Idx * 4;
+		Out[0] = InTexels[Idx * 3 + 0];
+		Out[1] = InTexels[Idx * 3 + 1];
+		Out[2] = InTexels[Idx * 3 + 2];
+		Out[3] = 0xFF;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct FDecodedImage
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	// Channels stored in the source file. Pixels always hold RGBA8.
+	uint32_t NumChannels = 0;
+	std::vector<uint8_t> Pixels;
+};
+
+// Reentrant image decoding on top of stb_image. No global decoder state is touched, so any number of threads may
+// decode at once; the vertical flip is an argument of each call instead of a global setting.
+class FImageDecoder
+{
+public:
+	static bool Decode(const uint8_t* InData, size_t InSize, bool bInFlipVertically, FDecodedImage& OutImage);
+	static bool DecodeFile(const std::string& InFilename, bool bInFlipVertically, FDecodedImage& OutImage);
+
+	// Decodes the files side by side on background jobs. Fails if any of them fails.
+	static bool DecodeFiles(const std::vector<std::string>& InFilenames, bool bInFlipVertically, std::vector<FDecodedImage>& OutImages);
+
+	// Conversions of InNumPixels texels to RGBA8. Missing alpha becomes opaque and gray is copied to every color channel.
+	static void ConvertGrayToRGBA(const uint8_t* InTexels, size_t InNumPixels, uint8_t* OutTexels);
+	static void ConvertGrayAlphaToRGBA(const uint8_t* InTexels, size_t InNumPixels, uint8_t* OutTexels);
+	static void ConvertRGBToRGBA(const uint8_t* InTexels, size_t InNumPixels, uint8_t* OutTexels);
+};
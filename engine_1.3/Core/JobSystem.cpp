@@ -0,0 +1,378 @@
+#include "JobSystem.h"
+#include "Config.h"
+
+#include <algorithm>
+
+FJobSystem* GJobSystem;
+
+static thread_local uint32_t GWorkerIndex = FJobSystem::InvalidWorkerIndex;
+
+FJobCounter::FJobCounter()
+	: Value(0)
+{
+}
+
+void FJobCounter::Add(int32_t InCount)
+{
+	Value.fetch_add(InCount, std::memory_order_acq_rel);
+}
+
+void FJobCounter::Decrement()
+{
+	std::vector<FContinuation> Released;
+	{
+		// Held across the decrement so a waiter cannot destroy the counter while it is still being touched.
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (Value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		Released.swap(Continuations);
+	}
+
+	for (FContinuation& Continuation : Released)
+	{
+		GJobSystem->Enqueue({ std::move(Continuation.Function), Continuation.Counter });
+	}
+}
+
+void FJobSystem::Startup()
+{
+	uint32_t NumHardwareThreads = std::thread::hardware_concurrency();
+
+	int32_t JobWorkerCount = NumHardwareThreads > 1 ? static_cast<int32_t>(NumHardwareThreads - 1) : 0;
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("JobWorkerCount", JobWorkerCount);
+	}
+
+	GJobSystem = new FJobSystem(static_cast<uint32_t>(std::max(JobWorkerCount, 0)));
+}
+
+void FJobSystem::Shutdown()
+{
+	delete GJobSystem;
+	GJobSystem = nullptr;
+}
+
+FJobSystem::FJobSystem(uint32_t InNumWorkerThreads)
+	: NumQueuedJobs(0)
+	, NumBackgroundJobs(0)
+	, bStopping(false)
+{
+	GWorkerIndex = 0;
+
+	for (uint32_t Idx = 0; Idx < InNumWorkerThreads + 1; ++Idx)
+	{
+		Queues.push_back(std::make_unique<FWorkQueue>());
+	}
+
+	for (uint32_t Idx = 1; Idx < Queues.size(); ++Idx)
+	{
+		Threads.emplace_back(&FJobSystem::WorkerMain, this, Idx);
+	}
+}
+
+FJobSystem::~FJobSystem()
+{
+	{
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+		bStopping = true;
+	}
+	SleepCondition.notify_all();
+
+	for (std::thread& Thread : Threads)
+	{
+		if (Thread.joinable())
+		{
+			Thread.join();
+		}
+	}
+}
+
+uint32_t FJobSystem::GetWorkerIndex()
+{
+	return GWorkerIndex;
+}
+
+void FJobSystem::Schedule(FJobFunction InFunction, FJobCounter* InCounter)
+{
+	if (InCounter != nullptr)
+	{
+		InCounter->Add(1);
+	}
+
+	Enqueue({ std::move(InFunction), InCounter });
+}
+
+void FJobSystem::ScheduleAfter(FJobCounter& InDependency, FJobFunction InFunction, FJobCounter* InCounter)
+{
+	if (InCounter != nullptr)
+	{
+		InCounter->Add(1);
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(InDependency.Mutex);
+		if (InDependency.IsDone() == false)
+		{
+			InDependency.Continuations.push_back({ std::move(InFunction), InCounter });
+			return;
+		}
+	}
+
+	Enqueue({ std::move(InFunction), InCounter });
+}
+
+void FJobSystem::ScheduleBackground(FJobFunction InFunction, FJobCounter* InCounter)
+{
+	if (InCounter != nullptr)
+	{
+		InCounter->Add(1);
+	}
+
+	FJob Job{ std::move(InFunction), InCounter };
+
+	if (Threads.empty())
+	{
+		Execute(Job);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(BackgroundMutex);
+		BackgroundJobs.push_back(std::move(Job));
+	}
+
+	NumBackgroundJobs.fetch_add(1, std::memory_order_release);
+
+	{
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+	}
+	SleepCondition.notify_one();
+}
+
+void FJobSystem::Wait(const FJobCounter& InCounter)
+{
+	uint32_t WorkerIndex = GWorkerIndex != InvalidWorkerIndex ? GWorkerIndex : 0;
+
+	while (InCounter.IsDone() == false)
+	{
+		if (TryRunJob(WorkerIndex) == false)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	std::lock_guard<std::mutex> Lock(InCounter.Mutex);
+}
+
+void FJobSystem::ParallelFor(uint32_t InCount, uint32_t InChunkSize, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction)
+{
+	if (InCount == 0)
+	{
+		return;
+	}
+
+	InChunkSize = std::max(InChunkSize, 1U);
+	uint32_t NumChunks = (InCount + InChunkSize - 1) / InChunkSize;
+
+	if (NumChunks == 1 || Threads.empty())
+	{
+		InFunction(0, InCount);
+		return;
+	}
+
+	FJobCounter Counter;
+	for (uint32_t Chunk = 1; Chunk < NumChunks; ++Chunk)
+	{
+		uint32_t Begin = Chunk * InChunkSize;
+		uint32_t End = std::min(Begin + InChunkSize, InCount);
+		Schedule([&InFunction, Begin, End]() { InFunction(Begin, End); }, &Counter);
+	}
+
+	InFunction(0, std::min(InChunkSize, InCount));
+
+	Wait(Counter);
+}
+
+void FJobSystem::ParallelFor(uint32_t InCount, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction)
+{
+	// A few chunks per thread leaves room for stealing when chunks are uneven.
+	uint32_t ChunkSize = InCount / (GetNumThreads() * 4);
+	ParallelFor(InCount, std::max(ChunkSize, 1U), InFunction);
+}
+
+void FJobSystem::ParallelForBackground(uint32_t InCount, uint32_t InChunkSize, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction)
+{
+	if (InCount == 0)
+	{
+		return;
+	}
+
+	InChunkSize = std::max(InChunkSize, 1U);
+	uint32_t NumChunks = (InCount + InChunkSize - 1) / InChunkSize;
+
+	if (NumChunks == 1 || Threads.empty())
+	{
+		InFunction(0, InCount);
+		return;
+	}
+
+	struct FSharedState
+	{
+		std::atomic<uint32_t> NextChunk{ 0 };
+		std::atomic<uint32_t> NumFinishedChunks{ 0 };
+	};
+
+	// Helpers may start after this call returned; they only touch InFunction when they still claim a chunk.
+	std::shared_ptr<FSharedState> State = std::make_shared<FSharedState>();
+
+	auto RunChunks = [State, &InFunction, InCount, InChunkSize, NumChunks]()
+	{
+		while (true)
+		{
+			uint32_t Chunk = State->NextChunk.fetch_add(1, std::memory_order_relaxed);
+			if (Chunk >= NumChunks)
+			{
+				return;
+			}
+
+			uint32_t Begin = Chunk * InChunkSize;
+			InFunction(Begin, std::min(Begin + InChunkSize, InCount));
+
+			State->NumFinishedChunks.fetch_add(1, std::memory_order_release);
+		}
+	};
+
+	uint32_t NumHelpers = std::min(NumChunks - 1, static_cast<uint32_t>(Threads.size()));
+	for (uint32_t Idx = 0; Idx < NumHelpers; ++Idx)
+	{
+		ScheduleBackground(RunChunks);
+	}
+
+	RunChunks();
+
+	while (State->NumFinishedChunks.load(std::memory_order_acquire) < NumChunks)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void FJobSystem::Enqueue(FJob&& InJob)
+{
+	uint32_t WorkerIndex = GWorkerIndex < Queues.size() ? GWorkerIndex : 0;
+
+	{
+		FWorkQueue& Queue = *Queues[WorkerIndex];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		Queue.Jobs.push_back(std::move(InJob));
+	}
+
+	NumQueuedJobs.fetch_add(1, std::memory_order_release);
+
+	{
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+	}
+	SleepCondition.notify_one();
+}
+
+bool FJobSystem::TryRunJob(uint32_t InWorkerIndex)
+{
+	FJob Job;
+	if (PopJob(InWorkerIndex, Job) == false)
+	{
+		return false;
+	}
+
+	Execute(Job);
+	return true;
+}
+
+bool FJobSystem::PopJob(uint32_t InWorkerIndex, FJob& OutJob)
+{
+	// The owner works LIFO on its own queue for locality; thieves take the oldest job from the front.
+	{
+		FWorkQueue& Queue = *Queues[InWorkerIndex];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		if (Queue.Jobs.empty() == false)
+		{
+			OutJob = std::move(Queue.Jobs.back());
+			Queue.Jobs.pop_back();
+			NumQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	uint32_t NumQueues = static_cast<uint32_t>(Queues.size());
+	for (uint32_t Offset = 1; Offset < NumQueues; ++Offset)
+	{
+		FWorkQueue& Victim = *Queues[(InWorkerIndex + Offset) % NumQueues];
+		std::lock_guard<std::mutex> Lock(Victim.Mutex);
+		if (Victim.Jobs.empty() == false)
+		{
+			OutJob = std::move(Victim.Jobs.front());
+			Victim.Jobs.pop_front();
+			NumQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FJobSystem::PopBackgroundJob(FJob& OutJob)
+{
+	std::lock_guard<std::mutex> Lock(BackgroundMutex);
+	if (BackgroundJobs.empty())
+	{
+		return false;
+	}
+
+	OutJob = std::move(BackgroundJobs.front());
+	BackgroundJobs.pop_front();
+	NumBackgroundJobs.fetch_sub(1, std::memory_order_acq_rel);
+	return true;
+}
+
+void FJobSystem::Execute(FJob& InJob)
+{
+	InJob.Function();
+
+	if (InJob.Counter != nullptr)
+	{
+		InJob.Counter->Decrement();
+	}
+}
+
+void FJobSystem::WorkerMain(uint32_t InWorkerIndex)
+{
+	GWorkerIndex = InWorkerIndex;
+
+	while (true)
+	{
+		if (TryRunJob(InWorkerIndex))
+		{
+			continue;
+		}
+
+		FJob BackgroundJob;
+		if (PopBackgroundJob(BackgroundJob))
+		{
+			Execute(BackgroundJob);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> Lock(SleepMutex);
+		SleepCondition.wait(Lock, [this]()
+		{
+			return bStopping || NumQueuedJobs.load(std::memory_order_acquire) > 0 || NumBackgroundJobs.load(std::memory_order_acquire) > 0;
+		});
+
+		if (bStopping)
+		{
+			return;
+		}
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+using FJobFunction = std::function<void()>;
+
+// Counts outstanding jobs. Jobs can be chained behind a counter with FJobSystem::ScheduleAfter.
+class FJobCounter
+{
+public:
+	FJobCounter();
+
+	FJobCounter(const FJobCounter&) = delete;
+	FJobCounter& operator=(const FJobCounter&) = delete;
+
+	bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+	int32_t GetValue() const { return Value.load(std::memory_order_acquire); }
+
+private:
+	friend class FJobSystem;
+
+	struct FContinuation
+	{
+		FJobFunction Function;
+		FJobCounter* Counter;
+	};
+
+	void Add(int32_t InCount);
+	void Decrement();
+
+	std::atomic<int32_t> Value;
+
+	mutable std::mutex Mutex;
+	std::vector<FContinuation> Continuations;
+};
+
+// Per-thread work-stealing job queues. The thread that calls Startup is worker 0 and takes part in
+// Wait and ParallelFor; the other workers are owned by the job system.
+class FJobSystem
+{
+public:
+	static constexpr uint32_t InvalidWorkerIndex = UINT32_MAX;
+
+	static void Startup();
+	static void Shutdown();
+
+	FJobSystem(uint32_t InNumWorkerThreads);
+	virtual ~FJobSystem();
+
+	// InCounter, when given, is incremented now and decremented once the job has run.
+	void Schedule(FJobFunction InFunction, FJobCounter* InCounter = nullptr);
+	// Holds the job back until InDependency reaches zero.
+	void ScheduleAfter(FJobCounter& InDependency, FJobFunction InFunction, FJobCounter* InCounter = nullptr);
+	// For long jobs such as asset loads. They only run on worker threads, once those are out of regular jobs,
+	// so Wait and ParallelFor on the main thread never pick one up. Runs inline when there are no workers.
+	void ScheduleBackground(FJobFunction InFunction, FJobCounter* InCounter = nullptr);
+
+	// Runs queued jobs on the calling thread until InCounter reaches zero.
+	void Wait(const FJobCounter& InCounter);
+
+	// Splits [0, InCount) into chunks of InChunkSize and blocks until every chunk has run.
+	void ParallelFor(uint32_t InCount, uint32_t InChunkSize, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction);
+	void ParallelFor(uint32_t InCount, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction);
+	// ParallelFor for background jobs: the helpers are background jobs, so the main thread never runs a chunk. The caller
+	// takes chunks too and only waits for chunks that have started, never for a helper to be picked up.
+	void ParallelForBackground(uint32_t InCount, uint32_t InChunkSize, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction);
+
+	// Worker threads plus the main thread.
+	uint32_t GetNumThreads() const { return static_cast<uint32_t>(Queues.size()); }
+
+	// 0 on the main thread, 1..N on workers and InvalidWorkerIndex anywhere else.
+	static uint32_t GetWorkerIndex();
+
+private:
+	friend class FJobCounter;
+
+	struct FJob
+	{
+		FJobFunction Function;
+		FJobCounter* Counter = nullptr;
+	};
+
+	struct FWorkQueue
+	{
+		std::mutex Mutex;
+		std::deque<FJob> Jobs;
+	};
+
+	void Enqueue(FJob&& InJob);
+	bool TryRunJob(uint32_t InWorkerIndex);
+	bool PopJob(uint32_t InWorkerIndex, FJob& OutJob);
+	bool PopBackgroundJob(FJob& OutJob);
+	void Execute(FJob& InJob);
+	void WorkerMain(uint32_t InWorkerIndex);
+
+	std::vector<std::unique_ptr<FWorkQueue>> Queues;
+	std::vector<std::thread> Threads;
+
+	std::mutex BackgroundMutex;
+	std::deque<FJob> BackgroundJobs;
+
+	std::atomic<int32_t> NumQueuedJobs;
+	std::atomic<int32_t> NumBackgroundJobs;
+	std::atomic<bool> bStopping;
+
+	std::mutex SleepMutex;
+	std::condition_variable SleepCondition;
+};
+
+extern FJobSystem* GJobSystem;
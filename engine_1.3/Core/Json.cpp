@@ -0,0 +1,361 @@
+#include "Json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// Deep enough for any asset description, shallow enough that a hostile file cannot exhaust the stack.
+static constexpr uint32_t MaxJsonDepth = 128;
+
+class FJsonParser
+{
+public:
+	FJsonParser(const char* InData, size_t InSize)
+		: Cursor(InData)
+		, End(InData + InSize)
+	{
+	}
+
+	bool ParseDocument(FJsonValue& OutValue)
+	{
+		if (ParseValue(OutValue, 0) == false)
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+		return Cursor == End;
+	}
+
+private:
+	void SkipWhitespace()
+	{
+		while (Cursor < End && (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\n' || *Cursor == '\r'))
+		{
+			++Cursor;
+		}
+	}
+
+	bool Consume(char InChar)
+	{
+		SkipWhitespace();
+		if (Cursor < End && *Cursor == InChar)
+		{
+			++Cursor;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool ConsumeLiteral(const char* InLiteral)
+	{
+		size_t Length = strlen(InLiteral);
+		if (static_cast<size_t>(End - Cursor) < Length || memcmp(Cursor, InLiteral, Length) != 0)
+		{
+			return false;
+		}
+
+		Cursor += Length;
+		return true;
+	}
+
+	bool ParseValue(FJsonValue& OutValue, uint32_t InDepth)
+	{
+		SkipWhitespace();
+		if (Cursor == End || InDepth > MaxJsonDepth)
+		{
+			return false;
+		}
+
+		switch (*Cursor)
+		{
+		case '{':
+			return ParseObject(OutValue, InDepth);
+		case '[':
+			return ParseArray(OutValue, InDepth);
+		case '"':
+			OutValue.Type = EJsonType::String;
+			return ParseString(OutValue.String);
+		case 't':
+			OutValue.Type = EJsonType::Bool;
+			OutValue.bBool = true;
+			return ConsumeLiteral("true");
+		case 'f':
+			OutValue.Type = EJsonType::Bool;
+			OutValue.bBool = false;
+			return ConsumeLiteral("false");
+		case 'n':
+			OutValue.Type = EJsonType::Null;
+			return ConsumeLiteral("null");
+		default:
+			return ParseNumber(OutValue);
+		}
+	}
+
+	bool ParseObject(FJsonValue& OutValue, uint32_t InDepth)
+	{
+		++Cursor;
+		OutValue.Type = EJsonType::Object;
+
+		if (Consume('}'))
+		{
+			return true;
+		}
+
+		do
+		{
+			SkipWhitespace();
+			if (Cursor == End || *Cursor != '"')
+			{
+				return false;
+			}
+
+			OutValue.Members.emplace_back();
+			std::pair<std::string, FJsonValue>& Member = OutValue.Members.back();
+
+			if (ParseString(Member.first) == false || Consume(':') == false || ParseValue(Member.second, InDepth + 1) == false)
+			{
+				return false;
+			}
+		}
+		while (Consume(','));
+
+		return Consume('}');
+	}
+
+	bool ParseArray(FJsonValue& OutValue, uint32_t InDepth)
+	{
+		++Cursor;
+		OutValue.Type = EJsonType::Array;
+
+		if (Consume(']'))
+		{
+			return true;
+		}
+
+		do
+		{
+			OutValue.Elements.emplace_back();
+			if (ParseValue(OutValue.Elements.back(), InDepth + 1) == false)
+			{
+				return false;
+			}
+		}
+		while (Consume(','));
+
+		return Consume(']');
+	}
+
+	bool ParseHex4(uint32_t& OutCode)
+	{
+		if (End - Cursor < 4)
+		{
+			return false;
+		}
+
+		OutCode = 0;
+		for (int Idx = 0; Idx < 4; ++Idx)
+		{
+			char Char = *Cursor++;
+			OutCode <<= 4;
+
+			if (Char >= '0' && Char <= '9')
+			{
+				OutCode |= Char - '0';
+			}
+			else if (Char >= 'a' && Char <= 'f')
+			{
+				OutCode |= Char - 'a' + 10;
+			}
+			else if (Char >= 'A' && Char <= 'F')
+			{
+				OutCode |= Char - 'A' + 10;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void AppendUTF8(uint32_t InCode, std::string& OutString)
+	{
+		if (InCode < 0x80)
+		{
+			OutString += static_cast<char>(InCode);
+		}
+		else if (InCode < 0x800)
+		{
+			OutString += static_cast<char>(0xc0 | (InCode >> 6));
+			OutString += static_cast<char>(0x80 | (InCode & 0x3f));
+		}
+		else if (InCode < 0x10000)
+		{
+			OutString += static_cast<char>(0xe0 | (InCode >> 12));
+			OutString += static_cast<char>(0x80 | ((InCode >> 6) & 0x3f));
+			OutString += static_cast<char>(0x80 | (InCode & 0x3f));
+		}
+		else
+		{
+			OutString += static_cast<char>(0xf0 | (InCode >> 18));
+			OutString += static_cast<char>(0x80 | ((InCode >> 12) & 0x3f));
+			OutString += static_cast<char>(0x80 | ((InCode >> 6) & 0x3f));
+			OutString += static_cast<char>(0x80 | (InCode & 0x3f));
+		}
+	}
+
+	bool ParseString(std::string& OutString)
+	{
+		++Cursor;
+
+		while (Cursor < End)
+		{
+			// Copies runs without escapes in one go.
+			const char* RunStart = Cursor;
+			while (Cursor < End && *Cursor != '"' && *Cursor != '\\' && static_cast<unsigned char>(*Cursor) >= 0x20)
+			{
+				++Cursor;
+			}
+			OutString.append(RunStart, Cursor);
+
+			if (Cursor == End || static_cast<unsigned char>(*Cursor) < 0x20)
+			{
+				return false;
+			}
+
+			if (*Cursor++ == '"')
+			{
+				return true;
+			}
+
+			if (Cursor == End)
+			{
+				return false;
+			}
+
+			switch (*Cursor++)
+			{
+			case '"': OutString += '"'; break;
+			case '\\': OutString += '\\'; break;
+			case '/': OutString += '/'; break;
+			case 'b': OutString += '\b'; break;
+			case 'f': OutString += '\f'; break;
+			case 'n': OutString += '\n'; break;
+			case 'r': OutString += '\r'; break;
+			case 't': OutString += '\t'; break;
+			case 'u':
+			{
+				uint32_t Code = 0;
+				if (ParseHex4(Code) == false)
+				{
+					return false;
+				}
+
+				// A high surrogate is only valid when the low half follows.
+				if (Code >= 0xd800 && Code < 0xdc00)
+				{
+					uint32_t LowCode = 0;
+					if (ConsumeLiteral("\\u") == false || ParseHex4(LowCode) == false || LowCode < 0xdc00 || LowCode >= 0xe000)
+					{
+						return false;
+					}
+
+					Code = 0x10000 + ((Code - 0xd800) << 10) + (LowCode - 0xdc00);
+				}
+				else if (Code >= 0xdc00 && Code < 0xe000)
+				{
+					return false;
+				}
+
+				AppendUTF8(Code, OutString);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	bool ParseNumber(FJsonValue& OutValue)
+	{
+		const char* Start = Cursor;
+		while (Cursor < End && ((*Cursor >= '0' && *Cursor <= '9') || *Cursor == '-' || *Cursor == '+' || *Cursor == '.' || *Cursor == 'e' || *Cursor == 'E'))
+		{
+			++Cursor;
+		}
+
+		// strtod needs a terminated string, and the input need not be one.
+		char Buffer[64];
+		size_t Length = static_cast<size_t>(Cursor - Start);
+		if (Length == 0 || Length >= sizeof(Buffer))
+		{
+			return false;
+		}
+
+		memcpy(Buffer, Start, Length);
+		Buffer[Length] = '\0';
+
+		char* NumberEnd = nullptr;
+		OutValue.Type = EJsonType::Number;
+		OutValue.Number = strtod(Buffer, &NumberEnd);
+
+		return NumberEnd == Buffer + Length;
+	}
+
+	const char* Cursor;
+	const char* End;
+};
+
+bool FJsonValue::Parse(const char* InData, size_t InSize, FJsonValue& OutValue)
+{
+	OutValue = FJsonValue();
+
+	FJsonParser Parser(InData, InSize);
+	if (Parser.ParseDocument(OutValue) == false)
+	{
+		OutValue = FJsonValue();
+		return false;
+	}
+
+	return true;
+}
+
+static const FJsonValue NullJsonValue;
+
+const FJsonValue& FJsonValue::operator[](size_t InIndex) const
+{
+	if (Type == EJsonType::Array)
+	{
+		return InIndex < Elements.size() ? Elements[InIndex] : NullJsonValue;
+	}
+
+	if (Type == EJsonType::Object)
+	{
+		return InIndex < Members.size() ? Members[InIndex].second : NullJsonValue;
+	}
+
+	return NullJsonValue;
+}
+
+const FJsonValue& FJsonValue::operator[](std::string_view InName) const
+{
+	const FJsonValue* Member = Find(InName);
+	return Member != nullptr ? *Member : NullJsonValue;
+}
+
+const FJsonValue* FJsonValue::Find(std::string_view InName) const
+{
+	for (const std::pair<std::string, FJsonValue>& Member : Members)
+	{
+		if (Member.first == InName)
+		{
+			return &Member.second;
+		}
+	}
+
+	return nullptr;
+}
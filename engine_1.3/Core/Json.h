@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+enum class EJsonType : uint8_t
+{
+	Null,
+	Bool,
+	Number,
+	String,
+	Array,
+	Object,
+};
+
+// Parsed JSON document. Objects keep their members in file order; lookups are linear, which is fine for the small
+// objects of asset descriptions such as glTF.
+class FJsonValue
+{
+public:
+	// Fails on malformed input, leaving OutValue null.
+	static bool Parse(const char* InData, size_t InSize, FJsonValue& OutValue);
+
+	EJsonType GetType() const { return Type; }
+
+	bool IsNull() const { return Type == EJsonType::Null; }
+	bool IsNumber() const { return Type == EJsonType::Number; }
+	bool IsString() const { return Type == EJsonType::String; }
+	bool IsArray() const { return Type == EJsonType::Array; }
+	bool IsObject() const { return Type == EJsonType::Object; }
+
+	// The accessors return InDefault when the value has another type.
+	bool GetBool(bool InDefault = false) const { return Type == EJsonType::Bool ? bBool : InDefault; }
+	double GetNumber(double InDefault = 0.0) const { return Type == EJsonType::Number ? Number : InDefault; }
+	int64_t GetInt(int64_t InDefault = 0) const { return Type == EJsonType::Number ? static_cast<int64_t>(Number) : InDefault; }
+	const std::string& GetString() const { return String; }
+
+	// Array elements, or object members in file order.
+	size_t GetSize() const { return Type == EJsonType::Array ? Elements.size() : (Type == EJsonType::Object ? Members.size() : 0); }
+	const FJsonValue& operator[](size_t InIndex) const;
+
+	// Returns a null value for a missing member, so lookups can be chained.
+	const FJsonValue& operator[](std::string_view InName) const;
+	const FJsonValue* Find(std::string_view InName) const;
+
+	const std::vector<std::pair<std::string, FJsonValue>>& GetMembers() const { return Members; }
+
+private:
+	friend class FJsonParser;
+
+	EJsonType Type = EJsonType::Null;
+	bool bBool = false;
+	double Number = 0.0;
+	std::string String;
+	std::vector<FJsonValue> Elements;
+	std::vector<std::pair<std::string, FJsonValue>> Members;
+};
@@ -0,0 +1,217 @@
+#include "LZ4.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+static constexpr size_t MinMatch = 4;
+// The block format ends with at least this many literals, and no match may start within MatchStartLimit bytes of the end.
+static constexpr size_t LastLiterals = 5;
+static constexpr size_t MatchStartLimit = 12;
+static constexpr size_t MaxOffset = 65535;
+static constexpr uint32_t HashBits = 16;
+
+static uint32_t Read32(const uint8_t* InData)
+{
+	uint32_t Value;
+	memcpy(&Value, InData, sizeof(Value));
+	return Value;
+}
+
+static uint32_t HashSequence(uint32_t InSequence)
+{
+	return (InSequence * 2654435761U) >> (32 - HashBits);
+}
+
+static uint8_t* WriteLength(uint8_t* OutData, size_t InLength)
+{
+	while (InLength >= 255)
+	{
+		*OutData++ = 255;
+		InLength -= 255;
+	}
+
+	*OutData++ = static_cast<uint8_t>(InLength);
+	return OutData;
+}
+
+static uint8_t* WriteSequence(uint8_t* OutData, const uint8_t* InLiterals, size_t InNumLiterals, size_t InOffset, size_t InMatchLength)
+{
+	uint8_t* Token = OutData++;
+	*Token = static_cast<uint8_t>(std::min<size_t>(InNumLiterals, 15) << 4);
+
+	if (InNumLiterals >= 15)
+	{
+		OutData = WriteLength(OutData, InNumLiterals - 15);
+	}
+
+	memcpy(OutData, InLiterals, InNumLiterals);
+	OutData += InNumLiterals;
+
+	// The last sequence carries literals only.
+	if (InMatchLength == 0)
+	{
+		return OutData;
+	}
+
+	*OutData++ = static_cast<uint8_t>(InOffset & 0xFF);
+	*OutData++ = static_cast<uint8_t>(InOffset >> 8);
+
+	size_t MatchCode = InMatchLength - MinMatch;
+	*Token |= static_cast<uint8_t>(std::min<size_t>(MatchCode, 15));
+
+	if (MatchCode >= 15)
+	{
+		OutData = WriteLength(OutData, MatchCode - 15);
+	}
+
+	return OutData;
+}
+
+size_t FLZ4::Compress(const uint8_t* InData, size_t InSize, uint8_t* OutData, size_t OutCapacity)
+{
+	if (OutCapacity < GetMaxCompressedSize(InSize))
+	{
+		return 0;
+	}
+
+	// An empty block is a lone token. InData may be null then, which memcpy must not see even for zero bytes.
+	if (InSize == 0)
+	{
+		OutData[0] = 0;
+		return 1;
+	}
+
+	uint8_t* Out = OutData;
+	size_t Anchor = 0;
+
+	// Positions are kept as 32 bits, so larger inputs are stored as literals.
+	if (InSize > MatchStartLimit && InSize < UINT32_MAX)
+	{
+		std::vector<uint32_t> Table(size_t(1) << HashBits, UINT32_MAX);
+
+		const size_t MatchEndLimit = InSize - LastLiterals;
+		size_t Pos = 0;
+
+		while (Pos + MatchStartLimit <= InSize)
+		{
+			uint32_t Sequence = Read32(InData + Pos);
+			uint32_t& Slot = Table[HashSequence(Sequence)];
+			size_t Candidate = Slot;
+			Slot = static_cast<uint32_t>(Pos);
+
+			if (Candidate == UINT32_MAX || Pos - Candidate > MaxOffset || Read32(InData + Candidate) != Sequence)
+			{
+				++Pos;
+				continue;
+			}
+
+			size_t MatchLength = MinMatch;
+			while (Pos + MatchLength < MatchEndLimit && InData[Candidate + MatchLength] == InData[Pos + MatchLength])
+			{
+				++MatchLength;
+			}
+
+			Out = WriteSequence(Out, InData + Anchor, Pos - Anchor, Pos - Candidate, MatchLength);
+
+			Pos += MatchLength;
+			Anchor = Pos;
+		}
+	}
+
+	Out = WriteSequence(Out, InData + Anchor, InSize - Anchor, 0, 0);
+
+	return static_cast<size_t>(Out - OutData);
+}
+
+bool FLZ4::Decompress(const uint8_t* InData, size_t InSize, uint8_t* OutData, size_t InDecompressedSize)
+{
+	// OutData may be null for an empty block, so nothing is copied.
+	if (InDecompressedSize == 0)
+	{
+		return InSize == 0 || (InSize == 1 && InData[0] == 0);
+	}
+
+	const uint8_t* In = InData;
+	const uint8_t* InEnd = InData + InSize;
+	size_t OutPos = 0;
+
+	auto ReadLength = [&In, InEnd](size_t& InOutLength)
+	{
+		uint8_t Byte;
+		do
+		{
+			if (In == InEnd)
+			{
+				return false;
+			}
+
+			Byte = *In++;
+			InOutLength += Byte;
+		} while (Byte == 255);
+
+		return true;
+	};
+
+	while (In < InEnd)
+	{
+		uint8_t Token = *In++;
+
+		size_t NumLiterals = Token >> 4;
+		if (NumLiterals == 15 && ReadLength(NumLiterals) == false)
+		{
+			return false;
+		}
+
+		if (NumLiterals > static_cast<size_t>(InEnd - In) || NumLiterals > InDecompressedSize - OutPos)
+		{
+			return false;
+		}
+
+		memcpy(OutData + OutPos, In, NumLiterals);
+		In += NumLiterals;
+		OutPos += NumLiterals;
+
+		if (In == InEnd)
+		{
+			break;
+		}
+
+		if (InEnd - In < 2)
+		{
+			return false;
+		}
+
+		size_t Offset = In[0] | (static_cast<size_t>(In[1]) << 8);
+		In += 2;
+
+		size_t MatchLength = Token & 15;
+		if (MatchLength == 15 && ReadLength(MatchLength) == false)
+		{
+			return false;
+		}
+		MatchLength += MinMatch;
+
+		if (Offset == 0 || Offset > OutPos || MatchLength > InDecompressedSize - OutPos)
+		{
+			return false;
+		}
+
+		const uint8_t* Match = OutData + OutPos - Offset;
+		if (Offset >= MatchLength)
+		{
+			memcpy(OutData + OutPos, Match, MatchLength);
+		}
+		else
+		{
+			// The match overlaps the bytes it produces, so it repeats the last Offset bytes.
+			for (size_t Idx = 0; Idx < MatchLength; ++Idx)
+			{
+				OutData[OutPos + Idx] = Match[Idx];
+			}
+		}
+		OutPos += MatchLength;
+	}
+
+	return OutPos == InDecompressedSize;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 block format, compatible with LZ4_compress_default and LZ4_decompress_safe. Used for pak entries, where
+// decompression speed matters far more than ratio, so the compressor is a plain greedy single-hash matcher.
+class FLZ4
+{
+public:
+	// Worst case size of InSize bytes after compression.
+	static size_t GetMaxCompressedSize(size_t InSize) { return InSize + InSize / 255 + 16; }
+
+	// Returns the compressed size, or 0 when OutCapacity is below GetMaxCompressedSize.
+	static size_t Compress(const uint8_t* InData, size_t InSize, uint8_t* OutData, size_t OutCapacity);
+
+	// Fails on malformed input or when the block does not decompress to exactly InDecompressedSize bytes.
+	static bool Decompress(const uint8_t* InData, size_t InSize, uint8_t* OutData, size_t InDecompressedSize);
+};
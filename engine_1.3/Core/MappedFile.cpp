@@ -0,0 +1,141 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+FMappedFile::FMappedFile()
+	: Data(nullptr)
+	, Size(0)
+#ifdef _WIN32
+	, FileHandle(INVALID_HANDLE_VALUE)
+	, MappingHandle(nullptr)
+#else
+	, FileDescriptor(-1)
+#endif
+{
+}
+
+FMappedFile::~FMappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool FMappedFile::Open(const std::string& InFilename)
+{
+	Close();
+
+	FileHandle = CreateFileA(InFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (FileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER FileSize;
+	if (GetFileSizeEx(FileHandle, &FileSize) == FALSE || FileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (MappingHandle == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (Data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	Size = static_cast<size_t>(FileSize.QuadPart);
+
+	return true;
+}
+
+void FMappedFile::Close()
+{
+	if (Data != nullptr)
+	{
+		UnmapViewOfFile(Data);
+		Data = nullptr;
+	}
+
+	if (MappingHandle != nullptr)
+	{
+		CloseHandle(MappingHandle);
+		MappingHandle = nullptr;
+	}
+
+	if (FileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(FileHandle);
+		FileHandle = INVALID_HANDLE_VALUE;
+	}
+
+	Size = 0;
+}
+
+#else
+
+bool FMappedFile::Open(const std::string& InFilename)
+{
+	Close();
+
+	FileDescriptor = open(InFilename.c_str(), O_RDONLY);
+	if (FileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat FileStat;
+	if (fstat(FileDescriptor, &FileStat) != 0 || FileStat.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* Mapped = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+	if (Mapped == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(Mapped);
+	Size = static_cast<size_t>(FileStat.st_size);
+
+	return true;
+}
+
+void FMappedFile::Close()
+{
+	if (Data != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(Data), Size);
+		Data = nullptr;
+	}
+
+	if (FileDescriptor >= 0)
+	{
+		close(FileDescriptor);
+		FileDescriptor = -1;
+	}
+
+	Size = 0;
+}
+
+#endif
@@ -3,16 +3,39 @@
 
 #include "VulkanContext.h"
 #include "VulkanMesh.h"
+#include "VulkanMeshRenderer.h"
+
+#include "Config.h"
+#include "FileSystem.h"
+#include "GLTFImporter.h"
+#include "MeshOptimizer.h"
+#include "ObjParser.h"
+#include "Utils.h"
 
 #include "assimp/Importer.hpp"
+#include "assimp/IOSystem.hpp"
+#include "assimp/IOStream.hpp"
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
 #include "glm/glm.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 UMesh::UMesh()
 	: UAsset()
-	, Material(nullptr)
+	, VertexData(nullptr)
+	, NumVertices(0)
+	, IndexData(nullptr)
+	, NumIndices(0)
+	, SubmeshData(nullptr)
+	, NumSubmeshes(0)
+	, NumSourceMaterialSlots(0)
+	, VertexFormat(EVertexFormat::Float)
 	, RenderMesh(nullptr)
 {
 
@@ -23,104 +46,245 @@ UMesh::~UMesh()
 	DestroyRenderMesh();
 }
 
-static aiMesh* FindFirstMesh(const aiScene* InScene, const aiNode* InNode)
+struct FMeshPart
+{
+	const aiMesh* Mesh;
+	aiMatrix4x4 Transform;
+};
+
+static void CollectMeshParts(const aiScene* InScene, const aiNode* InNode, const aiMatrix4x4& InParentTransform, std::vector<FMeshPart>& OutParts)
 {
-	for (int Idx = 0; Idx < InNode->mNumMeshes; ++Idx)
+	aiMatrix4x4 Transform = InParentTransform * InNode->mTransformation;
+
+	for (uint32_t Idx = 0; Idx < InNode->mNumMeshes; ++Idx)
 	{
-		aiMesh* Mesh = InScene->mMeshes[InNode->mMeshes[Idx]];
-		if (Mesh != nullptr)
+		const aiMesh* Mesh = InScene->mMeshes[InNode->mMeshes[Idx]];
+		if (Mesh != nullptr && Mesh->mNumVertices > 0 && Mesh->mNumFaces > 0)
 		{
-			return Mesh;
+			OutParts.push_back({ Mesh, Transform });
 		}
 	}
 
-	for (int Idx = 0; Idx < InNode->mNumChildren; ++Idx)
+	for (uint32_t Idx = 0; Idx < InNode->mNumChildren; ++Idx)
 	{
-		aiNode* ChildNode = InNode->mChildren[Idx];
-		if (ChildNode == nullptr)
+		if (InNode->mChildren[Idx] != nullptr)
 		{
-			continue;
+			CollectMeshParts(InScene, InNode->mChildren[Idx], Transform, OutParts);
 		}
+	}
+}
 
-		aiMesh* FoundMesh = FindFirstMesh(InScene, ChildNode);
-		if (FoundMesh != nullptr)
+// Lets assimp read the source and the files it references, such as OBJ material libraries, through GFileSystem.
+class FMeshIOStream : public Assimp::IOStream
+{
+public:
+	bool Open(const std::string& InFilename) { return View.Open(InFilename); }
+
+	size_t Read(void* OutBuffer, size_t InSize, size_t InCount) override
+	{
+		if (InSize == 0)
 		{
-			return FoundMesh;
+			return 0;
 		}
+
+		size_t Count = std::min(InCount, (View.GetSize() - Position) / InSize);
+		if (Count > 0)
+		{
+			memcpy(OutBuffer, View.GetData() + Position, Count * InSize);
+			Position += Count * InSize;
+		}
+
+		return Count;
 	}
 
-	return nullptr;
-}
+	size_t Write(const void* InBuffer, size_t InSize, size_t InCount) override { return 0; }
 
-bool UMesh::Load(const std::string& InFilename)
+	aiReturn Seek(size_t InOffset, aiOrigin InOrigin) override
+	{
+		size_t Base = InOrigin == aiOrigin_CUR ? Position : (InOrigin == aiOrigin_END ? View.GetSize() : 0);
+		size_t NewPosition = Base + InOffset;
+		if (NewPosition > View.GetSize())
+		{
+			return aiReturn_FAILURE;
+		}
+
+		Position = NewPosition;
+		return aiReturn_SUCCESS;
+	}
+
+	size_t Tell() const override { return Position; }
+	size_t FileSize() const override { return View.GetSize(); }
+	void Flush() override {}
+
+private:
+	FFileView View;
+	size_t Position = 0;
+};
+
+class FMeshIOSystem : public Assimp::IOSystem
 {
-	Assimp::Importer Importer;
-	const aiScene* Scene = Importer.ReadFile(InFilename, aiProcess_Triangulate | aiProcess_FlipUVs);
-	if (Scene == nullptr)
+public:
+	bool Exists(const char* InFilename) const override
 	{
-		return false;
+		return GFileSystem != nullptr ? GFileSystem->Exists(InFilename) : FFileView().Open(InFilename);
 	}
 
-	aiNode* RootNode = Scene->mRootNode;
-	if (RootNode == nullptr)
+	char getOsSeparator() const override { return '/'; }
+
+	Assimp::IOStream* Open(const char* InFilename, const char* InMode) override
 	{
-		return false;
+		if (strchr(InMode, 'w') != nullptr || strchr(InMode, 'a') != nullptr)
+		{
+			return nullptr;
+		}
+
+		FMeshIOStream* Stream = new FMeshIOStream();
+		if (Stream->Open(InFilename) == false)
+		{
+			delete Stream;
+			return nullptr;
+		}
+
+		return Stream;
 	}
 
-	aiMesh* Mesh = FindFirstMesh(Scene, RootNode);
-	if (Mesh == nullptr)
+	void Close(Assimp::IOStream* InStream) override { delete InStream; }
+};
+
+static glm::mat4 ToGLM(const aiMatrix4x4& InMatrix)
+{
+	// Assimp matrices are row-major.
+	return glm::transpose(glm::make_mat4(&InMatrix.a1));
+}
+
+bool UMesh::Load(const std::string& InFilename)
+{
+	if (LoadData(InFilename) == false)
 	{
 		return false;
 	}
 
-	bool bHasTexCoords = Mesh->HasTextureCoords(0);
-	bool bHasNormals = Mesh->HasNormals();
-	bool bHasTangents = Mesh->HasTangentsAndBitangents();
+	CreateRenderResources();
 
-	for (int Idx = 0; Idx < Mesh->mNumVertices; ++Idx)
-	{
-		const aiVector3D& PositionData = Mesh->mVertices[Idx];
+	return true;
+}
 
-		FVertex NewVertex;
-		NewVertex.Position = glm::vec3(PositionData.x, PositionData.y, PositionData.z);
+bool UMesh::LoadData(const std::string& InFilename)
+{
+	Vertices.clear();
+	Indices.clear();
+	Submeshes.clear();
+	Cache.Close();
+
+	bool bCookedDataOnly = IsCookedDataOnly();
 
-		if (bHasNormals)
+	uint64_t SourceHash = FMeshCache::AnySourceHash;
+	if (bCookedDataOnly == false)
+	{
+		FFileView SourceFile;
+		if (SourceFile.Open(InFilename) == false)
 		{
-			const aiVector3D& NormalData = Mesh->mNormals[Idx];
-			NewVertex.Normal = glm::vec3(NormalData.x, NormalData.y, NormalData.z);
+			return false;
 		}
 
-		if (bHasTexCoords)
+		SourceHash = HashBytes(SourceFile.GetData(), SourceFile.GetSize());
+
+		// A .gltf keeps its geometry in separate buffers, which the cache has to follow as well.
+		std::vector<std::string> BufferURIs;
+		if (FGLTFImporter::IsGLTFFile(InFilename) && FGLTFImporter::GetBufferURIs(InFilename, BufferURIs))
 		{
-			const aiVector3D& TexCoordsData = Mesh->mTextureCoords[0][Idx];
-			NewVertex.TexCoords = glm::vec2(TexCoordsData.x, TexCoordsData.y);
+			std::string Directory = InFilename.substr(0, InFilename.find_last_of("/\\") + 1);
+
+			for (const std::string& BufferURI : BufferURIs)
+			{
+				FFileView BufferFile;
+				if (BufferFile.Open(Directory + BufferURI))
+				{
+					SourceHash = HashBytes(BufferFile.GetData(), BufferFile.GetSize(), SourceHash);
+				}
+			}
 		}
+	}
 
-		if (bHasTangents)
+	std::string CachePath = FMeshCache::GetCachePath(InFilename);
+
+	if (Cache.Open(CachePath, SourceHash))
+	{
+		VertexData = Cache.GetVertices();
+		NumVertices = Cache.GetNumVertices();
+		IndexData = Cache.GetIndices();
+		NumIndices = Cache.GetNumIndices();
+		SubmeshData = Cache.GetSubmeshes();
+		NumSubmeshes = Cache.GetNumSubmeshes();
+		Bounds = Cache.GetBounds();
+
+		NumSourceMaterialSlots = Cache.GetNumMaterialSlots();
+	}
+	else if (bCookedDataOnly)
+	{
+		return false;
+	}
+	else
+	{
+		if (Import(InFilename, NumSourceMaterialSlots) == false)
 		{
-			const aiVector3D& TangentData = Mesh->mTangents[Idx];
-			NewVertex.Tangent = glm::vec3(TangentData.x, TangentData.y, TangentData.z);
+			return false;
 		}
 
-		Vertices.push_back(NewVertex);
+		Bounds = FBoundingSphere::FromVertices(Vertices);
+
+		FMeshCache::Write(CachePath, SourceHash, Vertices.data(), static_cast<uint32_t>(Vertices.size()), Indices.data(), static_cast<uint32_t>(Indices.size()), Submeshes, NumSourceMaterialSlots, Bounds);
+
+		VertexData = Vertices.data();
+		NumVertices = static_cast<uint32_t>(Vertices.size());
+		IndexData = Indices.data();
+		NumIndices = static_cast<uint32_t>(Indices.size());
+		SubmeshData = Submeshes.data();
+		NumSubmeshes = static_cast<uint32_t>(Submeshes.size());
 	}
 
-	for (int FaceIdx = 0; FaceIdx < Mesh->mNumFaces; ++FaceIdx)
+	SourceFilename = InFilename;
+
+	return true;
+}
+
+void UMesh::CreateRenderResources()
+{
+	// Materials assigned before loading carry over; slots the import added start with the first slot's material.
+	// The slots are resized here rather than in LoadData because materials are assigned on the render thread.
+	Materials.resize(std::max(NumSourceMaterialSlots, 1U), Materials.empty() ? nullptr : Materials[0]);
+
+	CreateRenderMesh();
+}
+
+struct FMeshImportStats
+{
+	FVertexCacheStats Source;
+	FVertexCacheStats Optimized;
+};
+
+// Welds and optimizes the geometry of one submesh and appends it to the mesh arrays.
+static void AppendSubmesh(std::vector<FVertex>& InPartVertices, std::vector<uint32_t>& InPartIndices, bool bInHasTangents, uint32_t InMaterialSlot, std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices, std::vector<FSubmesh>& OutSubmeshes, FMeshImportStats& OutStats)
+{
+	if (InPartIndices.empty())
 	{
-		const aiFace& Face = Mesh->mFaces[FaceIdx];
-		for (int Idx = 0; Idx < Face.mNumIndices; ++Idx)
-		{
-			Indices.push_back(Face.mIndices[Idx]);
-		}
+		return;
 	}
 
-	if (bHasTangents == false)
+	FVertexCacheStats PartSourceStats = FMeshOptimizer::AnalyzeVertexCache(InPartIndices.data(), InPartIndices.size(), static_cast<uint32_t>(InPartVertices.size()));
+
+	// Welding before the tangents are generated lets faces sharing a corner accumulate into one smooth tangent.
+	FMeshOptimizer::WeldVertices(InPartVertices, InPartIndices);
+
+	if (bInHasTangents == false)
 	{
-		for (int Idx = 0; Idx < Indices.size(); Idx += 3)
+		std::vector<glm::vec3> Bitangents(InPartVertices.size(), glm::vec3(0.0f));
+
+		for (size_t Idx = 0; Idx < InPartIndices.size(); Idx += 3)
 		{
-			FVertex& V0 = Vertices[Indices[Idx]];
-			FVertex& V1 = Vertices[Indices[Idx + 1]];
-			FVertex& V2 = Vertices[Indices[Idx + 2]];
+			FVertex& V0 = InPartVertices[InPartIndices[Idx]];
+			FVertex& V1 = InPartVertices[InPartIndices[Idx + 1]];
+			FVertex& V2 = InPartVertices[InPartIndices[Idx + 2]];
 
 			glm::vec3 DeltaPos1 = V1.Position - V0.Position;
 			glm::vec3 DeltaPos2 = V2.Position - V0.Position;
@@ -135,34 +299,408 @@ bool UMesh::Load(const std::string& InFilename)
 			Tangent.z = (DeltaUV2.y * DeltaPos1.z - DeltaUV1.y * DeltaPos2.z) * R;
 			Tangent = normalize(Tangent);
 
-			V0.Tangent += Tangent;
-			V1.Tangent += Tangent;
-			V2.Tangent += Tangent;
+			glm::vec3 Bitangent = (DeltaUV1.x * DeltaPos2 - DeltaUV2.x * DeltaPos1) * R;
+
+			V0.Tangent += glm::vec4(Tangent, 0.0f);
+			V1.Tangent += glm::vec4(Tangent, 0.0f);
+			V2.Tangent += glm::vec4(Tangent, 0.0f);
+
+			Bitangents[InPartIndices[Idx]] += Bitangent;
+			Bitangents[InPartIndices[Idx + 1]] += Bitangent;
+			Bitangents[InPartIndices[Idx + 2]] += Bitangent;
+		}
+
+		// Mirrored texture coordinates flip the bitangent against cross(Normal, Tangent).
+		for (size_t Idx = 0; Idx < InPartVertices.size(); ++Idx)
+		{
+			FVertex& Vertex = InPartVertices[Idx];
+			Vertex.Tangent.w = glm::dot(glm::cross(Vertex.Normal, glm::vec3(Vertex.Tangent)), Bitangents[Idx]) < 0.0f ? -1.0f : 1.0f;
 		}
 	}
 
-	CreateRenderMesh();
+	uint32_t NumPartVertices = static_cast<uint32_t>(InPartVertices.size());
+	FMeshOptimizer::OptimizeVertexCache(InPartIndices.data(), InPartIndices.size(), NumPartVertices);
+	FMeshOptimizer::OptimizeOverdraw(InPartIndices.data(), InPartIndices.size(), InPartVertices.data(), NumPartVertices);
+	FMeshOptimizer::OptimizeVertexFetch(InPartVertices, InPartIndices.data(), InPartIndices.size());
+
+	FVertexCacheStats PartOptimizedStats = FMeshOptimizer::AnalyzeVertexCache(InPartIndices.data(), InPartIndices.size(), static_cast<uint32_t>(InPartVertices.size()));
+
+	OutStats.Source.NumTriangles += PartSourceStats.NumTriangles;
+	OutStats.Source.NumVertices += PartSourceStats.NumVertices;
+	OutStats.Source.NumTransformedVertices += PartSourceStats.NumTransformedVertices;
+	OutStats.Optimized.NumTriangles += PartOptimizedStats.NumTriangles;
+	OutStats.Optimized.NumVertices += PartOptimizedStats.NumVertices;
+	OutStats.Optimized.NumTransformedVertices += PartOptimizedStats.NumTransformedVertices;
+
+	FSubmesh Submesh;
+	Submesh.FirstIndex = static_cast<uint32_t>(OutIndices.size());
+	Submesh.NumIndices = static_cast<uint32_t>(InPartIndices.size());
+	Submesh.VertexOffset = static_cast<uint32_t>(OutVertices.size());
+	Submesh.NumVertices = static_cast<uint32_t>(InPartVertices.size());
+	Submesh.MaterialSlot = InMaterialSlot;
+	Submesh.Bounds = FBoundingSphere::FromVertices(InPartVertices);
+	OutSubmeshes.push_back(Submesh);
+
+	OutVertices.insert(OutVertices.end(), InPartVertices.begin(), InPartVertices.end());
+	OutIndices.insert(OutIndices.end(), InPartIndices.begin(), InPartIndices.end());
+}
+
+static bool ImportWithAssimp(const std::string& InFilename, std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices, std::vector<FSubmesh>& OutSubmeshes, uint32_t& OutNumMaterialSlots, FMeshImportStats& OutStats)
+{
+	Assimp::Importer Importer;
+	Importer.SetIOHandler(new FMeshIOSystem());
+	const aiScene* Scene = Importer.ReadFile(InFilename, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_SortByPType);
+	if (Scene == nullptr)
+	{
+		return false;
+	}
+
+	aiNode* RootNode = Scene->mRootNode;
+	if (RootNode == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<FMeshPart> Parts;
+	CollectMeshParts(Scene, RootNode, aiMatrix4x4(), Parts);
+	if (Parts.empty())
+	{
+		return false;
+	}
+
+	// Parts sharing a material become neighbouring submeshes so the renderer can keep its bindings between them.
+	std::stable_sort(Parts.begin(), Parts.end(), [](const FMeshPart& A, const FMeshPart& B) { return A.Mesh->mMaterialIndex < B.Mesh->mMaterialIndex; });
+
+	size_t TotalVertices = 0;
+	size_t TotalIndices = 0;
+	for (const FMeshPart& Part : Parts)
+	{
+		TotalVertices += Part.Mesh->mNumVertices;
+		TotalIndices += static_cast<size_t>(Part.Mesh->mNumFaces) * 3;
+	}
+
+	OutVertices.reserve(TotalVertices);
+	OutIndices.reserve(TotalIndices);
+	OutSubmeshes.reserve(Parts.size());
+
+	std::vector<FVertex> PartVertices;
+	std::vector<uint32_t> PartIndices;
+
+	for (const FMeshPart& Part : Parts)
+	{
+		const aiMesh* Mesh = Part.Mesh;
+
+		// Node transforms are baked into the vertices so every submesh shares the model matrix of the instance.
+		glm::mat4 Transform = ToGLM(Part.Transform);
+		glm::mat3 NormalMatrix = glm::transpose(glm::inverse(glm::mat3(Transform)));
+		// A mirroring transform flips the handedness of the tangent frame.
+		float TransformHandedness = glm::determinant(glm::mat3(Transform)) < 0.0f ? -1.0f : 1.0f;
+
+		bool bHasTexCoords = Mesh->HasTextureCoords(0);
+		bool bHasNormals = Mesh->HasNormals();
+		bool bHasTangents = Mesh->HasTangentsAndBitangents();
+
+		PartVertices.assign(Mesh->mNumVertices, FVertex{});
+		PartIndices.clear();
+
+		for (uint32_t Idx = 0; Idx < Mesh->mNumVertices; ++Idx)
+		{
+			const aiVector3D& PositionData = Mesh->mVertices[Idx];
+
+			FVertex& NewVertex = PartVertices[Idx];
+			NewVertex.Position = glm::vec3(Transform * glm::vec4(PositionData.x, PositionData.y, PositionData.z, 1.0f));
+
+			if (bHasNormals)
+			{
+				const aiVector3D& NormalData = Mesh->mNormals[Idx];
+				NewVertex.Normal = glm::normalize(NormalMatrix * glm::vec3(NormalData.x, NormalData.y, NormalData.z));
+			}
+
+			if (bHasTexCoords)
+			{
+				const aiVector3D& TexCoordsData = Mesh->mTextureCoords[0][Idx];
+				NewVertex.TexCoords = glm::vec2(TexCoordsData.x, TexCoordsData.y);
+			}
+
+			if (bHasTangents)
+			{
+				const aiVector3D& TangentData = Mesh->mTangents[Idx];
+				const aiVector3D& BitangentData = Mesh->mBitangents[Idx];
+				const aiVector3D& NormalData = bHasNormals ? Mesh->mNormals[Idx] : aiVector3D(0.0f, 0.0f, 1.0f);
+
+				glm::vec3 Tangent(TangentData.x, TangentData.y, TangentData.z);
+				glm::vec3 Bitangent(BitangentData.x, BitangentData.y, BitangentData.z);
+				float Handedness = glm::dot(glm::cross(glm::vec3(NormalData.x, NormalData.y, NormalData.z), Tangent), Bitangent) < 0.0f ? -1.0f : 1.0f;
+
+				NewVertex.Tangent = glm::vec4(glm::mat3(Transform) * Tangent, Handedness * TransformHandedness);
+			}
+		}
+
+		for (uint32_t FaceIdx = 0; FaceIdx < Mesh->mNumFaces; ++FaceIdx)
+		{
+			const aiFace& Face = Mesh->mFaces[FaceIdx];
+			if (Face.mNumIndices != 3)
+			{
+				continue;
+			}
+
+			PartIndices.insert(PartIndices.end(), Face.mIndices, Face.mIndices + 3);
+		}
+
+		AppendSubmesh(PartVertices, PartIndices, bHasTangents, Mesh->mMaterialIndex, OutVertices, OutIndices, OutSubmeshes, OutStats);
+	}
+
+	OutNumMaterialSlots = std::max(Scene->mNumMaterials, 1U);
+
+	return true;
+}
+
+static bool ImportGLTF(const std::string& InFilename, std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices, std::vector<FSubmesh>& OutSubmeshes, uint32_t& OutNumMaterialSlots, FMeshImportStats& OutStats)
+{
+	FGLTFImporter Importer;
+	std::vector<FGLTFPrimitive> Primitives;
+	if (Importer.Open(InFilename) == false || Importer.ImportPrimitives(Primitives) == false)
+	{
+		return false;
+	}
+
+	std::stable_sort(Primitives.begin(), Primitives.end(), [](const FGLTFPrimitive& A, const FGLTFPrimitive& B) { return A.MaterialIndex < B.MaterialIndex; });
+
+	size_t TotalVertices = 0;
+	size_t TotalIndices = 0;
+	for (const FGLTFPrimitive& Primitive : Primitives)
+	{
+		TotalVertices += Primitive.Vertices.size();
+		TotalIndices += Primitive.Indices.size();
+	}
+
+	OutVertices.reserve(TotalVertices);
+	OutIndices.reserve(TotalIndices);
+	OutSubmeshes.reserve(Primitives.size());
+
+	for (FGLTFPrimitive& Primitive : Primitives)
+	{
+		AppendSubmesh(Primitive.Vertices, Primitive.Indices, Primitive.bHasTangents, Primitive.MaterialIndex, OutVertices, OutIndices, OutSubmeshes, OutStats);
+	}
+
+	// Primitives without a material sorted last, into the slot after the file's materials.
+	OutNumMaterialSlots = std::max({ Importer.GetNumMaterials(), Primitives.back().MaterialIndex + 1, 1U });
+
+	return true;
+}
+
+static bool ImportOBJ(const std::string& InFilename, std::vector<FVertex>& OutVertices, std::vector<uint32_t>& OutIndices, std::vector<FSubmesh>& OutSubmeshes, uint32_t& OutNumMaterialSlots, FMeshImportStats& OutStats)
+{
+	FObjParser Parser;
+	if (Parser.Parse(InFilename) == false)
+	{
+		return false;
+	}
+
+	const std::vector<FVertex>& ObjVertices = Parser.GetVertices();
+	const std::vector<uint32_t>& ObjIndices = Parser.GetIndices();
+	const std::vector<FObjGroup>& Groups = Parser.GetGroups();
+
+	OutVertices.reserve(ObjVertices.size());
+	OutIndices.reserve(ObjIndices.size());
+	OutSubmeshes.reserve(Groups.size());
+
+	// Groups share the parser's vertices, so each one is renumbered from zero in the order it first uses them.
+	std::vector<uint32_t> Remap(ObjVertices.size(), UINT32_MAX);
+
+	std::vector<FVertex> PartVertices;
+	std::vector<uint32_t> PartIndices;
+
+	for (size_t GroupIdx = 0; GroupIdx < Groups.size(); ++GroupIdx)
+	{
+		const FObjGroup& Group = Groups[GroupIdx];
+		const uint32_t* GroupIndices = ObjIndices.data() + Group.FirstIndex;
+
+		PartVertices.clear();
+		PartIndices.resize(Group.NumIndices);
+
+		for (uint32_t Idx = 0; Idx < Group.NumIndices; ++Idx)
+		{
+			uint32_t& PartIndex = Remap[GroupIndices[Idx]];
+			if (PartIndex == UINT32_MAX)
+			{
+				PartIndex = static_cast<uint32_t>(PartVertices.size());
+				PartVertices.push_back(ObjVertices[GroupIndices[Idx]]);
+
+				// OBJ texture coordinates point up, as assimp's FlipUVs corrected for the other formats.
+				PartVertices.back().TexCoords.y = 1.0f - PartVertices.back().TexCoords.y;
+			}
+
+			PartIndices[Idx] = PartIndex;
+		}
+
+		for (uint32_t Idx = 0; Idx < Group.NumIndices; ++Idx)
+		{
+			Remap[GroupIndices[Idx]] = UINT32_MAX;
+		}
+
+		// Scans often come without normals; area weighted face normals make them smooth.
+		if (Parser.HasNormals() == false)
+		{
+			for (size_t Idx = 0; Idx < PartIndices.size(); Idx += 3)
+			{
+				FVertex& V0 = PartVertices[PartIndices[Idx]];
+				FVertex& V1 = PartVertices[PartIndices[Idx + 1]];
+				FVertex& V2 = PartVertices[PartIndices[Idx + 2]];
+
+				glm::vec3 FaceNormal = glm::cross(V1.Position - V0.Position, V2.Position - V0.Position);
+				V0.Normal += FaceNormal;
+				V1.Normal += FaceNormal;
+				V2.Normal += FaceNormal;
+			}
+
+			for (FVertex& Vertex : PartVertices)
+			{
+				float Length = glm::length(Vertex.Normal);
+				Vertex.Normal = Length > 0.0f ? Vertex.Normal / Length : glm::vec3(0.0f, 0.0f, 1.0f);
+			}
+		}
+
+		AppendSubmesh(PartVertices, PartIndices, false, static_cast<uint32_t>(GroupIdx), OutVertices, OutIndices, OutSubmeshes, OutStats);
+	}
+
+	OutNumMaterialSlots = std::max(static_cast<uint32_t>(Groups.size()), 1U);
 
 	return true;
 }
 
+bool UMesh::Import(const std::string& InFilename, uint32_t& OutNumMaterialSlots)
+{
+	auto StartTime = std::chrono::steady_clock::now();
+
+	// glTF and OBJ are read directly, which is several times faster than going through assimp's scene.
+	FMeshImportStats Stats;
+	bool bImported = false;
+	if (FGLTFImporter::IsGLTFFile(InFilename))
+	{
+		bImported = ImportGLTF(InFilename, Vertices, Indices, Submeshes, OutNumMaterialSlots, Stats);
+	}
+	else if (FObjParser::IsObjFile(InFilename))
+	{
+		bImported = ImportOBJ(InFilename, Vertices, Indices, Submeshes, OutNumMaterialSlots, Stats);
+	}
+	else
+	{
+		bImported = ImportWithAssimp(InFilename, Vertices, Indices, Submeshes, OutNumMaterialSlots, Stats);
+	}
+
+	if (bImported == false)
+	{
+		return false;
+	}
+
+	const FVertexCacheStats& SourceStats = Stats.Source;
+	const FVertexCacheStats& OptimizedStats = Stats.Optimized;
+
+	// Import statistics are for tuning the optimizer and stay quiet unless asked for.
+	bool bLogMeshImports = false;
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("LogMeshImports", bLogMeshImports);
+	}
+
+	if (bLogMeshImports && OptimizedStats.NumTriangles > 0)
+	{
+		std::chrono::duration<double, std::milli> ImportTime = std::chrono::steady_clock::now() - StartTime;
+
+		std::cout << "Optimized " << InFilename << " (imported in " << ImportTime.count() << " ms): "
+			<< SourceStats.NumVertices << " -> " << OptimizedStats.NumVertices << " vertices, "
+			<< "ACMR " << static_cast<float>(SourceStats.NumTransformedVertices) / SourceStats.NumTriangles << " -> " << static_cast<float>(OptimizedStats.NumTransformedVertices) / OptimizedStats.NumTriangles << ", "
+			<< "ATVR " << static_cast<float>(SourceStats.NumTransformedVertices) / SourceStats.NumVertices << " -> " << static_cast<float>(OptimizedStats.NumTransformedVertices) / OptimizedStats.NumVertices
+			<< std::endl;
+	}
+
+	return Submeshes.empty() == false;
+}
+
 void UMesh::Unload()
 {
 	Vertices.clear();
 	Indices.clear();
-	Material = nullptr;
+	Submeshes.clear();
+	Cache.Close();
+
+	VertexData = nullptr;
+	NumVertices = 0;
+	IndexData = nullptr;
+	NumIndices = 0;
+	SubmeshData = nullptr;
+	NumSubmeshes = 0;
+	NumSourceMaterialSlots = 0;
+	Bounds = FBoundingSphere();
+
+	// Material assignments are kept so a mesh that is loaded again, e.g. after eviction, renders the same.
 
 	DestroyRenderMesh();
 }
 
+size_t UMesh::GetCPUMemorySize() const
+{
+	// Counts mapped cache data too; those pages are resident once the mesh has been uploaded.
+	return static_cast<size_t>(NumVertices) * sizeof(FVertex)
+		+ static_cast<size_t>(NumIndices) * sizeof(uint32_t)
+		+ static_cast<size_t>(NumSubmeshes) * sizeof(FSubmesh);
+}
+
+size_t UMesh::GetGPUMemorySize() const
+{
+	return RenderMesh != nullptr ? static_cast<size_t>(RenderMesh->GetMemorySize()) : 0;
+}
+
 void UMesh::SetMaterial(UMaterial* InMaterial)
 {
-	Material = InMaterial;
-	
+	if (Materials.empty())
+	{
+		Materials.resize(1);
+	}
+
+	for (uint32_t Slot = 0; Slot < Materials.size(); ++Slot)
+	{
+		SetMaterial(Slot, InMaterial);
+	}
+}
+
+void UMesh::SetMaterial(uint32_t InSlot, UMaterial* InMaterial)
+{
+	if (InSlot >= Materials.size())
+	{
+		return;
+	}
+
+	Materials[InSlot] = InMaterial;
+
 	if (RenderMesh != nullptr)
 	{
-		RenderMesh->SetMaterial(InMaterial != nullptr ? InMaterial->GetRenderMaterial() : nullptr);
+		RenderMesh->SetMaterial(InSlot, InMaterial != nullptr ? InMaterial->GetRenderMaterial() : nullptr);
+	}
+}
+
+uint32_t UMesh::ImportMaterials(const FShaderPath& InShaderPath, UTexture* InDefaultBaseColor, UTexture* InDefaultNormal)
+{
+	if (FGLTFImporter::IsGLTFFile(SourceFilename) == false)
+	{
+		return 0;
+	}
+
+	// Imported submeshes use the glTF material index as their slot.
+	std::vector<UMaterial*> SourceMaterials = FGLTFImporter::CreateMaterials(SourceFilename, InShaderPath, InDefaultBaseColor, InDefaultNormal);
+
+	uint32_t NumAssigned = 0;
+	for (uint32_t Slot = 0; Slot < SourceMaterials.size() && Slot < Materials.size(); ++Slot)
+	{
+		if (SourceMaterials[Slot] != nullptr)
+		{
+			SetMaterial(Slot, SourceMaterials[Slot]);
+			++NumAssigned;
+		}
 	}
+
+	return NumAssigned;
 }
 
 FVulkanMesh* UMesh::GetRenderMesh() const
@@ -193,6 +731,12 @@ void UMesh::DestroyRenderMesh()
 		return;
 	}
 
+	// The renderer keys its instance buffers and descriptor sets by render mesh, and a new one may reuse the address.
+	if (FVulkanMeshRenderer* MeshRenderer = GEngine->GetMeshRenderer())
+	{
+		MeshRenderer->RemoveMesh(RenderMesh);
+	}
+
 	RenderContext->DestroyObject(RenderMesh);
 	RenderMesh = nullptr;
 }
@@ -3,6 +3,8 @@
 #include "Asset.h"
 #include "Vertex.h"
 #include "Material.h"
+#include "Frustum.h"
+#include "MeshCache.h"
 
 #include <string>
 
@@ -14,24 +16,68 @@ public:
 	UMesh();
 	virtual ~UMesh();
 
-	const std::vector<FVertex>& GetVertices() const { return Vertices; }
-	const std::vector<uint32_t>& GetIndices() const { return Indices; }
+	// Points either into the mapped mesh cache or into the freshly imported arrays.
+	const FVertex* GetVertexData() const { return VertexData; }
+	uint32_t GetNumVertices() const { return NumVertices; }
+
+	const uint32_t* GetIndexData() const { return IndexData; }
+	uint32_t GetNumIndices() const { return NumIndices; }
+
+	const FSubmesh* GetSubmeshes() const { return SubmeshData; }
+	uint32_t GetNumSubmeshes() const { return NumSubmeshes; }
+
+	const FBoundingSphere& GetBounds() const { return Bounds; }
+
+	// Layout of the vertex buffer on the GPU. Takes effect the next time the render mesh is created.
+	EVertexFormat GetVertexFormat() const { return VertexFormat; }
+	void SetVertexFormat(EVertexFormat InVertexFormat) { VertexFormat = InVertexFormat; }
 
 	virtual bool Load(const std::string& InFilename);
-	void Unload();
+	virtual bool LoadData(const std::string& InFilename) override;
+	virtual void CreateRenderResources() override;
+	virtual void Unload() override;
+
+	virtual size_t GetCPUMemorySize() const override;
+	virtual size_t GetGPUMemorySize() const override;
+
+	// Submeshes refer to materials by slot; imported meshes get one slot per source material.
+	uint32_t GetNumMaterialSlots() const { return static_cast<uint32_t>(Materials.size()); }
 
-	UMaterial* GetMaterial() const { return Material; }
+	UMaterial* GetMaterial(uint32_t InSlot = 0) const { return InSlot < Materials.size() ? Materials[InSlot] : nullptr; }
+	// Assigns InMaterial to every slot.
 	void SetMaterial(UMaterial* InMaterial);
+	void SetMaterial(uint32_t InSlot, UMaterial* InMaterial);
+
+	// Creates the materials of a glTF source and assigns them to their slots. Slots the file has no material for, and
+	// meshes from other formats, keep what they had. Returns the number of slots assigned. Render thread only.
+	uint32_t ImportMaterials(const FShaderPath& InShaderPath, class UTexture* InDefaultBaseColor, class UTexture* InDefaultNormal);
 
 	class FVulkanMesh* GetRenderMesh() const;
 	void CreateRenderMesh();
 	void DestroyRenderMesh();
 
+protected:
+	bool Import(const std::string& InFilename, uint32_t& OutNumMaterialSlots);
+
 protected:
 	std::vector<FVertex> Vertices;
 	std::vector<uint32_t> Indices;
+	std::vector<FSubmesh> Submeshes;
+	FMeshCache Cache;
+
+	const FVertex* VertexData;
+	uint32_t NumVertices;
+	const uint32_t* IndexData;
+	uint32_t NumIndices;
+	const FSubmesh* SubmeshData;
+	uint32_t NumSubmeshes;
+
+	FBoundingSphere Bounds;
+	uint32_t NumSourceMaterialSlots;
+
+	EVertexFormat VertexFormat;
 
-	UMaterial* Material;
+	std::vector<UMaterial*> Materials;
 
 	class FVulkanMesh* RenderMesh;
 };
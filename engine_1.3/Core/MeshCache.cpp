@@ -0,0 +1,152 @@
+#include "MeshCache.h"
+
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <filesystem>
+#include <system_error>
+
+static uint64_t AlignOffset(uint64_t InOffset)
+{
+	return (InOffset + 15) & ~static_cast<uint64_t>(15);
+}
+
+std::string FMeshCache::GetCachePath(const std::string& InSourceFilename)
+{
+	return InSourceFilename + ".vkmesh";
+}
+
+bool FMeshCache::Write(
+	const std::string& InFilename,
+	uint64_t InSourceHash,
+	const FVertex* InVertices,
+	uint32_t InNumVertices,
+	const uint32_t* InIndices,
+	uint32_t InNumIndices,
+	const std::vector<FSubmesh>& InSubmeshes,
+	uint32_t InNumMaterialSlots,
+	const FBoundingSphere& InBounds)
+{
+	FMeshCacheHeader Header{};
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.SourceHash = InSourceHash;
+	Header.VertexStride = sizeof(FVertex);
+	Header.NumVertices = InNumVertices;
+	Header.NumIndices = InNumIndices;
+	Header.NumSubmeshes = static_cast<uint32_t>(InSubmeshes.size());
+	Header.NumMaterialSlots = InNumMaterialSlots;
+	Header.Bounds = InBounds;
+	Header.SubmeshOffset = sizeof(FMeshCacheHeader);
+	Header.VertexOffset = Header.SubmeshOffset + InSubmeshes.size() * sizeof(FSubmesh);
+	Header.IndexOffset = AlignOffset(Header.VertexOffset + static_cast<uint64_t>(InNumVertices) * sizeof(FVertex));
+
+	// Written under a temporary name so an interrupted write never leaves a truncated cache behind. The name is
+	// per thread because asynchronous loads of the same source may write its cache at the same time.
+	std::string TempFilename = InFilename + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+	{
+		std::ofstream File(TempFilename, std::ios::binary | std::ios::trunc);
+		if (File.is_open() == false)
+		{
+			return false;
+		}
+
+		static const char Padding[16] = {};
+
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+		File.write(reinterpret_cast<const char*>(InSubmeshes.data()), static_cast<std::streamsize>(InSubmeshes.size() * sizeof(FSubmesh)));
+		File.write(reinterpret_cast<const char*>(InVertices), static_cast<std::streamsize>(InNumVertices) * sizeof(FVertex));
+		File.write(Padding, static_cast<std::streamsize>(Header.IndexOffset - Header.VertexOffset - static_cast<uint64_t>(InNumVertices) * sizeof(FVertex)));
+		File.write(reinterpret_cast<const char*>(InIndices), static_cast<std::streamsize>(InNumIndices) * sizeof(uint32_t));
+
+		if (File.good() == false)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ErrorCode;
+	std::filesystem::rename(TempFilename, InFilename, ErrorCode);
+	if (ErrorCode)
+	{
+		std::filesystem::remove(TempFilename, ErrorCode);
+		return false;
+	}
+
+	return true;
+}
+
+bool FMeshCache::Open(const std::string& InFilename, uint64_t InSourceHash)
+{
+	Close();
+
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	if (File.GetSize() < sizeof(FMeshCacheHeader))
+	{
+		File.Close();
+		return false;
+	}
+
+	const FMeshCacheHeader* MappedHeader = reinterpret_cast<const FMeshCacheHeader*>(File.GetData());
+
+	uint64_t VertexBytes = static_cast<uint64_t>(MappedHeader->NumVertices) * sizeof(FVertex);
+	uint64_t IndexBytes = static_cast<uint64_t>(MappedHeader->NumIndices) * sizeof(uint32_t);
+	uint64_t SubmeshBytes = static_cast<uint64_t>(MappedHeader->NumSubmeshes) * sizeof(FSubmesh);
+
+	if (MappedHeader->Magic != Magic ||
+		MappedHeader->Version != Version ||
+		MappedHeader->VertexStride != sizeof(FVertex) ||
+		(InSourceHash != AnySourceHash && MappedHeader->SourceHash != InSourceHash) ||
+		MappedHeader->SubmeshOffset + SubmeshBytes > MappedHeader->VertexOffset ||
+		MappedHeader->VertexOffset + VertexBytes > MappedHeader->IndexOffset ||
+		MappedHeader->IndexOffset + IndexBytes > File.GetSize())
+	{
+		File.Close();
+		return false;
+	}
+
+	Header = MappedHeader;
+
+	return true;
+}
+
+void FMeshCache::Close()
+{
+	Header = nullptr;
+	File.Close();
+}
+
+const FVertex* FMeshCache::GetVertices() const
+{
+	if (Header == nullptr)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const FVertex*>(File.GetData() + Header->VertexOffset);
+}
+
+const FSubmesh* FMeshCache::GetSubmeshes() const
+{
+	if (Header == nullptr)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const FSubmesh*>(File.GetData() + Header->SubmeshOffset);
+}
+
+const uint32_t* FMeshCache::GetIndices() const
+{
+	if (Header == nullptr)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const uint32_t*>(File.GetData() + Header->IndexOffset);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Vertex.h"
+#include "Frustum.h"
+#include "FileSystem.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// A contiguous index range of a mesh drawn with one material slot. Indices are relative to VertexOffset.
+struct alignas(16) FSubmesh
+{
+	uint32_t FirstIndex = 0;
+	uint32_t NumIndices = 0;
+	uint32_t VertexOffset = 0;
+	uint32_t NumVertices = 0;
+	uint32_t MaterialSlot = 0;
+	uint32_t Reserved[3] = {};
+	FBoundingSphere Bounds;
+};
+
+static_assert(sizeof(FSubmesh) == 48, "FSubmesh is part of the on-disk mesh cache format.");
+
+struct alignas(16) FMeshCacheHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t SourceHash;
+	uint32_t VertexStride;
+	uint32_t NumVertices;
+	uint32_t NumIndices;
+	uint32_t NumSubmeshes;
+	FBoundingSphere Bounds;
+	uint64_t VertexOffset;
+	uint64_t IndexOffset;
+	uint64_t SubmeshOffset;
+	uint32_t NumMaterialSlots;
+	uint32_t Reserved;
+};
+
+static_assert(sizeof(FMeshCacheHeader) == 80, "FMeshCacheHeader is part of the on-disk format.");
+
+// Binary mesh container written after the first import of a source mesh. Later loads map it and hand the
+// vertex and index arrays straight to the renderer; it is rejected when the source hash or format no longer match.
+class FMeshCache
+{
+public:
+	static constexpr uint32_t Magic = 0x434d4b56; // "VKMC"
+	static constexpr uint32_t Version = 6;
+	// Accepts the cache whatever source it was built from, for cooked data that ships without its sources.
+	static constexpr uint64_t AnySourceHash = 0;
+
+	static std::string GetCachePath(const std::string& InSourceFilename);
+
+	static bool Write(
+		const std::string& InFilename,
+		uint64_t InSourceHash,
+		const FVertex* InVertices,
+		uint32_t InNumVertices,
+		const uint32_t* InIndices,
+		uint32_t InNumIndices,
+		const std::vector<FSubmesh>& InSubmeshes,
+		uint32_t InNumMaterialSlots,
+		const FBoundingSphere& InBounds);
+
+	bool Open(const std::string& InFilename, uint64_t InSourceHash);
+	void Close();
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	const FVertex* GetVertices() const;
+	uint32_t GetNumVertices() const { return Header != nullptr ? Header->NumVertices : 0; }
+
+	const uint32_t* GetIndices() const;
+	uint32_t GetNumIndices() const { return Header != nullptr ? Header->NumIndices : 0; }
+
+	const FSubmesh* GetSubmeshes() const;
+	uint32_t GetNumSubmeshes() const { return Header != nullptr ? Header->NumSubmeshes : 0; }
+	uint32_t GetNumMaterialSlots() const { return Header != nullptr ? Header->NumMaterialSlots : 0; }
+
+	FBoundingSphere GetBounds() const { return Header != nullptr ? Header->Bounds : FBoundingSphere(); }
+
+private:
+	FFileView File;
+	const FMeshCacheHeader* Header = nullptr;
+};
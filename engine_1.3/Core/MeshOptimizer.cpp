@@ -0,0 +1,448 @@
+#include "MeshOptimizer.h"
+#include "Utils.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+// Forsyth's scoring parameters. The cache modeled while scoring is larger than the FIFO the statistics assume,
+// which keeps the ordering good across hardware.
+static constexpr uint32_t ScoringCacheSize = 32;
+static constexpr float CacheDecayPower = 1.5f;
+static constexpr float LastTriangleScore = 0.75f;
+static constexpr float ValenceBoostScale = 2.0f;
+static constexpr float ValenceBoostPower = 0.5f;
+
+static float ScoreVertex(int32_t InCachePosition, uint32_t InNumLiveTriangles)
+{
+	if (InNumLiveTriangles == 0)
+	{
+		return -1.0f;
+	}
+
+	float Score = 0.0f;
+	if (InCachePosition >= 0)
+	{
+		if (InCachePosition < 3)
+		{
+			// The last triangle's vertices score the same, regardless of their order in it.
+			Score = LastTriangleScore;
+		}
+		else
+		{
+			const float Scale = 1.0f / (ScoringCacheSize - 3);
+			Score = std::pow(1.0f - (InCachePosition - 3) * Scale, CacheDecayPower);
+		}
+	}
+
+	// Vertices with few remaining triangles are preferred so they leave the working set quickly.
+	Score += ValenceBoostScale * std::pow(static_cast<float>(InNumLiveTriangles), -ValenceBoostPower);
+
+	return Score;
+}
+
+// Simulates a FIFO cache with timestamps. Returns the number of misses the triangle causes.
+static uint32_t UpdateFIFOCache(const uint32_t* InTriangle, std::vector<uint32_t>& InOutCacheTimestamps, uint32_t& InOutTimestamp, uint32_t InCacheSize)
+{
+	uint32_t Misses = 0;
+	for (uint32_t Corner = 0; Corner < 3; ++Corner)
+	{
+		uint32_t Vertex = InTriangle[Corner];
+		if (InOutTimestamp - InOutCacheTimestamps[Vertex] > InCacheSize)
+		{
+			InOutCacheTimestamps[Vertex] = InOutTimestamp++;
+			++Misses;
+		}
+	}
+
+	return Misses;
+}
+
+void FMeshOptimizer::WeldVertices(std::vector<FVertex>& InOutVertices, std::vector<uint32_t>& InOutIndices)
+{
+	// FVertex is tightly packed floats, so hashing and comparing its bytes is exact and much cheaper than std::hash.
+	static_assert(sizeof(FVertex) == sizeof(float) * 12, "FVertex must not contain padding to be welded bytewise.");
+
+	size_t TableSize = 1;
+	while (TableSize < InOutVertices.size() * 2)
+	{
+		TableSize *= 2;
+	}
+
+	std::vector<uint32_t> Table(TableSize, InvalidIndex);
+	std::vector<uint32_t> Remap(InOutVertices.size(), InvalidIndex);
+
+	std::vector<FVertex> WeldedVertices;
+	WeldedVertices.reserve(InOutVertices.size());
+
+	for (uint32_t& Index : InOutIndices)
+	{
+		if (Remap[Index] != InvalidIndex)
+		{
+			Index = Remap[Index];
+			continue;
+		}
+
+		const FVertex& Vertex = InOutVertices[Index];
+
+		// Open addressing with linear probing; the table is at most half full.
+		size_t Slot = static_cast<size_t>(HashBytes(&Vertex, sizeof(FVertex))) & (TableSize - 1);
+		while (Table[Slot] != InvalidIndex && memcmp(&WeldedVertices[Table[Slot]], &Vertex, sizeof(FVertex)) != 0)
+		{
+			Slot = (Slot + 1) & (TableSize - 1);
+		}
+
+		if (Table[Slot] == InvalidIndex)
+		{
+			Table[Slot] = static_cast<uint32_t>(WeldedVertices.size());
+			WeldedVertices.push_back(Vertex);
+		}
+
+		Remap[Index] = Table[Slot];
+		Index = Table[Slot];
+	}
+
+	InOutVertices.swap(WeldedVertices);
+}
+
+void FMeshOptimizer::OptimizeVertexCache(uint32_t* InOutIndices, size_t InNumIndices, uint32_t InNumVertices)
+{
+	const uint32_t NumTriangles = static_cast<uint32_t>(InNumIndices / 3);
+	if (NumTriangles == 0 || InNumVertices == 0)
+	{
+		return;
+	}
+
+	// Triangles adjacent to each vertex, packed by vertex. The live part of each list shrinks as triangles are emitted.
+	std::vector<uint32_t> AdjacencyOffsets(InNumVertices + 1, 0);
+	std::vector<uint32_t> NumLiveTriangles(InNumVertices, 0);
+	for (size_t Idx = 0; Idx < NumTriangles * 3; ++Idx)
+	{
+		++NumLiveTriangles[InOutIndices[Idx]];
+	}
+
+	for (uint32_t Vertex = 0; Vertex < InNumVertices; ++Vertex)
+	{
+		AdjacencyOffsets[Vertex + 1] = AdjacencyOffsets[Vertex] + NumLiveTriangles[Vertex];
+	}
+
+	std::vector<uint32_t> Adjacency(NumTriangles * 3);
+	{
+		std::vector<uint32_t> Fill(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+		for (uint32_t Triangle = 0; Triangle < NumTriangles; ++Triangle)
+		{
+			for (uint32_t Corner = 0; Corner < 3; ++Corner)
+			{
+				Adjacency[Fill[InOutIndices[Triangle * 3 + Corner]]++] = Triangle;
+			}
+		}
+	}
+
+	std::vector<int32_t> CachePositions(InNumVertices, -1);
+	std::vector<float> VertexScores(InNumVertices);
+	for (uint32_t Vertex = 0; Vertex < InNumVertices; ++Vertex)
+	{
+		VertexScores[Vertex] = ScoreVertex(-1, NumLiveTriangles[Vertex]);
+	}
+
+	std::vector<float> TriangleScores(NumTriangles);
+	std::vector<uint8_t> Emitted(NumTriangles, 0);
+
+	uint32_t BestTriangle = 0;
+	for (uint32_t Triangle = 0; Triangle < NumTriangles; ++Triangle)
+	{
+		const uint32_t* Corners = InOutIndices + Triangle * 3;
+		TriangleScores[Triangle] = VertexScores[Corners[0]] + VertexScores[Corners[1]] + VertexScores[Corners[2]];
+		if (TriangleScores[Triangle] > TriangleScores[BestTriangle])
+		{
+			BestTriangle = Triangle;
+		}
+	}
+
+	std::vector<uint32_t> Output(NumTriangles * 3);
+
+	uint32_t Cache[ScoringCacheSize + 3];
+	uint32_t NewCache[ScoringCacheSize + 3];
+	uint32_t CacheCount = 0;
+
+	uint32_t Cursor = 0;
+
+	for (uint32_t NumEmitted = 0; NumEmitted < NumTriangles; ++NumEmitted)
+	{
+		if (BestTriangle == InvalidIndex)
+		{
+			// Nothing in the cache has live triangles left; continue with the next unemitted triangle in input order.
+			while (Emitted[Cursor] != 0)
+			{
+				++Cursor;
+			}
+			BestTriangle = Cursor;
+		}
+
+		const uint32_t* Corners = InOutIndices + BestTriangle * 3;
+		Output[NumEmitted * 3 + 0] = Corners[0];
+		Output[NumEmitted * 3 + 1] = Corners[1];
+		Output[NumEmitted * 3 + 2] = Corners[2];
+		Emitted[BestTriangle] = 1;
+
+		uint32_t NewCacheCount = 0;
+		for (uint32_t Corner = 0; Corner < 3; ++Corner)
+		{
+			uint32_t Vertex = Corners[Corner];
+
+			// Swap-remove the triangle from the live part of the vertex's adjacency list.
+			uint32_t* Triangles = Adjacency.data() + AdjacencyOffsets[Vertex];
+			uint32_t& NumLive = NumLiveTriangles[Vertex];
+			for (uint32_t Idx = 0; Idx < NumLive; ++Idx)
+			{
+				if (Triangles[Idx] == BestTriangle)
+				{
+					Triangles[Idx] = Triangles[NumLive - 1];
+					--NumLive;
+					break;
+				}
+			}
+
+			NewCache[NewCacheCount++] = Vertex;
+		}
+
+		for (uint32_t Idx = 0; Idx < CacheCount; ++Idx)
+		{
+			uint32_t Vertex = Cache[Idx];
+			if (Vertex != Corners[0] && Vertex != Corners[1] && Vertex != Corners[2])
+			{
+				NewCache[NewCacheCount++] = Vertex;
+			}
+		}
+
+		// Vertices pushed past the end of the cache get their scores updated once more as evicted.
+		for (uint32_t Idx = 0; Idx < NewCacheCount; ++Idx)
+		{
+			uint32_t Vertex = NewCache[Idx];
+			CachePositions[Vertex] = Idx < ScoringCacheSize ? static_cast<int32_t>(Idx) : -1;
+			VertexScores[Vertex] = ScoreVertex(CachePositions[Vertex], NumLiveTriangles[Vertex]);
+		}
+
+		BestTriangle = InvalidIndex;
+		float BestScore = -1.0f;
+
+		for (uint32_t Idx = 0; Idx < NewCacheCount; ++Idx)
+		{
+			uint32_t Vertex = NewCache[Idx];
+			const uint32_t* Triangles = Adjacency.data() + AdjacencyOffsets[Vertex];
+
+			for (uint32_t TriangleIdx = 0; TriangleIdx < NumLiveTriangles[Vertex]; ++TriangleIdx)
+			{
+				uint32_t Triangle = Triangles[TriangleIdx];
+				const uint32_t* TriangleCorners = InOutIndices + Triangle * 3;
+
+				float Score = VertexScores[TriangleCorners[0]] + VertexScores[TriangleCorners[1]] + VertexScores[TriangleCorners[2]];
+				TriangleScores[Triangle] = Score;
+
+				if (Score > BestScore || (Score == BestScore && Triangle < BestTriangle))
+				{
+					BestScore = Score;
+					BestTriangle = Triangle;
+				}
+			}
+		}
+
+		CacheCount = std::min(NewCacheCount, ScoringCacheSize);
+		memcpy(Cache, NewCache, sizeof(uint32_t) * CacheCount);
+	}
+
+	memcpy(InOutIndices, Output.data(), sizeof(uint32_t) * Output.size());
+}
+
+void FMeshOptimizer::OptimizeOverdraw(uint32_t* InOutIndices, size_t InNumIndices, const FVertex* InVertices, uint32_t InNumVertices, float InThreshold)
+{
+	const uint32_t NumTriangles = static_cast<uint32_t>(InNumIndices / 3);
+	if (NumTriangles == 0 || InNumVertices == 0)
+	{
+		return;
+	}
+
+	std::vector<uint32_t> CacheTimestamps(InNumVertices, 0);
+	uint32_t Timestamp = DefaultCacheSize + 1;
+
+	// Hard boundaries are where the cache-optimized order starts over, i.e. a triangle misses on all three vertices.
+	std::vector<uint32_t> HardClusters;
+	for (uint32_t Triangle = 0; Triangle < NumTriangles; ++Triangle)
+	{
+		if (UpdateFIFOCache(InOutIndices + Triangle * 3, CacheTimestamps, Timestamp, DefaultCacheSize) == 3)
+		{
+			HardClusters.push_back(Triangle);
+		}
+	}
+
+	if (HardClusters.empty() || HardClusters[0] != 0)
+	{
+		HardClusters.insert(HardClusters.begin(), 0);
+	}
+
+	// Soft boundaries split a hard cluster wherever the ACMR so far stays within InThreshold of the whole cluster's,
+	// trading a little cache efficiency for more freedom in the sort.
+	std::vector<uint32_t> Clusters;
+	for (size_t ClusterIdx = 0; ClusterIdx < HardClusters.size(); ++ClusterIdx)
+	{
+		uint32_t Begin = HardClusters[ClusterIdx];
+		uint32_t End = ClusterIdx + 1 < HardClusters.size() ? HardClusters[ClusterIdx + 1] : NumTriangles;
+
+		Timestamp += DefaultCacheSize + 1;
+		uint32_t ClusterMisses = 0;
+		for (uint32_t Triangle = Begin; Triangle < End; ++Triangle)
+		{
+			ClusterMisses += UpdateFIFOCache(InOutIndices + Triangle * 3, CacheTimestamps, Timestamp, DefaultCacheSize);
+		}
+
+		float ClusterThreshold = InThreshold * static_cast<float>(ClusterMisses) / static_cast<float>(End - Begin);
+
+		Clusters.push_back(Begin);
+
+		Timestamp += DefaultCacheSize + 1;
+		uint32_t SoftBegin = Begin;
+		uint32_t Misses = 0;
+		for (uint32_t Triangle = Begin; Triangle < End; ++Triangle)
+		{
+			Misses += UpdateFIFOCache(InOutIndices + Triangle * 3, CacheTimestamps, Timestamp, DefaultCacheSize);
+
+			if (Triangle + 1 < End && static_cast<float>(Misses) / static_cast<float>(Triangle + 1 - SoftBegin) <= ClusterThreshold)
+			{
+				Clusters.push_back(Triangle + 1);
+				SoftBegin = Triangle + 1;
+				Misses = 0;
+				Timestamp += DefaultCacheSize + 1;
+			}
+		}
+	}
+
+	struct FCluster
+	{
+		uint32_t Begin;
+		uint32_t End;
+		float SortKey;
+	};
+
+	std::vector<FCluster> SortedClusters(Clusters.size());
+
+	glm::vec3 MeshCentroid(0.0f);
+	float MeshArea = 0.0f;
+
+	std::vector<glm::vec3> ClusterCentroids(Clusters.size(), glm::vec3(0.0f));
+	std::vector<glm::vec3> ClusterNormals(Clusters.size(), glm::vec3(0.0f));
+
+	for (size_t ClusterIdx = 0; ClusterIdx < Clusters.size(); ++ClusterIdx)
+	{
+		uint32_t Begin = Clusters[ClusterIdx];
+		uint32_t End = ClusterIdx + 1 < Clusters.size() ? Clusters[ClusterIdx + 1] : NumTriangles;
+
+		float ClusterArea = 0.0f;
+		for (uint32_t Triangle = Begin; Triangle < End; ++Triangle)
+		{
+			const glm::vec3& P0 = InVertices[InOutIndices[Triangle * 3 + 0]].Position;
+			const glm::vec3& P1 = InVertices[InOutIndices[Triangle * 3 + 1]].Position;
+			const glm::vec3& P2 = InVertices[InOutIndices[Triangle * 3 + 2]].Position;
+
+			glm::vec3 Normal = glm::cross(P1 - P0, P2 - P0);
+			float Area = glm::length(Normal);
+
+			ClusterCentroids[ClusterIdx] += (P0 + P1 + P2) * (Area / 3.0f);
+			ClusterNormals[ClusterIdx] += Normal;
+			ClusterArea += Area;
+		}
+
+		MeshCentroid += ClusterCentroids[ClusterIdx];
+		MeshArea += ClusterArea;
+
+		if (ClusterArea > 0.0f)
+		{
+			ClusterCentroids[ClusterIdx] /= ClusterArea;
+		}
+
+		SortedClusters[ClusterIdx].Begin = Begin;
+		SortedClusters[ClusterIdx].End = End;
+	}
+
+	if (MeshArea > 0.0f)
+	{
+		MeshCentroid /= MeshArea;
+	}
+
+	// Clusters facing away from the centroid are likely to occlude the rest, so they are drawn first.
+	for (size_t ClusterIdx = 0; ClusterIdx < Clusters.size(); ++ClusterIdx)
+	{
+		float NormalLength = glm::length(ClusterNormals[ClusterIdx]);
+		glm::vec3 Normal = NormalLength > 0.0f ? ClusterNormals[ClusterIdx] / NormalLength : glm::vec3(0.0f);
+
+		SortedClusters[ClusterIdx].SortKey = glm::dot(ClusterCentroids[ClusterIdx] - MeshCentroid, Normal);
+	}
+
+	std::stable_sort(SortedClusters.begin(), SortedClusters.end(), [](const FCluster& A, const FCluster& B) { return A.SortKey > B.SortKey; });
+
+	std::vector<uint32_t> Output;
+	Output.reserve(NumTriangles * 3);
+	for (const FCluster& Cluster : SortedClusters)
+	{
+		Output.insert(Output.end(), InOutIndices + Cluster.Begin * 3, InOutIndices + Cluster.End * 3);
+	}
+
+	memcpy(InOutIndices, Output.data(), sizeof(uint32_t) * Output.size());
+}
+
+void FMeshOptimizer::OptimizeVertexFetch(std::vector<FVertex>& InOutVertices, uint32_t* InOutIndices, size_t InNumIndices)
+{
+	std::vector<uint32_t> Remap(InOutVertices.size(), InvalidIndex);
+
+	std::vector<FVertex> OrderedVertices;
+	OrderedVertices.reserve(InOutVertices.size());
+
+	for (size_t Idx = 0; Idx < InNumIndices; ++Idx)
+	{
+		uint32_t& Index = InOutIndices[Idx];
+		if (Remap[Index] == InvalidIndex)
+		{
+			Remap[Index] = static_cast<uint32_t>(OrderedVertices.size());
+			OrderedVertices.push_back(InOutVertices[Index]);
+		}
+
+		Index = Remap[Index];
+	}
+
+	InOutVertices.swap(OrderedVertices);
+}
+
+FVertexCacheStats FMeshOptimizer::AnalyzeVertexCache(const uint32_t* InIndices, size_t InNumIndices, uint32_t InNumVertices, uint32_t InCacheSize)
+{
+	FVertexCacheStats Stats;
+	Stats.NumTriangles = static_cast<uint32_t>(InNumIndices / 3);
+	if (Stats.NumTriangles == 0 || InNumVertices == 0)
+	{
+		return Stats;
+	}
+
+	std::vector<uint32_t> CacheTimestamps(InNumVertices, 0);
+	std::vector<uint8_t> Referenced(InNumVertices, 0);
+	uint32_t Timestamp = InCacheSize + 1;
+
+	for (uint32_t Triangle = 0; Triangle < Stats.NumTriangles; ++Triangle)
+	{
+		const uint32_t* Corners = InIndices + Triangle * 3;
+		Stats.NumTransformedVertices += UpdateFIFOCache(Corners, CacheTimestamps, Timestamp, InCacheSize);
+
+		for (uint32_t Corner = 0; Corner < 3; ++Corner)
+		{
+			if (Referenced[Corners[Corner]] == 0)
+			{
+				Referenced[Corners[Corner]] = 1;
+				++Stats.NumVertices;
+			}
+		}
+	}
+
+	Stats.ACMR = static_cast<float>(Stats.NumTransformedVertices) / static_cast<float>(Stats.NumTriangles);
+	Stats.ATVR = static_cast<float>(Stats.NumTransformedVertices) / static_cast<float>(Stats.NumVertices);
+
+	return Stats;
+}
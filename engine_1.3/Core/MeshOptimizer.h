@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <vector>
+#include <cstdint>
+
+struct FVertexCacheStats
+{
+	uint32_t NumTriangles = 0;
+	uint32_t NumVertices = 0;
+	uint32_t NumTransformedVertices = 0;
+
+	// Average cache miss ratio: transformed vertices per triangle. 0.5 is the ideal, 3 means no reuse at all.
+	float ACMR = 0.0f;
+	// Average transform to vertex ratio: transformed vertices per referenced vertex. 1 is the ideal.
+	float ATVR = 0.0f;
+};
+
+// Import-time mesh optimizations. Every pass is deterministic, so the same source always cooks to the same mesh.
+// The intended order is WeldVertices, OptimizeVertexCache, OptimizeOverdraw and finally OptimizeVertexFetch.
+class FMeshOptimizer
+{
+public:
+	// FIFO size used for the statistics and overdraw clustering, a conservative match for current GPUs.
+	static constexpr uint32_t DefaultCacheSize = 16;
+
+	// Merges bitwise identical vertices and drops unreferenced ones. Vertices keep the order of their first use.
+	static void WeldVertices(std::vector<FVertex>& InOutVertices, std::vector<uint32_t>& InOutIndices);
+
+	// Reorders triangles for post-transform cache reuse (Forsyth, linear-speed vertex cache optimization).
+	static void OptimizeVertexCache(uint32_t* InOutIndices, size_t InNumIndices, uint32_t InNumVertices);
+
+	// Splits the cache-optimized triangle order into clusters and sorts them front to back around the mesh centroid.
+	// InThreshold bounds how much the ACMR may degrade to get smaller clusters.
+	static void OptimizeOverdraw(uint32_t* InOutIndices, size_t InNumIndices, const FVertex* InVertices, uint32_t InNumVertices, float InThreshold = 1.05f);
+
+	// Reorders vertices by first use so vertex fetches walk memory linearly.
+	static void OptimizeVertexFetch(std::vector<FVertex>& InOutVertices, uint32_t* InOutIndices, size_t InNumIndices);
+
+	static FVertexCacheStats AnalyzeVertexCache(const uint32_t* InIndices, size_t InNumIndices, uint32_t InNumVertices, uint32_t InCacheSize = DefaultCacheSize);
+};
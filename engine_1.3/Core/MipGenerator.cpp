@@ -0,0 +1,276 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define MIP_GENERATOR_USE_SSE 1
+#include <emmintrin.h>
+#else
+#define MIP_GENERATOR_USE_SSE 0
+#endif
+
+static constexpr uint32_t LinearToSRGBSteps = 4096;
+
+struct FColorTables
+{
+	FColorTables()
+	{
+		for (uint32_t Idx = 0; Idx < 256; ++Idx)
+		{
+			float Value = Idx / 255.0f;
+			SRGBToLinear[Idx] = Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		for (uint32_t Idx = 0; Idx < LinearToSRGBSteps; ++Idx)
+		{
+			float Value = Idx / static_cast<float>(LinearToSRGBSteps - 1);
+			float Encoded = Value <= 0.0031308f ? Value * 12.92f : 1.055f * std::pow(Value, 1.0f / 2.4f) - 0.055f;
+			LinearToSRGB[Idx] = static_cast<uint8_t>(Encoded * 255.0f + 0.5f);
+		}
+	}
+
+	float SRGBToLinear[256];
+	uint8_t LinearToSRGB[LinearToSRGBSteps];
+};
+
+static const FColorTables& GetColorTables()
+{
+	static const FColorTables Tables;
+	return Tables;
+}
+
+static uint8_t ToUnorm8(float InValue)
+{
+	return static_cast<uint8_t>(std::clamp(InValue, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Expands a row of texels to floats in the space the filter averages in.
+static void DecodeRow(const uint8_t* InTexels, uint32_t InWidth, EMipFilter InFilter, float* OutTexels)
+{
+	const size_t NumValues = static_cast<size_t>(InWidth) * 4;
+
+	if (InFilter == EMipFilter::SRGB)
+	{
+		const FColorTables& Tables = GetColorTables();
+
+		for (size_t Idx = 0; Idx < NumValues; Idx += 4)
+		{
+			OutTexels[Idx + 0] = Tables.SRGBToLinear[InTexels[Idx + 0]];
+			OutTexels[Idx + 1] = Tables.SRGBToLinear[InTexels[Idx + 1]];
+			OutTexels[Idx + 2] = Tables.SRGBToLinear[InTexels[Idx + 2]];
+			OutTexels[Idx + 3] = InTexels[Idx + 3] / 255.0f;
+		}
+		return;
+	}
+
+	// Normals are mapped back to [-1, 1]; alpha always stays in [0, 1].
+	const bool bNormal = InFilter == EMipFilter::Normal;
+	const float ColorScale = bNormal ? 2.0f / 255.0f : 1.0f / 255.0f;
+	const float ColorBias = bNormal ? -1.0f : 0.0f;
+
+#if MIP_GENERATOR_USE_SSE
+	const __m128 Scale = _mm_setr_ps(ColorScale, ColorScale, ColorScale, 1.0f / 255.0f);
+	const __m128 Bias = _mm_setr_ps(ColorBias, ColorBias, ColorBias, 0.0f);
+	const __m128i Zero = _mm_setzero_si128();
+
+	for (size_t Idx = 0; Idx < NumValues; Idx += 4)
+	{
+		int32_t Packed;
+		memcpy(&Packed, InTexels + Idx, sizeof(Packed));
+
+		__m128i Bytes = _mm_cvtsi32_si128(Packed);
+		__m128i Ints = _mm_unpacklo_epi16(_mm_unpacklo_epi8(Bytes, Zero), Zero);
+		_mm_storeu_ps(OutTexels + Idx, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(Ints), Scale), Bias));
+	}
+#else
+	for (size_t Idx = 0; Idx < NumValues; Idx += 4)
+	{
+		OutTexels[Idx + 0] = InTexels[Idx + 0] * ColorScale + ColorBias;
+		OutTexels[Idx + 1] = InTexels[Idx + 1] * ColorScale + ColorBias;
+		OutTexels[Idx + 2] = InTexels[Idx + 2] * ColorScale + ColorBias;
+		OutTexels[Idx + 3] = InTexels[Idx + 3] / 255.0f;
+	}
+#endif
+}
+
+static void EncodeTexel(const float* InTexel, EMipFilter InFilter, uint8_t* OutTexel)
+{
+	switch (InFilter)
+	{
+	case EMipFilter::SRGB:
+	{
+		const FColorTables& Tables = GetColorTables();
+
+		for (uint32_t Channel = 0; Channel < 3; ++Channel)
+		{
+			float Value = std::clamp(InTexel[Channel], 0.0f, 1.0f);
+			OutTexel[Channel] = Tables.LinearToSRGB[static_cast<uint32_t>(Value * (LinearToSRGBSteps - 1) + 0.5f)];
+		}
+		break;
+	}
+	case EMipFilter::Normal:
+	{
+		float Length = std::sqrt(InTexel[0] * InTexel[0] + InTexel[1] * InTexel[1] + InTexel[2] * InTexel[2]);
+		float InvLength = Length > 0.0f ? 1.0f / Length : 0.0f;
+
+		for (uint32_t Channel = 0; Channel < 3; ++Channel)
+		{
+			OutTexel[Channel] = ToUnorm8(InTexel[Channel] * InvLength * 0.5f + 0.5f);
+		}
+		break;
+	}
+	default:
+		for (uint32_t Channel = 0; Channel < 3; ++Channel)
+		{
+			OutTexel[Channel] = ToUnorm8(InTexel[Channel]);
+		}
+		break;
+	}
+
+	OutTexel[3] = ToUnorm8(InTexel[3]);
+}
+
+// Averages the footprints of InNumRows decoded source rows into one destination row. Footprints are two texels wide,
+// except that the last one of an odd source row is three wide so its last texel is not dropped.
+static void FilterRow(const float* const* InRows, uint32_t InNumRows, uint32_t InSrcWidth, uint32_t InDstWidth, EMipFilter InFilter, uint8_t* OutTexels)
+{
+	const bool bOddWidth = InSrcWidth > 1 && (InSrcWidth & 1) != 0;
+
+	for (uint32_t X = 0; X < InDstWidth; ++X)
+	{
+		const uint32_t NumTaps = bOddWidth && X == InDstWidth - 1 ? 3 : 2;
+		const float Weight = 1.0f / (NumTaps * InNumRows);
+
+		size_t Taps[3];
+		for (uint32_t Tap = 0; Tap < NumTaps; ++Tap)
+		{
+			Taps[Tap] = static_cast<size_t>(std::min(X * 2 + Tap, InSrcWidth - 1)) * 4;
+		}
+
+		alignas(16) float Texel[4];
+
+#if MIP_GENERATOR_USE_SSE
+		__m128 Sum = _mm_setzero_ps();
+		for (uint32_t Row = 0; Row < InNumRows; ++Row)
+		{
+			__m128 RowSum = _mm_add_ps(_mm_loadu_ps(InRows[Row] + Taps[0]), _mm_loadu_ps(InRows[Row] + Taps[1]));
+			if (NumTaps == 3)
+			{
+				RowSum = _mm_add_ps(RowSum, _mm_loadu_ps(InRows[Row] + Taps[2]));
+			}
+
+			Sum = _mm_add_ps(Sum, RowSum);
+		}
+		_mm_store_ps(Texel, _mm_mul_ps(Sum, _mm_set1_ps(Weight)));
+#else
+		for (uint32_t Channel = 0; Channel < 4; ++Channel)
+		{
+			float Sum = 0.0f;
+			for (uint32_t Row = 0; Row < InNumRows; ++Row)
+			{
+				for (uint32_t Tap = 0; Tap < NumTaps; ++Tap)
+				{
+					Sum += InRows[Row][Taps[Tap] + Channel];
+				}
+			}
+			Texel[Channel] = Sum * Weight;
+		}
+#endif
+
+		EncodeTexel(Texel, InFilter, OutTexels + static_cast<size_t>(X) * 4);
+	}
+}
+
+uint32_t FMipGenerator::GetNumMipLevels(uint32_t InWidth, uint32_t InHeight)
+{
+	uint32_t Size = std::max(InWidth, InHeight);
+
+	uint32_t NumLevels = 1;
+	while (Size > 1)
+	{
+		Size /= 2;
+		++NumLevels;
+	}
+
+	return NumLevels;
+}
+
+uint64_t FMipGenerator::GetMipChainLayout(uint32_t InWidth, uint32_t InHeight, uint32_t InNumLevels, std::vector<FTextureMip>& OutMips)
+{
+	OutMips.clear();
+	OutMips.reserve(InNumLevels);
+
+	uint64_t Offset = 0;
+	uint32_t Width = InWidth;
+	uint32_t Height = InHeight;
+
+	for (uint32_t Level = 0; Level < InNumLevels; ++Level)
+	{
+		FTextureMip Mip;
+		Mip.Width = Width;
+		Mip.Height = Height;
+		Mip.Offset = Offset;
+		Mip.Size = static_cast<uint64_t>(Width) * Height * 4;
+		OutMips.push_back(Mip);
+
+		Offset += Mip.Size;
+		Width = std::max(Width / 2, 1U);
+		Height = std::max(Height / 2, 1U);
+	}
+
+	return Offset;
+}
+
+void FMipGenerator::GenerateMips(uint8_t* InOutMipChain, const std::vector<FTextureMip>& InMips, EMipFilter InFilter)
+{
+	if (InOutMipChain == nullptr || InMips.size() < 2)
+	{
+		return;
+	}
+
+	const size_t MaxRowValues = static_cast<size_t>(InMips[0].Width) * 4;
+	std::vector<float> RowBuffers[3] = { std::vector<float>(MaxRowValues), std::vector<float>(MaxRowValues), std::vector<float>(MaxRowValues) };
+
+	for (size_t Level = 1; Level < InMips.size(); ++Level)
+	{
+		const FTextureMip& SrcMip = InMips[Level - 1];
+		const FTextureMip& DstMip = InMips[Level];
+
+		const uint8_t* SrcTexels = InOutMipChain + SrcMip.Offset;
+		uint8_t* DstTexels = InOutMipChain + DstMip.Offset;
+
+		const size_t SrcRowSize = static_cast<size_t>(SrcMip.Width) * 4;
+		const size_t DstRowSize = static_cast<size_t>(DstMip.Width) * 4;
+
+		// Like the columns in FilterRow, the last destination row of an odd source takes three source rows.
+		const bool bOddHeight = SrcMip.Height > 1 && (SrcMip.Height & 1) != 0;
+
+		for (uint32_t Y = 0; Y < DstMip.Height; ++Y)
+		{
+			const uint32_t NumRows = bOddHeight && Y == DstMip.Height - 1 ? 3 : 2;
+
+			const float* Rows[3];
+			uint32_t PrevSrcY = UINT32_MAX;
+
+			for (uint32_t Row = 0; Row < NumRows; ++Row)
+			{
+				uint32_t SrcY = std::min(Y * 2 + Row, SrcMip.Height - 1);
+				if (SrcY != PrevSrcY)
+				{
+					DecodeRow(SrcTexels + SrcY * SrcRowSize, SrcMip.Width, InFilter, RowBuffers[Row].data());
+					Rows[Row] = RowBuffers[Row].data();
+				}
+				else
+				{
+					Rows[Row] = Rows[Row - 1];
+				}
+
+				PrevSrcY = SrcY;
+			}
+
+			FilterRow(Rows, NumRows, SrcMip.Width, DstMip.Width, InFilter, DstTexels + Y * DstRowSize);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// How texels are averaged. SRGB filters in linear space; Normal renormalizes the averaged vectors.
+enum class EMipFilter : uint32_t
+{
+	Linear,
+	SRGB,
+	Normal,
+};
+
+// One level of a mip chain. Offset is relative to the start of the chain.
+struct FTextureMip
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint64_t Offset = 0;
+	uint64_t Size = 0;
+};
+
+static_assert(sizeof(FTextureMip) == 24, "FTextureMip is part of the on-disk texture cache format.");
+
+// Import-time mip generation for RGBA8 textures. Every level is stored back to back, largest first.
+class FMipGenerator
+{
+public:
+	static uint32_t GetNumMipLevels(uint32_t InWidth, uint32_t InHeight);
+
+	// Fills OutMips with the layout of the first InNumLevels levels and returns the size of the whole chain.
+	static uint64_t GetMipChainLayout(uint32_t InWidth, uint32_t InHeight, uint32_t InNumLevels, std::vector<FTextureMip>& OutMips);
+
+	// Builds every level after the first from the one above it with a 2x2 box filter. Along an odd source dimension
+	// the last destination texel averages three source texels instead, so the last row and column still contribute.
+	static void GenerateMips(uint8_t* InOutMipChain, const std::vector<FTextureMip>& InMips, EMipFilter InFilter);
+};
@@ -0,0 +1,864 @@
+#include "ObjParser.h"
+
+#include "FileSystem.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <memory>
+#include <limits>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+
+// Chunks are at least this large so that small files are parsed on the calling thread alone.
+static constexpr size_t MinChunkSize = 1 << 20;
+
+static constexpr int32_t MissingObjIndex = -1;
+
+static const double PowersOf10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// One corner of a face as written. Negative OBJ indices count back from the last attribute seen so far, which a chunk
+// only knows relative to its own start, so they are kept chunk-relative until the chunks are merged.
+struct FObjCorner
+{
+	int32_t Position;
+	int32_t TexCoord;
+	int32_t Normal;
+	uint8_t RelativeMask;
+};
+
+enum EObjRelative : uint8_t
+{
+	ObjRelativePosition = 1,
+	ObjRelativeTexCoord = 2,
+	ObjRelativeNormal = 4,
+};
+
+struct FObjMaterialRun
+{
+	uint32_t FirstTriangle;
+	// Into the chunk's material names, or -1 for faces that continue the material of the previous chunk.
+	int32_t Material;
+};
+
+struct FObjChunk
+{
+	const char* Begin = nullptr;
+	const char* End = nullptr;
+
+	std::vector<float> Positions;
+	std::vector<float> TexCoords;
+	std::vector<float> Normals;
+	std::vector<FObjCorner> Corners;
+
+	std::vector<FObjMaterialRun> MaterialRuns;
+	std::vector<std::string> MaterialNames;
+	std::vector<std::string> MaterialLibraries;
+
+	// Filled in when the chunks are merged.
+	uint32_t PositionBase = 0;
+	uint32_t TexCoordBase = 0;
+	uint32_t NormalBase = 0;
+	bool bValid = true;
+	// Every corner uses the same index for all of its attributes, so positions can be used as vertices directly.
+	bool bAligned = true;
+	bool bHasTexCoords = false;
+	bool bHasNormals = false;
+	bool bMissingTexCoords = false;
+	bool bMissingNormals = false;
+};
+
+// True when all eight bytes are ASCII digits.
+static bool IsEightDigits(uint64_t InChars)
+{
+	return (((InChars + 0x4646464646464646ULL) | (InChars - 0x3030303030303030ULL)) & 0x8080808080808080ULL) == 0;
+}
+
+// Converts eight ASCII digits, the first in the lowest byte, with three multiplies instead of eight.
+static uint32_t ParseEightDigits(uint64_t InChars)
+{
+	InChars = ((InChars & 0x0f0f0f0f0f0f0f0fULL) * 2561) >> 8;
+	InChars = ((InChars & 0x00ff00ff00ff00ffULL) * 6553601) >> 16;
+	return static_cast<uint32_t>(((InChars & 0x0000ffff0000ffffULL) * 42949672960001ULL) >> 32);
+}
+
+static bool IsDigit(char InChar)
+{
+	return InChar >= '0' && InChar <= '9';
+}
+
+// Accumulates a run of digits. OutNumDigits counts every digit, so the caller can tell when Mantissa overflowed.
+static const char* ParseDigits(const char* InCursor, const char* InEnd, uint64_t& InOutMantissa, int32_t& InOutNumDigits)
+{
+	while (InEnd - InCursor >= 8)
+	{
+		uint64_t Chars;
+		memcpy(&Chars, InCursor, sizeof(Chars));
+		if (IsEightDigits(Chars) == false)
+		{
+			break;
+		}
+
+		InOutMantissa = InOutMantissa * 100000000 + ParseEightDigits(Chars);
+		InOutNumDigits += 8;
+		InCursor += 8;
+	}
+
+	while (InCursor < InEnd && IsDigit(*InCursor))
+	{
+		InOutMantissa = InOutMantissa * 10 + static_cast<uint64_t>(*InCursor - '0');
+		++InOutNumDigits;
+		++InCursor;
+	}
+
+	return InCursor;
+}
+
+bool FObjParser::ParseFloat(const char*& InOutCursor, const char* InEnd, float& OutValue)
+{
+	const char* Cursor = InOutCursor;
+
+	bool bNegative = false;
+	if (Cursor < InEnd && (*Cursor == '-' || *Cursor == '+'))
+	{
+		bNegative = *Cursor == '-';
+		++Cursor;
+	}
+
+	uint64_t Mantissa = 0;
+	int32_t NumDigits = 0;
+	int32_t Exponent = 0;
+
+	Cursor = ParseDigits(Cursor, InEnd, Mantissa, NumDigits);
+
+	if (Cursor < InEnd && *Cursor == '.')
+	{
+		const char* FractionStart = ++Cursor;
+		Cursor = ParseDigits(Cursor, InEnd, Mantissa, NumDigits);
+		Exponent -= static_cast<int32_t>(Cursor - FractionStart);
+	}
+
+	if (NumDigits == 0)
+	{
+		return false;
+	}
+
+	bool bExact = NumDigits <= 19;
+
+	if (Cursor < InEnd && (*Cursor == 'e' || *Cursor == 'E'))
+	{
+		const char* ExponentCursor = Cursor + 1;
+
+		bool bNegativeExponent = false;
+		if (ExponentCursor < InEnd && (*ExponentCursor == '-' || *ExponentCursor == '+'))
+		{
+			bNegativeExponent = *ExponentCursor == '-';
+			++ExponentCursor;
+		}
+
+		// Without digits the 'e' is not part of the number.
+		if (ExponentCursor < InEnd && IsDigit(*ExponentCursor))
+		{
+			int32_t ExplicitExponent = 0;
+			while (ExponentCursor < InEnd && IsDigit(*ExponentCursor))
+			{
+				ExplicitExponent = std::min(ExplicitExponent * 10 + (*ExponentCursor - '0'), 100000);
+				++ExponentCursor;
+			}
+
+			Exponent += bNegativeExponent ? -ExplicitExponent : ExplicitExponent;
+			Cursor = ExponentCursor;
+		}
+	}
+
+	// Both the mantissa and the power of ten are exact doubles here, so one multiply or divide rounds correctly.
+	if (bExact && Mantissa <= (1ULL << 53) && Exponent >= -22 && Exponent <= 22)
+	{
+		double Value = static_cast<double>(Mantissa);
+		Value = Exponent < 0 ? Value / PowersOf10[-Exponent] : Value * PowersOf10[Exponent];
+
+		OutValue = static_cast<float>(bNegative ? -Value : Value);
+		InOutCursor = Cursor;
+		return true;
+	}
+
+	// strtod needs a terminated string, and the mapped file is not one.
+	char Buffer[128];
+	size_t Length = static_cast<size_t>(Cursor - InOutCursor);
+	if (Length >= sizeof(Buffer))
+	{
+		return false;
+	}
+
+	memcpy(Buffer, InOutCursor, Length);
+	Buffer[Length] = '\0';
+
+	OutValue = static_cast<float>(strtod(Buffer, nullptr));
+	InOutCursor = Cursor;
+	return true;
+}
+
+static const char* SkipSpaces(const char* InCursor, const char* InEnd)
+{
+	while (InCursor < InEnd && (*InCursor == ' ' || *InCursor == '\t'))
+	{
+		++InCursor;
+	}
+
+	return InCursor;
+}
+
+static bool IsSpace(char InChar)
+{
+	return InChar == ' ' || InChar == '\t';
+}
+
+static bool StartsWithKeyword(const char* InCursor, const char* InEnd, const char* InKeyword, size_t InLength)
+{
+	return static_cast<size_t>(InEnd - InCursor) > InLength && memcmp(InCursor, InKeyword, InLength) == 0 && IsSpace(InCursor[InLength]);
+}
+
+static std::string ReadRestOfLine(const char* InCursor, const char* InEnd)
+{
+	InCursor = SkipSpaces(InCursor, InEnd);
+	while (InEnd > InCursor && (IsSpace(InEnd[-1]) || InEnd[-1] == '\r'))
+	{
+		--InEnd;
+	}
+
+	return std::string(InCursor, InEnd);
+}
+
+// Reads up to InMaxValues floats, leaving the rest of OutValues at zero.
+static void ParseFloats(const char* InCursor, const char* InEnd, uint32_t InMaxValues, float* OutValues)
+{
+	for (uint32_t Idx = 0; Idx < InMaxValues; ++Idx)
+	{
+		InCursor = SkipSpaces(InCursor, InEnd);
+		if (FObjParser::ParseFloat(InCursor, InEnd, OutValues[Idx]) == false)
+		{
+			return;
+		}
+	}
+}
+
+static bool ParseIndex(const char*& InOutCursor, const char* InEnd, int64_t& OutIndex)
+{
+	const char* Cursor = InOutCursor;
+
+	bool bNegative = false;
+	if (Cursor < InEnd && (*Cursor == '-' || *Cursor == '+'))
+	{
+		bNegative = *Cursor == '-';
+		++Cursor;
+	}
+
+	if (Cursor == InEnd || IsDigit(*Cursor) == false)
+	{
+		return false;
+	}
+
+	int64_t Index = 0;
+	while (Cursor < InEnd && IsDigit(*Cursor))
+	{
+		Index = std::min<int64_t>(Index * 10 + (*Cursor - '0'), std::numeric_limits<int32_t>::max());
+		++Cursor;
+	}
+
+	OutIndex = bNegative ? -Index : Index;
+	InOutCursor = Cursor;
+	return true;
+}
+
+// Positive indices are 1-based and absolute; negative ones count back from InLocalCount, the attributes of this chunk
+// seen so far. Relative results may be negative when they point into an earlier chunk.
+static int32_t ResolveIndex(int64_t InIndex, size_t InLocalCount, uint8_t InRelativeFlag, uint8_t& InOutRelativeMask)
+{
+	if (InIndex > 0)
+	{
+		return static_cast<int32_t>(InIndex - 1);
+	}
+
+	InOutRelativeMask |= InRelativeFlag;
+	return static_cast<int32_t>(static_cast<int64_t>(InLocalCount) + InIndex);
+}
+
+static void ParseFace(const char* InCursor, const char* InEnd, FObjChunk& InOutChunk, std::vector<FObjCorner>& InOutFaceCorners)
+{
+	InOutFaceCorners.clear();
+
+	while (true)
+	{
+		InCursor = SkipSpaces(InCursor, InEnd);
+
+		int64_t PositionIndex = 0;
+		if (ParseIndex(InCursor, InEnd, PositionIndex) == false || PositionIndex == 0)
+		{
+			break;
+		}
+
+		FObjCorner Corner;
+		Corner.RelativeMask = 0;
+		Corner.Position = ResolveIndex(PositionIndex, InOutChunk.Positions.size() / 3, ObjRelativePosition, Corner.RelativeMask);
+		Corner.TexCoord = MissingObjIndex;
+		Corner.Normal = MissingObjIndex;
+
+		if (InCursor < InEnd && *InCursor == '/')
+		{
+			++InCursor;
+
+			int64_t TexCoordIndex = 0;
+			if (ParseIndex(InCursor, InEnd, TexCoordIndex) && TexCoordIndex != 0)
+			{
+				Corner.TexCoord = ResolveIndex(TexCoordIndex, InOutChunk.TexCoords.size() / 2, ObjRelativeTexCoord, Corner.RelativeMask);
+			}
+
+			if (InCursor < InEnd && *InCursor == '/')
+			{
+				++InCursor;
+
+				int64_t NormalIndex = 0;
+				if (ParseIndex(InCursor, InEnd, NormalIndex) && NormalIndex != 0)
+				{
+					Corner.Normal = ResolveIndex(NormalIndex, InOutChunk.Normals.size() / 3, ObjRelativeNormal, Corner.RelativeMask);
+				}
+			}
+		}
+
+		InOutFaceCorners.push_back(Corner);
+
+		// Skips whatever else the token holds, e.g. a malformed index.
+		while (InCursor < InEnd && IsSpace(*InCursor) == false)
+		{
+			++InCursor;
+		}
+	}
+
+	for (size_t Idx = 2; Idx < InOutFaceCorners.size(); ++Idx)
+	{
+		InOutChunk.Corners.push_back(InOutFaceCorners[0]);
+		InOutChunk.Corners.push_back(InOutFaceCorners[Idx - 1]);
+		InOutChunk.Corners.push_back(InOutFaceCorners[Idx]);
+	}
+}
+
+static void ParseChunk(FObjChunk& InOutChunk)
+{
+	InOutChunk.MaterialRuns.push_back({ 0, -1 });
+
+	std::vector<FObjCorner> FaceCorners;
+
+	const char* Cursor = InOutChunk.Begin;
+	const char* End = InOutChunk.End;
+
+	while (Cursor < End)
+	{
+		const char* LineEnd = static_cast<const char*>(memchr(Cursor, '\n', static_cast<size_t>(End - Cursor)));
+		if (LineEnd == nullptr)
+		{
+			LineEnd = End;
+		}
+
+		const char* Line = SkipSpaces(Cursor, LineEnd);
+		Cursor = LineEnd + (LineEnd < End ? 1 : 0);
+
+		if (LineEnd - Line < 2)
+		{
+			continue;
+		}
+
+		if (Line[0] == 'v')
+		{
+			if (IsSpace(Line[1]))
+			{
+				float Position[3] = {};
+				ParseFloats(Line + 2, LineEnd, 3, Position);
+				InOutChunk.Positions.insert(InOutChunk.Positions.end(), Position, Position + 3);
+			}
+			else if (Line[1] == 't' && LineEnd - Line > 2 && IsSpace(Line[2]))
+			{
+				float TexCoords[2] = {};
+				ParseFloats(Line + 3, LineEnd, 2, TexCoords);
+				InOutChunk.TexCoords.insert(InOutChunk.TexCoords.end(), TexCoords, TexCoords + 2);
+			}
+			else if (Line[1] == 'n' && LineEnd - Line > 2 && IsSpace(Line[2]))
+			{
+				float Normal[3] = {};
+				ParseFloats(Line + 3, LineEnd, 3, Normal);
+				InOutChunk.Normals.insert(InOutChunk.Normals.end(), Normal, Normal + 3);
+			}
+		}
+		else if (Line[0] == 'f' && IsSpace(Line[1]))
+		{
+			ParseFace(Line + 2, LineEnd, InOutChunk, FaceCorners);
+		}
+		else if (StartsWithKeyword(Line, LineEnd, "usemtl", 6))
+		{
+			std::string Name = ReadRestOfLine(Line + 6, LineEnd);
+
+			auto Iter = std::find(InOutChunk.MaterialNames.begin(), InOutChunk.MaterialNames.end(), Name);
+			int32_t Material = static_cast<int32_t>(Iter - InOutChunk.MaterialNames.begin());
+			if (Iter == InOutChunk.MaterialNames.end())
+			{
+				InOutChunk.MaterialNames.push_back(Name);
+			}
+
+			uint32_t NumTriangles = static_cast<uint32_t>(InOutChunk.Corners.size() / 3);
+			if (InOutChunk.MaterialRuns.back().FirstTriangle == NumTriangles)
+			{
+				InOutChunk.MaterialRuns.back().Material = Material;
+			}
+			else
+			{
+				InOutChunk.MaterialRuns.push_back({ NumTriangles, Material });
+			}
+		}
+		else if (StartsWithKeyword(Line, LineEnd, "mtllib", 6))
+		{
+			InOutChunk.MaterialLibraries.push_back(ReadRestOfLine(Line + 6, LineEnd));
+		}
+	}
+}
+
+// Turns chunk-relative indices into absolute ones and checks them against the merged attribute counts.
+static void ResolveChunk(FObjChunk& InOutChunk, uint32_t InNumPositions, uint32_t InNumTexCoords, uint32_t InNumNormals)
+{
+	auto Resolve = [](int32_t& InOutIndex, bool bInRelative, uint32_t InBase, uint32_t InCount) -> bool
+	{
+		int64_t Index = bInRelative ? static_cast<int64_t>(InBase) + InOutIndex : InOutIndex;
+		if (Index < 0 || Index >= InCount)
+		{
+			return false;
+		}
+
+		InOutIndex = static_cast<int32_t>(Index);
+		return true;
+	};
+
+	for (FObjCorner& Corner : InOutChunk.Corners)
+	{
+		if (Resolve(Corner.Position, (Corner.RelativeMask & ObjRelativePosition) != 0, InOutChunk.PositionBase, InNumPositions) == false)
+		{
+			InOutChunk.bValid = false;
+			return;
+		}
+
+		if (Corner.TexCoord != MissingObjIndex || (Corner.RelativeMask & ObjRelativeTexCoord) != 0)
+		{
+			if (Resolve(Corner.TexCoord, (Corner.RelativeMask & ObjRelativeTexCoord) != 0, InOutChunk.TexCoordBase, InNumTexCoords) == false)
+			{
+				InOutChunk.bValid = false;
+				return;
+			}
+
+			InOutChunk.bHasTexCoords = true;
+		}
+		else
+		{
+			InOutChunk.bMissingTexCoords = true;
+		}
+
+		if (Corner.Normal != MissingObjIndex || (Corner.RelativeMask & ObjRelativeNormal) != 0)
+		{
+			if (Resolve(Corner.Normal, (Corner.RelativeMask & ObjRelativeNormal) != 0, InOutChunk.NormalBase, InNumNormals) == false)
+			{
+				InOutChunk.bValid = false;
+				return;
+			}
+
+			InOutChunk.bHasNormals = true;
+		}
+		else
+		{
+			InOutChunk.bMissingNormals = true;
+		}
+
+		InOutChunk.bAligned = InOutChunk.bAligned
+			&& (Corner.TexCoord == MissingObjIndex || Corner.TexCoord == Corner.Position)
+			&& (Corner.Normal == MissingObjIndex || Corner.Normal == Corner.Position);
+	}
+}
+
+// Open addressing map from a corner's attribute indices to its vertex, much lighter than std::unordered_map for the
+// tens of millions of corners of a scan. Corners are placed by position index rather than a hash: faces that are close
+// in the file mostly share nearby positions, so their lookups stay in cache, and the few corners of one position that
+// differ in texture coordinate or normal probe the slots that follow.
+class FObjVertexTable
+{
+public:
+	FObjVertexTable(size_t InNumPositions, size_t InExpectedVertices)
+	{
+		size_t Capacity = 16;
+		while (Capacity < InNumPositions * 2 || Capacity < InExpectedVertices * 2)
+		{
+			Capacity *= 2;
+		}
+
+		while (InNumPositions > 0 && (InNumPositions << (SpreadShift + 1)) <= Capacity)
+		{
+			++SpreadShift;
+		}
+
+		Entries.resize(Capacity);
+	}
+
+	// Returns the vertex of InCorner, or InNewVertex after adding it.
+	uint32_t FindOrAdd(const FObjCorner& InCorner, uint32_t InNewVertex)
+	{
+		if ((NumEntries + 1) * 2 > Entries.size())
+		{
+			Grow();
+		}
+
+		size_t Mask = Entries.size() - 1;
+		for (size_t Slot = GetHomeSlot(InCorner); ; Slot = (Slot + 1) & Mask)
+		{
+			FEntry& Entry = Entries[Slot];
+			if (Entry.Vertex == EmptyVertex)
+			{
+				Entry.Position = InCorner.Position;
+				Entry.TexCoord = InCorner.TexCoord;
+				Entry.Normal = InCorner.Normal;
+				Entry.Vertex = InNewVertex;
+				++NumEntries;
+				return InNewVertex;
+			}
+
+			if (Entry.Position == InCorner.Position && Entry.TexCoord == InCorner.TexCoord && Entry.Normal == InCorner.Normal)
+			{
+				return Entry.Vertex;
+			}
+		}
+	}
+
+private:
+	static constexpr uint32_t EmptyVertex = UINT32_MAX;
+
+	struct FEntry
+	{
+		int32_t Position = 0;
+		int32_t TexCoord = 0;
+		int32_t Normal = 0;
+		uint32_t Vertex = EmptyVertex;
+	};
+
+	size_t GetHomeSlot(const FObjCorner& InCorner) const
+	{
+		return (static_cast<size_t>(InCorner.Position) << SpreadShift) & (Entries.size() - 1);
+	}
+
+	void Grow()
+	{
+		std::vector<FEntry> OldEntries(Entries.size() * 2);
+		OldEntries.swap(Entries);
+		NumEntries = 0;
+		++SpreadShift;
+
+		size_t Mask = Entries.size() - 1;
+		for (const FEntry& OldEntry : OldEntries)
+		{
+			if (OldEntry.Vertex == EmptyVertex)
+			{
+				continue;
+			}
+
+			FObjCorner Corner{ OldEntry.Position, OldEntry.TexCoord, OldEntry.Normal, 0 };
+			size_t Slot = GetHomeSlot(Corner);
+			while (Entries[Slot].Vertex != EmptyVertex)
+			{
+				Slot = (Slot + 1) & Mask;
+			}
+
+			Entries[Slot] = OldEntry;
+			++NumEntries;
+		}
+	}
+
+	std::vector<FEntry> Entries;
+	size_t NumEntries = 0;
+	// Slots per position.
+	uint32_t SpreadShift = 0;
+};
+
+bool FObjParser::IsObjFile(const std::string& InFilename)
+{
+	size_t Dot = InFilename.find_last_of('.');
+	if (Dot == std::string::npos)
+	{
+		return false;
+	}
+
+	std::string Extension = InFilename.substr(Dot);
+	std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](unsigned char InChar) { return static_cast<char>(tolower(InChar)); });
+
+	return Extension == ".obj";
+}
+
+bool FObjParser::Parse(const std::string& InFilename)
+{
+	Vertices.clear();
+	Indices.clear();
+	Groups.clear();
+	MaterialLibraries.clear();
+	bHasNormals = false;
+	bHasTexCoords = false;
+
+	FFileView File;
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	const char* Data = reinterpret_cast<const char*>(File.GetData());
+	const char* DataEnd = Data + File.GetSize();
+
+	uint32_t NumThreads = GJobSystem != nullptr ? GJobSystem->GetNumThreads() : 1;
+
+	// A few chunks per thread evens out chunks that are slower to parse, e.g. faces against vertices.
+	size_t ChunkSize = std::max(MinChunkSize, File.GetSize() / (NumThreads * 4) + 1);
+
+	std::vector<FObjChunk> Chunks;
+	for (const char* ChunkBegin = Data; ChunkBegin < DataEnd; )
+	{
+		// Chunks end after a line break so that no line is split.
+		const char* ChunkEnd = ChunkBegin + std::min(ChunkSize, static_cast<size_t>(DataEnd - ChunkBegin));
+		if (ChunkEnd < DataEnd)
+		{
+			const char* LineEnd = static_cast<const char*>(memchr(ChunkEnd, '\n', static_cast<size_t>(DataEnd - ChunkEnd)));
+			ChunkEnd = LineEnd != nullptr ? LineEnd + 1 : DataEnd;
+		}
+
+		Chunks.emplace_back();
+		Chunks.back().Begin = ChunkBegin;
+		Chunks.back().End = ChunkEnd;
+
+		ChunkBegin = ChunkEnd;
+	}
+
+	auto RunParallel = [](uint32_t InCount, uint32_t InChunkSize, const std::function<void(uint32_t InBegin, uint32_t InEnd)>& InFunction)
+	{
+		// Meshes are imported by asset loads, which are background jobs themselves.
+		if (GJobSystem != nullptr)
+		{
+			GJobSystem->ParallelForBackground(InCount, InChunkSize, InFunction);
+		}
+		else
+		{
+			InFunction(0, InCount);
+		}
+	};
+
+	uint32_t NumChunks = static_cast<uint32_t>(Chunks.size());
+
+	RunParallel(NumChunks, 1, [&Chunks](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+		{
+			ParseChunk(Chunks[Idx]);
+		}
+	});
+
+	// Every attribute must be addressable by the int32_t indices of FObjCorner.
+	const uint64_t MaxAttributes = static_cast<uint64_t>(std::numeric_limits<int32_t>::max());
+
+	uint64_t NumPositions = 0;
+	uint64_t NumTexCoords = 0;
+	uint64_t NumNormals = 0;
+	uint64_t NumCorners = 0;
+
+	for (FObjChunk& Chunk : Chunks)
+	{
+		Chunk.PositionBase = static_cast<uint32_t>(NumPositions);
+		Chunk.TexCoordBase = static_cast<uint32_t>(NumTexCoords);
+		Chunk.NormalBase = static_cast<uint32_t>(NumNormals);
+
+		NumPositions += Chunk.Positions.size() / 3;
+		NumTexCoords += Chunk.TexCoords.size() / 2;
+		NumNormals += Chunk.Normals.size() / 3;
+		NumCorners += Chunk.Corners.size();
+
+		if (NumPositions > MaxAttributes || NumTexCoords > MaxAttributes || NumNormals > MaxAttributes || NumCorners > std::numeric_limits<uint32_t>::max())
+		{
+			return false;
+		}
+	}
+
+	if (NumCorners == 0)
+	{
+		return false;
+	}
+
+	std::vector<float> Positions(NumPositions * 3);
+	std::vector<float> TexCoords(NumTexCoords * 2);
+	std::vector<float> Normals(NumNormals * 3);
+
+	RunParallel(NumChunks, 1, [&](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+		{
+			FObjChunk& Chunk = Chunks[Idx];
+			ResolveChunk(Chunk, static_cast<uint32_t>(NumPositions), static_cast<uint32_t>(NumTexCoords), static_cast<uint32_t>(NumNormals));
+
+			std::copy(Chunk.Positions.begin(), Chunk.Positions.end(), Positions.begin() + static_cast<size_t>(Chunk.PositionBase) * 3);
+			std::copy(Chunk.TexCoords.begin(), Chunk.TexCoords.end(), TexCoords.begin() + static_cast<size_t>(Chunk.TexCoordBase) * 2);
+			std::copy(Chunk.Normals.begin(), Chunk.Normals.end(), Normals.begin() + static_cast<size_t>(Chunk.NormalBase) * 3);
+
+			std::vector<float>().swap(Chunk.Positions);
+			std::vector<float>().swap(Chunk.TexCoords);
+			std::vector<float>().swap(Chunk.Normals);
+		}
+	});
+
+	bool bAligned = true;
+	bool bMissingTexCoords = false;
+	bool bMissingNormals = false;
+	for (const FObjChunk& Chunk : Chunks)
+	{
+		if (Chunk.bValid == false)
+		{
+			return false;
+		}
+
+		bAligned = bAligned && Chunk.bAligned;
+		bHasTexCoords = bHasTexCoords || Chunk.bHasTexCoords;
+		bHasNormals = bHasNormals || Chunk.bHasNormals;
+		bMissingTexCoords = bMissingTexCoords || Chunk.bMissingTexCoords;
+		bMissingNormals = bMissingNormals || Chunk.bMissingNormals;
+
+		MaterialLibraries.insert(MaterialLibraries.end(), Chunk.MaterialLibraries.begin(), Chunk.MaterialLibraries.end());
+	}
+
+	// A position used both with and without an attribute needs two vertices.
+	bAligned = bAligned && (bHasTexCoords == false || bMissingTexCoords == false) && (bHasNormals == false || bMissingNormals == false);
+
+	// Material runs in file order, each assigned to a group in the order the materials are first used.
+	struct FRun
+	{
+		const FObjChunk* Chunk;
+		uint32_t FirstTriangle;
+		uint32_t NumTriangles;
+	};
+
+	std::vector<std::vector<FRun>> GroupRuns;
+	std::unordered_map<std::string, uint32_t> GroupIndices;
+	std::string CurrentMaterial;
+
+	for (const FObjChunk& Chunk : Chunks)
+	{
+		uint32_t NumChunkTriangles = static_cast<uint32_t>(Chunk.Corners.size() / 3);
+
+		for (size_t RunIdx = 0; RunIdx < Chunk.MaterialRuns.size(); ++RunIdx)
+		{
+			const FObjMaterialRun& Run = Chunk.MaterialRuns[RunIdx];
+			if (Run.Material >= 0)
+			{
+				CurrentMaterial = Chunk.MaterialNames[Run.Material];
+			}
+
+			uint32_t RunEnd = RunIdx + 1 < Chunk.MaterialRuns.size() ? Chunk.MaterialRuns[RunIdx + 1].FirstTriangle : NumChunkTriangles;
+			if (RunEnd == Run.FirstTriangle)
+			{
+				continue;
+			}
+
+			auto [Iter, bInserted] = GroupIndices.emplace(CurrentMaterial, static_cast<uint32_t>(Groups.size()));
+			if (bInserted)
+			{
+				FObjGroup NewGroup;
+				NewGroup.Material = CurrentMaterial;
+				Groups.push_back(NewGroup);
+				GroupRuns.emplace_back();
+			}
+
+			Groups[Iter->second].NumIndices += (RunEnd - Run.FirstTriangle) * 3;
+			GroupRuns[Iter->second].push_back({ &Chunk, Run.FirstTriangle, RunEnd - Run.FirstTriangle });
+		}
+	}
+
+	Indices.reserve(static_cast<size_t>(NumCorners));
+
+	auto MakeVertex = [&](const FObjCorner& InCorner)
+	{
+		FVertex Vertex{};
+
+		const float* Position = &Positions[static_cast<size_t>(InCorner.Position) * 3];
+		Vertex.Position = glm::vec3(Position[0], Position[1], Position[2]);
+
+		if (InCorner.TexCoord != MissingObjIndex)
+		{
+			const float* TexCoord = &TexCoords[static_cast<size_t>(InCorner.TexCoord) * 2];
+			Vertex.TexCoords = glm::vec2(TexCoord[0], TexCoord[1]);
+		}
+
+		if (InCorner.Normal != MissingObjIndex)
+		{
+			const float* Normal = &Normals[static_cast<size_t>(InCorner.Normal) * 3];
+			Vertex.Normal = glm::vec3(Normal[0], Normal[1], Normal[2]);
+		}
+
+		return Vertex;
+	};
+
+	if (bAligned)
+	{
+		// Each position already is a unique vertex, so no lookups are needed. Unreferenced positions stay in.
+		Vertices.resize(static_cast<size_t>(NumPositions));
+
+		RunParallel(static_cast<uint32_t>(NumPositions), 1 << 16, [&](uint32_t InBegin, uint32_t InEnd)
+		{
+			for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+			{
+				int32_t Index = static_cast<int32_t>(Idx);
+				FObjCorner Corner{ Index, bHasTexCoords && Idx < NumTexCoords ? Index : MissingObjIndex, bHasNormals && Idx < NumNormals ? Index : MissingObjIndex, 0 };
+				Vertices[Idx] = MakeVertex(Corner);
+			}
+		});
+	}
+
+	std::unique_ptr<FObjVertexTable> VertexTable;
+	if (bAligned == false)
+	{
+		// Usually every position, texture coordinate or normal ends up in at least one vertex.
+		size_t ExpectedVertices = static_cast<size_t>(std::max({ NumPositions, NumTexCoords, NumNormals }));
+		VertexTable = std::make_unique<FObjVertexTable>(static_cast<size_t>(NumPositions), ExpectedVertices);
+	}
+
+	for (size_t GroupIdx = 0; GroupIdx < Groups.size(); ++GroupIdx)
+	{
+		Groups[GroupIdx].FirstIndex = static_cast<uint32_t>(Indices.size());
+
+		for (const FRun& Run : GroupRuns[GroupIdx])
+		{
+			const FObjCorner* Corners = Run.Chunk->Corners.data() + static_cast<size_t>(Run.FirstTriangle) * 3;
+			size_t NumRunCorners = static_cast<size_t>(Run.NumTriangles) * 3;
+
+			for (size_t Idx = 0; Idx < NumRunCorners; ++Idx)
+			{
+				const FObjCorner& Corner = Corners[Idx];
+
+				if (bAligned)
+				{
+					Indices.push_back(static_cast<uint32_t>(Corner.Position));
+					continue;
+				}
+
+				uint32_t NewVertex = static_cast<uint32_t>(Vertices.size());
+				uint32_t Vertex = VertexTable->FindOrAdd(Corner, NewVertex);
+				if (Vertex == NewVertex)
+				{
+					Vertices.push_back(MakeVertex(Corner));
+				}
+
+				Indices.push_back(Vertex);
+			}
+		}
+	}
+
+	return true;
+}
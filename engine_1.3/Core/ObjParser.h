@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Faces of one material, contiguous in the index array.
+struct FObjGroup
+{
+	// Name given to usemtl; empty for faces before the first usemtl.
+	std::string Material;
+	uint32_t FirstIndex = 0;
+	uint32_t NumIndices = 0;
+};
+
+// Wavefront OBJ reader for large scans. The file is viewed through GFileSystem, split into line-aligned chunks that
+// are parsed in parallel on the job system, and merged into vertices deduplicated by their position, texture
+// coordinate and normal indices. Polygons are triangulated as fans. Texture coordinates are kept as written, with V
+// pointing up.
+class FObjParser
+{
+public:
+	static bool IsObjFile(const std::string& InFilename);
+
+	bool Parse(const std::string& InFilename);
+
+	const std::vector<FVertex>& GetVertices() const { return Vertices; }
+	const std::vector<uint32_t>& GetIndices() const { return Indices; }
+
+	// One group per material, in the order the materials are first used.
+	const std::vector<FObjGroup>& GetGroups() const { return Groups; }
+	const std::vector<std::string>& GetMaterialLibraries() const { return MaterialLibraries; }
+
+	// Whether any face referenced a normal or a texture coordinate; the others are zero.
+	bool HasNormals() const { return bHasNormals; }
+	bool HasTexCoords() const { return bHasTexCoords; }
+
+	// Parses a decimal floating point number as written in OBJ files and advances InOutCursor past it. Digits are
+	// consumed eight at a time; numbers that cannot be converted exactly that way fall back to strtod.
+	static bool ParseFloat(const char*& InOutCursor, const char* InEnd, float& OutValue);
+
+private:
+	std::vector<FVertex> Vertices;
+	std::vector<uint32_t> Indices;
+	std::vector<FObjGroup> Groups;
+	std::vector<std::string> MaterialLibraries;
+
+	bool bHasNormals = false;
+	bool bHasTexCoords = false;
+};
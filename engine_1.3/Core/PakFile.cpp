@@ -0,0 +1,307 @@
+#include "PakFile.h"
+
+#include "LZ4.h"
+#include "Utils.h"
+
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <filesystem>
+#include <system_error>
+#include <algorithm>
+#include <cstring>
+
+static uint64_t AlignOffset(uint64_t InOffset, uint32_t InAlignment)
+{
+	return (InOffset + InAlignment - 1) & ~static_cast<uint64_t>(InAlignment - 1);
+}
+
+static void WritePadding(std::ofstream& InFile, uint64_t InSize)
+{
+	static const char Padding[256] = {};
+
+	while (InSize > 0)
+	{
+		uint64_t Chunk = std::min<uint64_t>(InSize, sizeof(Padding));
+		InFile.write(Padding, static_cast<std::streamsize>(Chunk));
+		InSize -= Chunk;
+	}
+}
+
+std::string FPakFile::NormalizePath(std::string_view InPath)
+{
+	std::string Path(InPath);
+	std::replace(Path.begin(), Path.end(), '\\', '/');
+
+	size_t Start = 0;
+	while (Start < Path.size() && Path[Start] == '/')
+	{
+		++Start;
+	}
+
+	return Path.substr(Start);
+}
+
+uint64_t FPakFile::HashPath(std::string_view InNormalizedPath)
+{
+	return HashBytes(InNormalizedPath.data(), InNormalizedPath.size());
+}
+
+bool FPakFile::Write(const std::string& InFilename, const std::vector<FPakWriteEntry>& InEntries, uint32_t InAlignment)
+{
+	if (InAlignment == 0 || (InAlignment & (InAlignment - 1)) != 0)
+	{
+		return false;
+	}
+
+	struct FPendingEntry
+	{
+		std::string Path;
+		const std::vector<uint8_t>* Data;
+		EPakCompression Compression;
+		uint64_t Hash;
+		size_t Order;
+	};
+
+	std::vector<FPendingEntry> Pending;
+	Pending.reserve(InEntries.size());
+
+	for (size_t Idx = 0; Idx < InEntries.size(); ++Idx)
+	{
+		std::string Path = NormalizePath(InEntries[Idx].Path);
+		uint64_t Hash = HashPath(Path);
+		Pending.push_back({ std::move(Path), &InEntries[Idx].Data, InEntries[Idx].Compression, Hash, Idx });
+	}
+
+	// Sorted by hash for lookups; when the same path is added twice the last one is kept.
+	std::sort(Pending.begin(), Pending.end(), [](const FPendingEntry& A, const FPendingEntry& B)
+	{
+		if (A.Hash != B.Hash)
+		{
+			return A.Hash < B.Hash;
+		}
+		if (A.Path != B.Path)
+		{
+			return A.Path < B.Path;
+		}
+		return A.Order > B.Order;
+	});
+
+	Pending.erase(std::unique(Pending.begin(), Pending.end(), [](const FPendingEntry& A, const FPendingEntry& B)
+	{
+		return A.Hash == B.Hash && A.Path == B.Path;
+	}), Pending.end());
+
+	std::vector<FPakEntry> Entries(Pending.size());
+	std::vector<std::vector<uint8_t>> Compressed(Pending.size());
+	std::string Names;
+
+	uint64_t Offset = AlignOffset(sizeof(FPakHeader), InAlignment);
+
+	for (size_t Idx = 0; Idx < Pending.size(); ++Idx)
+	{
+		const FPendingEntry& Source = Pending[Idx];
+		FPakEntry& Entry = Entries[Idx];
+
+		Entry.PathHash = Source.Hash;
+		Entry.UncompressedSize = Source.Data->size();
+		Entry.Size = Source.Data->size();
+		Entry.Compression = EPakCompression::None;
+		Entry.NameOffset = static_cast<uint32_t>(Names.size());
+		Entry.NameLength = static_cast<uint32_t>(Source.Path.size());
+		Entry.Reserved = 0;
+
+		Names += Source.Path;
+
+		if (Source.Compression == EPakCompression::LZ4 && Source.Data->empty() == false)
+		{
+			std::vector<uint8_t>& Block = Compressed[Idx];
+			Block.resize(FLZ4::GetMaxCompressedSize(Source.Data->size()));
+
+			size_t CompressedSize = FLZ4::Compress(Source.Data->data(), Source.Data->size(), Block.data(), Block.size());
+			if (CompressedSize > 0 && CompressedSize < Source.Data->size())
+			{
+				Block.resize(CompressedSize);
+				Entry.Size = CompressedSize;
+				Entry.Compression = EPakCompression::LZ4;
+			}
+			else
+			{
+				Block.clear();
+				Block.shrink_to_fit();
+			}
+		}
+
+		Entry.Offset = Offset;
+		Offset = AlignOffset(Offset + Entry.Size, InAlignment);
+	}
+
+	FPakHeader Header{};
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumEntries = static_cast<uint32_t>(Entries.size());
+	Header.Alignment = InAlignment;
+	Header.TocOffset = AlignOffset(Offset, alignof(FPakEntry));
+	Header.NamesOffset = Header.TocOffset + Entries.size() * sizeof(FPakEntry);
+	Header.NamesSize = Names.size();
+
+	// Same temporary file scheme as the texture and mesh caches.
+	std::string TempFilename = InFilename + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+	{
+		std::ofstream File(TempFilename, std::ios::binary | std::ios::trunc);
+		if (File.is_open() == false)
+		{
+			return false;
+		}
+
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+		uint64_t Written = sizeof(Header);
+		for (size_t Idx = 0; Idx < Entries.size(); ++Idx)
+		{
+			const FPakEntry& Entry = Entries[Idx];
+			const uint8_t* Data = Entry.Compression == EPakCompression::LZ4 ? Compressed[Idx].data() : Pending[Idx].Data->data();
+
+			WritePadding(File, Entry.Offset - Written);
+			File.write(reinterpret_cast<const char*>(Data), static_cast<std::streamsize>(Entry.Size));
+			Written = Entry.Offset + Entry.Size;
+		}
+
+		WritePadding(File, Header.TocOffset - Written);
+		File.write(reinterpret_cast<const char*>(Entries.data()), static_cast<std::streamsize>(Entries.size() * sizeof(FPakEntry)));
+		File.write(Names.data(), static_cast<std::streamsize>(Names.size()));
+
+		if (File.good() == false)
+		{
+			File.close();
+
+			std::error_code ErrorCode;
+			std::filesystem::remove(TempFilename, ErrorCode);
+			return false;
+		}
+	}
+
+	std::error_code ErrorCode;
+	std::filesystem::rename(TempFilename, InFilename, ErrorCode);
+	if (ErrorCode)
+	{
+		std::filesystem::remove(TempFilename, ErrorCode);
+		return false;
+	}
+
+	return true;
+}
+
+bool FPakFile::Open(const std::string& InFilename)
+{
+	Close();
+
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	if (File.GetSize() < sizeof(FPakHeader))
+	{
+		File.Close();
+		return false;
+	}
+
+	const FPakHeader* MappedHeader = reinterpret_cast<const FPakHeader*>(File.GetData());
+	const uint64_t FileSize = File.GetSize();
+
+	if (MappedHeader->Magic != Magic ||
+		MappedHeader->Version != Version ||
+		MappedHeader->TocOffset % alignof(FPakEntry) != 0 ||
+		MappedHeader->TocOffset > FileSize ||
+		static_cast<uint64_t>(MappedHeader->NumEntries) * sizeof(FPakEntry) > FileSize - MappedHeader->TocOffset ||
+		MappedHeader->NamesOffset > FileSize ||
+		MappedHeader->NamesSize > FileSize - MappedHeader->NamesOffset)
+	{
+		File.Close();
+		return false;
+	}
+
+	const FPakEntry* MappedEntries = reinterpret_cast<const FPakEntry*>(File.GetData() + MappedHeader->TocOffset);
+	for (uint32_t Idx = 0; Idx < MappedHeader->NumEntries; ++Idx)
+	{
+		const FPakEntry& Entry = MappedEntries[Idx];
+		if (Entry.Offset > FileSize ||
+			Entry.Size > FileSize - Entry.Offset ||
+			static_cast<uint64_t>(Entry.NameOffset) + Entry.NameLength > MappedHeader->NamesSize ||
+			(Entry.Compression == EPakCompression::None && Entry.Size != Entry.UncompressedSize) ||
+			Entry.Compression > EPakCompression::LZ4)
+		{
+			File.Close();
+			return false;
+		}
+	}
+
+	Header = MappedHeader;
+	Entries = MappedEntries;
+	Names = reinterpret_cast<const char*>(File.GetData() + MappedHeader->NamesOffset);
+
+	return true;
+}
+
+void FPakFile::Close()
+{
+	Header = nullptr;
+	Entries = nullptr;
+	Names = nullptr;
+	File.Close();
+}
+
+const FPakEntry* FPakFile::FindEntry(std::string_view InNormalizedPath) const
+{
+	if (Header == nullptr)
+	{
+		return nullptr;
+	}
+
+	uint64_t Hash = HashPath(InNormalizedPath);
+
+	const FPakEntry* End = Entries + Header->NumEntries;
+	const FPakEntry* It = std::lower_bound(Entries, End, Hash, [](const FPakEntry& InEntry, uint64_t InHash)
+	{
+		return InEntry.PathHash < InHash;
+	});
+
+	for (; It != End && It->PathHash == Hash; ++It)
+	{
+		if (GetEntryName(*It) == InNormalizedPath)
+		{
+			return It;
+		}
+	}
+
+	return nullptr;
+}
+
+std::string_view FPakFile::GetEntryName(const FPakEntry& InEntry) const
+{
+	return std::string_view(Names + InEntry.NameOffset, InEntry.NameLength);
+}
+
+const uint8_t* FPakFile::GetEntryData(const FPakEntry& InEntry) const
+{
+	return File.GetData() + InEntry.Offset;
+}
+
+bool FPakFile::ReadEntry(const FPakEntry& InEntry, uint8_t* OutData) const
+{
+	switch (InEntry.Compression)
+	{
+	case EPakCompression::None:
+		if (InEntry.Size > 0)
+		{
+			memcpy(OutData, GetEntryData(InEntry), static_cast<size_t>(InEntry.Size));
+		}
+		return true;
+	case EPakCompression::LZ4:
+		return FLZ4::Decompress(GetEntryData(InEntry), static_cast<size_t>(InEntry.Size), OutData, static_cast<size_t>(InEntry.UncompressedSize));
+	default:
+		return false;
+	}
+}
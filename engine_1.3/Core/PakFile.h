@@ -0,0 +1,91 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+enum class EPakCompression : uint32_t
+{
+	None,
+	LZ4,
+};
+
+struct FPakHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t NumEntries;
+	uint32_t Alignment;
+	uint64_t TocOffset;
+	uint64_t NamesOffset;
+	uint64_t NamesSize;
+	uint64_t Reserved;
+};
+
+static_assert(sizeof(FPakHeader) == 48, "FPakHeader is part of the on-disk pak format.");
+
+// Table of contents entry. Entries are sorted by PathHash; names are kept to resolve hash collisions.
+struct FPakEntry
+{
+	uint64_t PathHash;
+	uint64_t Offset;
+	uint64_t Size;
+	uint64_t UncompressedSize;
+	uint32_t NameOffset;
+	uint32_t NameLength;
+	EPakCompression Compression;
+	uint32_t Reserved;
+};
+
+static_assert(sizeof(FPakEntry) == 48, "FPakEntry is part of the on-disk pak format.");
+
+// One file to be written into a pak. Compression is only kept when it makes the entry smaller.
+struct FPakWriteEntry
+{
+	std::string Path;
+	std::vector<uint8_t> Data;
+	EPakCompression Compression = EPakCompression::None;
+};
+
+// Read-only archive of many files. The whole archive is mapped once; entries start at aligned offsets, so stored
+// entries can be used in place and lookups are a binary search over path hashes.
+class FPakFile
+{
+public:
+	static constexpr uint32_t Magic = 0x4b504b56; // "VKPK"
+	static constexpr uint32_t Version = 1;
+	static constexpr uint32_t DefaultAlignment = 16;
+
+	// Paths are relative to the mount point and use forward slashes.
+	static std::string NormalizePath(std::string_view InPath);
+	static uint64_t HashPath(std::string_view InNormalizedPath);
+
+	// InAlignment must be a power of two.
+	static bool Write(const std::string& InFilename, const std::vector<FPakWriteEntry>& InEntries, uint32_t InAlignment = DefaultAlignment);
+
+	bool Open(const std::string& InFilename);
+	void Close();
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	const FPakEntry* FindEntry(std::string_view InNormalizedPath) const;
+
+	uint32_t GetNumEntries() const { return Header != nullptr ? Header->NumEntries : 0; }
+	const FPakEntry* GetEntries() const { return Entries; }
+	std::string_view GetEntryName(const FPakEntry& InEntry) const;
+
+	// The entry as stored, compressed or not. Points into the mapping.
+	const uint8_t* GetEntryData(const FPakEntry& InEntry) const;
+
+	// Writes the UncompressedSize bytes of the entry to OutData, decompressing it if needed.
+	bool ReadEntry(const FPakEntry& InEntry, uint8_t* OutData) const;
+
+private:
+	FMappedFile File;
+	const FPakHeader* Header = nullptr;
+	const FPakEntry* Entries = nullptr;
+	const char* Names = nullptr;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Texture.h"
+#include "AssetPtr.h"
 
 #include "glm/glm.hpp"
 
@@ -20,6 +21,6 @@ struct FShaderParameter
 	float FloatParam;
 	glm::vec3 Vec3Param;
 	glm::vec4 Vec4Param;
-	UTexture* TexParam;
+	TAssetPtr<UTexture> TexParam;
 };
 
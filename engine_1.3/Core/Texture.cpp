@@ -19,6 +19,11 @@ UTexture::~UTexture()
 	DestroyRenderTexture();
 }
 
+size_t UTexture::GetGPUMemorySize() const
+{
+	return RenderTexture != nullptr ? static_cast<size_t>(RenderTexture->GetMemorySize()) : 0;
+}
+
 FVulkanTexture* UTexture::GetRenderTexture() const
 {
 	return RenderTexture;
@@ -13,6 +13,8 @@ public:
 	UTexture();
 	virtual ~UTexture();
 
+	virtual size_t GetGPUMemorySize() const override;
+
 	class FVulkanTexture* GetRenderTexture() const;
 	virtual void CreateRenderTexture() { }
 	void DestroyRenderTexture();
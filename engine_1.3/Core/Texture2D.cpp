@@ -5,8 +5,34 @@
 #include "VulkanContext.h"
 #include "VulkanTexture.h"
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include "Config.h"
+#include "ImageDecoder.h"
+#include "FileSystem.h"
+#include "Utils.h"
+
+#include <climits>
+#include <utility>
+
+static ETextureCompression GetTextureCompression()
+{
+	std::string Compression = "Default";
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("TextureCompression", Compression);
+	}
+
+	if (Compression == "None")
+	{
+		return ETextureCompression::None;
+	}
+
+	if (Compression == "HighQuality")
+	{
+		return ETextureCompression::HighQuality;
+	}
+
+	return ETextureCompression::Default;
+}
 
 UTexture2D::UTexture2D()
 	: UTexture()
@@ -14,57 +40,156 @@ UTexture2D::UTexture2D()
 	, Height(0)
 	, NumChannels(0)
 	, bIsNormal(false)
-	, Pixels(nullptr)
+	, Format(ETextureFormat::RGBA8)
+	, MipData(nullptr)
+	, MipDataSize(0)
 {
 
 }
 
 UTexture2D::~UTexture2D()
 {
-	if (Pixels != nullptr)
+
+}
+
+bool UTexture2D::Load(const std::string& InFilename, bool InbIsNormal)
+{
+	bIsNormal = InbIsNormal;
+
+	if (LoadData(InFilename) == false)
 	{
-		stbi_image_free(Pixels);
+		return false;
 	}
+
+	CreateRenderResources();
+
+	return true;
 }
 
-bool UTexture2D::Load(const std::string& InFilename, bool InbIsNormal)
+bool UTexture2D::LoadData(const std::string& InFilename)
 {
-	int OutWidth, OutHeight, OutNumChannels;
+	MipData = nullptr;
+	MipDataSize = 0;
+	Mips.clear();
+	MipChain.clear();
+	Cache.Close();
 
-	stbi_set_flip_vertically_on_load(true);
+	FFileView SourceFile;
+	uint64_t SourceHash = FTextureCache::AnySourceHash;
 
-	Pixels = stbi_load(InFilename.c_str(), &OutWidth, &OutHeight, &OutNumChannels, STBI_rgb_alpha);
-	if (Pixels == nullptr)
+	if (IsCookedDataOnly() == false)
+	{
+		if (SourceFile.Open(InFilename) == false || SourceFile.GetSize() > INT_MAX)
+		{
+			return false;
+		}
+
+		SourceHash = HashBytes(SourceFile.GetData(), SourceFile.GetSize());
+	}
+
+	// The GPU path uploads the first level only and blits the rest.
+	bool bMipsOnGPU = false;
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("TextureMipsOnGPU", bMipsOnGPU);
+	}
+
+	// Compressed formats cannot be blitted, so the GPU path keeps textures uncompressed.
+	ETextureCompression Compression = bMipsOnGPU ? ETextureCompression::None : GetTextureCompression();
+
+	FVulkanContext* RenderContext = GEngine != nullptr ? GEngine->GetRenderContext() : nullptr;
+	if (RenderContext != nullptr && RenderContext->IsTextureCompressionBCSupported() == false)
+	{
+		Compression = ETextureCompression::None;
+	}
+
+	EMipFilter Filter = bIsNormal ? EMipFilter::Normal : EMipFilter::SRGB;
+	std::string CachePath = FTextureCache::GetCachePath(InFilename);
+
+	if (Cache.Open(CachePath, SourceHash, Filter, bMipsOnGPU == false, Compression))
+	{
+		Format = Cache.GetFormat();
+		Width = Cache.GetWidth();
+		Height = Cache.GetHeight();
+		NumChannels = Cache.GetNumChannels();
+
+		Mips.assign(Cache.GetMips(), Cache.GetMips() + Cache.GetNumMips());
+		MipData = Cache.GetData();
+		MipDataSize = Cache.GetDataSize();
+	}
+	else if (SourceFile.IsOpen() == false)
 	{
 		return false;
 	}
+	else
+	{
+		FDecodedImage Image;
+		if (FImageDecoder::Decode(SourceFile.GetData(), SourceFile.GetSize(), true, Image) == false)
+		{
+			return false;
+		}
 
-	assert(OutWidth >= 0);
-	assert(OutHeight >= 0);
-	assert(OutNumChannels >= 0);
+		Width = Image.Width;
+		Height = Image.Height;
+		NumChannels = Image.NumChannels;
 
-	Width = static_cast<uint32_t>(OutWidth);
-	Height = static_cast<uint32_t>(OutHeight);
-	NumChannels = static_cast<uint32_t>(OutNumChannels);
-	bIsNormal = InbIsNormal;
+		uint32_t NumLevels = bMipsOnGPU ? 1 : FMipGenerator::GetNumMipLevels(Width, Height);
+		MipDataSize = FMipGenerator::GetMipChainLayout(Width, Height, NumLevels, Mips);
 
-	CreateRenderTexture();
+		// The first level is already in place; the rest of the chain is appended behind it.
+		MipChain = std::move(Image.Pixels);
+		MipChain.resize(static_cast<size_t>(MipDataSize));
+
+		FMipGenerator::GenerateMips(MipChain.data(), Mips, Filter);
+
+		// Only sources with an alpha channel are scanned for translucent texels.
+		bool bHasAlpha = (NumChannels == 2 || NumChannels == 4) && FTextureCompressor::HasAlpha(MipChain.data(), Width, Height);
+
+		Format = FTextureCompressor::ChooseFormat(Compression, Filter, bHasAlpha);
+		if (FTextureCompressor::IsCompressed(Format))
+		{
+			std::vector<uint8_t> CompressedChain;
+			std::vector<FTextureMip> CompressedMips;
+			FTextureCompressor::CompressMipChain(Format, MipChain.data(), Mips, CompressedChain, CompressedMips);
+
+			MipChain.swap(CompressedChain);
+			Mips.swap(CompressedMips);
+			MipDataSize = MipChain.size();
+		}
+
+		FTextureCache::Write(CachePath, SourceHash, Filter, Compression, Format, NumChannels, Mips, MipChain.data(), MipDataSize);
+
+		MipData = MipChain.data();
+	}
+
+	SourceFilename = InFilename;
 
 	return true;
 }
 
+size_t UTexture2D::GetCPUMemorySize() const
+{
+	// Counts mapped cache data too, like meshes do.
+	return static_cast<size_t>(MipDataSize);
+}
+
+void UTexture2D::CreateRenderResources()
+{
+	CreateRenderTexture();
+}
+
 void UTexture2D::Unload()
 {
 	Width = 0;
 	Height = 0;
 	NumChannels = 0;
-	bIsNormal = false;
 
-	if (Pixels != nullptr)
-	{
-		stbi_image_free(Pixels);
-		Pixels = nullptr;
-	}
+	MipData = nullptr;
+	MipDataSize = 0;
+	Mips.clear();
+	MipChain.clear();
+	MipChain.shrink_to_fit();
+	Cache.Close();
 
 	DestroyRenderTexture();
 }
@@ -75,7 +200,7 @@ void UTexture2D::CreateRenderTexture()
 	if (RenderContext != nullptr)
 	{
 		RenderTexture = RenderContext->CreateObject<FVulkanTexture>();
-		RenderTexture->SetFormat(bIsNormal ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB);
+		RenderTexture->SetFormat(FVulkanTexture::GetVulkanFormat(Format, bIsNormal == false));
 		RenderTexture->Load(this);
 	}
 }
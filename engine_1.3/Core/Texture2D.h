@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Texture.h"
+#include "MipGenerator.h"
+#include "TextureCompressor.h"
+#include "TextureCache.h"
+
+#include <vector>
 
 class UTexture2D : public UTexture
 {
@@ -13,10 +18,30 @@ public:
 	uint32_t GetWidth() const { return Width; }
 	uint32_t GetHeight() const { return Height; }
 	uint32_t GetNumChannels() const { return NumChannels; }
-	const uint8_t* GetPixels() const { return Pixels; }
+	// Layout of the mip data, chosen at import from the TextureCompression setting and the source channels.
+	ETextureFormat GetFormat() const { return Format; }
+
+	// The first mip level.
+	const uint8_t* GetPixels() const { return MipData; }
+
+	// Every level back to back, largest first. Holds a single uncompressed level when mips are generated on the GPU.
+	const uint8_t* GetMipData() const { return MipData; }
+	uint64_t GetMipDataSize() const { return MipDataSize; }
+	const std::vector<FTextureMip>& GetMips() const { return Mips; }
+	uint32_t GetNumMips() const { return static_cast<uint32_t>(Mips.size()); }
+	// Every level is stored, so the renderer may drop and upload levels again at any time.
+	bool IsStreamable() const { return Mips.size() > 1 && Mips.size() == FMipGenerator::GetNumMipLevels(Width, Height); }
+
+	// Normal maps are sampled linearly instead of as sRGB and their mips are renormalized. Set before loading.
+	bool IsNormal() const { return bIsNormal; }
+	void SetIsNormal(bool InbIsNormal) { bIsNormal = InbIsNormal; }
 
 	bool Load(const std::string& InFilename, bool InbIsNormal = false);
-	void Unload();
+	virtual bool LoadData(const std::string& InFilename) override;
+	virtual void CreateRenderResources() override;
+	virtual void Unload() override;
+
+	virtual size_t GetCPUMemorySize() const override;
 
 	virtual void CreateRenderTexture();
 
@@ -25,6 +50,13 @@ private:
 	uint32_t Height;
 	uint32_t NumChannels;
 	bool bIsNormal;
+	ETextureFormat Format;
+
+	// Either points into the mapped cache or into MipChain when the source was just imported.
+	const uint8_t* MipData;
+	uint64_t MipDataSize;
+	std::vector<FTextureMip> Mips;
 
-	uint8_t* Pixels;
+	FTextureCache Cache;
+	std::vector<uint8_t> MipChain;
 };
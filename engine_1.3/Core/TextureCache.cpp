@@ -0,0 +1,155 @@
+#include "TextureCache.h"
+
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <filesystem>
+#include <system_error>
+
+static uint64_t AlignOffset(uint64_t InOffset)
+{
+	return (InOffset + 15) & ~static_cast<uint64_t>(15);
+}
+
+std::string FTextureCache::GetCachePath(const std::string& InSourceFilename)
+{
+	return InSourceFilename + ".vktex";
+}
+
+bool FTextureCache::Write(
+	const std::string& InFilename,
+	uint64_t InSourceHash,
+	EMipFilter InFilter,
+	ETextureCompression InCompression,
+	ETextureFormat InFormat,
+	uint32_t InNumChannels,
+	const std::vector<FTextureMip>& InMips,
+	const uint8_t* InData,
+	uint64_t InDataSize)
+{
+	if (InMips.empty() || InData == nullptr)
+	{
+		return false;
+	}
+
+	FTextureCacheHeader Header{};
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.SourceHash = InSourceHash;
+	Header.Width = InMips[0].Width;
+	Header.Height = InMips[0].Height;
+	Header.NumChannels = InNumChannels;
+	Header.NumMips = static_cast<uint32_t>(InMips.size());
+	Header.Filter = InFilter;
+	Header.Compression = InCompression;
+	Header.Format = InFormat;
+	Header.MipOffset = sizeof(FTextureCacheHeader);
+	Header.DataOffset = AlignOffset(Header.MipOffset + InMips.size() * sizeof(FTextureMip));
+	Header.DataSize = InDataSize;
+
+	// Same temporary file scheme as the mesh cache.
+	std::string TempFilename = InFilename + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+	{
+		std::ofstream File(TempFilename, std::ios::binary | std::ios::trunc);
+		if (File.is_open() == false)
+		{
+			return false;
+		}
+
+		static const char Padding[16] = {};
+
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+		File.write(reinterpret_cast<const char*>(InMips.data()), static_cast<std::streamsize>(InMips.size() * sizeof(FTextureMip)));
+		File.write(Padding, static_cast<std::streamsize>(Header.DataOffset - Header.MipOffset - InMips.size() * sizeof(FTextureMip)));
+		File.write(reinterpret_cast<const char*>(InData), static_cast<std::streamsize>(InDataSize));
+
+		if (File.good() == false)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ErrorCode;
+	std::filesystem::rename(TempFilename, InFilename, ErrorCode);
+	if (ErrorCode)
+	{
+		std::filesystem::remove(TempFilename, ErrorCode);
+		return false;
+	}
+
+	return true;
+}
+
+bool FTextureCache::Open(const std::string& InFilename, uint64_t InSourceHash, EMipFilter InFilter, bool bInFullMipChain, ETextureCompression InCompression)
+{
+	Close();
+
+	if (File.Open(InFilename) == false)
+	{
+		return false;
+	}
+
+	if (File.GetSize() < sizeof(FTextureCacheHeader))
+	{
+		File.Close();
+		return false;
+	}
+
+	const FTextureCacheHeader* MappedHeader = reinterpret_cast<const FTextureCacheHeader*>(File.GetData());
+
+	uint64_t MipBytes = static_cast<uint64_t>(MappedHeader->NumMips) * sizeof(FTextureMip);
+
+	if (MappedHeader->Magic != Magic ||
+		MappedHeader->Version != Version ||
+		(InSourceHash != AnySourceHash && MappedHeader->SourceHash != InSourceHash) ||
+		MappedHeader->Filter != InFilter ||
+		MappedHeader->Compression != InCompression ||
+		MappedHeader->NumMips != (bInFullMipChain ? FMipGenerator::GetNumMipLevels(MappedHeader->Width, MappedHeader->Height) : 1) ||
+		MappedHeader->MipOffset + MipBytes > MappedHeader->DataOffset ||
+		MappedHeader->DataOffset + MappedHeader->DataSize > File.GetSize())
+	{
+		File.Close();
+		return false;
+	}
+
+	const FTextureMip* Mips = reinterpret_cast<const FTextureMip*>(File.GetData() + MappedHeader->MipOffset);
+	for (uint32_t Level = 0; Level < MappedHeader->NumMips; ++Level)
+	{
+		if (Mips[Level].Offset + Mips[Level].Size > MappedHeader->DataSize)
+		{
+			File.Close();
+			return false;
+		}
+	}
+
+	Header = MappedHeader;
+
+	return true;
+}
+
+void FTextureCache::Close()
+{
+	Header = nullptr;
+	File.Close();
+}
+
+const FTextureMip* FTextureCache::GetMips() const
+{
+	if (Header == nullptr)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const FTextureMip*>(File.GetData() + Header->MipOffset);
+}
+
+const uint8_t* FTextureCache::GetData() const
+{
+	if (Header == nullptr)
+	{
+		return nullptr;
+	}
+
+	return File.GetData() + Header->DataOffset;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "MipGenerator.h"
+#include "TextureCompressor.h"
+#include "FileSystem.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct alignas(16) FTextureCacheHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t SourceHash;
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t NumChannels;
+	uint32_t NumMips;
+	EMipFilter Filter;
+	ETextureCompression Compression;
+	ETextureFormat Format;
+	uint32_t Reserved;
+	uint64_t MipOffset;
+	uint64_t DataOffset;
+	uint64_t DataSize;
+};
+
+static_assert(sizeof(FTextureCacheHeader) == 80, "FTextureCacheHeader is part of the on-disk format.");
+
+// Decoded and possibly block-compressed texture with its mip chain, written after the first import of a source image.
+// Later loads map it and upload the levels directly; it is rejected when the source hash or any import setting changed.
+class FTextureCache
+{
+public:
+	static constexpr uint32_t Magic = 0x54584b56; // "VKXT"
+	static constexpr uint32_t Version = 3;
+	// Accepts the cache whatever source it was built from, for cooked data that ships without its sources.
+	static constexpr uint64_t AnySourceHash = 0;
+
+	static std::string GetCachePath(const std::string& InSourceFilename);
+
+	static bool Write(
+		const std::string& InFilename,
+		uint64_t InSourceHash,
+		EMipFilter InFilter,
+		ETextureCompression InCompression,
+		ETextureFormat InFormat,
+		uint32_t InNumChannels,
+		const std::vector<FTextureMip>& InMips,
+		const uint8_t* InData,
+		uint64_t InDataSize);
+
+	bool Open(const std::string& InFilename, uint64_t InSourceHash, EMipFilter InFilter, bool bInFullMipChain, ETextureCompression InCompression);
+	void Close();
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	uint32_t GetWidth() const { return Header != nullptr ? Header->Width : 0; }
+	uint32_t GetHeight() const { return Header != nullptr ? Header->Height : 0; }
+	uint32_t GetNumChannels() const { return Header != nullptr ? Header->NumChannels : 0; }
+	ETextureFormat GetFormat() const { return Header != nullptr ? Header->Format : ETextureFormat::RGBA8; }
+
+	const FTextureMip* GetMips() const;
+	uint32_t GetNumMips() const { return Header != nullptr ? Header->NumMips : 0; }
+
+	const uint8_t* GetData() const;
+	uint64_t GetDataSize() const { return Header != nullptr ? Header->DataSize : 0; }
+
+private:
+	FFileView File;
+	const FTextureCacheHeader* Header = nullptr;
+};
@@ -0,0 +1,656 @@
+#include "TextureCompressor.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+// Blocks handed to one job; small levels are compressed by the calling thread alone.
+static constexpr uint32_t BlocksPerChunk = 1024;
+
+// BC1 interpolation weights of the second endpoint, by index.
+static const float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+// BC7 4-bit index interpolation weights, out of 64.
+static const uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct FBitWriter
+{
+	uint8_t* Data;
+	uint32_t Position = 0;
+
+	void Write(uint32_t InValue, uint32_t InNumBits)
+	{
+		for (uint32_t Bit = 0; Bit < InNumBits; ++Bit, ++Position)
+		{
+			if ((InValue >> Bit) & 1)
+			{
+				Data[Position >> 3] |= static_cast<uint8_t>(1 << (Position & 7));
+			}
+		}
+	}
+};
+
+// Reads a 4x4 block as floats. Partial blocks at the right and bottom edges repeat the last texel.
+static void LoadBlock(const uint8_t* InTexels, uint32_t InWidth, uint32_t InHeight, uint32_t InBlockX, uint32_t InBlockY, float OutBlock[16][4])
+{
+	for (uint32_t Y = 0; Y < 4; ++Y)
+	{
+		uint32_t SrcY = std::min(InBlockY * 4 + Y, InHeight - 1);
+
+		for (uint32_t X = 0; X < 4; ++X)
+		{
+			uint32_t SrcX = std::min(InBlockX * 4 + X, InWidth - 1);
+			const uint8_t* Texel = InTexels + (static_cast<size_t>(SrcY) * InWidth + SrcX) * 4;
+
+			for (uint32_t Channel = 0; Channel < 4; ++Channel)
+			{
+				OutBlock[Y * 4 + X][Channel] = Texel[Channel];
+			}
+		}
+	}
+}
+
+static float Distance(const float* InA, const float* InB, uint32_t InNumChannels)
+{
+	float Sum = 0.0f;
+	for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+	{
+		float Delta = InA[Channel] - InB[Channel];
+		Sum += Delta * Delta;
+	}
+	return Sum;
+}
+
+// Endpoints at the extremes of the block along the direction of largest variance, found by power iteration.
+static void FitEndpoints(const float InBlock[16][4], uint32_t InNumChannels, float OutE0[4], float OutE1[4])
+{
+	float Mean[4] = {};
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+		{
+			Mean[Channel] += InBlock[Idx][Channel] / 16.0f;
+		}
+	}
+
+	float Covariance[4][4] = {};
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		for (uint32_t Row = 0; Row < InNumChannels; ++Row)
+		{
+			for (uint32_t Column = 0; Column < InNumChannels; ++Column)
+			{
+				Covariance[Row][Column] += (InBlock[Idx][Row] - Mean[Row]) * (InBlock[Idx][Column] - Mean[Column]);
+			}
+		}
+	}
+
+	// Start from the channel that varies the most.
+	uint32_t LargestChannel = 0;
+	for (uint32_t Channel = 1; Channel < InNumChannels; ++Channel)
+	{
+		if (Covariance[Channel][Channel] > Covariance[LargestChannel][LargestChannel])
+		{
+			LargestChannel = Channel;
+		}
+	}
+
+	float Axis[4] = {};
+	for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+	{
+		Axis[Channel] = Covariance[Channel][LargestChannel];
+	}
+
+	for (uint32_t Iteration = 0; Iteration < 8; ++Iteration)
+	{
+		float NextAxis[4] = {};
+		float Length = 0.0f;
+
+		for (uint32_t Row = 0; Row < InNumChannels; ++Row)
+		{
+			for (uint32_t Column = 0; Column < InNumChannels; ++Column)
+			{
+				NextAxis[Row] += Covariance[Row][Column] * Axis[Column];
+			}
+			Length += NextAxis[Row] * NextAxis[Row];
+		}
+
+		if (Length <= FLT_EPSILON)
+		{
+			break;
+		}
+
+		float InvLength = 1.0f / std::sqrt(Length);
+		for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+		{
+			Axis[Channel] = NextAxis[Channel] * InvLength;
+		}
+	}
+
+	float MinProjection = FLT_MAX;
+	float MaxProjection = -FLT_MAX;
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		float Projection = 0.0f;
+		for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+		{
+			Projection += (InBlock[Idx][Channel] - Mean[Channel]) * Axis[Channel];
+		}
+
+		MinProjection = std::min(MinProjection, Projection);
+		MaxProjection = std::max(MaxProjection, Projection);
+	}
+
+	for (uint32_t Channel = 0; Channel < 4; ++Channel)
+	{
+		OutE0[Channel] = Channel < InNumChannels ? std::clamp(Mean[Channel] + Axis[Channel] * MinProjection, 0.0f, 255.0f) : 255.0f;
+		OutE1[Channel] = Channel < InNumChannels ? std::clamp(Mean[Channel] + Axis[Channel] * MaxProjection, 0.0f, 255.0f) : 255.0f;
+	}
+}
+
+// Least squares endpoints for fixed indices, where texel i is approximated by (1 - W_i) * E0 + W_i * E1.
+static bool SolveEndpoints(const float InBlock[16][4], uint32_t InNumChannels, const float InWeights[16], float OutE0[4], float OutE1[4])
+{
+	float A = 0.0f;
+	float B = 0.0f;
+	float C = 0.0f;
+	float X[4] = {};
+	float Y[4] = {};
+
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		float W = InWeights[Idx];
+		float V = 1.0f - W;
+
+		A += V * V;
+		B += V * W;
+		C += W * W;
+
+		for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+		{
+			X[Channel] += V * InBlock[Idx][Channel];
+			Y[Channel] += W * InBlock[Idx][Channel];
+		}
+	}
+
+	float Determinant = A * C - B * B;
+	if (std::abs(Determinant) < 1e-6f)
+	{
+		return false;
+	}
+
+	for (uint32_t Channel = 0; Channel < InNumChannels; ++Channel)
+	{
+		OutE0[Channel] = std::clamp((C * X[Channel] - B * Y[Channel]) / Determinant, 0.0f, 255.0f);
+		OutE1[Channel] = std::clamp((A * Y[Channel] - B * X[Channel]) / Determinant, 0.0f, 255.0f);
+	}
+
+	return true;
+}
+
+static uint16_t PackRGB565(const float InColor[4])
+{
+	uint32_t R = static_cast<uint32_t>(std::clamp(InColor[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+	uint32_t G = static_cast<uint32_t>(std::clamp(InColor[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+	uint32_t B = static_cast<uint32_t>(std::clamp(InColor[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+
+	return static_cast<uint16_t>((R << 11) | (G << 5) | B);
+}
+
+static void UnpackRGB565(uint16_t InColor, float OutColor[4])
+{
+	uint32_t R = (InColor >> 11) & 31;
+	uint32_t G = (InColor >> 5) & 63;
+	uint32_t B = InColor & 31;
+
+	OutColor[0] = static_cast<float>((R << 3) | (R >> 2));
+	OutColor[1] = static_cast<float>((G << 2) | (G >> 4));
+	OutColor[2] = static_cast<float>((B << 3) | (B >> 2));
+	OutColor[3] = 255.0f;
+}
+
+// Quantizes the endpoints, picks the closest palette entry for every texel and returns the squared error.
+static float EncodeBC1Endpoints(const float InBlock[16][4], const float InE0[4], const float InE1[4], uint16_t& OutColor0, uint16_t& OutColor1, uint32_t& OutIndices)
+{
+	uint16_t Color0 = PackRGB565(InE0);
+	uint16_t Color1 = PackRGB565(InE1);
+
+	// Color0 > Color1 selects the four color mode.
+	if (Color0 < Color1)
+	{
+		std::swap(Color0, Color1);
+	}
+
+	float Palette[4][4];
+	UnpackRGB565(Color0, Palette[0]);
+	UnpackRGB565(Color1, Palette[1]);
+
+	uint32_t NumColors = Color0 == Color1 ? 1 : 4;
+	for (uint32_t Channel = 0; Channel < 3; ++Channel)
+	{
+		Palette[2][Channel] = (2.0f * Palette[0][Channel] + Palette[1][Channel]) / 3.0f;
+		Palette[3][Channel] = (Palette[0][Channel] + 2.0f * Palette[1][Channel]) / 3.0f;
+	}
+
+	float Error = 0.0f;
+	uint32_t Indices = 0;
+
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		uint32_t BestIndex = 0;
+		float BestDistance = Distance(InBlock[Idx], Palette[0], 3);
+
+		for (uint32_t Index = 1; Index < NumColors; ++Index)
+		{
+			float CurrentDistance = Distance(InBlock[Idx], Palette[Index], 3);
+			if (CurrentDistance < BestDistance)
+			{
+				BestDistance = CurrentDistance;
+				BestIndex = Index;
+			}
+		}
+
+		Indices |= BestIndex << (Idx * 2);
+		Error += BestDistance;
+	}
+
+	OutColor0 = Color0;
+	OutColor1 = Color1;
+	OutIndices = Indices;
+
+	return Error;
+}
+
+static void EncodeBC1Block(const float InBlock[16][4], uint8_t* OutBlock)
+{
+	float E0[4];
+	float E1[4];
+	FitEndpoints(InBlock, 3, E0, E1);
+
+	uint16_t Color0;
+	uint16_t Color1;
+	uint32_t Indices;
+	float Error = EncodeBC1Endpoints(InBlock, E0, E1, Color0, Color1, Indices);
+
+	// Refit the endpoints to the chosen indices while that keeps lowering the error.
+	for (uint32_t Iteration = 0; Iteration < 2 && Color0 != Color1; ++Iteration)
+	{
+		float Weights[16];
+		for (uint32_t Idx = 0; Idx < 16; ++Idx)
+		{
+			Weights[Idx] = BC1Weights[(Indices >> (Idx * 2)) & 3];
+		}
+
+		if (SolveEndpoints(InBlock, 3, Weights, E0, E1) == false)
+		{
+			break;
+		}
+
+		uint16_t NewColor0;
+		uint16_t NewColor1;
+		uint32_t NewIndices;
+		float NewError = EncodeBC1Endpoints(InBlock, E0, E1, NewColor0, NewColor1, NewIndices);
+		if (NewError >= Error)
+		{
+			break;
+		}
+
+		Color0 = NewColor0;
+		Color1 = NewColor1;
+		Indices = NewIndices;
+		Error = NewError;
+	}
+
+	OutBlock[0] = static_cast<uint8_t>(Color0 & 0xff);
+	OutBlock[1] = static_cast<uint8_t>(Color0 >> 8);
+	OutBlock[2] = static_cast<uint8_t>(Color1 & 0xff);
+	OutBlock[3] = static_cast<uint8_t>(Color1 >> 8);
+	for (uint32_t Byte = 0; Byte < 4; ++Byte)
+	{
+		OutBlock[4 + Byte] = static_cast<uint8_t>((Indices >> (Byte * 8)) & 0xff);
+	}
+}
+
+// Encodes one channel of the block in the eight value mode.
+static void EncodeBC4Block(const float InBlock[16][4], uint32_t InChannel, uint8_t* OutBlock)
+{
+	float MinValue = 255.0f;
+	float MaxValue = 0.0f;
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		MinValue = std::min(MinValue, InBlock[Idx][InChannel]);
+		MaxValue = std::max(MaxValue, InBlock[Idx][InChannel]);
+	}
+
+	uint8_t Value0 = static_cast<uint8_t>(MaxValue + 0.5f);
+	uint8_t Value1 = static_cast<uint8_t>(MinValue + 0.5f);
+
+	uint64_t Indices = 0;
+
+	if (Value0 > Value1)
+	{
+		float Palette[8];
+		Palette[0] = Value0;
+		Palette[1] = Value1;
+		for (uint32_t Step = 1; Step < 7; ++Step)
+		{
+			Palette[Step + 1] = ((7 - Step) * Value0 + Step * Value1) / 7.0f;
+		}
+
+		for (uint32_t Idx = 0; Idx < 16; ++Idx)
+		{
+			uint64_t BestIndex = 0;
+			float BestDistance = std::abs(InBlock[Idx][InChannel] - Palette[0]);
+
+			for (uint32_t Index = 1; Index < 8; ++Index)
+			{
+				float CurrentDistance = std::abs(InBlock[Idx][InChannel] - Palette[Index]);
+				if (CurrentDistance < BestDistance)
+				{
+					BestDistance = CurrentDistance;
+					BestIndex = Index;
+				}
+			}
+
+			Indices |= BestIndex << (Idx * 3);
+		}
+	}
+
+	OutBlock[0] = Value0;
+	OutBlock[1] = Value1;
+	for (uint32_t Byte = 0; Byte < 6; ++Byte)
+	{
+		OutBlock[2 + Byte] = static_cast<uint8_t>((Indices >> (Byte * 8)) & 0xff);
+	}
+}
+
+// Mode 6 endpoints have 7 bits per channel plus one p-bit shared by all channels of the endpoint.
+static void QuantizeBC7Endpoint(const float InEndpoint[4], uint8_t OutQuantized[4], uint8_t& OutPBit)
+{
+	float BestError = FLT_MAX;
+
+	for (uint8_t PBit = 0; PBit < 2; ++PBit)
+	{
+		uint8_t Quantized[4];
+		float Error = 0.0f;
+
+		for (uint32_t Channel = 0; Channel < 4; ++Channel)
+		{
+			int32_t Value = static_cast<int32_t>(std::floor((InEndpoint[Channel] - PBit) / 2.0f + 0.5f));
+			Quantized[Channel] = static_cast<uint8_t>(std::clamp(Value, 0, 127));
+
+			float Reconstructed = static_cast<float>((Quantized[Channel] << 1) | PBit);
+			Error += (Reconstructed - InEndpoint[Channel]) * (Reconstructed - InEndpoint[Channel]);
+		}
+
+		if (Error < BestError)
+		{
+			BestError = Error;
+			memcpy(OutQuantized, Quantized, sizeof(Quantized));
+			OutPBit = PBit;
+		}
+	}
+}
+
+static float EncodeBC7Endpoints(const float InBlock[16][4], const float InE0[4], const float InE1[4], uint8_t OutQuantized0[4], uint8_t OutQuantized1[4], uint8_t& OutPBit0, uint8_t& OutPBit1, uint8_t OutIndices[16])
+{
+	QuantizeBC7Endpoint(InE0, OutQuantized0, OutPBit0);
+	QuantizeBC7Endpoint(InE1, OutQuantized1, OutPBit1);
+
+	float Palette[16][4];
+	for (uint32_t Channel = 0; Channel < 4; ++Channel)
+	{
+		uint32_t Endpoint0 = (OutQuantized0[Channel] << 1) | OutPBit0;
+		uint32_t Endpoint1 = (OutQuantized1[Channel] << 1) | OutPBit1;
+
+		for (uint32_t Index = 0; Index < 16; ++Index)
+		{
+			Palette[Index][Channel] = static_cast<float>(((64 - BC7Weights[Index]) * Endpoint0 + BC7Weights[Index] * Endpoint1 + 32) >> 6);
+		}
+	}
+
+	float Error = 0.0f;
+
+	for (uint32_t Idx = 0; Idx < 16; ++Idx)
+	{
+		uint8_t BestIndex = 0;
+		float BestDistance = Distance(InBlock[Idx], Palette[0], 4);
+
+		for (uint8_t Index = 1; Index < 16; ++Index)
+		{
+			float CurrentDistance = Distance(InBlock[Idx], Palette[Index], 4);
+			if (CurrentDistance < BestDistance)
+			{
+				BestDistance = CurrentDistance;
+				BestIndex = Index;
+			}
+		}
+
+		OutIndices[Idx] = BestIndex;
+		Error += BestDistance;
+	}
+
+	return Error;
+}
+
+// Always uses mode 6: one subset, RGBA endpoints and 4-bit indices.
+static void EncodeBC7Block(const float InBlock[16][4], uint8_t* OutBlock)
+{
+	float E0[4];
+	float E1[4];
+	FitEndpoints(InBlock, 4, E0, E1);
+
+	uint8_t Quantized0[4];
+	uint8_t Quantized1[4];
+	uint8_t PBit0;
+	uint8_t PBit1;
+	uint8_t Indices[16];
+	float Error = EncodeBC7Endpoints(InBlock, E0, E1, Quantized0, Quantized1, PBit0, PBit1, Indices);
+
+	for (uint32_t Iteration = 0; Iteration < 2; ++Iteration)
+	{
+		float Weights[16];
+		for (uint32_t Idx = 0; Idx < 16; ++Idx)
+		{
+			Weights[Idx] = BC7Weights[Indices[Idx]] / 64.0f;
+		}
+
+		if (SolveEndpoints(InBlock, 4, Weights, E0, E1) == false)
+		{
+			break;
+		}
+
+		uint8_t NewQuantized0[4];
+		uint8_t NewQuantized1[4];
+		uint8_t NewPBit0;
+		uint8_t NewPBit1;
+		uint8_t NewIndices[16];
+		float NewError = EncodeBC7Endpoints(InBlock, E0, E1, NewQuantized0, NewQuantized1, NewPBit0, NewPBit1, NewIndices);
+		if (NewError >= Error)
+		{
+			break;
+		}
+
+		memcpy(Quantized0, NewQuantized0, sizeof(Quantized0));
+		memcpy(Quantized1, NewQuantized1, sizeof(Quantized1));
+		PBit0 = NewPBit0;
+		PBit1 = NewPBit1;
+		memcpy(Indices, NewIndices, sizeof(Indices));
+		Error = NewError;
+	}
+
+	// The first index is stored without its top bit, so it has to be below 8.
+	if (Indices[0] >= 8)
+	{
+		std::swap(Quantized0, Quantized1);
+		std::swap(PBit0, PBit1);
+		for (uint8_t& Index : Indices)
+		{
+			Index = 15 - Index;
+		}
+	}
+
+	memset(OutBlock, 0, 16);
+
+	FBitWriter Writer{ OutBlock };
+	Writer.Write(1 << 6, 7);
+	for (uint32_t Channel = 0; Channel < 4; ++Channel)
+	{
+		Writer.Write(Quantized0[Channel], 7);
+		Writer.Write(Quantized1[Channel], 7);
+	}
+	Writer.Write(PBit0, 1);
+	Writer.Write(PBit1, 1);
+	Writer.Write(Indices[0], 3);
+	for (uint32_t Idx = 1; Idx < 16; ++Idx)
+	{
+		Writer.Write(Indices[Idx], 4);
+	}
+}
+
+uint32_t FTextureCompressor::GetBlockSize(ETextureFormat InFormat)
+{
+	switch (InFormat)
+	{
+	case ETextureFormat::BC1:
+		return 8;
+	case ETextureFormat::BC3:
+	case ETextureFormat::BC5:
+	case ETextureFormat::BC7:
+		return 16;
+	default:
+		return 4;
+	}
+}
+
+uint64_t FTextureCompressor::GetImageSize(ETextureFormat InFormat, uint32_t InWidth, uint32_t InHeight)
+{
+	if (IsCompressed(InFormat) == false)
+	{
+		return static_cast<uint64_t>(InWidth) * InHeight * GetBlockSize(InFormat);
+	}
+
+	return static_cast<uint64_t>((InWidth + 3) / 4) * ((InHeight + 3) / 4) * GetBlockSize(InFormat);
+}
+
+ETextureFormat FTextureCompressor::ChooseFormat(ETextureCompression InCompression, EMipFilter InFilter, bool bInHasAlpha)
+{
+	if (InCompression == ETextureCompression::None)
+	{
+		return ETextureFormat::RGBA8;
+	}
+
+	if (InFilter == EMipFilter::Normal)
+	{
+		return ETextureFormat::BC5;
+	}
+
+	if (InCompression == ETextureCompression::HighQuality)
+	{
+		return ETextureFormat::BC7;
+	}
+
+	return bInHasAlpha ? ETextureFormat::BC3 : ETextureFormat::BC1;
+}
+
+bool FTextureCompressor::HasAlpha(const uint8_t* InTexels, uint32_t InWidth, uint32_t InHeight)
+{
+	const size_t NumTexels = static_cast<size_t>(InWidth) * InHeight;
+
+	for (size_t Idx = 0; Idx < NumTexels; ++Idx)
+	{
+		if (InTexels[Idx * 4 + 3] != 255)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FTextureCompressor::CompressMipChain(ETextureFormat InFormat, const uint8_t* InMipChain, const std::vector<FTextureMip>& InMips, std::vector<uint8_t>& OutData, std::vector<FTextureMip>& OutMips)
+{
+	OutMips.clear();
+	OutMips.reserve(InMips.size());
+
+	uint64_t Offset = 0;
+	for (const FTextureMip& Mip : InMips)
+	{
+		FTextureMip CompressedMip;
+		CompressedMip.Width = Mip.Width;
+		CompressedMip.Height = Mip.Height;
+		CompressedMip.Offset = Offset;
+		CompressedMip.Size = GetImageSize(InFormat, Mip.Width, Mip.Height);
+		OutMips.push_back(CompressedMip);
+
+		Offset += CompressedMip.Size;
+	}
+
+	OutData.resize(static_cast<size_t>(Offset));
+
+	for (size_t Level = 0; Level < InMips.size(); ++Level)
+	{
+		Compress(InFormat, InMipChain + InMips[Level].Offset, InMips[Level].Width, InMips[Level].Height, OutData.data() + OutMips[Level].Offset);
+	}
+}
+
+void FTextureCompressor::Compress(ETextureFormat InFormat, const uint8_t* InTexels, uint32_t InWidth, uint32_t InHeight, uint8_t* OutBlocks)
+{
+	if (IsCompressed(InFormat) == false)
+	{
+		memcpy(OutBlocks, InTexels, static_cast<size_t>(GetImageSize(InFormat, InWidth, InHeight)));
+		return;
+	}
+
+	const uint32_t BlockSize = GetBlockSize(InFormat);
+	const uint32_t NumBlocksX = (InWidth + 3) / 4;
+	const uint32_t NumBlocksY = (InHeight + 3) / 4;
+
+	auto CompressRows = [=](uint32_t InBegin, uint32_t InEnd)
+	{
+		float Block[16][4];
+
+		for (uint32_t BlockY = InBegin; BlockY < InEnd; ++BlockY)
+		{
+			for (uint32_t BlockX = 0; BlockX < NumBlocksX; ++BlockX)
+			{
+				LoadBlock(InTexels, InWidth, InHeight, BlockX, BlockY, Block);
+
+				uint8_t* Output = OutBlocks + (static_cast<size_t>(BlockY) * NumBlocksX + BlockX) * BlockSize;
+
+				switch (InFormat)
+				{
+				case ETextureFormat::BC1:
+					EncodeBC1Block(Block, Output);
+					break;
+				case ETextureFormat::BC3:
+					EncodeBC4Block(Block, 3, Output);
+					EncodeBC1Block(Block, Output + 8);
+					break;
+				case ETextureFormat::BC5:
+					EncodeBC4Block(Block, 0, Output);
+					EncodeBC4Block(Block, 1, Output + 8);
+					break;
+				case ETextureFormat::BC7:
+					EncodeBC7Block(Block, Output);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	};
+
+	uint32_t RowsPerChunk = std::max(BlocksPerChunk / NumBlocksX, 1U);
+
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelForBackground(NumBlocksY, RowsPerChunk, CompressRows);
+	}
+	else
+	{
+		CompressRows(0, NumBlocksY);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "MipGenerator.h"
+
+#include <vector>
+#include <cstdint>
+
+// Layout of texture data in memory and in the texture cache. Compressed formats store 4x4 texel blocks.
+enum class ETextureFormat : uint32_t
+{
+	RGBA8,
+	// Opaque color, 4 bits per texel.
+	BC1,
+	// Color with alpha, 8 bits per texel.
+	BC3,
+	// Two channels, 8 bits per texel. Used for tangent-space normals; the shader rebuilds Z.
+	BC5,
+	// Color with alpha, 8 bits per texel, at a higher quality than BC1 and BC3.
+	BC7,
+};
+
+enum class ETextureCompression : uint32_t
+{
+	None,
+	// BC1 for opaque color, BC3 for color with alpha.
+	Default,
+	// BC7 for all color.
+	HighQuality,
+};
+
+// Import-time block compression of RGBA8 images. Normal maps always become BC5 unless compression is off.
+class FTextureCompressor
+{
+public:
+	// Bytes per 4x4 block, or per texel for RGBA8.
+	static uint32_t GetBlockSize(ETextureFormat InFormat);
+	static bool IsCompressed(ETextureFormat InFormat) { return InFormat != ETextureFormat::RGBA8; }
+	static uint64_t GetImageSize(ETextureFormat InFormat, uint32_t InWidth, uint32_t InHeight);
+
+	static ETextureFormat ChooseFormat(ETextureCompression InCompression, EMipFilter InFilter, bool bInHasAlpha);
+
+	// True when any texel of the image is not fully opaque.
+	static bool HasAlpha(const uint8_t* InTexels, uint32_t InWidth, uint32_t InHeight);
+
+	// Compresses every level of an RGBA8 mip chain into OutData and fills OutMips with the compressed layout.
+	static void CompressMipChain(ETextureFormat InFormat, const uint8_t* InMipChain, const std::vector<FTextureMip>& InMips, std::vector<uint8_t>& OutData, std::vector<FTextureMip>& OutMips);
+
+	// Compresses one RGBA8 image into rows of blocks. The rows are spread over background jobs.
+	static void Compress(ETextureFormat InFormat, const uint8_t* InTexels, uint32_t InWidth, uint32_t InHeight, uint8_t* OutBlocks);
+};
@@ -5,14 +5,17 @@
 #include "VulkanContext.h"
 #include "VulkanTexture.h"
 
-#include "stb_image.h"
+#include "ImageDecoder.h"
+#include "FileSystem.h"
+#include "Utils.h"
+
+#include <utility>
 
 UTextureCube::UTextureCube()
 	: UTexture()
 	, Width(0)
 	, Height(0)
 	, NumChannels(0)
-	, Images({})
 {
 
 }
@@ -24,69 +27,177 @@ UTextureCube::~UTextureCube()
 
 bool UTextureCube::Load(const std::vector<std::string>& InFilenames)
 {
-	if (InFilenames.size() != 6)
+	if (LoadData(InFilenames) == false)
+	{
+		return false;
+	}
+
+	CreateRenderResources();
+
+	return true;
+}
+
+bool UTextureCube::LoadData(const std::vector<std::string>& InFilenames)
+{
+	if (InFilenames.size() != Images.size())
 	{
 		return false;
 	}
 
-	for (int Idx = 0; Idx < InFilenames.size(); ++Idx)
+	for (size_t Idx = 0; Idx < Images.size(); ++Idx)
 	{
-		const std::string& Filename = InFilenames[Idx];
+		Caches[Idx].Close();
+		Images[Idx].clear();
+	}
+
+	bool bCookedDataOnly = IsCookedDataOnly();
 
-		int OutWidth, OutHeight, OutNumChannels;
+	std::array<uint64_t, 6> SourceHashes;
+	SourceHashes.fill(FTextureCache::AnySourceHash);
 
-		Images[Idx] = stbi_load(Filename.c_str(), &OutWidth, &OutHeight, &OutNumChannels, STBI_rgb_alpha);
-		if (Images[Idx] == nullptr)
+	if (bCookedDataOnly == false)
+	{
+		for (size_t Idx = 0; Idx < SourceHashes.size(); ++Idx)
 		{
-			Unload();
-			return false;
+			FFileView SourceFile;
+			if (SourceFile.Open(InFilenames[Idx]) == false)
+			{
+				return false;
+			}
+
+			SourceHashes[Idx] = HashBytes(SourceFile.GetData(), SourceFile.GetSize());
 		}
+	}
 
-		if ((Width != 0 && Width != OutWidth) ||
-			(Height != 0 && Height != OutHeight) ||
-			(NumChannels != 0 && NumChannels != OutNumChannels))
+	if (OpenFaceCaches(InFilenames, SourceHashes))
+	{
+		return true;
+	}
+
+	if (bCookedDataOnly)
+	{
+		return false;
+	}
+
+	std::vector<FDecodedImage> Faces;
+	if (FImageDecoder::DecodeFiles(InFilenames, true, Faces) == false)
+	{
+		return false;
+	}
+
+	for (const FDecodedImage& Face : Faces)
+	{
+		if (Face.Width != Faces[0].Width || Face.Height != Faces[0].Height || Face.NumChannels != Faces[0].NumChannels)
 		{
-			Unload();
 			return false;
 		}
+	}
+
+	Width = Faces[0].Width;
+	Height = Faces[0].Height;
+	NumChannels = Faces[0].NumChannels;
+
+	for (size_t Idx = 0; Idx < Images.size(); ++Idx)
+	{
+		Images[Idx] = std::move(Faces[Idx].Pixels);
 
-		Width = OutWidth;
-		Height = OutHeight;
-		NumChannels = OutNumChannels;
+		FTextureMip Mip;
+		Mip.Width = Width;
+		Mip.Height = Height;
+		Mip.Size = Images[Idx].size();
 
-		stbi_set_flip_vertically_on_load(true);
+		FTextureCache::Write(GetFaceCachePath(InFilenames[Idx]), SourceHashes[Idx], EMipFilter::SRGB, ETextureCompression::None, ETextureFormat::RGBA8, NumChannels, { Mip }, Images[Idx].data(), Mip.Size);
 	}
 
-	CreateRenderTexture();
+	return true;
+}
+
+bool UTextureCube::OpenFaceCaches(const std::vector<std::string>& InFilenames, const std::array<uint64_t, 6>& InSourceHashes)
+{
+	for (size_t Idx = 0; Idx < Caches.size(); ++Idx)
+	{
+		FTextureCache& Cache = Caches[Idx];
+		if (Cache.Open(GetFaceCachePath(InFilenames[Idx]), InSourceHashes[Idx], EMipFilter::SRGB, false, ETextureCompression::None) == false ||
+			Cache.GetFormat() != ETextureFormat::RGBA8 ||
+			Cache.GetWidth() != Caches[0].GetWidth() ||
+			Cache.GetHeight() != Caches[0].GetHeight())
+		{
+			for (FTextureCache& OpenedCache : Caches)
+			{
+				OpenedCache.Close();
+			}
+
+			return false;
+		}
+	}
+
+	Width = Caches[0].GetWidth();
+	Height = Caches[0].GetHeight();
+	NumChannels = Caches[0].GetNumChannels();
 
 	return true;
 }
 
+std::string UTextureCube::GetFaceCachePath(const std::string& InFaceFilename)
+{
+	return InFaceFilename + ".vkface";
+}
+
 bool UTextureCube::Load(const std::array<std::string, 6>& InFilenames)
 {
 	return Load(std::vector<std::string>(InFilenames.begin(), InFilenames.end()));
 }
 
+std::array<const uint8_t*, 6> UTextureCube::GetImages() const
+{
+	std::array<const uint8_t*, 6> Pointers;
+	for (size_t Idx = 0; Idx < Images.size(); ++Idx)
+	{
+		if (Caches[Idx].IsOpen())
+		{
+			Pointers[Idx] = Caches[Idx].GetData();
+		}
+		else
+		{
+			Pointers[Idx] = Images[Idx].empty() ? nullptr : Images[Idx].data();
+		}
+	}
+
+	return Pointers;
+}
+
+size_t UTextureCube::GetCPUMemorySize() const
+{
+	size_t Size = 0;
+	for (size_t Idx = 0; Idx < Images.size(); ++Idx)
+	{
+		Size += Images[Idx].size() + static_cast<size_t>(Caches[Idx].GetDataSize());
+	}
+
+	return Size;
+}
+
 void UTextureCube::Unload()
 {	
 	Width = 0;
 	Height = 0;
 	NumChannels = 0;
 
-	for (int Idx = 0; Idx < Images.size(); ++Idx)
+	for (size_t Idx = 0; Idx < Images.size(); ++Idx)
 	{
-		uint8_t* Pixels = Images[Idx];
-		if (Pixels != nullptr)
-		{
-			stbi_image_free(Pixels);
-		}
-
-		Images[Idx] = nullptr;
+		Caches[Idx].Close();
+		Images[Idx].clear();
+		Images[Idx].shrink_to_fit();
 	}
 
 	DestroyRenderTexture();
 }
 
+void UTextureCube::CreateRenderResources()
+{
+	CreateRenderTexture();
+}
+
 void UTextureCube::CreateRenderTexture()
 {
 	FVulkanContext* RenderContext = GEngine->GetRenderContext();
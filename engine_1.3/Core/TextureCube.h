@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Texture.h"
+#include "TextureCache.h"
 
 #include <cstdint>
 #include <array>
@@ -17,18 +18,31 @@ public:
 	uint32_t GetWidth() const { return Width; }
 	uint32_t GetHeight() const { return Height; }
 	uint32_t GetNumChannels() const { return NumChannels; }
-	const std::array<uint8_t*, 6> GetImages() const { return Images; }
+	std::array<const uint8_t*, 6> GetImages() const;
+
+	// Each decoded face is kept in a texture cache of its own next to the face image.
+	static std::string GetFaceCachePath(const std::string& InFaceFilename);
 
 	bool Load(const std::vector<std::string>& InFilenames);
 	bool Load(const std::array<std::string, 6>& InFilenames);
-	void Unload();
+	// Maps the six faces from their caches, or decodes them in parallel and writes the caches. Does not touch the GPU,
+	// so it may run on a worker thread.
+	bool LoadData(const std::vector<std::string>& InFilenames);
+	virtual void CreateRenderResources() override;
+	virtual void Unload() override;
+
+	virtual size_t GetCPUMemorySize() const override;
 
 	virtual void CreateRenderTexture() override;
 
 private:
+	bool OpenFaceCaches(const std::vector<std::string>& InFilenames, const std::array<uint64_t, 6>& InSourceHashes);
+
 	uint32_t Width;
 	uint32_t Height;
 	uint32_t NumChannels;
 
-	std::array<uint8_t*, 6> Images;
+	// A face is either mapped from its cache or decoded into Images.
+	std::array<FTextureCache, 6> Caches;
+	std::array<std::vector<uint8_t>, 6> Images;
 };
@@ -0,0 +1,146 @@
+#include "TextureStreaming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+
+float FTextureStreamingPolicy::GetScreenSize(float InRadius, float InDistance, float InFOV, float InViewportHeight)
+{
+	if (InDistance <= InRadius)
+	{
+		return std::numeric_limits<float>::max();
+	}
+
+	// The tangent of the angle the sphere subtends from its center, relative to the tangent of half the FOV.
+	float TangentDistance = std::sqrt(InDistance * InDistance - InRadius * InRadius);
+	return InViewportHeight * InRadius / (TangentDistance * std::tan(InFOV * 0.5f));
+}
+
+uint32_t FTextureStreamingPolicy::GetRequiredMip(uint32_t InWidth, uint32_t InHeight, uint32_t InNumMips, float InScreenSize, float InMipBias)
+{
+	if (InNumMips == 0)
+	{
+		return 0;
+	}
+
+	uint32_t LastMip = InNumMips - 1;
+	if (InScreenSize <= 0.0f)
+	{
+		return LastMip;
+	}
+
+	float TexelsPerPixel = std::max(InWidth, InHeight) / InScreenSize;
+	float Mip = std::floor(std::log2(std::max(TexelsPerPixel, 1.0f)) + InMipBias);
+
+	return static_cast<uint32_t>(std::clamp(Mip, 0.0f, static_cast<float>(LastMip)));
+}
+
+uint64_t FTextureStreamingPolicy::GetResidentSize(const FTextureMip* InMips, uint32_t InNumMips, uint32_t InFirstMip)
+{
+	uint64_t Size = 0;
+	for (uint32_t Level = InFirstMip; Level < InNumMips; ++Level)
+	{
+		Size += InMips[Level].Size;
+	}
+
+	return Size;
+}
+
+uint32_t FTextureStreamingPolicy::ApplyHysteresis(uint32_t InResidentMip, uint32_t InRequiredMip, uint32_t InStreamOutDelay, uint32_t& InOutStreamOutFrames)
+{
+	if (InRequiredMip <= InResidentMip)
+	{
+		InOutStreamOutFrames = 0;
+		return InRequiredMip;
+	}
+
+	// The counter keeps running until the levels are actually gone, in case the caller defers the update.
+	++InOutStreamOutFrames;
+	return InOutStreamOutFrames <= InStreamOutDelay ? InResidentMip : InRequiredMip;
+}
+
+uint64_t FTextureStreamingPolicy::FitToBudget(std::vector<FStreamingTexture>& InOutTextures, uint64_t InBudget)
+{
+	uint64_t TotalSize = 0;
+	for (const FStreamingTexture& Texture : InOutTextures)
+	{
+		TotalSize += GetResidentSize(Texture.Mips, Texture.NumMips, Texture.WantedMip);
+	}
+
+	if (TotalSize <= InBudget)
+	{
+		return TotalSize;
+	}
+
+	auto GetCost = [&InOutTextures](size_t InIndex)
+	{
+		const FStreamingTexture& Texture = InOutTextures[InIndex];
+		return static_cast<double>(Texture.Mips[Texture.WantedMip].Size) / std::max(Texture.ScreenSize, 1.0f);
+	};
+
+	std::priority_queue<std::pair<double, size_t>> Candidates;
+	for (size_t Idx = 0; Idx < InOutTextures.size(); ++Idx)
+	{
+		const FStreamingTexture& Texture = InOutTextures[Idx];
+		if (Texture.WantedMip + 1 < Texture.NumMips)
+		{
+			Candidates.push({ GetCost(Idx), Idx });
+		}
+	}
+
+	while (TotalSize > InBudget && Candidates.empty() == false)
+	{
+		size_t Idx = Candidates.top().second;
+		Candidates.pop();
+
+		FStreamingTexture& Texture = InOutTextures[Idx];
+		TotalSize -= Texture.Mips[Texture.WantedMip].Size;
+		++Texture.WantedMip;
+
+		if (Texture.WantedMip + 1 < Texture.NumMips)
+		{
+			Candidates.push({ GetCost(Idx), Idx });
+		}
+	}
+
+	return TotalSize;
+}
+
+uint64_t FTextureStreamingPolicy::Update(std::vector<FStreamingTexture>& InOutTextures, const FTextureStreamingSettings& InSettings)
+{
+	std::vector<uint32_t> RequiredMips(InOutTextures.size());
+
+	uint64_t TotalSize = 0;
+	for (size_t Idx = 0; Idx < InOutTextures.size(); ++Idx)
+	{
+		FStreamingTexture& Texture = InOutTextures[Idx];
+		if (Texture.NumMips == 0)
+		{
+			continue;
+		}
+
+		RequiredMips[Idx] = GetRequiredMip(Texture.Mips[0].Width, Texture.Mips[0].Height, Texture.NumMips, Texture.ScreenSize, InSettings.MipBias);
+		Texture.WantedMip = ApplyHysteresis(Texture.ResidentMip, RequiredMips[Idx], InSettings.StreamOutDelay, Texture.StreamOutFrames);
+
+		TotalSize += GetResidentSize(Texture.Mips, Texture.NumMips, Texture.WantedMip);
+	}
+
+	if (InSettings.BudgetBytes == 0 || TotalSize <= InSettings.BudgetBytes)
+	{
+		return TotalSize;
+	}
+
+	for (size_t Idx = 0; Idx < InOutTextures.size(); ++Idx)
+	{
+		FStreamingTexture& Texture = InOutTextures[Idx];
+		if (Texture.WantedMip < RequiredMips[Idx])
+		{
+			Texture.WantedMip = RequiredMips[Idx];
+			Texture.StreamOutFrames = 0;
+		}
+	}
+
+	return FitToBudget(InOutTextures, InSettings.BudgetBytes);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MipGenerator.h"
+
+#include <vector>
+#include <cstdint>
+
+// One streamed texture as seen by the policy for a single frame.
+struct FStreamingTexture
+{
+	// Every level of the texture as stored on disk, largest first.
+	const FTextureMip* Mips = nullptr;
+	uint32_t NumMips = 0;
+
+	// Largest projected size in pixels of the models using the texture. Zero when nothing uses it.
+	float ScreenSize = 0.0f;
+
+	// First level currently on the GPU.
+	uint32_t ResidentMip = 0;
+	// Consecutive frames the texture has needed fewer levels than are resident. Kept by the caller between frames.
+	uint32_t StreamOutFrames = 0;
+
+	// Output: the first level that should be on the GPU.
+	uint32_t WantedMip = 0;
+};
+
+struct FTextureStreamingSettings
+{
+	// Bytes all streamed textures may take together. Zero means no limit.
+	uint64_t BudgetBytes = 0;
+	// Frames unneeded levels stay resident before they are streamed out, unless the budget is exceeded.
+	uint32_t StreamOutDelay = 60;
+	// Added to every required level. Positive values trade sharpness for memory.
+	float MipBias = 0.0f;
+};
+
+// Decides which mip levels of streamed textures should be resident. Nothing here touches the GPU.
+class FTextureStreamingPolicy
+{
+public:
+	// Projected diameter in pixels of a sphere whose center is InDistance away from the camera.
+	// InFOV is the vertical field of view in radians. A camera inside the sphere gets an unbounded size.
+	static float GetScreenSize(float InRadius, float InDistance, float InFOV, float InViewportHeight);
+
+	// The smallest level that still has a texel per pixel when the texture spans InScreenSize pixels.
+	static uint32_t GetRequiredMip(uint32_t InWidth, uint32_t InHeight, uint32_t InNumMips, float InScreenSize, float InMipBias = 0.0f);
+
+	// Bytes taken by InFirstMip and every smaller level.
+	static uint64_t GetResidentSize(const FTextureMip* InMips, uint32_t InNumMips, uint32_t InFirstMip);
+
+	// Levels are streamed in as soon as they are required, but only streamed out once they have been unneeded for
+	// more than InStreamOutDelay frames in a row, so textures near a mip boundary do not flip every frame.
+	static uint32_t ApplyHysteresis(uint32_t InResidentMip, uint32_t InRequiredMip, uint32_t InStreamOutDelay, uint32_t& InOutStreamOutFrames);
+
+	// Drops the largest resident level of one texture at a time until the textures fit in InBudget. Each step picks the
+	// level that frees the most bytes per pixel of screen size. Returns the size of the wanted levels afterwards.
+	static uint64_t FitToBudget(std::vector<FStreamingTexture>& InOutTextures, uint64_t InBudget);
+
+	// Sets WantedMip of every texture from its screen size, the hysteresis and the budget. When over budget, levels
+	// held only by the hysteresis go first. Returns the size of the wanted levels.
+	static uint64_t Update(std::vector<FStreamingTexture>& InOutTextures, const FTextureStreamingSettings& InSettings);
+};
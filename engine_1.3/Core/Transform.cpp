@@ -47,5 +47,11 @@ glm::vec3 FTransform::GetRotator() const
 
 glm::mat4 FTransform::ToMatrix() const
 {
-	return glm::mat4();
+	glm::mat3 RotationMatrix = glm::mat3_cast(Rotation);
+
+	return glm::mat4(
+		glm::vec4(RotationMatrix[0] * Scale.x, 0.0f),
+		glm::vec4(RotationMatrix[1] * Scale.y, 0.0f),
+		glm::vec4(RotationMatrix[2] * Scale.z, 0.0f),
+		glm::vec4(Translation, 1.0f));
 }
@@ -0,0 +1,255 @@
+#include "TransformPool.h"
+#include "JobSystem.h"
+
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_POOL_USE_SSE 1
+#include <xmmintrin.h>
+#else
+#define TRANSFORM_POOL_USE_SSE 0
+#endif
+
+FTransformPool::FTransformPool()
+	: NumDirty(0)
+{
+}
+
+FTransformHandle FTransformPool::Allocate(const FTransform& InTransform)
+{
+	uint32_t Index;
+	if (FreeIndices.empty() == false)
+	{
+		Index = FreeIndices.back();
+		FreeIndices.pop_back();
+	}
+	else
+	{
+		Index = static_cast<uint32_t>(Translations.size());
+
+		Translations.emplace_back();
+		Rotations.emplace_back();
+		Scales.emplace_back();
+		WorldMatrices.emplace_back(1.0f);
+		WorldMatrixGenerations.push_back(0);
+		Generations.push_back(0);
+		DirtyFlags.push_back(0);
+		DirtyIndices.push_back(0);
+	}
+
+	Translations[Index] = InTransform.GetTranslation();
+	Rotations[Index] = InTransform.GetRotation();
+	Scales[Index] = InTransform.GetScale();
+
+	// A reused slot keeps counting its matrix generation so stale copies of the previous owner never look current.
+	WorldMatrices[Index] = InTransform.ToMatrix();
+	++WorldMatrixGenerations[Index];
+
+	FTransformHandle Handle;
+	Handle.Index = Index;
+	Handle.Generation = Generations[Index];
+
+	return Handle;
+}
+
+void FTransformPool::Release(FTransformHandle InHandle)
+{
+	if (IsAlive(InHandle) == false)
+	{
+		return;
+	}
+
+	// A pending dirty entry for this slot is harmless; it recomposes whatever the slot holds at the next update.
+	++Generations[InHandle.Index];
+	FreeIndices.push_back(InHandle.Index);
+}
+
+bool FTransformPool::IsAlive(FTransformHandle InHandle) const
+{
+	return InHandle.Index < Generations.size() && Generations[InHandle.Index] == InHandle.Generation;
+}
+
+FTransform FTransformPool::GetTransform(FTransformHandle InHandle) const
+{
+	assert(IsAlive(InHandle));
+	return FTransform(Translations[InHandle.Index], Rotations[InHandle.Index], Scales[InHandle.Index]);
+}
+
+void FTransformPool::SetTransform(FTransformHandle InHandle, const FTransform& InTransform)
+{
+	assert(IsAlive(InHandle));
+
+	Translations[InHandle.Index] = InTransform.GetTranslation();
+	Rotations[InHandle.Index] = InTransform.GetRotation();
+	Scales[InHandle.Index] = InTransform.GetScale();
+	MarkDirty(InHandle.Index);
+}
+
+void FTransformPool::SetTranslation(FTransformHandle InHandle, const glm::vec3& InTranslation)
+{
+	assert(IsAlive(InHandle));
+
+	Translations[InHandle.Index] = InTranslation;
+	MarkDirty(InHandle.Index);
+}
+
+void FTransformPool::SetRotation(FTransformHandle InHandle, const glm::quat& InRotation)
+{
+	assert(IsAlive(InHandle));
+
+	Rotations[InHandle.Index] = InRotation;
+	MarkDirty(InHandle.Index);
+}
+
+void FTransformPool::SetScale(FTransformHandle InHandle, const glm::vec3& InScale)
+{
+	assert(IsAlive(InHandle));
+
+	Scales[InHandle.Index] = InScale;
+	MarkDirty(InHandle.Index);
+}
+
+void FTransformPool::MarkDirty(uint32_t InIndex)
+{
+	// Only the thread that owns the transform touches its flag, so the check needs no synchronization.
+	// Each slot is queued at most once per update, which keeps DirtyIndices within the pool capacity.
+	if (DirtyFlags[InIndex] != 0)
+	{
+		return;
+	}
+
+	DirtyFlags[InIndex] = 1;
+	DirtyIndices[NumDirty.fetch_add(1, std::memory_order_acq_rel)] = InIndex;
+}
+
+void FTransformPool::UpdateWorldMatrices()
+{
+	uint32_t Count = NumDirty.load(std::memory_order_acquire);
+	if (Count == 0)
+	{
+		return;
+	}
+
+	const uint32_t* Indices = DirtyIndices.data();
+
+	auto ComposeRange = [this, Indices](uint32_t InBegin, uint32_t InEnd)
+	{
+		ComposeWorldMatrices(Indices + InBegin, InEnd - InBegin);
+	};
+
+	// Kept a multiple of four so only the last chunk falls back to the scalar path.
+	constexpr uint32_t ChunkSize = 256;
+
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelFor(Count, ChunkSize, ComposeRange);
+	}
+	else
+	{
+		ComposeRange(0, Count);
+	}
+
+	for (uint32_t Idx = 0; Idx < Count; ++Idx)
+	{
+		uint32_t Index = Indices[Idx];
+		DirtyFlags[Index] = 0;
+		++WorldMatrixGenerations[Index];
+	}
+
+	NumDirty.store(0, std::memory_order_release);
+}
+
+void FTransformPool::ComposeWorldMatrices(const uint32_t* InIndices, uint32_t InCount)
+{
+	uint32_t Idx = 0;
+
+#if TRANSFORM_POOL_USE_SSE
+	// Four transforms per iteration, one per SIMD lane. The rotation is expanded from the quaternion the same way
+	// glm::mat3_cast does, each column is scaled, and the lanes are transposed back into column-major matrices.
+	const __m128 One = _mm_set1_ps(1.0f);
+	const __m128 Two = _mm_set1_ps(2.0f);
+
+	for (; Idx + 4 <= InCount; Idx += 4)
+	{
+		const uint32_t I0 = InIndices[Idx + 0];
+		const uint32_t I1 = InIndices[Idx + 1];
+		const uint32_t I2 = InIndices[Idx + 2];
+		const uint32_t I3 = InIndices[Idx + 3];
+
+		const glm::quat& Q0 = Rotations[I0];
+		const glm::quat& Q1 = Rotations[I1];
+		const glm::quat& Q2 = Rotations[I2];
+		const glm::quat& Q3 = Rotations[I3];
+
+		const glm::vec3& S0 = Scales[I0];
+		const glm::vec3& S1 = Scales[I1];
+		const glm::vec3& S2 = Scales[I2];
+		const glm::vec3& S3 = Scales[I3];
+
+		const glm::vec3& T0 = Translations[I0];
+		const glm::vec3& T1 = Translations[I1];
+		const glm::vec3& T2 = Translations[I2];
+		const glm::vec3& T3 = Translations[I3];
+
+		__m128 Qx = _mm_setr_ps(Q0.x, Q1.x, Q2.x, Q3.x);
+		__m128 Qy = _mm_setr_ps(Q0.y, Q1.y, Q2.y, Q3.y);
+		__m128 Qz = _mm_setr_ps(Q0.z, Q1.z, Q2.z, Q3.z);
+		__m128 Qw = _mm_setr_ps(Q0.w, Q1.w, Q2.w, Q3.w);
+
+		__m128 Xx = _mm_mul_ps(Qx, Qx);
+		__m128 Yy = _mm_mul_ps(Qy, Qy);
+		__m128 Zz = _mm_mul_ps(Qz, Qz);
+		__m128 Xy = _mm_mul_ps(Qx, Qy);
+		__m128 Xz = _mm_mul_ps(Qx, Qz);
+		__m128 Yz = _mm_mul_ps(Qy, Qz);
+		__m128 Wx = _mm_mul_ps(Qw, Qx);
+		__m128 Wy = _mm_mul_ps(Qw, Qy);
+		__m128 Wz = _mm_mul_ps(Qw, Qz);
+
+		__m128 Sx = _mm_setr_ps(S0.x, S1.x, S2.x, S3.x);
+		__m128 Sy = _mm_setr_ps(S0.y, S1.y, S2.y, S3.y);
+		__m128 Sz = _mm_setr_ps(S0.z, S1.z, S2.z, S3.z);
+
+		__m128 C0 = _mm_mul_ps(_mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(Yy, Zz))), Sx);
+		__m128 C1 = _mm_mul_ps(_mm_mul_ps(Two, _mm_add_ps(Xy, Wz)), Sx);
+		__m128 C2 = _mm_mul_ps(_mm_mul_ps(Two, _mm_sub_ps(Xz, Wy)), Sx);
+		__m128 C3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+		_mm_storeu_ps(&WorldMatrices[I0][0][0], C0);
+		_mm_storeu_ps(&WorldMatrices[I1][0][0], C1);
+		_mm_storeu_ps(&WorldMatrices[I2][0][0], C2);
+		_mm_storeu_ps(&WorldMatrices[I3][0][0], C3);
+
+		C0 = _mm_mul_ps(_mm_mul_ps(Two, _mm_sub_ps(Xy, Wz)), Sy);
+		C1 = _mm_mul_ps(_mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(Xx, Zz))), Sy);
+		C2 = _mm_mul_ps(_mm_mul_ps(Two, _mm_add_ps(Yz, Wx)), Sy);
+		C3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+		_mm_storeu_ps(&WorldMatrices[I0][1][0], C0);
+		_mm_storeu_ps(&WorldMatrices[I1][1][0], C1);
+		_mm_storeu_ps(&WorldMatrices[I2][1][0], C2);
+		_mm_storeu_ps(&WorldMatrices[I3][1][0], C3);
+
+		C0 = _mm_mul_ps(_mm_mul_ps(Two, _mm_add_ps(Xz, Wy)), Sz);
+		C1 = _mm_mul_ps(_mm_mul_ps(Two, _mm_sub_ps(Yz, Wx)), Sz);
+		C2 = _mm_mul_ps(_mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(Xx, Yy))), Sz);
+		C3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+		_mm_storeu_ps(&WorldMatrices[I0][2][0], C0);
+		_mm_storeu_ps(&WorldMatrices[I1][2][0], C1);
+		_mm_storeu_ps(&WorldMatrices[I2][2][0], C2);
+		_mm_storeu_ps(&WorldMatrices[I3][2][0], C3);
+
+		_mm_storeu_ps(&WorldMatrices[I0][3][0], _mm_setr_ps(T0.x, T0.y, T0.z, 1.0f));
+		_mm_storeu_ps(&WorldMatrices[I1][3][0], _mm_setr_ps(T1.x, T1.y, T1.z, 1.0f));
+		_mm_storeu_ps(&WorldMatrices[I2][3][0], _mm_setr_ps(T2.x, T2.y, T2.z, 1.0f));
+		_mm_storeu_ps(&WorldMatrices[I3][3][0], _mm_setr_ps(T3.x, T3.y, T3.z, 1.0f));
+	}
+#endif
+
+	for (; Idx < InCount; ++Idx)
+	{
+		uint32_t Index = InIndices[Idx];
+		WorldMatrices[Index] = FTransform(Translations[Index], Rotations[Index], Scales[Index]).ToMatrix();
+	}
+}
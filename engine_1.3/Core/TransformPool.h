@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Transform.h"
+
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+struct FTransformHandle
+{
+	uint32_t Index = UINT32_MAX;
+	uint32_t Generation = 0;
+
+	bool IsValid() const { return Index != UINT32_MAX; }
+};
+
+// Keeps translation, rotation, scale and the composed world matrix of every transform in separate contiguous arrays.
+// Setters only flag the transform as dirty; UpdateWorldMatrices recomposes the dirty set in one batch.
+// Setting different transforms from different threads is safe, allocating and releasing is not.
+class FTransformPool
+{
+public:
+	FTransformPool();
+
+	FTransformPool(const FTransformPool&) = delete;
+	FTransformPool& operator=(const FTransformPool&) = delete;
+
+	FTransformHandle Allocate(const FTransform& InTransform = FTransform());
+	void Release(FTransformHandle InHandle);
+
+	bool IsAlive(FTransformHandle InHandle) const;
+
+	FTransform GetTransform(FTransformHandle InHandle) const;
+	void SetTransform(FTransformHandle InHandle, const FTransform& InTransform);
+
+	glm::vec3 GetTranslation(FTransformHandle InHandle) const { return Translations[InHandle.Index]; }
+	glm::quat GetRotation(FTransformHandle InHandle) const { return Rotations[InHandle.Index]; }
+	glm::vec3 GetScale(FTransformHandle InHandle) const { return Scales[InHandle.Index]; }
+
+	void SetTranslation(FTransformHandle InHandle, const glm::vec3& InTranslation);
+	void SetRotation(FTransformHandle InHandle, const glm::quat& InRotation);
+	void SetScale(FTransformHandle InHandle, const glm::vec3& InScale);
+
+	// World matrix as of the last UpdateWorldMatrices. The generation changes whenever the matrix is recomposed.
+	const glm::mat4& GetWorldMatrix(FTransformHandle InHandle) const { return WorldMatrices[InHandle.Index]; }
+	uint64_t GetWorldMatrixGeneration(FTransformHandle InHandle) const { return WorldMatrixGenerations[InHandle.Index]; }
+
+	void UpdateWorldMatrices();
+
+	uint32_t GetNumTransforms() const { return static_cast<uint32_t>(Translations.size() - FreeIndices.size()); }
+	uint32_t GetNumDirty() const { return NumDirty.load(std::memory_order_acquire); }
+
+private:
+	void MarkDirty(uint32_t InIndex);
+	void ComposeWorldMatrices(const uint32_t* InIndices, uint32_t InCount);
+
+	std::vector<glm::vec3> Translations;
+	std::vector<glm::quat> Rotations;
+	std::vector<glm::vec3> Scales;
+	std::vector<glm::mat4> WorldMatrices;
+	std::vector<uint64_t> WorldMatrixGenerations;
+
+	std::vector<uint32_t> Generations;
+	std::vector<uint32_t> FreeIndices;
+
+	std::vector<uint8_t> DirtyFlags;
+	std::vector<uint32_t> DirtyIndices;
+	std::atomic<uint32_t> NumDirty;
+};
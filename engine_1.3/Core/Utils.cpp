@@ -1,10 +1,19 @@
 #include "Utils.h"
+#include "FileSystem.h"
 
 #include <iostream>
 #include <fstream>
 
 bool ReadFile(const std::string& InFilename, std::vector<char>& OutBytes)
 {
+	const FPakFile* Pak;
+	const FPakEntry* Entry;
+	if (GFileSystem != nullptr && GFileSystem->FindEntry(InFilename, Pak, Entry))
+	{
+		OutBytes.resize(static_cast<size_t>(Entry->UncompressedSize));
+		return Pak->ReadEntry(*Entry, reinterpret_cast<uint8_t*>(OutBytes.data()));
+	}
+
 	std::ifstream File(InFilename, std::ios::ate | std::ios::binary);
 	if (File.is_open() == false)
 	{
@@ -22,3 +31,32 @@ bool ReadFile(const std::string& InFilename, std::vector<char>& OutBytes)
 	return true;
 }
 
+
+bool WriteFile(const std::string& InFilename, const std::vector<char>& InBytes)
+{
+	std::ofstream File(InFilename, std::ios::binary | std::ios::trunc);
+	if (File.is_open() == false)
+	{
+		return false;
+	}
+
+	File.write(InBytes.data(), InBytes.size());
+
+	File.close();
+
+	return File.good();
+}
+
+uint64_t HashBytes(const void* InData, size_t InSize, uint64_t InSeed)
+{
+	const uint8_t* Bytes = static_cast<const uint8_t*>(InData);
+
+	uint64_t Hash = InSeed;
+	for (size_t Idx = 0; Idx < InSize; ++Idx)
+	{
+		Hash ^= Bytes[Idx];
+		Hash *= 0x100000001b3ULL;
+	}
+
+	return Hash;
+}
@@ -3,10 +3,15 @@
 #include <string>
 #include <vector>
 #include <type_traits>
+#include <cstdint>
 
 #include "stb_image.h"
 
 bool ReadFile(const std::string& InFilename, std::vector<char>& OutBytes);
+bool WriteFile(const std::string& InFilename, const std::vector<char>& InBytes);
+
+// 64-bit FNV-1a. Stable across runs and platforms, so it can be stored in cooked files.
+uint64_t HashBytes(const void* InData, size_t InSize, uint64_t InSeed = 0xcbf29ce484222325ULL);
 
 template <typename T>
 inline void CombineHash(std::size_t& InSeed, const T& V)
@@ -1,6 +1,113 @@
 #include "Vertex.h"
 
+#include "glm/gtc/packing.hpp"
+
+#include <cmath>
+#include <algorithm>
+
 bool FVertex::operator==(const FVertex& RHS) const
 {
 	return Position == RHS.Position && Normal == RHS.Normal && TexCoords == RHS.TexCoords && Tangent == RHS.Tangent;
 }
+
+FVertexQuantization FVertexQuantization::FromVertices(const FVertex* InVertices, size_t InNumVertices)
+{
+	FVertexQuantization Quantization;
+	if (InNumVertices == 0)
+	{
+		return Quantization;
+	}
+
+	glm::vec3 Min = InVertices[0].Position;
+	glm::vec3 Max = InVertices[0].Position;
+	for (size_t Idx = 1; Idx < InNumVertices; ++Idx)
+	{
+		Min = glm::min(Min, InVertices[Idx].Position);
+		Max = glm::max(Max, InVertices[Idx].Position);
+	}
+
+	glm::vec3 HalfExtent = (Max - Min) * 0.5f;
+
+	Quantization.Offset = (Min + Max) * 0.5f;
+	Quantization.Scale = std::max(std::max(HalfExtent.x, HalfExtent.y), HalfExtent.z);
+	if (Quantization.Scale <= 0.0f)
+	{
+		Quantization.Scale = 1.0f;
+	}
+
+	return Quantization;
+}
+
+glm::mat4 FVertexQuantization::GetDequantizationMatrix() const
+{
+	return glm::scale(glm::translate(glm::mat4(1.0f), Offset), glm::vec3(Scale));
+}
+
+static glm::vec2 SignNotZero(const glm::vec2& InValue)
+{
+	return glm::vec2(InValue.x >= 0.0f ? 1.0f : -1.0f, InValue.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+glm::vec2 EncodeOctahedral(const glm::vec3& InDirection)
+{
+	float L1Norm = std::abs(InDirection.x) + std::abs(InDirection.y) + std::abs(InDirection.z);
+	if (L1Norm <= 0.0f)
+	{
+		return glm::vec2(0.0f);
+	}
+
+	glm::vec3 Projected = InDirection / L1Norm;
+	if (Projected.z >= 0.0f)
+	{
+		return glm::vec2(Projected.x, Projected.y);
+	}
+
+	// The lower hemisphere is folded over the diagonals of the octahedron.
+	return (1.0f - glm::abs(glm::vec2(Projected.y, Projected.x))) * SignNotZero(glm::vec2(Projected.x, Projected.y));
+}
+
+glm::vec3 DecodeOctahedral(const glm::vec2& InEncoded)
+{
+	glm::vec3 Direction(InEncoded.x, InEncoded.y, 1.0f - std::abs(InEncoded.x) - std::abs(InEncoded.y));
+	if (Direction.z < 0.0f)
+	{
+		glm::vec2 Folded = (1.0f - glm::abs(glm::vec2(Direction.y, Direction.x))) * SignNotZero(glm::vec2(Direction.x, Direction.y));
+		Direction.x = Folded.x;
+		Direction.y = Folded.y;
+	}
+
+	return glm::normalize(Direction);
+}
+
+static int16_t PackSnorm16(float InValue)
+{
+	return static_cast<int16_t>(std::round(glm::clamp(InValue, -1.0f, 1.0f) * 32767.0f));
+}
+
+void PackVertices(const FVertex* InVertices, size_t InNumVertices, const FVertexQuantization& InQuantization, FPackedVertex* OutVertices)
+{
+	const float InvScale = 1.0f / InQuantization.Scale;
+
+	for (size_t Idx = 0; Idx < InNumVertices; ++Idx)
+	{
+		const FVertex& Vertex = InVertices[Idx];
+		FPackedVertex& Packed = OutVertices[Idx];
+
+		glm::vec3 Position = (Vertex.Position - InQuantization.Offset) * InvScale;
+		Packed.Position[0] = PackSnorm16(Position.x);
+		Packed.Position[1] = PackSnorm16(Position.y);
+		Packed.Position[2] = PackSnorm16(Position.z);
+		Packed.Position[3] = PackSnorm16(Vertex.Tangent.w < 0.0f ? -1.0f : 1.0f);
+
+		glm::vec2 Normal = EncodeOctahedral(Vertex.Normal);
+		Packed.Normal[0] = PackSnorm16(Normal.x);
+		Packed.Normal[1] = PackSnorm16(Normal.y);
+
+		glm::vec2 Tangent = EncodeOctahedral(glm::vec3(Vertex.Tangent));
+		Packed.Tangent[0] = PackSnorm16(Tangent.x);
+		Packed.Tangent[1] = PackSnorm16(Tangent.y);
+
+		Packed.TexCoords[0] = glm::packHalf1x16(Vertex.TexCoords.x);
+		Packed.TexCoords[1] = glm::packHalf1x16(Vertex.TexCoords.y);
+	}
+}
@@ -9,6 +9,7 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtx/hash.hpp"
 
+#include <cstdint>
 #include <type_traits>
 #include <unordered_map>
 
@@ -17,11 +18,54 @@ struct FVertex
 	glm::vec3 Position;
 	glm::vec3 Normal;
 	glm::vec2 TexCoords;
-	glm::vec3 Tangent;
+	// W is the handedness of the tangent frame: the bitangent is cross(Normal, Tangent) * W.
+	glm::vec4 Tangent;
 
 	bool operator==(const FVertex& RHS) const;
 };
 
+// GPU-side vertex layout of a mesh. Assets always keep FVertex; the layout is applied when the mesh is uploaded.
+enum class EVertexFormat : uint8_t
+{
+	// FVertex as is.
+	Float,
+	// FPackedVertex.
+	Packed,
+	Count
+};
+
+// 20 bytes instead of 48. Positions are normalized to the mesh's quantization box (see FVertexQuantization),
+// normals and tangents are octahedral encoded and texture coordinates are half floats.
+struct FPackedVertex
+{
+	// SNORM. W holds the tangent handedness as +-1.
+	int16_t Position[4];
+	// SNORM, octahedral.
+	int16_t Normal[2];
+	// SNORM, octahedral.
+	int16_t Tangent[2];
+	// Half floats, since texture coordinates may repeat outside [0, 1].
+	uint16_t TexCoords[2];
+};
+
+static_assert(sizeof(FPackedVertex) == 20, "FPackedVertex must stay tightly packed.");
+
+// Maps packed positions in [-1, 1] back to mesh space. The scale is uniform so bounding spheres stay spheres.
+struct FVertexQuantization
+{
+	glm::vec3 Offset = glm::vec3(0.0f);
+	float Scale = 1.0f;
+
+	static FVertexQuantization FromVertices(const FVertex* InVertices, size_t InNumVertices);
+
+	glm::mat4 GetDequantizationMatrix() const;
+};
+
+glm::vec2 EncodeOctahedral(const glm::vec3& InDirection);
+glm::vec3 DecodeOctahedral(const glm::vec2& InEncoded);
+
+void PackVertices(const FVertex* InVertices, size_t InNumVertices, const FVertexQuantization& InQuantization, FPackedVertex* OutVertices);
+
 namespace std
 {
 	template<> struct hash<FVertex>
@@ -30,8 +74,8 @@ namespace std
 		{
 			size_t CombinedHash = hash<glm::vec3>()(InVertex.Position);
 			CombineHash(CombinedHash, hash<glm::vec3>()(InVertex.Normal));
-			CombineHash(CombinedHash, hash<glm::vec2>()(InVertex.Tangent));
 			CombineHash(CombinedHash, hash<glm::vec2>()(InVertex.TexCoords));
+			CombineHash(CombinedHash, hash<glm::vec4>()(InVertex.Tangent));
 
 			return CombinedHash;
 		}
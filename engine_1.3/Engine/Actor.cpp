@@ -1,15 +1,25 @@
 #include "Actor.h"
 #include "World.h"
 
+#include <cassert>
+
 AActor::AActor()
 	: World(nullptr)
-	, Transform()
-	, CachedModelMatrix(1.0)
+	, TickGroup(ETickGroup::Main)
 	, bVisible(true)
+	, bParallelTick(false)
 {
 
 }
 
+AActor::~AActor()
+{
+	if (World != nullptr)
+	{
+		World->GetTransformPool().Release(TransformHandle);
+	}
+}
+
 void AActor::Initialize()
 {
 
@@ -32,53 +42,119 @@ class FWorld* AActor::GetWorld() const
 
 void AActor::SetWorld(class FWorld* InWorld)
 {
+	if (World == InWorld)
+	{
+		return;
+	}
+
+	FTransform CurrentTransform;
+	if (World != nullptr)
+	{
+		CurrentTransform = GetTransform();
+		World->GetTransformPool().Release(TransformHandle);
+	}
+
 	World = InWorld;
+	TransformHandle = World != nullptr ? World->GetTransformPool().Allocate(CurrentTransform) : FTransformHandle();
+}
+
+void AActor::SetTickGroup(ETickGroup InTickGroup)
+{
+	if (TickGroup == InTickGroup)
+	{
+		return;
+	}
+
+	TickGroup = InTickGroup;
+
+	if (World != nullptr)
+	{
+		World->MarkTickListsDirty();
+	}
+}
+
+void AActor::SetParallelTick(bool InbParallelTick)
+{
+	if (bParallelTick == InbParallelTick)
+	{
+		return;
+	}
+
+	bParallelTick = InbParallelTick;
+
+	if (World != nullptr)
+	{
+		World->MarkTickListsDirty();
+	}
+}
+
+FTransform AActor::GetTransform() const
+{
+	return GetTransformPool().GetTransform(TransformHandle);
 }
 
 void AActor::SetTransform(const FTransform& InTransform)
 {
-	Transform = InTransform;
-	UpdateModelMatrix();
+	GetTransformPool().SetTransform(TransformHandle, InTransform);
+}
+
+glm::vec3 AActor::GetLocation() const
+{
+	return GetTransformPool().GetTranslation(TransformHandle);
+}
+
+glm::quat AActor::GetRotation() const
+{
+	return GetTransformPool().GetRotation(TransformHandle);
+}
+
+glm::vec3 AActor::GetScale() const
+{
+	return GetTransformPool().GetScale(TransformHandle);
 }
 
 void AActor::SetLocation(const glm::vec3& InLocation)
 {
-	Transform.SetTranslation(InLocation);
-	UpdateModelMatrix();
+	GetTransformPool().SetTranslation(TransformHandle, InLocation);
 }
 
 void AActor::SetRotation(const glm::quat& InRotation)
 {
-	Transform.SetRotation(InRotation);
-	UpdateModelMatrix();
+	GetTransformPool().SetRotation(TransformHandle, InRotation);
 }
 
 void AActor::SetScale(const glm::vec3& InScale)
 {
-	Transform.SetScale(InScale);
-	UpdateModelMatrix();
+	GetTransformPool().SetScale(TransformHandle, InScale);
 }
 
 void AActor::AddOffset(const glm::vec3& InOffset)
 {
-	Transform.SetTranslation(Transform.GetTranslation() + InOffset);
-	UpdateModelMatrix();
+	SetLocation(GetLocation() + InOffset);
 }
 
 void AActor::AddRotation(const glm::quat& InRotation)
 {
-	Transform.SetRotation(InRotation * Transform.GetTranslation());
-	UpdateModelMatrix();
+	SetRotation(InRotation * GetRotation());
 }
 
 void AActor::AddScale(const glm::vec3& InScale)
 {
-	Transform.SetScale(Transform.GetScale() + InScale);
-	UpdateModelMatrix();
+	SetScale(GetScale() + InScale);
+}
+
+glm::mat4 AActor::GetCachedModelMatrix() const
+{
+	return GetTransformPool().GetWorldMatrix(TransformHandle);
+}
+
+uint64_t AActor::GetModelMatrixGeneration() const
+{
+	return GetTransformPool().GetWorldMatrixGeneration(TransformHandle);
 }
 
-void AActor::UpdateModelMatrix()
+FTransformPool& AActor::GetTransformPool() const
 {
-	static const glm::mat4 IdentityMatrix(1.0f);
-	CachedModelMatrix = glm::translate(IdentityMatrix, Transform.GetTranslation()) * glm::toMat4(Transform.GetRotation()) * glm::scale(IdentityMatrix, Transform.GetScale());
+	assert(World != nullptr);
+	return World->GetTransformPool();
 }
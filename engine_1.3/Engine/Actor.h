@@ -2,10 +2,12 @@
 
 #include "Object.h"
 #include "Transform.h"
+#include "TransformPool.h"
 
 #include "glm/glm.hpp"
 
 #include <string>
+#include <cstdint>
 
 #define DECLARE_ACTOR_BODY(ClassName, ParentClassName) \
 	DECLARE_OBJECT_BODY(ClassName, ParentClassName); \
@@ -17,13 +19,22 @@
 		return NewActor; \
 	} \
 
+// Groups run in declaration order; every actor of one group has ticked before the next group starts.
+enum class ETickGroup : uint8_t
+{
+	PrePhysics,
+	Main,
+	PostUpdate,
+	Count
+};
+
 class AActor : public UObject
 {
 public:
 	DECLARE_ACTOR_BODY(AActor, UObject);
 
 	AActor();
-	virtual ~AActor() = default;
+	virtual ~AActor();
 
 	virtual void Initialize();
 	virtual void Deinitialize();
@@ -38,15 +49,22 @@ public:
 	class FWorld* GetWorld() const;
 	void SetWorld(class FWorld* InWorld);
 
+	ETickGroup GetTickGroup() const { return TickGroup; }
+	void SetTickGroup(ETickGroup InTickGroup);
+
+	// Parallel actors tick on the job system alongside the rest of their group, so Tick must only touch the actor itself.
+	bool CanTickInParallel() const { return bParallelTick; }
+	void SetParallelTick(bool InbParallelTick);
+
 	bool IsVisible() const { return bVisible; }
 	void SetVisible(bool InbVisible) { bVisible = InbVisible; }
 
-	FTransform GetTransform() const { return Transform; }
+	FTransform GetTransform() const;
 	void SetTransform(const FTransform& InTransform);
 
-	glm::vec3 GetLocation() const { return Transform.GetTranslation(); }
-	glm::quat GetRotation() const { return Transform.GetRotation(); }
-	glm::vec3 GetScale() const { return Transform.GetScale(); }
+	glm::vec3 GetLocation() const;
+	glm::quat GetRotation() const;
+	glm::vec3 GetScale() const;
 
 	void SetLocation(const glm::vec3& InLocation);
 	void SetRotation(const glm::quat& InRotation);
@@ -56,17 +74,23 @@ public:
 	void AddRotation(const glm::quat& InRotation);
 	void AddScale(const glm::vec3& InScale);
 
-	glm::mat4 GetCachedModelMatrix() const { return CachedModelMatrix; }
+	// Composed by the world's transform pool after each tick group, so a change made during a tick shows up here once the group has finished.
+	glm::mat4 GetCachedModelMatrix() const;
+	uint64_t GetModelMatrixGeneration() const;
+
+	FTransformHandle GetTransformHandle() const { return TransformHandle; }
 
 protected:
-	void UpdateModelMatrix();
+	FTransformPool& GetTransformPool() const;
 
 protected:
 	class FWorld* World;
 
-	FTransform Transform;
-	glm::mat4 CachedModelMatrix;
+	FTransformHandle TransformHandle;
+
+	ETickGroup TickGroup;
 
 	bool bVisible;
+	bool bParallelTick;
 };
 
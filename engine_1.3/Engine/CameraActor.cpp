@@ -205,8 +205,8 @@ void ACameraActor::OnKeyUp(int InKey, int InScanCode, int InMods)
 
 glm::mat4 ACameraActor::GetViewMatrix() const
 {
-	glm::mat4 RotationMatrix = glm::toMat4(Transform.GetRotation());
-	glm::mat4 TranslationMatrix = glm::translate(glm::mat4(1.0f), Transform.GetTranslation());
+	glm::mat4 RotationMatrix = glm::toMat4(GetRotation());
+	glm::mat4 TranslationMatrix = glm::translate(glm::mat4(1.0f), GetLocation());
 
 	return glm::inverse(TranslationMatrix * RotationMatrix);
 }
@@ -1,6 +1,8 @@
 #include "Engine.h"
 #include "Config.h"
 #include "AssetManager.h"
+#include "FileSystem.h"
+#include "JobSystem.h"
 #include "Utils.h"
 #include "World.h"
 #include "LightActor.h"
@@ -51,15 +53,27 @@ FEngine::~FEngine()
 
 	delete RenderContext;
 
+	FJobSystem::Shutdown();
+	FFileSystem::Shutdown();
+
 	glfwDestroyWindow(Window);
 	glfwTerminate();
 }
 
 void FEngine::Initialize()
 {
+	FFileSystem::Startup();
+
 	InitializeGLFW();
 	CreateGLFWWindow();
-	CompileShaders();
+
+	// Cooked builds ship the shaders already compiled.
+	if (UAsset::IsCookedDataOnly() == false)
+	{
+		CompileShaders();
+	}
+
+	FJobSystem::Startup();
 
 	World = new FWorld();
 	RenderContext = new FVulkanContext(Window);
@@ -96,6 +110,8 @@ FVulkanUIRenderer* FEngine::GetUIRenderer() const
 
 void FEngine::Tick(float DeltaTime)
 {
+	FAssetManager::Tick();
+
 	if (World != nullptr)
 	{
 		World->Tick(DeltaTime);
@@ -146,7 +162,7 @@ void FEngine::CompileShaders()
 	{
 		std::string Filename = Entry.path().string();
 		std::string Extension = Entry.path().extension().string();
-		if (Extension == ".vert" || Extension == ".frag" || Extension == ".geom")
+		if (Extension == ".vert" || Extension == ".frag" || Extension == ".geom" || Extension == ".comp")
 		{
 			std::string Command = "glslang -g -V ";
 			Command += Filename;
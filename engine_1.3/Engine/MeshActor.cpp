@@ -3,6 +3,7 @@
 #include "Engine.h"
 
 #include "VulkanContext.h"
+#include "VulkanScene.h"
 #include "VulkanModel.h"
 #include "VulkanMesh.h"
 #include "VulkanMaterial.h"
@@ -12,9 +13,28 @@ AMeshActor::AMeshActor()
 	: AActor()
 	, Mesh(nullptr)
 	, RenderModel(nullptr)
+	, RenderModelGeneration(0)
 {
 }
 
+void AMeshActor::Deinitialize()
+{
+	AActor::Deinitialize();
+
+	if (RenderModel == nullptr)
+	{
+		return;
+	}
+
+	if (World != nullptr && World->GetRenderScene() != nullptr)
+	{
+		World->GetRenderScene()->RemoveModel(RenderModel);
+	}
+
+	RenderModel = nullptr;
+	RenderModelGeneration = 0;
+}
+
 FVulkanModel* AMeshActor::GetRenderModel() const
 {
 	return RenderModel;
@@ -54,5 +74,11 @@ void AMeshActor::UpdateRenderModel()
 		CreateRenderModel();
 	}
 
+	if (RenderModelGeneration == GetModelMatrixGeneration())
+	{
+		return;
+	}
+
 	RenderModel->SetModelMatrix(GetCachedModelMatrix());
+	RenderModelGeneration = GetModelMatrixGeneration();
 }
@@ -4,6 +4,7 @@
 #include "Texture.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "AssetPtr.h"
 
 class AMeshActor : public AActor
 {
@@ -12,6 +13,8 @@ public:
 
 	AMeshActor();
 
+	virtual void Deinitialize() override;
+
 	UMesh* GetMesh() const { return Mesh; }
 	void SetMesh(UMesh* InMesh) { Mesh = InMesh; }
 
@@ -20,7 +23,8 @@ public:
 	void UpdateRenderModel();
 
 private:
-	UMesh* Mesh;
+	TAssetPtr<UMesh> Mesh;
 
 	class FVulkanModel* RenderModel;
+	uint64_t RenderModelGeneration;
 };
@@ -4,6 +4,7 @@
 
 #include "Mesh.h"
 #include "Texture.h"
+#include "AssetPtr.h"
 
 #include <vector>
 
@@ -19,7 +20,7 @@ public:
 	void UpdateRenderModel();
 
 private:
-	UMesh* Mesh;
+	TAssetPtr<UMesh> Mesh;
 
 	class FVulkanModel* RenderModel;
 };
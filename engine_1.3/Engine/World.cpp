@@ -16,8 +16,13 @@
 #include "VulkanMesh.h"
 #include "VulkanTexture.h"
 
+#include "JobSystem.h"
+
+#include <algorithm>
+
 FWorld::FWorld()
-	: CameraActor(nullptr)
+	: bTickListsDirty(true)
+	, CameraActor(nullptr)
 	, RenderScene(nullptr)
 {
 	CameraActor = SpawnActor<ACameraActor>();
@@ -45,6 +50,14 @@ void FWorld::DestroyActor(AActor* InActor)
 			InActor->Deinitialize();
 			Actors.erase(Actors.begin() + Idx);
 
+			// The actor may be destroyed from inside a tick, so its tick list slot is cleared rather than erased.
+			for (FTickList& TickList : TickLists)
+			{
+				std::replace(TickList.ParallelActors.begin(), TickList.ParallelActors.end(), InActor, static_cast<AActor*>(nullptr));
+				std::replace(TickList.SerialActors.begin(), TickList.SerialActors.end(), InActor, static_cast<AActor*>(nullptr));
+			}
+			bTickListsDirty = true;
+
 			delete InActor;
 			break;
 		}
@@ -58,6 +71,30 @@ void FWorld::Tick(float DeltaTime)
 		GenerateRenderScene();
 	}
 
+	for (FTickList& TickList : TickLists)
+	{
+		if (bTickListsDirty)
+		{
+			RebuildTickLists();
+		}
+
+		TickActors(TickList, DeltaTime);
+
+		// Later groups and the render scene read the world matrices composed from this group's changes.
+		TransformPool.UpdateWorldMatrices();
+	}
+
+	UpdateRenderScene();
+}
+
+void FWorld::RebuildTickLists()
+{
+	for (FTickList& TickList : TickLists)
+	{
+		TickList.ParallelActors.clear();
+		TickList.SerialActors.clear();
+	}
+
 	for (AActor* Actor : Actors)
 	{
 		if (Actor == nullptr)
@@ -65,10 +102,53 @@ void FWorld::Tick(float DeltaTime)
 			continue;
 		}
 
-		Actor->Tick(DeltaTime);
+		FTickList& TickList = TickLists[static_cast<size_t>(Actor->GetTickGroup())];
+		if (Actor->CanTickInParallel())
+		{
+			TickList.ParallelActors.push_back(Actor);
+		}
+		else
+		{
+			TickList.SerialActors.push_back(Actor);
+		}
 	}
 
-	UpdateRenderScene();
+	bTickListsDirty = false;
+}
+
+void FWorld::TickActors(FTickList& InTickList, float DeltaTime)
+{
+	std::vector<AActor*>& ParallelActors = InTickList.ParallelActors;
+
+	auto TickRange = [&ParallelActors, DeltaTime](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+		{
+			if (ParallelActors[Idx] != nullptr)
+			{
+				ParallelActors[Idx]->Tick(DeltaTime);
+			}
+		}
+	};
+
+	uint32_t NumParallelActors = static_cast<uint32_t>(ParallelActors.size());
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelFor(NumParallelActors, TickRange);
+	}
+	else
+	{
+		TickRange(0, NumParallelActors);
+	}
+
+	// Serial actors run after the parallel ones so they may freely read the state the group has just produced.
+	for (AActor* Actor : InTickList.SerialActors)
+	{
+		if (Actor != nullptr)
+		{
+			Actor->Tick(DeltaTime);
+		}
+	}
 }
 
 const std::vector<class AActor*>& FWorld::GetActors()
@@ -103,37 +183,6 @@ void FWorld::GenerateRenderScene()
 
 	RenderScene = RenderContext->CreateObject<FVulkanScene>();
 
-	for (AActor* Actor : Actors)
-	{
-		if (Actor == nullptr)
-		{
-			continue;
-		}
-
-		if (Actor->IsVisible() == false)
-		{
-			continue;
-		}
-
-		if (Actor->GetTypeId() == AMeshActor::StaticTypeId())
-		{
-			if (AMeshActor* MeshActor = Cast<AMeshActor>(Actor))
-			{
-				UMesh* MeshAsset = MeshActor->GetMesh();
-				if (MeshAsset == nullptr)
-				{
-					continue;
-				}
-
-				FVulkanModel* Model = MeshActor->CreateRenderModel();
-				if (Model != nullptr)
-				{
-					RenderScene->AddModel(Model);
-				}
-			}
-		}
-	}
-
 	if (SkyActor != nullptr)
 	{
 		FVulkanModel* Model = SkyActor->CreateRenderModel();
@@ -169,8 +218,73 @@ void FWorld::UpdateRenderScene()
 		RenderScene->SetCamera(Camera);
 	}
 
-	for (AActor* Actor : Actors)
+	uint32_t NumActors = static_cast<uint32_t>(Actors.size());
+
+	// Each chunk gathers into its own bucket; merging the buckets in chunk order keeps the light order stable.
+	static constexpr uint32_t GatherChunkSize = 512;
+	uint32_t NumChunks = (NumActors + GatherChunkSize - 1) / GatherChunkSize;
+
+	if (RenderGathers.size() < NumChunks)
+	{
+		RenderGathers.resize(NumChunks);
+	}
+
+	auto GatherRange = [this](uint32_t InBegin, uint32_t InEnd)
+	{
+		GatherRenderState(InBegin, InEnd, RenderGathers[InBegin / GatherChunkSize]);
+	};
+
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelFor(NumActors, GatherChunkSize, GatherRange);
+	}
+	else
 	{
+		for (uint32_t Begin = 0; Begin < NumActors; Begin += GatherChunkSize)
+		{
+			GatherRange(Begin, std::min(Begin + GatherChunkSize, NumActors));
+		}
+	}
+
+	for (uint32_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+	{
+		FRenderGather& Gather = RenderGathers[Chunk];
+
+		// Render models are created on this thread because creating Vulkan objects and adding them to the scene is not thread safe.
+		for (AMeshActor* MeshActor : Gather.NewMeshActors)
+		{
+			FVulkanModel* Model = MeshActor->CreateRenderModel();
+			if (Model == nullptr)
+			{
+				continue;
+			}
+
+			RenderScene->AddModel(Model);
+			MeshActor->UpdateRenderModel();
+		}
+
+		PointLights.insert(PointLights.end(), Gather.PointLights.begin(), Gather.PointLights.end());
+		DirectionalLights.insert(DirectionalLights.end(), Gather.DirectionalLights.begin(), Gather.DirectionalLights.end());
+	}
+
+	RenderScene->SetPointLights(PointLights);
+	RenderScene->SetDirectionalLights(DirectionalLights);
+
+	if (SkyActor != nullptr)
+	{
+		SkyActor->UpdateRenderModel();
+	}
+}
+
+void FWorld::GatherRenderState(uint32_t InBegin, uint32_t InEnd, FRenderGather& OutGather)
+{
+	OutGather.NewMeshActors.clear();
+	OutGather.PointLights.clear();
+	OutGather.DirectionalLights.clear();
+
+	for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+	{
+		AActor* Actor = Actors[Idx];
 		if (Actor == nullptr)
 		{
 			continue;
@@ -180,6 +294,18 @@ void FWorld::UpdateRenderScene()
 		{
 			if (AMeshActor* MeshActor = Cast<AMeshActor>(Actor))
 			{
+				if (MeshActor->GetRenderModel() == nullptr)
+				{
+					// Actors whose mesh is still loading asynchronously are picked up once it has its render mesh.
+					UMesh* Mesh = MeshActor->GetMesh();
+					if (MeshActor->IsVisible() && Mesh != nullptr && Mesh->GetRenderMesh() != nullptr)
+					{
+						OutGather.NewMeshActors.push_back(MeshActor);
+					}
+
+					continue;
+				}
+
 				MeshActor->UpdateRenderModel();
 			}
 		}
@@ -195,7 +321,7 @@ void FWorld::UpdateRenderScene()
 				Light.Attenuation = PointLight->GetAttenuation();
 				Light.Shininess = PointLight->GetShininess();
 
-				PointLights.push_back(Light);
+				OutGather.PointLights.push_back(Light);
 			}
 		}
 		else if (Actor->GetTypeId() == ADirectionalLightActor::StaticTypeId())
@@ -210,16 +336,8 @@ void FWorld::UpdateRenderScene()
 				Light.Attenuation = DirectionalLight->GetAttenuation();
 				Light.Shininess = DirectionalLight->GetShininess();
 
-				DirectionalLights.push_back(Light);
+				OutGather.DirectionalLights.push_back(Light);
 			}
 		}
 	}
-
-	RenderScene->SetPointLights(PointLights);
-	RenderScene->SetDirectionalLights(DirectionalLights);
-
-	if (SkyActor != nullptr)
-	{
-		SkyActor->UpdateRenderModel();
-	}
 }
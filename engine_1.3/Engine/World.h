@@ -1,10 +1,12 @@
 #pragma once
 
+#include "Actor.h"
+#include "TransformPool.h"
+#include "VulkanLight.h"
+
 #include <vector>
 #include <unordered_map>
 
-class AActor;
-
 class FWorld
 {
 public:
@@ -16,6 +18,7 @@ public:
 	{
 		T* NewActor = T::StaticSpawnActor(this);
 		Actors.push_back(NewActor);
+		bTickListsDirty = true;
 
 		NewActor->Initialize();
 
@@ -26,18 +29,49 @@ public:
 
 	void Tick(float DeltaTime);
 
+	// Called when an actor changes its tick group or parallel tick setting.
+	void MarkTickListsDirty() { bTickListsDirty = true; }
+
 	const std::vector<class AActor*>& GetActors();
 	class ACameraActor* GetCamera() const;
 	class ASkyActor* GetSky() const;
 
 	class FVulkanScene* GetRenderScene() const;
 
+	FTransformPool& GetTransformPool() { return TransformPool; }
+
 private:
+	struct FTickList
+	{
+		std::vector<class AActor*> ParallelActors;
+		std::vector<class AActor*> SerialActors;
+	};
+
+	// Render state gathered by one chunk of actors during UpdateRenderScene.
+	struct FRenderGather
+	{
+		std::vector<class AMeshActor*> NewMeshActors;
+		std::vector<FVulkanPointLight> PointLights;
+		std::vector<FVulkanDirectionalLight> DirectionalLights;
+	};
+
+	void RebuildTickLists();
+	void TickActors(FTickList& InTickList, float DeltaTime);
+
 	void GenerateRenderScene();
 	void UpdateRenderScene();
+	void GatherRenderState(uint32_t InBegin, uint32_t InEnd, FRenderGather& OutGather);
 
 private:
+	FTransformPool TransformPool;
+
 	std::vector<class AActor*> Actors;
+
+	FTickList TickLists[static_cast<size_t>(ETickGroup::Count)];
+	bool bTickListsDirty;
+
+	std::vector<FRenderGather> RenderGathers;
+
 	class ACameraActor* CameraActor;
 	class ASkyActor* SkyActor;
 
@@ -0,0 +1,353 @@
+#include "TLSFAllocator.h"
+
+#include <cassert>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+static uint32_t FindLastSet(uint64_t InValue)
+{
+	unsigned long Index;
+	_BitScanReverse64(&Index, InValue);
+	return static_cast<uint32_t>(Index);
+}
+
+static uint32_t FindFirstSet(uint64_t InValue)
+{
+	unsigned long Index;
+	_BitScanForward64(&Index, InValue);
+	return static_cast<uint32_t>(Index);
+}
+#else
+static uint32_t FindLastSet(uint64_t InValue)
+{
+	return 63U - static_cast<uint32_t>(__builtin_clzll(InValue));
+}
+
+static uint32_t FindFirstSet(uint64_t InValue)
+{
+	return static_cast<uint32_t>(__builtin_ctzll(InValue));
+}
+#endif
+
+static uint64_t AlignUp(uint64_t InValue, uint64_t InAlignment)
+{
+	return (InValue + InAlignment - 1) & ~(InAlignment - 1);
+}
+
+FTLSFAllocator::FTLSFAllocator()
+	: FTLSFAllocator(0)
+{
+}
+
+FTLSFAllocator::FTLSFAllocator(uint64_t InCapacity)
+{
+	Reset(InCapacity);
+}
+
+void FTLSFAllocator::Reset(uint64_t InCapacity)
+{
+	Nodes.clear();
+	FreeNodes.clear();
+
+	FLBitmap = 0;
+	for (uint32_t FL = 0; FL < FLCount; ++FL)
+	{
+		SLBitmaps[FL] = 0;
+		for (uint32_t SL = 0; SL < SLCount; ++SL)
+		{
+			FreeLists[FL][SL] = InvalidHandle;
+		}
+	}
+
+	Capacity = InCapacity;
+	UsedSize = 0;
+	NumAllocations = 0;
+
+	if (Capacity > 0)
+	{
+		uint32_t Handle = NewNode();
+		Nodes[Handle].Offset = 0;
+		Nodes[Handle].Size = Capacity;
+		InsertFreeBlock(Handle);
+	}
+}
+
+uint32_t FTLSFAllocator::Allocate(uint64_t InSize, uint64_t InAlignment, uint64_t& OutOffset)
+{
+	assert(InAlignment > 0 && (InAlignment & (InAlignment - 1)) == 0);
+
+	if (InSize == 0)
+	{
+		InSize = 1;
+	}
+
+	uint32_t Handle = FindFreeBlock(InSize);
+	if (Handle != InvalidHandle)
+	{
+		const FNode& Node = Nodes[Handle];
+		if (AlignUp(Node.Offset, InAlignment) + InSize > Node.Offset + Node.Size)
+		{
+			Handle = InvalidHandle;
+		}
+	}
+
+	if (Handle == InvalidHandle && InAlignment > 1)
+	{
+		Handle = FindFreeBlock(InSize + InAlignment - 1);
+	}
+
+	if (Handle == InvalidHandle)
+	{
+		return InvalidHandle;
+	}
+
+	RemoveFreeBlock(Handle);
+
+	uint64_t Padding = AlignUp(Nodes[Handle].Offset, InAlignment) - Nodes[Handle].Offset;
+	if (Padding > 0)
+	{
+		uint32_t Aligned = Split(Handle, Padding);
+		InsertFreeBlock(Handle);
+		Handle = Aligned;
+	}
+
+	if (Nodes[Handle].Size > InSize)
+	{
+		uint32_t Remainder = Split(Handle, InSize);
+		InsertFreeBlock(Remainder);
+	}
+
+	UsedSize += Nodes[Handle].Size;
+	++NumAllocations;
+
+	OutOffset = Nodes[Handle].Offset;
+	return Handle;
+}
+
+void FTLSFAllocator::Free(uint32_t InHandle)
+{
+	if (InHandle >= Nodes.size() || Nodes[InHandle].bFree)
+	{
+		return;
+	}
+
+	UsedSize -= Nodes[InHandle].Size;
+	--NumAllocations;
+
+	uint32_t Handle = InHandle;
+
+	uint32_t Prev = Nodes[Handle].PrevPhysical;
+	if (Prev != InvalidHandle && Nodes[Prev].bFree)
+	{
+		RemoveFreeBlock(Prev);
+		Merge(Prev, Handle);
+		Handle = Prev;
+	}
+
+	uint32_t Next = Nodes[Handle].NextPhysical;
+	if (Next != InvalidHandle && Nodes[Next].bFree)
+	{
+		RemoveFreeBlock(Next);
+		Merge(Handle, Next);
+	}
+
+	InsertFreeBlock(Handle);
+}
+
+FTLSFAllocator::FStats FTLSFAllocator::GetStats() const
+{
+	FStats Stats;
+	Stats.Capacity = Capacity;
+	Stats.UsedSize = UsedSize;
+	Stats.NumAllocations = NumAllocations;
+
+	if (Nodes.empty())
+	{
+		return Stats;
+	}
+
+	// The node at offset zero is never released, so the physical chain always starts there.
+	for (uint32_t Handle = 0; Handle != InvalidHandle; Handle = Nodes[Handle].NextPhysical)
+	{
+		const FNode& Node = Nodes[Handle];
+		if (Node.bFree)
+		{
+			++Stats.NumFreeBlocks;
+			if (Node.Size > Stats.LargestFreeBlock)
+			{
+				Stats.LargestFreeBlock = Node.Size;
+			}
+		}
+	}
+
+	return Stats;
+}
+
+void FTLSFAllocator::MapSize(uint64_t InSize, uint32_t& OutFL, uint32_t& OutSL)
+{
+	if (InSize < SLCount)
+	{
+		OutFL = 0;
+		OutSL = static_cast<uint32_t>(InSize);
+		return;
+	}
+
+	uint32_t Msb = FindLastSet(InSize);
+	OutFL = Msb - SLLog2 + 1;
+	OutSL = static_cast<uint32_t>(InSize >> (Msb - SLLog2)) - SLCount;
+}
+
+void FTLSFAllocator::MapSearchSize(uint64_t InSize, uint32_t& OutFL, uint32_t& OutSL)
+{
+	if (InSize >= SLCount)
+	{
+		// Round up to the next class so any block found in it is large enough.
+		InSize += (1ULL << (FindLastSet(InSize) - SLLog2)) - 1;
+	}
+
+	MapSize(InSize, OutFL, OutSL);
+}
+
+uint32_t FTLSFAllocator::FindFreeBlock(uint64_t InSize) const
+{
+	uint32_t FL = 0;
+	uint32_t SL = 0;
+	MapSearchSize(InSize, FL, SL);
+
+	if (FL >= FLCount)
+	{
+		return InvalidHandle;
+	}
+
+	uint32_t SLMap = SLBitmaps[FL] & (~0U << SL);
+	if (SLMap == 0)
+	{
+		uint64_t FLMap = FL + 1 < 64 ? FLBitmap & (~0ULL << (FL + 1)) : 0;
+		if (FLMap == 0)
+		{
+			return InvalidHandle;
+		}
+
+		FL = FindFirstSet(FLMap);
+		SLMap = SLBitmaps[FL];
+	}
+
+	SL = FindFirstSet(SLMap);
+	return FreeLists[FL][SL];
+}
+
+void FTLSFAllocator::InsertFreeBlock(uint32_t InHandle)
+{
+	uint32_t FL = 0;
+	uint32_t SL = 0;
+	MapSize(Nodes[InHandle].Size, FL, SL);
+
+	FNode& Node = Nodes[InHandle];
+	Node.bFree = true;
+	Node.PrevFree = InvalidHandle;
+	Node.NextFree = FreeLists[FL][SL];
+
+	if (Node.NextFree != InvalidHandle)
+	{
+		Nodes[Node.NextFree].PrevFree = InHandle;
+	}
+
+	FreeLists[FL][SL] = InHandle;
+	FLBitmap |= 1ULL << FL;
+	SLBitmaps[FL] |= 1U << SL;
+}
+
+void FTLSFAllocator::RemoveFreeBlock(uint32_t InHandle)
+{
+	uint32_t FL = 0;
+	uint32_t SL = 0;
+	MapSize(Nodes[InHandle].Size, FL, SL);
+
+	FNode& Node = Nodes[InHandle];
+
+	if (Node.PrevFree != InvalidHandle)
+	{
+		Nodes[Node.PrevFree].NextFree = Node.NextFree;
+	}
+	if (Node.NextFree != InvalidHandle)
+	{
+		Nodes[Node.NextFree].PrevFree = Node.PrevFree;
+	}
+
+	if (FreeLists[FL][SL] == InHandle)
+	{
+		FreeLists[FL][SL] = Node.NextFree;
+		if (FreeLists[FL][SL] == InvalidHandle)
+		{
+			SLBitmaps[FL] &= ~(1U << SL);
+			if (SLBitmaps[FL] == 0)
+			{
+				FLBitmap &= ~(1ULL << FL);
+			}
+		}
+	}
+
+	Node.bFree = false;
+	Node.PrevFree = InvalidHandle;
+	Node.NextFree = InvalidHandle;
+}
+
+uint32_t FTLSFAllocator::Split(uint32_t InHandle, uint64_t InSize)
+{
+	uint32_t Remainder = NewNode();
+
+	FNode& Node = Nodes[InHandle];
+	FNode& RemainderNode = Nodes[Remainder];
+
+	RemainderNode.Offset = Node.Offset + InSize;
+	RemainderNode.Size = Node.Size - InSize;
+	RemainderNode.PrevPhysical = InHandle;
+	RemainderNode.NextPhysical = Node.NextPhysical;
+
+	if (Node.NextPhysical != InvalidHandle)
+	{
+		Nodes[Node.NextPhysical].PrevPhysical = Remainder;
+	}
+
+	Node.Size = InSize;
+	Node.NextPhysical = Remainder;
+
+	return Remainder;
+}
+
+void FTLSFAllocator::Merge(uint32_t InHandle, uint32_t InNext)
+{
+	FNode& Node = Nodes[InHandle];
+	const FNode& NextNode = Nodes[InNext];
+
+	Node.Size += NextNode.Size;
+	Node.NextPhysical = NextNode.NextPhysical;
+
+	if (Node.NextPhysical != InvalidHandle)
+	{
+		Nodes[Node.NextPhysical].PrevPhysical = InHandle;
+	}
+
+	ReleaseNode(InNext);
+}
+
+uint32_t FTLSFAllocator::NewNode()
+{
+	if (FreeNodes.empty() == false)
+	{
+		uint32_t Handle = FreeNodes.back();
+		FreeNodes.pop_back();
+		Nodes[Handle] = FNode();
+		return Handle;
+	}
+
+	Nodes.emplace_back();
+	return static_cast<uint32_t>(Nodes.size() - 1);
+}
+
+void FTLSFAllocator::ReleaseNode(uint32_t InHandle)
+{
+	Nodes[InHandle] = FNode();
+	FreeNodes.push_back(InHandle);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Two-level segregated fit bookkeeping over an abstract [0, Capacity) range.
+// It never touches memory itself, so it can be driven without a device.
+class FTLSFAllocator
+{
+public:
+	static constexpr uint32_t InvalidHandle = UINT32_MAX;
+
+	struct FStats
+	{
+		uint64_t Capacity = 0;
+		uint64_t UsedSize = 0;
+		uint64_t LargestFreeBlock = 0;
+		uint32_t NumAllocations = 0;
+		uint32_t NumFreeBlocks = 0;
+	};
+
+	FTLSFAllocator();
+	FTLSFAllocator(uint64_t InCapacity);
+
+	void Reset(uint64_t InCapacity);
+
+	// Returns InvalidHandle when no free block can hold the request. InAlignment must be a power of two.
+	uint32_t Allocate(uint64_t InSize, uint64_t InAlignment, uint64_t& OutOffset);
+	void Free(uint32_t InHandle);
+
+	uint64_t GetOffset(uint32_t InHandle) const { return Nodes[InHandle].Offset; }
+	uint64_t GetSize(uint32_t InHandle) const { return Nodes[InHandle].Size; }
+
+	uint64_t GetCapacity() const { return Capacity; }
+	uint64_t GetUsedSize() const { return UsedSize; }
+	uint32_t GetNumAllocations() const { return NumAllocations; }
+	bool IsEmpty() const { return NumAllocations == 0; }
+
+	FStats GetStats() const;
+
+private:
+	static constexpr uint32_t SLLog2 = 4;
+	static constexpr uint32_t SLCount = 1U << SLLog2;
+	static constexpr uint32_t FLCount = 64 - SLLog2 + 1;
+
+	struct FNode
+	{
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+		uint32_t PrevPhysical = InvalidHandle;
+		uint32_t NextPhysical = InvalidHandle;
+		uint32_t PrevFree = InvalidHandle;
+		uint32_t NextFree = InvalidHandle;
+		bool bFree = false;
+	};
+
+	static void MapSize(uint64_t InSize, uint32_t& OutFL, uint32_t& OutSL);
+	static void MapSearchSize(uint64_t InSize, uint32_t& OutFL, uint32_t& OutSL);
+
+	uint32_t FindFreeBlock(uint64_t InSize) const;
+	void InsertFreeBlock(uint32_t InHandle);
+	void RemoveFreeBlock(uint32_t InHandle);
+
+	// Splits InSize bytes off the front of InHandle and returns the handle of the remainder.
+	uint32_t Split(uint32_t InHandle, uint64_t InSize);
+	void Merge(uint32_t InHandle, uint32_t InNext);
+
+	uint32_t NewNode();
+	void ReleaseNode(uint32_t InHandle);
+
+	std::vector<FNode> Nodes;
+	std::vector<uint32_t> FreeNodes;
+
+	uint64_t FLBitmap;
+	uint32_t SLBitmaps[FLCount];
+	uint32_t FreeLists[FLCount][SLCount];
+
+	uint64_t Capacity;
+	uint64_t UsedSize;
+	uint32_t NumAllocations;
+};
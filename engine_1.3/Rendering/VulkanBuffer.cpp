@@ -1,11 +1,13 @@
 #include "VulkanBuffer.h"
 #include "VulkanContext.h"
 #include "VulkanHelpers.h"
+#include "VulkanUploader.h"
+
+#include <stdexcept>
 
 FVulkanBuffer::FVulkanBuffer(FVulkanContext* InContext)
 	: FVulkanObject(InContext)
 	, Buffer(VK_NULL_HANDLE)
-	, Memory(VK_NULL_HANDLE)
 	, Mapped(nullptr)
 	, AllocatedSize(0)
 	, Usage(0)
@@ -21,17 +23,29 @@ void FVulkanBuffer::Destroy()
 
 void FVulkanBuffer::Allocate(VkDeviceSize InBufferSize)
 {
-	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
 	VkDevice Device = Context->GetDevice();
 
-	Vk::CreateBuffer(
-		PhysicalDevice,
-		Device,
-		InBufferSize,
-		Usage,
-		Properties,
-		Buffer,
-		Memory);
+	VkBufferCreateInfo BufferCI{};
+	BufferCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	BufferCI.size = InBufferSize;
+	BufferCI.usage = Usage;
+	BufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(Device, &BufferCI, nullptr, &Buffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create buffer.");
+	}
+
+	VkMemoryRequirements MemoryReqs{};
+	vkGetBufferMemoryRequirements(Device, Buffer, &MemoryReqs);
+
+	FVulkanMemoryAllocator* MemoryAllocator = Context->GetMemoryAllocator();
+	if (MemoryAllocator->Allocate(MemoryReqs, Properties, EVulkanResourceKind::Linear, Allocation) == false)
+	{
+		throw std::runtime_error("Failed to allocate buffer memory.");
+	}
+
+	VK_ASSERT(vkBindBufferMemory(Device, Buffer, Allocation.Memory, Allocation.Offset));
 
 	AllocatedSize = InBufferSize;
 }
@@ -50,13 +64,9 @@ void FVulkanBuffer::Unallocate()
 		vkDestroyBuffer(Device, Buffer, nullptr);
 	}
 
-	if (Memory != VK_NULL_HANDLE)
-	{
-		vkFreeMemory(Device, Memory, nullptr);
-	}
+	Context->GetMemoryAllocator()->Free(Allocation);
 
 	Buffer = VK_NULL_HANDLE;
-	Memory = VK_NULL_HANDLE;
 	AllocatedSize = 0;
 }
 
@@ -79,56 +89,25 @@ bool FVulkanBuffer::Copy(uint8_t* InData, VkDeviceSize InBufferSize)
 		return false;
 	}
 
-	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
-	VkDevice Device = Context->GetDevice();
-	VkQueue GfxQueue = Context->GetGfxQueue();
-	VkCommandPool CommandPool = Context->GetCommandPool();
-
-	VkBuffer StagingBuffer;
-	VkDeviceMemory StagingBufferMemory;
-	Vk::CreateBuffer(
-		PhysicalDevice,
-		Device,
-		InBufferSize,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		StagingBuffer,
-		StagingBufferMemory);
-
-	void* MappedMemory;
-	VK_ASSERT(vkMapMemory(Device, StagingBufferMemory, 0, InBufferSize, 0, &MappedMemory));
-	memcpy(MappedMemory, InData, static_cast<size_t>(InBufferSize));
-	vkUnmapMemory(Device, StagingBufferMemory);
-
-	Vk::CopyBuffer(Device, CommandPool, GfxQueue, StagingBuffer, Buffer, InBufferSize);
-
-	vkDestroyBuffer(Device, StagingBuffer, nullptr);
-	vkFreeMemory(Device, StagingBufferMemory, nullptr);
+	FVulkanUploader* Uploader = Context->GetUploader();
+	Uploader->UploadBuffer(Buffer, 0, InData, InBufferSize);
 
 	return true;
 }
 
 void FVulkanBuffer::Map()
 {
-	if (Buffer == VK_NULL_HANDLE || Memory == VK_NULL_HANDLE)
+	if (Buffer == VK_NULL_HANDLE || Allocation.IsValid() == false)
 	{
 		return;
 	}
 
-	VkDevice Device = Context->GetDevice();
-	VK_ASSERT(vkMapMemory(Device, Memory, 0, AllocatedSize, 0, &Mapped));
+	// Host visible blocks are persistently mapped by the allocator.
+	Mapped = Allocation.Mapped;
 }
 
 void FVulkanBuffer::Unmap()
 {
-	if (Mapped == nullptr)
-	{
-		return;
-	}
-
-	VkDevice Device = Context->GetDevice();
-	vkUnmapMemory(Device, Memory);
-
 	Mapped = nullptr;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VulkanObject.h"
+#include "VulkanMemoryAllocator.h"
 
 #include "vulkan/vulkan.h"
 
@@ -14,8 +15,10 @@ public:
 	virtual void Destroy() override;
 
 	VkBuffer GetHandle() const { return Buffer; }
-	VkDeviceMemory GetMemory() const { return Memory; }
+	VkDeviceMemory GetMemory() const { return Allocation.Memory; }
+	VkDeviceSize GetMemoryOffset() const { return Allocation.Offset; }
 	void* GetMappedAddress() const { return Mapped; }
+	VkDeviceSize GetAllocatedSize() const { return AllocatedSize; }
 
 	void SetUsage(VkBufferUsageFlags InUsage) { Usage = InUsage; }
 	void SetProperties(VkMemoryPropertyFlags InProperties) { Properties = InProperties; }
@@ -33,7 +36,7 @@ public:
 
 protected:
 	VkBuffer Buffer;
-	VkDeviceMemory Memory;
+	FVulkanAllocation Allocation;
 	void* Mapped;
 
 	VkDeviceSize AllocatedSize;
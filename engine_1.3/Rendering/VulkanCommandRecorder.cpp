@@ -0,0 +1,151 @@
+#include "VulkanCommandRecorder.h"
+#include "VulkanContext.h"
+#include "VulkanHelpers.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+FVulkanCommandRecorder::FVulkanCommandRecorder(FVulkanContext* InContext)
+	: FVulkanObject(InContext)
+	, MinItemsPerSlot(8)
+{
+
+}
+
+void FVulkanCommandRecorder::Destroy()
+{
+	VkDevice Device = Context->GetDevice();
+
+	for (FSlot& Slot : Slots)
+	{
+		for (VkCommandPool CommandPool : Slot.CommandPools)
+		{
+			if (CommandPool != VK_NULL_HANDLE)
+			{
+				vkDestroyCommandPool(Device, CommandPool, nullptr);
+			}
+		}
+	}
+	Slots.clear();
+}
+
+void FVulkanCommandRecorder::Initialize(uint32_t InNumSlots)
+{
+	VkDevice Device = Context->GetDevice();
+
+	uint32_t GraphicsFamily = -1;
+	uint32_t PresentFamily = -1;
+	Vk::FindQueueFamilies(Context->GetPhysicalDevice(), Context->GetSurface(), GraphicsFamily, PresentFamily);
+
+	VkCommandPoolCreateInfo CommandPoolCI{};
+	CommandPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	CommandPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	CommandPoolCI.queueFamilyIndex = GraphicsFamily;
+
+	Slots.resize(std::max(InNumSlots, 1U));
+	for (FSlot& Slot : Slots)
+	{
+		for (VkCommandPool& CommandPool : Slot.CommandPools)
+		{
+			VK_ASSERT(vkCreateCommandPool(Device, &CommandPoolCI, nullptr, &CommandPool));
+		}
+	}
+}
+
+void FVulkanCommandRecorder::ResetFrame(uint32_t InFrame)
+{
+	VkDevice Device = Context->GetDevice();
+
+	for (FSlot& Slot : Slots)
+	{
+		if (Slot.NumUsedCommandBuffers[InFrame] == 0)
+		{
+			continue;
+		}
+
+		VK_ASSERT(vkResetCommandPool(Device, Slot.CommandPools[InFrame], 0));
+		Slot.NumUsedCommandBuffers[InFrame] = 0;
+	}
+}
+
+void FVulkanCommandRecorder::Record(
+	uint32_t InNumItems,
+	const VkCommandBufferInheritanceInfo& InInheritanceInfo,
+	const FRecordFunction& InRecordFunction,
+	std::vector<VkCommandBuffer>& OutCommandBuffers)
+{
+	OutCommandBuffers.clear();
+
+	if (InNumItems == 0 || Slots.empty())
+	{
+		return;
+	}
+
+	uint32_t NumChunks = std::min(static_cast<uint32_t>(Slots.size()), (InNumItems + MinItemsPerSlot - 1) / MinItemsPerSlot);
+	NumChunks = std::max(NumChunks, 1U);
+
+	uint32_t ChunkSize = (InNumItems + NumChunks - 1) / NumChunks;
+	NumChunks = (InNumItems + ChunkSize - 1) / ChunkSize;
+
+	OutCommandBuffers.resize(NumChunks, VK_NULL_HANDLE);
+
+	auto RecordChunk = [&](uint32_t InBegin, uint32_t InEnd)
+	{
+		// Command pools are externally synchronized, so each thread records from the pool of its own slot.
+		uint32_t WorkerIndex = FJobSystem::GetWorkerIndex();
+		uint32_t Slot = WorkerIndex < Slots.size() ? WorkerIndex : 0;
+
+		VkCommandBuffer CommandBuffer = AcquireCommandBuffer(Slot);
+
+		VkCommandBufferBeginInfo CommandBufferBeginInfo{};
+		CommandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		CommandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		CommandBufferBeginInfo.pInheritanceInfo = &InInheritanceInfo;
+
+		VK_ASSERT(vkBeginCommandBuffer(CommandBuffer, &CommandBufferBeginInfo));
+		InRecordFunction(CommandBuffer, InBegin, InEnd);
+		VK_ASSERT(vkEndCommandBuffer(CommandBuffer));
+
+		OutCommandBuffers[InBegin / ChunkSize] = CommandBuffer;
+	};
+
+	if (GJobSystem != nullptr && NumChunks > 1)
+	{
+		GJobSystem->ParallelFor(InNumItems, ChunkSize, RecordChunk);
+	}
+	else
+	{
+		OutCommandBuffers.resize(1);
+		RecordChunk(0, InNumItems);
+	}
+}
+
+VkCommandBuffer FVulkanCommandRecorder::AcquireCommandBuffer(uint32_t InSlot)
+{
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
+
+	FSlot& Slot = Slots[InSlot];
+	std::vector<VkCommandBuffer>& CommandBuffers = Slot.CommandBuffers[CurrentFrame];
+	uint32_t& NumUsed = Slot.NumUsedCommandBuffers[CurrentFrame];
+
+	if (NumUsed == CommandBuffers.size())
+	{
+		VkCommandBufferAllocateInfo CommandBufferAllocInfo{};
+		CommandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		CommandBufferAllocInfo.commandPool = Slot.CommandPools[CurrentFrame];
+		CommandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		CommandBufferAllocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(Context->GetDevice(), &CommandBufferAllocInfo, &CommandBuffer) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Failed to allocate secondary command buffer.");
+		}
+
+		CommandBuffers.push_back(CommandBuffer);
+	}
+
+	return CommandBuffers[NumUsed++];
+}
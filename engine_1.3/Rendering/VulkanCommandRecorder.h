@@ -0,0 +1,52 @@
+#pragma once
+
+#include "VulkanObject.h"
+#include "VulkanContext.h"
+
+#include "vulkan/vulkan.h"
+
+#include <vector>
+#include <functional>
+
+// Records secondary command buffers on the job system.
+// Every job system thread owns a slot with one VkCommandPool per concurrent frame, so recording never shares a pool across threads.
+class FVulkanCommandRecorder : public FVulkanObject
+{
+public:
+	using FRecordFunction = std::function<void(VkCommandBuffer InCommandBuffer, uint32_t InBegin, uint32_t InEnd)>;
+
+	FVulkanCommandRecorder(class FVulkanContext* InContext);
+
+	virtual void Destroy() override;
+
+	void Initialize(uint32_t InNumSlots);
+
+	// Must be called once the frame's fence has been waited on; recycles the secondary command buffers used by that frame.
+	void ResetFrame(uint32_t InFrame);
+
+	// Splits [0, InNumItems) into contiguous ranges and records each range into its own secondary command buffer.
+	// OutCommandBuffers is filled in range order so the caller can execute them with a single vkCmdExecuteCommands.
+	void Record(
+		uint32_t InNumItems,
+		const VkCommandBufferInheritanceInfo& InInheritanceInfo,
+		const FRecordFunction& InRecordFunction,
+		std::vector<VkCommandBuffer>& OutCommandBuffers);
+
+	uint32_t GetNumSlots() const { return static_cast<uint32_t>(Slots.size()); }
+
+	void SetMinItemsPerSlot(uint32_t InMinItemsPerSlot) { MinItemsPerSlot = InMinItemsPerSlot > 0 ? InMinItemsPerSlot : 1; }
+
+private:
+	struct FSlot
+	{
+		VkCommandPool CommandPools[MAX_CONCURRENT_FRAME] = {};
+		std::vector<VkCommandBuffer> CommandBuffers[MAX_CONCURRENT_FRAME];
+		uint32_t NumUsedCommandBuffers[MAX_CONCURRENT_FRAME] = {};
+	};
+
+	VkCommandBuffer AcquireCommandBuffer(uint32_t InSlot);
+
+	std::vector<FSlot> Slots;
+
+	uint32_t MinItemsPerSlot;
+};
@@ -8,8 +8,14 @@
 #include "VulkanRenderer.h"
 #include "VulkanMeshRenderer.h"
 #include "VulkanUIRenderer.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanUploader.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanCommandRecorder.h"
+#include "VulkanDescriptorAllocator.h"
 
 #include "Config.h"
+#include "JobSystem.h"
 
 #include <array>
 #include <vector>
@@ -72,12 +78,17 @@ FVulkanContext::FVulkanContext(GLFWwindow* InWindow)
 	, Surface(VK_NULL_HANDLE)
 	, PhysicalDevice(VK_NULL_HANDLE)
 	, Device(VK_NULL_HANDLE)
+	, MemoryAllocator(nullptr)
 	, Swapchain(nullptr)
 	, DepthImage(nullptr)
 	, SkyRenderer(nullptr)
 	, ShadowRenderer(nullptr)
 	, MeshRenderer(nullptr)
 	, UIRenderer(nullptr)
+	, DescriptorAllocator(nullptr)
+	, PipelineCache(nullptr)
+	, Uploader(nullptr)
+	, CommandRecorder(nullptr)
 {
 	RenderContextMap[InWindow] = this;
 
@@ -88,12 +99,16 @@ FVulkanContext::FVulkanContext(GLFWwindow* InWindow)
 	CreateSurface();
 	PickPhysicalDevice();
 	CreateLogicalDevice();
+	CreateMemoryAllocator();
 	CreateSwapchain();
 	CreateCommandPool();
 	CreateCommandBuffers();
 	CreateFramebuffers();
 	CreateSyncObjects();
+	CreateUploader();
+	CreateCommandRecorder();
 	CreateDescriptorPool();
+	CreatePipelineCache();
 	CreateRenderers();
 }
 
@@ -123,6 +138,10 @@ FVulkanContext::~FVulkanContext()
 		vkDestroyFence(Device, Fences[Idx], nullptr);
 	}
 
+	// Every buffer and image has returned its memory by now.
+	delete MemoryAllocator;
+	MemoryAllocator = nullptr;
+
 	vkDestroyDevice(Device, nullptr);
 
 	if (GEnableValidationLayers)
@@ -306,9 +325,15 @@ void FVulkanContext::CreateLogicalDevice()
 		QueueCIs.push_back(QueueCI);
 	}
 
+	VkPhysicalDeviceFeatures SupportedFeatures{};
+	vkGetPhysicalDeviceFeatures(PhysicalDevice, &SupportedFeatures);
+
 	VkPhysicalDeviceFeatures DeviceFeatures{};
 	DeviceFeatures.samplerAnisotropy = VK_TRUE;
 	DeviceFeatures.geometryShader = VK_TRUE;
+	DeviceFeatures.textureCompressionBC = SupportedFeatures.textureCompressionBC;
+
+	bTextureCompressionBCSupported = SupportedFeatures.textureCompressionBC == VK_TRUE;
 
 	VkDeviceCreateInfo DeviceCI{};
 	DeviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -337,6 +362,15 @@ void FVulkanContext::CreateLogicalDevice()
 	vkGetDeviceQueue(Device, PresentFamily, 0, &PresentQueue);
 }
 
+void FVulkanContext::CreateMemoryAllocator()
+{
+	int32_t MemoryBlockSizeMB = 64;
+	GConfig->Get("MemoryBlockSizeMB", MemoryBlockSizeMB);
+
+	MemoryAllocator = new FVulkanMemoryAllocator(this);
+	MemoryAllocator->Initialize(static_cast<VkDeviceSize>(MemoryBlockSizeMB) * 1024 * 1024);
+}
+
 void FVulkanContext::CreateSwapchain()
 {
 	VkSurfaceCapabilitiesKHR Capabilities;
@@ -493,6 +527,30 @@ void FVulkanContext::CreateSyncObjects()
 	}
 }
 
+void FVulkanContext::CreatePipelineCache()
+{
+	std::string PipelineCachePath;
+	GConfig->Get("PipelineCachePath", PipelineCachePath);
+
+	PipelineCache = CreateObject<FVulkanPipelineCache>();
+	PipelineCache->Load(PipelineCachePath);
+}
+
+void FVulkanContext::CreateUploader()
+{
+	int32_t StagingBufferSizeMB = 64;
+	GConfig->Get("StagingBufferSizeMB", StagingBufferSizeMB);
+
+	Uploader = CreateObject<FVulkanUploader>();
+	Uploader->Initialize(static_cast<VkDeviceSize>(StagingBufferSizeMB) * 1024 * 1024);
+}
+
+void FVulkanContext::CreateCommandRecorder()
+{
+	CommandRecorder = CreateObject<FVulkanCommandRecorder>();
+	CommandRecorder->Initialize(GJobSystem != nullptr ? GJobSystem->GetNumThreads() : 1);
+}
+
 void FVulkanContext::CreateDescriptorPool()
 {
 	std::vector<VkDescriptorPoolSize> PoolSizes =
@@ -518,6 +576,13 @@ void FVulkanContext::CreateDescriptorPool()
 	DescriptorPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
 	VK_ASSERT(vkCreateDescriptorPool(Device, &DescriptorPoolCI, nullptr, &DescriptorPool));
+
+	// Sets created per mesh and material slot come from pools that are added as they fill up.
+	int32_t DescriptorSetsPerPool = 256;
+	GConfig->Get("DescriptorSetsPerPool", DescriptorSetsPerPool);
+
+	DescriptorAllocator = CreateObject<FVulkanDescriptorAllocator>();
+	DescriptorAllocator->Initialize(static_cast<uint32_t>(std::max(DescriptorSetsPerPool, 1)), 4);
 }
 
 void FVulkanContext::CreateViewport()
@@ -605,6 +670,8 @@ void FVulkanContext::BeginRender()
 
 	vkResetFences(Device, 1, &Fences[CurrentFrame]);
 
+	CommandRecorder->ResetFrame(CurrentFrame);
+
 	VkCommandBuffer CommandBuffer = CommandBuffers[CurrentFrame];
 
 	vkResetCommandBuffer(CommandBuffer, 0);
@@ -617,6 +684,9 @@ void FVulkanContext::BeginRender()
 
 void FVulkanContext::EndRender()
 {
+	// Uploads recorded during the frame are submitted ahead of the frame that consumes them.
+	Uploader->Flush();
+
 	VkCommandBuffer CommandBuffer = CommandBuffers[CurrentFrame];
 
 	VK_ASSERT(vkEndCommandBuffer(CommandBuffer));
@@ -28,9 +28,17 @@ public:
 	const std::vector<VkCommandBuffer>& GetCommandBuffers() const { return CommandBuffers; }
 	VkCommandBuffer GetCommandBuffer() const { return CommandBuffers[CurrentFrame]; }
 	VkDescriptorPool GetDescriptorPool() const { return DescriptorPool; }
+	class FVulkanDescriptorAllocator* GetDescriptorAllocator() const { return DescriptorAllocator; }
+	class FVulkanPipelineCache* GetPipelineCache() const { return PipelineCache; }
+	class FVulkanUploader* GetUploader() const { return Uploader; }
+	class FVulkanCommandRecorder* GetCommandRecorder() const { return CommandRecorder; }
+	class FVulkanMemoryAllocator* GetMemoryAllocator() const { return MemoryAllocator; }
 	uint32_t GetCurrentFrame() const { return CurrentFrame; }
 	uint32_t GetMaxConcurrentFrames() const { return MAX_CONCURRENT_FRAME; }
 
+	// BC1-BC7 sampled image formats. Textures are imported uncompressed without it.
+	bool IsTextureCompressionBCSupported() const { return bTextureCompressionBCSupported; }
+
 	bool IsFramebufferResized() const { return bFramebufferResized; }
 	void SetFramebufferResized(bool InbFramebufferResized) { bFramebufferResized = InbFramebufferResized; }
 
@@ -60,10 +68,14 @@ protected:
 	void CreateSurface();
 	void PickPhysicalDevice();
 	void CreateLogicalDevice();
+	void CreateMemoryAllocator();
 	void CreateCommandPool();
 	void CreateCommandBuffers();
 	void CreateSyncObjects();
 	void CreateDescriptorPool();
+	void CreatePipelineCache();
+	void CreateUploader();
+	void CreateCommandRecorder();
 	void CreateViewport();
 	void CreateRenderers();
 
@@ -83,6 +95,8 @@ protected:
 	VkPhysicalDevice PhysicalDevice;
 	VkDevice Device;
 
+	class FVulkanMemoryAllocator* MemoryAllocator;
+
 	VkQueue GfxQueue;
 	VkQueue PresentQueue;
 
@@ -104,6 +118,14 @@ protected:
 
 	VkDescriptorPool DescriptorPool;
 
+	class FVulkanDescriptorAllocator* DescriptorAllocator;
+
+	class FVulkanPipelineCache* PipelineCache;
+
+	class FVulkanUploader* Uploader;
+
+	class FVulkanCommandRecorder* CommandRecorder;
+
 	std::vector<VkSemaphore> ImageAcquiredSemaphores;
 	std::vector<VkSemaphore> RenderFinishedSemaphores;
 	std::vector<VkFence> Fences;
@@ -111,6 +133,7 @@ protected:
 	uint32_t CurrentFrame;
 
 	bool bFramebufferResized = false;
+	bool bTextureCompressionBCSupported = false;
 
 	std::vector<FVulkanObject*> LiveObjects;
 };
@@ -0,0 +1,151 @@
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanContext.h"
+
+FVulkanDescriptorAllocator::FVulkanDescriptorAllocator(FVulkanContext* InContext)
+	: FVulkanObject(InContext)
+	, Device(VK_NULL_HANDLE)
+	, SetsPerPool(0)
+	, DescriptorsPerSet(0)
+{
+
+}
+
+void FVulkanDescriptorAllocator::Destroy()
+{
+	for (VkDescriptorPool Pool : Pools)
+	{
+		Functions.DestroyDescriptorPool(Device, Pool, nullptr);
+	}
+	Pools.clear();
+	SetPools.clear();
+}
+
+void FVulkanDescriptorAllocator::Initialize(uint32_t InSetsPerPool, uint32_t InDescriptorsPerSet)
+{
+	Initialize(Context->GetDevice(), InSetsPerPool, InDescriptorsPerSet);
+}
+
+void FVulkanDescriptorAllocator::Initialize(VkDevice InDevice, uint32_t InSetsPerPool, uint32_t InDescriptorsPerSet, const FVulkanDescriptorFunctions& InFunctions)
+{
+	Device = InDevice;
+	Functions = InFunctions;
+	SetsPerPool = InSetsPerPool > 0 ? InSetsPerPool : 1;
+	DescriptorsPerSet = InDescriptorsPerSet > 0 ? InDescriptorsPerSet : 1;
+}
+
+bool FVulkanDescriptorAllocator::Allocate(VkDescriptorSetLayout InLayout, uint32_t InCount, VkDescriptorSet* OutSets)
+{
+	if (InCount == 0)
+	{
+		return true;
+	}
+
+	if (InCount > SetsPerPool)
+	{
+		return false;
+	}
+
+	std::vector<VkDescriptorSetLayout> Layouts(InCount, InLayout);
+	VkDescriptorSetAllocateInfo DescriptorSetAllocInfo{};
+	DescriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	DescriptorSetAllocInfo.descriptorSetCount = InCount;
+	DescriptorSetAllocInfo.pSetLayouts = Layouts.data();
+
+	std::vector<VkDescriptorSet> Sets(InCount, VK_NULL_HANDLE);
+
+	// The newest pool is the most likely to have room left.
+	VkDescriptorPool Pool = VK_NULL_HANDLE;
+	for (size_t Idx = Pools.size(); Idx > 0 && Pool == VK_NULL_HANDLE; --Idx)
+	{
+		DescriptorSetAllocInfo.descriptorPool = Pools[Idx - 1];
+
+		VkResult Result = Functions.AllocateDescriptorSets(Device, &DescriptorSetAllocInfo, Sets.data());
+		if (Result == VK_SUCCESS)
+		{
+			Pool = Pools[Idx - 1];
+		}
+		else if (Result != VK_ERROR_OUT_OF_POOL_MEMORY && Result != VK_ERROR_FRAGMENTED_POOL)
+		{
+			return false;
+		}
+	}
+
+	if (Pool == VK_NULL_HANDLE)
+	{
+		VkDescriptorPool NewPool = CreatePool();
+		if (NewPool == VK_NULL_HANDLE)
+		{
+			return false;
+		}
+		Pools.push_back(NewPool);
+
+		DescriptorSetAllocInfo.descriptorPool = NewPool;
+		if (Functions.AllocateDescriptorSets(Device, &DescriptorSetAllocInfo, Sets.data()) != VK_SUCCESS)
+		{
+			return false;
+		}
+		Pool = NewPool;
+	}
+
+	for (uint32_t Idx = 0; Idx < InCount; ++Idx)
+	{
+		OutSets[Idx] = Sets[Idx];
+		SetPools[Sets[Idx]] = Pool;
+	}
+
+	return true;
+}
+
+void FVulkanDescriptorAllocator::Free(const VkDescriptorSet* InSets, uint32_t InCount)
+{
+	for (uint32_t Idx = 0; Idx < InCount; ++Idx)
+	{
+		auto Iter = SetPools.find(InSets[Idx]);
+		if (Iter == SetPools.end())
+		{
+			continue;
+		}
+
+		Functions.FreeDescriptorSets(Device, Iter->second, 1, &InSets[Idx]);
+		SetPools.erase(Iter);
+	}
+}
+
+VkDescriptorPool FVulkanDescriptorAllocator::CreatePool()
+{
+	const VkDescriptorType DescriptorTypes[] =
+	{
+		VK_DESCRIPTOR_TYPE_SAMPLER,
+		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+		VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+		VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+		VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,
+		VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,
+		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+		VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+	};
+
+	std::vector<VkDescriptorPoolSize> PoolSizes;
+	for (VkDescriptorType DescriptorType : DescriptorTypes)
+	{
+		PoolSizes.push_back({ DescriptorType, SetsPerPool * DescriptorsPerSet });
+	}
+
+	VkDescriptorPoolCreateInfo DescriptorPoolCI{};
+	DescriptorPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	DescriptorPoolCI.poolSizeCount = static_cast<uint32_t>(PoolSizes.size());
+	DescriptorPoolCI.pPoolSizes = PoolSizes.data();
+	DescriptorPoolCI.maxSets = SetsPerPool;
+	DescriptorPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+
+	VkDescriptorPool Pool = VK_NULL_HANDLE;
+	if (Functions.CreateDescriptorPool(Device, &DescriptorPoolCI, nullptr, &Pool) != VK_SUCCESS)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return Pool;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "VulkanObject.h"
+
+#include "vulkan/vulkan.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// The descriptor pool entry points the allocator calls. Defaults to the loader's functions; tests substitute their own.
+struct FVulkanDescriptorFunctions
+{
+	PFN_vkCreateDescriptorPool CreateDescriptorPool = vkCreateDescriptorPool;
+	PFN_vkDestroyDescriptorPool DestroyDescriptorPool = vkDestroyDescriptorPool;
+	PFN_vkAllocateDescriptorSets AllocateDescriptorSets = vkAllocateDescriptorSets;
+	PFN_vkFreeDescriptorSets FreeDescriptorSets = vkFreeDescriptorSets;
+};
+
+// Allocates descriptor sets from a growing list of pools, so renderers can create sets per mesh and material slot
+// without a fixed upper bound. A new pool is created when every existing one is out of memory or fragmented.
+// Render thread only.
+class FVulkanDescriptorAllocator : public FVulkanObject
+{
+public:
+	FVulkanDescriptorAllocator(class FVulkanContext* InContext);
+
+	virtual void Destroy() override;
+
+	// Each pool holds InSetsPerPool sets and InSetsPerPool * InDescriptorsPerSet descriptors of every type.
+	// Without a device, pools are created on the context's.
+	void Initialize(uint32_t InSetsPerPool, uint32_t InDescriptorsPerSet);
+	void Initialize(VkDevice InDevice, uint32_t InSetsPerPool, uint32_t InDescriptorsPerSet, const FVulkanDescriptorFunctions& InFunctions = FVulkanDescriptorFunctions());
+
+	// Allocates InCount sets of InLayout into OutSets. Returns false and leaves OutSets untouched if no pool could
+	// be created for them or InCount exceeds the sets per pool.
+	bool Allocate(VkDescriptorSetLayout InLayout, uint32_t InCount, VkDescriptorSet* OutSets);
+	void Free(const VkDescriptorSet* InSets, uint32_t InCount);
+
+	uint32_t GetNumPools() const { return static_cast<uint32_t>(Pools.size()); }
+
+private:
+	VkDescriptorPool CreatePool();
+
+	VkDevice Device;
+	FVulkanDescriptorFunctions Functions;
+
+	std::vector<VkDescriptorPool> Pools;
+	std::unordered_map<VkDescriptorSet, VkDescriptorPool> SetPools;
+
+	uint32_t SetsPerPool;
+	uint32_t DescriptorsPerSet;
+};
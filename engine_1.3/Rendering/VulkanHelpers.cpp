@@ -196,9 +196,14 @@ namespace Vk
 		VkPhysicalDeviceMemoryProperties MemoryProperties;
 		vkGetPhysicalDeviceMemoryProperties(InPhysicalDevice, &MemoryProperties);
 
-		for (uint32_t Idx = 0; Idx < MemoryProperties.memoryTypeCount; ++Idx)
+		return FindMemoryType(MemoryProperties, InTypeFilter, InProperties);
+	}
+
+	uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties& InMemoryProperties, uint32_t InTypeFilter, VkMemoryPropertyFlags InProperties)
+	{
+		for (uint32_t Idx = 0; Idx < InMemoryProperties.memoryTypeCount; ++Idx)
 		{
-			if ((InTypeFilter & (1 << Idx)) && (MemoryProperties.memoryTypes[Idx].propertyFlags & InProperties) == InProperties)
+			if ((InTypeFilter & (1 << Idx)) && (InMemoryProperties.memoryTypes[Idx].propertyFlags & InProperties) == InProperties)
 			{
 				return Idx;
 			}
@@ -343,8 +348,22 @@ namespace Vk
 	{
 		VkCommandBuffer CommandBuffer = BeginOneTimeCommandBuffer(InDevice, InCommandPool);
 
+		CmdCopyBufferToImage(CommandBuffer, InBuffer, 0, InImage, InMipLevel, InArrayLayers, InExtent);
+
+		EndOneTimeCommandBuffer(InDevice, InCommandPool, InCommandQueue, CommandBuffer);
+	}
+
+	void CmdCopyBufferToImage(
+		VkCommandBuffer InCommandBuffer,
+		VkBuffer InBuffer,
+		VkDeviceSize InBufferOffset,
+		VkImage InImage,
+		uint32_t InMipLevel,
+		uint32_t InArrayLayers,
+		VkExtent3D InExtent)
+	{
 		VkBufferImageCopy CopyRegion{};
-		CopyRegion.bufferOffset = 0;
+		CopyRegion.bufferOffset = InBufferOffset;
 		CopyRegion.bufferRowLength = 0;
 		CopyRegion.bufferImageHeight = 0;
 		CopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -354,24 +373,29 @@ namespace Vk
 		CopyRegion.imageOffset = { 0, 0, 0 };
 		CopyRegion.imageExtent = InExtent;
 
-		vkCmdCopyBufferToImage(CommandBuffer, InBuffer, InImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &CopyRegion);
-
-		EndOneTimeCommandBuffer(InDevice, InCommandPool, InCommandQueue, CommandBuffer);
+		vkCmdCopyBufferToImage(InCommandBuffer, InBuffer, InImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &CopyRegion);
 	}
 
-	void TransitionImageLayout(
-		VkDevice InDevice,
-		VkCommandPool InCommandPool,
-		VkQueue InCommandQueue,
+	void CmdTransitionImageLayout(
+		VkCommandBuffer InCommandBuffer,
 		VkImage InImage,
 		uint32_t InMipLevels,
 		uint32_t InArrayLayers,
-		VkFormat InFormat,
 		VkImageLayout InOldLayout,
 		VkImageLayout InNewLayout)
 	{
-		VkCommandBuffer CommandBuffer = BeginOneTimeCommandBuffer(InDevice, InCommandPool);
+		CmdTransitionImageLayout(InCommandBuffer, InImage, 0, InMipLevels, InArrayLayers, InOldLayout, InNewLayout);
+	}
 
+	void CmdTransitionImageLayout(
+		VkCommandBuffer InCommandBuffer,
+		VkImage InImage,
+		uint32_t InBaseMipLevel,
+		uint32_t InMipLevels,
+		uint32_t InArrayLayers,
+		VkImageLayout InOldLayout,
+		VkImageLayout InNewLayout)
+	{
 		VkImageMemoryBarrier ImageMemoryBarrier{};
 		ImageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		ImageMemoryBarrier.oldLayout = InOldLayout;
@@ -380,7 +404,7 @@ namespace Vk
 		ImageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		ImageMemoryBarrier.image = InImage;
 		ImageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		ImageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+		ImageMemoryBarrier.subresourceRange.baseMipLevel = InBaseMipLevel;
 		ImageMemoryBarrier.subresourceRange.levelCount = InMipLevels;
 		ImageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
 		ImageMemoryBarrier.subresourceRange.layerCount = InArrayLayers;
@@ -404,18 +428,50 @@ namespace Vk
 			SrcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 			DstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 		}
+		else if (InOldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && InNewLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+		{
+			ImageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			ImageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			SrcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			DstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+		else if (InOldLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL && InNewLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			ImageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			ImageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			SrcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			DstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		}
 		else
 		{
 			throw std::runtime_error("Unsupported layout transition.");
 		}
 
 		vkCmdPipelineBarrier(
-			CommandBuffer,
+			InCommandBuffer,
 			SrcStage, DstStage,
 			0,
 			0, nullptr,
 			0, nullptr,
 			1, &ImageMemoryBarrier);
+	}
+
+	void TransitionImageLayout(
+		VkDevice InDevice,
+		VkCommandPool InCommandPool,
+		VkQueue InCommandQueue,
+		VkImage InImage,
+		uint32_t InMipLevels,
+		uint32_t InArrayLayers,
+		VkFormat InFormat,
+		VkImageLayout InOldLayout,
+		VkImageLayout InNewLayout)
+	{
+		VkCommandBuffer CommandBuffer = BeginOneTimeCommandBuffer(InDevice, InCommandPool);
+
+		CmdTransitionImageLayout(CommandBuffer, InImage, InMipLevels, InArrayLayers, InOldLayout, InNewLayout);
 
 		EndOneTimeCommandBuffer(InDevice, InCommandPool, InCommandQueue, CommandBuffer);
 	}
@@ -39,6 +39,7 @@ namespace Vk
 	VkFormat FindSupportedFormat(VkPhysicalDevice InPhysicalDevice, const std::vector<VkFormat>& InCandidates, VkImageTiling InTiling, VkFormatFeatureFlags InFeatures);
 
 	uint32_t FindMemoryType(VkPhysicalDevice InDevice, uint32_t InTypeFilter, VkMemoryPropertyFlags InProperties);
+	uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties& InMemoryProperties, uint32_t InTypeFilter, VkMemoryPropertyFlags InProperties);
 
 	void CreateBuffer(
 		VkPhysicalDevice InPhysicalDevice,
@@ -75,6 +76,32 @@ namespace Vk
 		uint32_t InArrayLayers,
 		VkExtent3D InExtent);
 
+	void CmdCopyBufferToImage(
+		VkCommandBuffer InCommandBuffer,
+		VkBuffer InBuffer,
+		VkDeviceSize InBufferOffset,
+		VkImage InImage,
+		uint32_t InMipLevel,
+		uint32_t InArrayLayers,
+		VkExtent3D InExtent);
+
+	void CmdTransitionImageLayout(
+		VkCommandBuffer InCommandBuffer,
+		VkImage InImage,
+		uint32_t InMipLevels,
+		uint32_t InArrayLayers,
+		VkImageLayout InOldLayout,
+		VkImageLayout InNewLayout);
+
+	void CmdTransitionImageLayout(
+		VkCommandBuffer InCommandBuffer,
+		VkImage InImage,
+		uint32_t InBaseMipLevel,
+		uint32_t InMipLevels,
+		uint32_t InArrayLayers,
+		VkImageLayout InOldLayout,
+		VkImageLayout InNewLayout);
+
 	void TransitionImageLayout(
 		VkDevice InDevice,
 		VkCommandPool InCommandPool,
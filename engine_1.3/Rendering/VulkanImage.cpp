@@ -2,6 +2,8 @@
 #include "VulkanContext.h"
 #include "VulkanHelpers.h"
 
+#include <stdexcept>
+
 FVulkanImage::FVulkanImage(FVulkanContext* InContext)
 	: FVulkanObject(InContext)
 	, Extent({ 0, 0, 1 })
@@ -13,7 +15,6 @@ FVulkanImage::FVulkanImage(FVulkanContext* InContext)
 	, Usage(0)
 	, Properties(0)
 	, Image(VK_NULL_HANDLE)
-	, Memory(VK_NULL_HANDLE)
 	, View(VK_NULL_HANDLE)
 {
 }
@@ -27,10 +28,7 @@ void FVulkanImage::Destroy()
 		vkDestroyImage(Device, Image, nullptr);
 	}
 
-	if (Memory != VK_NULL_HANDLE)
-	{
-		vkFreeMemory(Device, Memory, nullptr);
-	}
+	Context->GetMemoryAllocator()->Free(Allocation);
 
 	if (View != VK_NULL_HANDLE)
 	{
@@ -73,20 +71,21 @@ void FVulkanImage::CreateImage(
 	ImageCI.flags = InFlags;
 
 	VkDevice Device = Context->GetDevice();
-	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
 
 	VkResult Result = vkCreateImage(Device, &ImageCI, nullptr, &Image);
 
 	VkMemoryRequirements MemoryReqs{};
 	vkGetImageMemoryRequirements(Device, Image, &MemoryReqs);
 
-	VkMemoryAllocateInfo MemoryAllocInfo{};
-	MemoryAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	MemoryAllocInfo.allocationSize = MemoryReqs.size;
-	MemoryAllocInfo.memoryTypeIndex = Vk::FindMemoryType(PhysicalDevice, MemoryReqs.memoryTypeBits, Properties);
+	EVulkanResourceKind ResourceKind = Tiling == VK_IMAGE_TILING_LINEAR ? EVulkanResourceKind::Linear : EVulkanResourceKind::Optimal;
+
+	FVulkanMemoryAllocator* MemoryAllocator = Context->GetMemoryAllocator();
+	if (MemoryAllocator->Allocate(MemoryReqs, Properties, ResourceKind, Allocation) == false)
+	{
+		throw std::runtime_error("Failed to allocate image memory.");
+	}
 
-	VK_ASSERT(vkAllocateMemory(Device, &MemoryAllocInfo, nullptr, &Memory));
-	VK_ASSERT(vkBindImageMemory(Device, Image, Memory, 0));
+	VK_ASSERT(vkBindImageMemory(Device, Image, Allocation.Memory, Allocation.Offset));
 }
 
 void FVulkanImage::CreateView(
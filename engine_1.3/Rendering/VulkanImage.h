@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VulkanObject.h"
+#include "VulkanMemoryAllocator.h"
 
 #include "vulkan/vulkan.h"
 
@@ -38,8 +39,14 @@ public:
 	void SetUsage(VkImageUsageFlags InUsage) { Usage = InUsage; }
 	void SetProperties(VkMemoryPropertyFlags InProperties) { Properties = InProperties; }
 
+	VkExtent3D GetExtent() const { return Extent; }
+	uint32_t GetMipLevels() const { return MipLevels; }
+	uint32_t GetArrayLayers() const { return ArrayLayers; }
+	VkFormat GetFormat() const { return Format; }
+
 	VkImage GetImage() const { return Image; }
-	VkDeviceMemory GetMemory() const { return Memory; }
+	VkDeviceMemory GetMemory() const { return Allocation.Memory; }
+	VkDeviceSize GetMemorySize() const { return Allocation.Size; }
 	VkImageView GetView() const { return View; }
 
 private:
@@ -53,6 +60,6 @@ private:
 	VkMemoryPropertyFlags Properties;
 
 	VkImage Image;
-	VkDeviceMemory Memory;
+	FVulkanAllocation Allocation;
 	VkImageView View;
 };
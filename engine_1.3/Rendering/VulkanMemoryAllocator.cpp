@@ -0,0 +1,289 @@
+#include "VulkanMemoryAllocator.h"
+#include "VulkanContext.h"
+#include "VulkanHelpers.h"
+
+#include <algorithm>
+
+FVulkanMemoryAllocator::FVulkanMemoryAllocator(FVulkanContext* InContext)
+	: Context(InContext)
+	, Device(VK_NULL_HANDLE)
+	, MemoryProperties{}
+	, BlockSize(0)
+{
+}
+
+FVulkanMemoryAllocator::~FVulkanMemoryAllocator()
+{
+	Destroy();
+}
+
+void FVulkanMemoryAllocator::Initialize(VkDeviceSize InBlockSize)
+{
+	VkPhysicalDeviceMemoryProperties DeviceMemoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(Context->GetPhysicalDevice(), &DeviceMemoryProperties);
+
+	Initialize(Context->GetDevice(), DeviceMemoryProperties, InBlockSize);
+}
+
+void FVulkanMemoryAllocator::Initialize(VkDevice InDevice, const VkPhysicalDeviceMemoryProperties& InMemoryProperties, VkDeviceSize InBlockSize, const FVulkanMemoryFunctions& InFunctions)
+{
+	Device = InDevice;
+	Functions = InFunctions;
+	MemoryProperties = InMemoryProperties;
+	BlockSize = InBlockSize;
+
+	Pools.resize(MemoryProperties.memoryTypeCount * static_cast<uint32_t>(EVulkanResourceKind::Count));
+	for (uint32_t Idx = 0; Idx < Pools.size(); ++Idx)
+	{
+		Pools[Idx].MemoryTypeIndex = Idx / static_cast<uint32_t>(EVulkanResourceKind::Count);
+	}
+}
+
+void FVulkanMemoryAllocator::Destroy()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	for (FMemoryPool& Pool : Pools)
+	{
+		for (FMemoryBlock& Block : Pool.Blocks)
+		{
+			if (Block.Memory != VK_NULL_HANDLE)
+			{
+				FreeDeviceMemory(Block.Memory, Block.Mapped);
+			}
+		}
+	}
+
+	Pools.clear();
+}
+
+bool FVulkanMemoryAllocator::Allocate(const VkMemoryRequirements& InRequirements, VkMemoryPropertyFlags InProperties, EVulkanResourceKind InKind, FVulkanAllocation& OutAllocation)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	uint32_t MemoryTypeIndex = Vk::FindMemoryType(MemoryProperties, InRequirements.memoryTypeBits, InProperties);
+	uint32_t PoolIndex = MemoryTypeIndex * static_cast<uint32_t>(EVulkanResourceKind::Count) + static_cast<uint32_t>(InKind);
+
+	FMemoryPool& Pool = Pools[PoolIndex];
+
+	OutAllocation = FVulkanAllocation();
+	OutAllocation.MemoryTypeIndex = MemoryTypeIndex;
+	OutAllocation.PoolIndex = PoolIndex;
+	OutAllocation.Size = InRequirements.size;
+
+	// Large resources would waste most of a block, so they get their own allocation.
+	if (InRequirements.size > BlockSize / 2)
+	{
+		if (AllocateDeviceMemory(MemoryTypeIndex, InRequirements.size, OutAllocation.Memory, OutAllocation.Mapped) == false)
+		{
+			return false;
+		}
+
+		OutAllocation.bDedicated = true;
+
+		++Pool.NumDedicatedAllocations;
+		Pool.DedicatedBytes += InRequirements.size;
+
+		return true;
+	}
+
+	uint32_t EmptySlot = UINT32_MAX;
+
+	for (uint32_t BlockIdx = 0; BlockIdx < Pool.Blocks.size(); ++BlockIdx)
+	{
+		FMemoryBlock& Block = Pool.Blocks[BlockIdx];
+		if (Block.Memory == VK_NULL_HANDLE)
+		{
+			EmptySlot = std::min(EmptySlot, BlockIdx);
+			continue;
+		}
+
+		VkDeviceSize Offset = 0;
+		uint32_t Handle = Block.Allocator.Allocate(InRequirements.size, InRequirements.alignment, Offset);
+		if (Handle == FTLSFAllocator::InvalidHandle)
+		{
+			continue;
+		}
+
+		OutAllocation.Memory = Block.Memory;
+		OutAllocation.Offset = Offset;
+		OutAllocation.Mapped = Block.Mapped != nullptr ? Block.Mapped + Offset : nullptr;
+		OutAllocation.BlockIndex = BlockIdx;
+		OutAllocation.Handle = Handle;
+
+		return true;
+	}
+
+	FMemoryBlock NewBlock;
+	if (AllocateDeviceMemory(MemoryTypeIndex, BlockSize, NewBlock.Memory, NewBlock.Mapped) == false)
+	{
+		return false;
+	}
+	NewBlock.Allocator.Reset(BlockSize);
+
+	if (EmptySlot == UINT32_MAX)
+	{
+		EmptySlot = static_cast<uint32_t>(Pool.Blocks.size());
+		Pool.Blocks.push_back(std::move(NewBlock));
+	}
+	else
+	{
+		Pool.Blocks[EmptySlot] = std::move(NewBlock);
+	}
+
+	FMemoryBlock& Block = Pool.Blocks[EmptySlot];
+
+	VkDeviceSize Offset = 0;
+	uint32_t Handle = Block.Allocator.Allocate(InRequirements.size, InRequirements.alignment, Offset);
+	if (Handle == FTLSFAllocator::InvalidHandle)
+	{
+		return false;
+	}
+
+	OutAllocation.Memory = Block.Memory;
+	OutAllocation.Offset = Offset;
+	OutAllocation.Mapped = Block.Mapped != nullptr ? Block.Mapped + Offset : nullptr;
+	OutAllocation.BlockIndex = EmptySlot;
+	OutAllocation.Handle = Handle;
+
+	return true;
+}
+
+void FVulkanMemoryAllocator::Free(FVulkanAllocation& InAllocation)
+{
+	if (InAllocation.IsValid() == false)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	if (InAllocation.PoolIndex >= Pools.size())
+	{
+		InAllocation = FVulkanAllocation();
+		return;
+	}
+
+	FMemoryPool& Pool = Pools[InAllocation.PoolIndex];
+
+	if (InAllocation.bDedicated)
+	{
+		FreeDeviceMemory(InAllocation.Memory, InAllocation.Mapped);
+
+		--Pool.NumDedicatedAllocations;
+		Pool.DedicatedBytes -= InAllocation.Size;
+	}
+	else
+	{
+		FMemoryBlock& Block = Pool.Blocks[InAllocation.BlockIndex];
+		Block.Allocator.Free(InAllocation.Handle);
+
+		if (Block.Allocator.IsEmpty())
+		{
+			uint32_t NumLiveBlocks = static_cast<uint32_t>(std::count_if(Pool.Blocks.begin(), Pool.Blocks.end(),
+				[](const FMemoryBlock& InBlock) { return InBlock.Memory != VK_NULL_HANDLE; }));
+
+			// Keep one empty block around so a pool that drains and refills does not thrash vkAllocateMemory.
+			if (NumLiveBlocks > 1)
+			{
+				FreeDeviceMemory(Block.Memory, Block.Mapped);
+				Block = FMemoryBlock();
+			}
+		}
+	}
+
+	InAllocation = FVulkanAllocation();
+}
+
+FVulkanMemoryStats FVulkanMemoryAllocator::GetStats(uint32_t InMemoryTypeIndex) const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	FVulkanMemoryStats Stats;
+
+	for (const FMemoryPool& Pool : Pools)
+	{
+		if (Pool.MemoryTypeIndex != InMemoryTypeIndex)
+		{
+			continue;
+		}
+
+		for (const FMemoryBlock& Block : Pool.Blocks)
+		{
+			if (Block.Memory == VK_NULL_HANDLE)
+			{
+				continue;
+			}
+
+			FTLSFAllocator::FStats BlockStats = Block.Allocator.GetStats();
+
+			++Stats.NumBlocks;
+			Stats.NumAllocations += BlockStats.NumAllocations;
+			Stats.BlockBytes += BlockStats.Capacity;
+			Stats.UsedBytes += BlockStats.UsedSize;
+			Stats.LargestFreeRange = std::max(Stats.LargestFreeRange, BlockStats.LargestFreeBlock);
+		}
+
+		Stats.NumDedicatedAllocations += Pool.NumDedicatedAllocations;
+		Stats.DedicatedBytes += Pool.DedicatedBytes;
+	}
+
+	return Stats;
+}
+
+FVulkanMemoryStats FVulkanMemoryAllocator::GetTotalStats() const
+{
+	FVulkanMemoryStats Total;
+
+	for (uint32_t Idx = 0; Idx < MemoryProperties.memoryTypeCount; ++Idx)
+	{
+		FVulkanMemoryStats Stats = GetStats(Idx);
+
+		Total.NumBlocks += Stats.NumBlocks;
+		Total.NumAllocations += Stats.NumAllocations;
+		Total.NumDedicatedAllocations += Stats.NumDedicatedAllocations;
+		Total.BlockBytes += Stats.BlockBytes;
+		Total.UsedBytes += Stats.UsedBytes;
+		Total.DedicatedBytes += Stats.DedicatedBytes;
+		Total.LargestFreeRange = std::max(Total.LargestFreeRange, Stats.LargestFreeRange);
+	}
+
+	return Total;
+}
+
+bool FVulkanMemoryAllocator::AllocateDeviceMemory(uint32_t InMemoryTypeIndex, VkDeviceSize InSize, VkDeviceMemory& OutMemory, uint8_t*& OutMapped)
+{
+	VkMemoryAllocateInfo MemoryAllocInfo{};
+	MemoryAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	MemoryAllocInfo.allocationSize = InSize;
+	MemoryAllocInfo.memoryTypeIndex = InMemoryTypeIndex;
+
+	if (Functions.AllocateMemory(Device, &MemoryAllocInfo, nullptr, &OutMemory) != VK_SUCCESS)
+	{
+		OutMemory = VK_NULL_HANDLE;
+		return false;
+	}
+
+	OutMapped = nullptr;
+	if (IsHostVisible(InMemoryTypeIndex))
+	{
+		VK_ASSERT(Functions.MapMemory(Device, OutMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&OutMapped)));
+	}
+
+	return true;
+}
+
+void FVulkanMemoryAllocator::FreeDeviceMemory(VkDeviceMemory InMemory, uint8_t* InMapped)
+{
+	if (InMapped != nullptr)
+	{
+		Functions.UnmapMemory(Device, InMemory);
+	}
+
+	Functions.FreeMemory(Device, InMemory, nullptr);
+}
+
+bool FVulkanMemoryAllocator::IsHostVisible(uint32_t InMemoryTypeIndex) const
+{
+	return (MemoryProperties.memoryTypes[InMemoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
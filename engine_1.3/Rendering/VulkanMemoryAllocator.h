@@ -0,0 +1,110 @@
+#pragma once
+
+#include "TLSFAllocator.h"
+
+#include "vulkan/vulkan.h"
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+enum class EVulkanResourceKind : uint8_t
+{
+	Linear,
+	Optimal,
+	Count
+};
+
+struct FVulkanAllocation
+{
+	VkDeviceMemory Memory = VK_NULL_HANDLE;
+	VkDeviceSize Offset = 0;
+	VkDeviceSize Size = 0;
+	uint8_t* Mapped = nullptr;
+
+	uint32_t MemoryTypeIndex = UINT32_MAX;
+	uint32_t PoolIndex = UINT32_MAX;
+	uint32_t BlockIndex = UINT32_MAX;
+	uint32_t Handle = FTLSFAllocator::InvalidHandle;
+	bool bDedicated = false;
+
+	bool IsValid() const { return Memory != VK_NULL_HANDLE; }
+};
+
+struct FVulkanMemoryStats
+{
+	uint32_t NumBlocks = 0;
+	uint32_t NumAllocations = 0;
+	uint32_t NumDedicatedAllocations = 0;
+	VkDeviceSize BlockBytes = 0;
+	VkDeviceSize UsedBytes = 0;
+	VkDeviceSize DedicatedBytes = 0;
+	VkDeviceSize LargestFreeRange = 0;
+};
+
+// The device memory entry points the allocator calls. Defaults to the loader's functions; tests substitute their own.
+struct FVulkanMemoryFunctions
+{
+	PFN_vkAllocateMemory AllocateMemory = vkAllocateMemory;
+	PFN_vkFreeMemory FreeMemory = vkFreeMemory;
+	PFN_vkMapMemory MapMemory = vkMapMemory;
+	PFN_vkUnmapMemory UnmapMemory = vkUnmapMemory;
+};
+
+// Sub-allocates buffers and images out of large VkDeviceMemory blocks, one block list per memory type
+// and resource kind so linear and optimal resources never share a page (bufferImageGranularity).
+// Host visible blocks stay mapped for their whole lifetime.
+class FVulkanMemoryAllocator
+{
+public:
+	FVulkanMemoryAllocator(class FVulkanContext* InContext);
+	virtual ~FVulkanMemoryAllocator();
+
+	// Queries the memory types of the context's physical device and allocates from its device.
+	void Initialize(VkDeviceSize InBlockSize);
+	void Initialize(VkDevice InDevice, const VkPhysicalDeviceMemoryProperties& InMemoryProperties, VkDeviceSize InBlockSize, const FVulkanMemoryFunctions& InFunctions = FVulkanMemoryFunctions());
+	void Destroy();
+
+	bool Allocate(const VkMemoryRequirements& InRequirements, VkMemoryPropertyFlags InProperties, EVulkanResourceKind InKind, FVulkanAllocation& OutAllocation);
+	void Free(FVulkanAllocation& InAllocation);
+
+	FVulkanMemoryStats GetStats(uint32_t InMemoryTypeIndex) const;
+	FVulkanMemoryStats GetTotalStats() const;
+
+	const VkPhysicalDeviceMemoryProperties& GetMemoryProperties() const { return MemoryProperties; }
+	VkDeviceSize GetBlockSize() const { return BlockSize; }
+
+private:
+	struct FMemoryBlock
+	{
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+		uint8_t* Mapped = nullptr;
+		FTLSFAllocator Allocator;
+	};
+
+	struct FMemoryPool
+	{
+		uint32_t MemoryTypeIndex = 0;
+		std::vector<FMemoryBlock> Blocks;
+		uint32_t NumDedicatedAllocations = 0;
+		VkDeviceSize DedicatedBytes = 0;
+	};
+
+	bool AllocateDeviceMemory(uint32_t InMemoryTypeIndex, VkDeviceSize InSize, VkDeviceMemory& OutMemory, uint8_t*& OutMapped);
+	void FreeDeviceMemory(VkDeviceMemory InMemory, uint8_t* InMapped);
+
+	bool IsHostVisible(uint32_t InMemoryTypeIndex) const;
+
+	class FVulkanContext* Context;
+
+	VkDevice Device;
+	FVulkanMemoryFunctions Functions;
+
+	VkPhysicalDeviceMemoryProperties MemoryProperties;
+	VkDeviceSize BlockSize;
+
+	// Indexed by MemoryTypeIndex * EVulkanResourceKind::Count + Kind.
+	std::vector<FMemoryPool> Pools;
+
+	mutable std::mutex Mutex;
+};
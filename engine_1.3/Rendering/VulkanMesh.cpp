@@ -6,12 +6,17 @@
 #include "Material.h"
 
 #include <vector>
+#include <algorithm>
+#include <cstdint>
 
 FVulkanMesh::FVulkanMesh(FVulkanContext* InContext)
 	: FVulkanObject(InContext)
 	, MeshAsset(nullptr)
 	, VertexBuffer(nullptr)
 	, IndexBuffer(nullptr)
+	, VertexFormat(EVertexFormat::Float)
+	, IndexType(VK_INDEX_TYPE_UINT32)
+	, DequantizationMatrix(1.0f)
 {
 	VertexBuffer = InContext->CreateObject<FVulkanBuffer>();
 	VertexBuffer->SetUsage(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
@@ -21,7 +26,7 @@ FVulkanMesh::FVulkanMesh(FVulkanContext* InContext)
 	IndexBuffer->SetUsage(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
 	IndexBuffer->SetProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-	Material = InContext->CreateObject<FVulkanMaterial>();
+	Materials.push_back(InContext->CreateObject<FVulkanMaterial>());
 }
 
 void FVulkanMesh::Destroy()
@@ -44,15 +49,74 @@ bool FVulkanMesh::Load(UMesh* InMesh)
 
 	MeshAsset = InMesh;
 
-	const std::vector<FVertex>& Vertices = InMesh->GetVertices();
-	const std::vector<uint32_t>& Indices = InMesh->GetIndices();
+	const FVertex* Vertices = InMesh->GetVertexData();
+	uint32_t NumVertices = InMesh->GetNumVertices();
 
-	VertexBuffer->Load((uint8_t*)Vertices.data(), sizeof(FVertex) * Vertices.size());
-	IndexBuffer->Load((uint8_t*)Indices.data(), sizeof(uint32_t) * Indices.size());
+	VertexFormat = InMesh->GetVertexFormat();
+	DequantizationMatrix = glm::mat4(1.0f);
+
+	if (VertexFormat == EVertexFormat::Packed)
+	{
+		FVertexQuantization Quantization = FVertexQuantization::FromVertices(Vertices, NumVertices);
+		DequantizationMatrix = Quantization.GetDequantizationMatrix();
+
+		std::vector<FPackedVertex> PackedVertices(NumVertices);
+		PackVertices(Vertices, NumVertices, Quantization, PackedVertices.data());
+		VertexBuffer->Load((uint8_t*)PackedVertices.data(), sizeof(FPackedVertex) * PackedVertices.size());
+	}
+	else
+	{
+		VertexBuffer->Load((uint8_t*)Vertices, sizeof(FVertex) * NumVertices);
+	}
+
+	const uint32_t* Indices = InMesh->GetIndexData();
+	uint32_t NumIndices = InMesh->GetNumIndices();
+
+	// Indices are relative to each submesh's vertex offset, so 16 bits suffice whenever every submesh stays below 65536 vertices.
+	uint32_t MaxIndex = 0;
+	for (uint32_t Idx = 0; Idx < NumIndices; ++Idx)
+	{
+		MaxIndex = std::max(MaxIndex, Indices[Idx]);
+	}
+
+	if (MaxIndex <= UINT16_MAX)
+	{
+		std::vector<uint16_t> ShortIndices(Indices, Indices + NumIndices);
+		IndexBuffer->Load((uint8_t*)ShortIndices.data(), sizeof(uint16_t) * ShortIndices.size());
+		IndexType = VK_INDEX_TYPE_UINT16;
+	}
+	else
+	{
+		IndexBuffer->Load((uint8_t*)Indices, sizeof(uint32_t) * NumIndices);
+		IndexType = VK_INDEX_TYPE_UINT32;
+	}
+
+	Materials.resize(std::max(InMesh->GetNumMaterialSlots(), 1U), Materials.empty() ? nullptr : Materials[0]);
+	for (uint32_t Slot = 0; Slot < Materials.size(); ++Slot)
+	{
+		UMaterial* MaterialAsset = InMesh->GetMaterial(Slot);
+		if (MaterialAsset != nullptr)
+		{
+			Materials[Slot] = MaterialAsset->GetRenderMaterial();
+		}
+	}
 
 	return true;
 }
 
+void FVulkanMesh::SetMaterial(FVulkanMaterial* InMaterial)
+{
+	std::fill(Materials.begin(), Materials.end(), InMaterial);
+}
+
+void FVulkanMesh::SetMaterial(uint32_t InSlot, FVulkanMaterial* InMaterial)
+{
+	if (InSlot < Materials.size())
+	{
+		Materials[InSlot] = InMaterial;
+	}
+}
+
 void FVulkanMesh::Unload()
 {
 	VkDevice Device = Context->GetDevice();
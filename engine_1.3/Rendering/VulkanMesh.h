@@ -4,6 +4,13 @@
 #include "VulkanBuffer.h"
 #include "VulkanMaterial.h"
 
+#include "Vertex.h"
+
+#include "vulkan/vulkan.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+
 class FVulkanMesh : public FVulkanObject
 {
 public:
@@ -16,16 +23,31 @@ public:
 
 	FVulkanBuffer* GetVertexBuffer() const { return VertexBuffer; }
 	FVulkanBuffer* GetIndexBuffer() const { return IndexBuffer; }
+	VkDeviceSize GetMemorySize() const { return VertexBuffer->GetAllocatedSize() + IndexBuffer->GetAllocatedSize(); }
+
+	EVertexFormat GetVertexFormat() const { return VertexFormat; }
+	VkIndexType GetIndexType() const { return IndexType; }
 
-	FVulkanMaterial* GetMaterial() const { return Material; }
-	void SetMaterial(FVulkanMaterial* InMaterial) { Material = InMaterial; }
+	// Identity for float vertices. Packed positions are multiplied by it before the model matrix.
+	const glm::mat4& GetDequantizationMatrix() const { return DequantizationMatrix; }
+
+	uint32_t GetNumMaterialSlots() const { return static_cast<uint32_t>(Materials.size()); }
+
+	FVulkanMaterial* GetMaterial(uint32_t InSlot = 0) const { return InSlot < Materials.size() ? Materials[InSlot] : nullptr; }
+	// Assigns InMaterial to every slot.
+	void SetMaterial(FVulkanMaterial* InMaterial);
+	void SetMaterial(uint32_t InSlot, FVulkanMaterial* InMaterial);
 
 	class UMesh* GetMeshAsset() const { return MeshAsset; }
 	
 protected:
 	FVulkanBuffer* VertexBuffer;
 	FVulkanBuffer* IndexBuffer;
-	FVulkanMaterial* Material;
+
+	EVertexFormat VertexFormat;
+	VkIndexType IndexType;
+	glm::mat4 DequantizationMatrix;
+	std::vector<FVulkanMaterial*> Materials;
 
 	class UMesh* MeshAsset;
 };
@@ -2,6 +2,7 @@
 #include "VulkanContext.h"
 #include "VulkanHelpers.h"
 #include "VulkanTexture.h"
+#include "VulkanTextureStreamer.h"
 #include "VulkanSampler.h"
 #include "VulkanScene.h"
 #include "VulkanLight.h"
@@ -12,9 +13,13 @@
 #include "VulkanPipeline.h"
 #include "VulkanFramebuffer.h"
 #include "VulkanViewport.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanCommandRecorder.h"
+#include "VulkanDescriptorAllocator.h"
 
 #include "Utils.h"
 #include "Config.h"
+#include "JobSystem.h"
 #include "Mesh.h"
 
 #include "glm/gtc/matrix_transform.hpp"
@@ -26,7 +31,6 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
-#include <execution>
 #include <unordered_map>
 
 struct FTransformBufferObject
@@ -59,30 +63,63 @@ struct FDebugBufferObject
 	alignas(4) bool bToneMapping;
 };
 
-struct FInstanceBuffer
+struct FCullPushConstants
 {
-	alignas(16) glm::mat4 Model;
-	alignas(16) glm::mat4 ModelView;
-	alignas(16) glm::mat4 NormalMatrix;
+	glm::vec4 Planes[FFrustum::NumPlanes];
+	glm::vec4 BoundingSphere;
+	uint32_t NumInstances;
 };
 
+static const uint32_t CullWorkGroupSize = 64;
+static const uint32_t MinInstanceCapacity = 64;
+static const uint64_t InvalidGeneration = UINT64_MAX;
+
+static VkImageView GetTextureView(UTexture* InTexture)
+{
+	FVulkanTexture* RenderTexture = InTexture != nullptr ? InTexture->GetRenderTexture() : nullptr;
+	if (RenderTexture == nullptr || RenderTexture->GetImage() == nullptr)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return RenderTexture->GetImage()->GetView();
+}
+
+static FVulkanBuffer* CreateHostVisibleBuffer(FVulkanContext* InContext, VkBufferUsageFlags InUsage, VkDeviceSize InSize)
+{
+	FVulkanBuffer* Buffer = InContext->CreateObject<FVulkanBuffer>();
+	Buffer->SetUsage(InUsage);
+	Buffer->SetProperties(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	Buffer->Allocate(InSize);
+	Buffer->Map();
+
+	return Buffer;
+}
+
 FVulkanMeshRenderer::FVulkanMeshRenderer(FVulkanContext* InContext)
 	: FVulkanRenderer(InContext)
-	, TBNPipeline(nullptr)
+	, CullPipeline(nullptr)
 	, DescriptorSetLayout(VK_NULL_HANDLE)
+	, CullDescriptorSetLayout(VK_NULL_HANDLE)
 	, Sampler(nullptr)
-	, bInitialized(false)
+	, TextureStreamer(nullptr)
 	, bEnableTBNVisualization(false)
 	, bEnableAttenuation(false)
 	, bEnableGammaCorrection(false)
 	, bEnableToneMapping(false)
+	, bEnableFrustumCulling(true)
+	, bEnableGPUCulling(true)
 {
 	CreateRenderPass();
 	CreateFramebuffers();
 	CreateTextureSampler();
 	CreateDescriptorSetLayout();
 	CreateUniformBuffers();
-	CreateTBNPipeline();
+	CreateTBNPipelines();
+	CreateCullDescriptorSetLayout();
+	CreateCullPipeline();
+
+	TextureStreamer = Context->CreateObject<FVulkanTextureStreamer>();
 }
 
 FVulkanMeshRenderer::~FVulkanMeshRenderer()
@@ -103,6 +140,7 @@ FVulkanMeshRenderer::~FVulkanMeshRenderer()
 	}
 
 	vkDestroyDescriptorSetLayout(Device, DescriptorSetLayout, nullptr);
+	vkDestroyDescriptorSetLayout(Device, CullDescriptorSetLayout, nullptr);
 }
 
 void FVulkanMeshRenderer::OnRecreateSwapchain()
@@ -119,35 +157,176 @@ void FVulkanMeshRenderer::OnRecreateSwapchain()
 	CreateFramebuffers();
 }
 
-void FVulkanMeshRenderer::GenerateInstancedDrawingInfo()
+void FVulkanMeshRenderer::SyncSceneModels()
 {
 	if (Scene == nullptr)
 	{
 		return;
 	}
 
-	InstancedDrawingMap.clear();
-	for (FVulkanModel* Model : Scene->GetModels())
+	for (FVulkanModel* Model : Scene->GetAddedModels())
 	{
-		if (Model == nullptr)
-		{
-			continue;
-		}
+		AddModel(Model);
+	}
 
-		FVulkanMesh* Mesh = Model->GetMesh();
-		if (Mesh == nullptr)
+	for (FVulkanModel* Model : Scene->GetRemovedModels())
+	{
+		RemoveModel(Model);
+	}
+
+	Scene->ClearPendingChanges();
+}
+
+void FVulkanMeshRenderer::AddModel(FVulkanModel* InModel)
+{
+	if (InModel == nullptr)
+	{
+		return;
+	}
+
+	FVulkanMesh* Mesh = InModel->GetMesh();
+	if (Mesh == nullptr)
+	{
+		return;
+	}
+
+	FInstancedDrawingInfo& DrawingInfo = FindOrCreateDrawingInfo(Mesh);
+	if (DrawingInfo.ModelSlots.find(InModel) != DrawingInfo.ModelSlots.end())
+	{
+		return;
+	}
+
+	uint32_t Slot;
+	if (DrawingInfo.FreeSlots.empty())
+	{
+		Slot = static_cast<uint32_t>(DrawingInfo.Models.size());
+		DrawingInfo.Models.push_back(nullptr);
+		DrawingInfo.InstanceData.push_back({ glm::mat4(0.0f), glm::mat4(0.0f) });
+		DrawingInfo.InstanceGenerations.push_back(0);
+		for (std::vector<uint64_t>& UploadedGenerations : DrawingInfo.UploadedGenerations)
 		{
-			continue;
+			UploadedGenerations.push_back(InvalidGeneration);
 		}
+	}
+	else
+	{
+		Slot = DrawingInfo.FreeSlots.back();
+		DrawingInfo.FreeSlots.pop_back();
+	}
+
+	DrawingInfo.Models[Slot] = InModel;
+	DrawingInfo.InstanceGenerations[Slot] = 0;
+	for (std::vector<uint64_t>& UploadedGenerations : DrawingInfo.UploadedGenerations)
+	{
+		UploadedGenerations[Slot] = InvalidGeneration;
+	}
+
+	DrawingInfo.ModelSlots.insert({ InModel, Slot });
+}
+
+void FVulkanMeshRenderer::RemoveModel(FVulkanModel* InModel)
+{
+	if (InModel == nullptr)
+	{
+		return;
+	}
+
+	auto Iter = InstancedDrawingMap.find(InModel->GetMesh());
+	if (Iter == InstancedDrawingMap.end())
+	{
+		return;
+	}
+
+	FInstancedDrawingInfo& DrawingInfo = Iter->second;
+
+	auto SlotIter = DrawingInfo.ModelSlots.find(InModel);
+	if (SlotIter == DrawingInfo.ModelSlots.end())
+	{
+		return;
+	}
+
+	uint32_t Slot = SlotIter->second;
+	DrawingInfo.ModelSlots.erase(SlotIter);
+
+	// A zero model matrix marks the slot as empty. The cull pass skips it and it degenerates if drawn unculled.
+	DrawingInfo.Models[Slot] = nullptr;
+	DrawingInfo.InstanceData[Slot] = { glm::mat4(0.0f), glm::mat4(0.0f) };
+	DrawingInfo.InstanceGenerations[Slot] = 0;
+	for (std::vector<uint64_t>& UploadedGenerations : DrawingInfo.UploadedGenerations)
+	{
+		UploadedGenerations[Slot] = InvalidGeneration;
+	}
 
-		auto Iter = InstancedDrawingMap.find(Mesh);
-		if (Iter == InstancedDrawingMap.end())
+	DrawingInfo.FreeSlots.push_back(Slot);
+}
+
+void FVulkanMeshRenderer::RemoveMesh(FVulkanMesh* InMesh)
+{
+	auto Iter = InstancedDrawingMap.find(InMesh);
+	if (Iter == InstancedDrawingMap.end())
+	{
+		return;
+	}
+
+	FVulkanDescriptorAllocator* DescriptorAllocator = Context->GetDescriptorAllocator();
+
+	FInstancedDrawingInfo& DrawingInfo = Iter->second;
+
+	auto DestroyBuffers = [this](std::vector<FVulkanBuffer*>& InBuffers)
+	{
+		for (FVulkanBuffer* Buffer : InBuffers)
 		{
-			Iter = InstancedDrawingMap.insert({ Mesh, {} }).first;
+			if (Buffer != nullptr)
+			{
+				Context->DestroyObject(Buffer);
+			}
 		}
+		InBuffers.clear();
+	};
+
+	for (FMaterialBatch& MaterialBatch : DrawingInfo.MaterialBatches)
+	{
+		DescriptorAllocator->Free(MaterialBatch.DescriptorSets.data(), static_cast<uint32_t>(MaterialBatch.DescriptorSets.size()));
+
+		DestroyBuffers(MaterialBatch.MaterialBuffers);
+	}
+
+	DescriptorAllocator->Free(DrawingInfo.CullDescriptorSets.data(), static_cast<uint32_t>(DrawingInfo.CullDescriptorSets.size()));
+
+	DestroyBuffers(DrawingInfo.InstanceBuffers);
+	DestroyBuffers(DrawingInfo.VisibleInstanceBuffers);
+	DestroyBuffers(DrawingInfo.IndirectBuffers);
+
+	InstancedDrawingMap.erase(Iter);
+}
+
+FVulkanMeshRenderer::FInstancedDrawingInfo& FVulkanMeshRenderer::FindOrCreateDrawingInfo(FVulkanMesh* InMesh)
+{
+	auto Iter = InstancedDrawingMap.find(InMesh);
+	if (Iter != InstancedDrawingMap.end())
+	{
+		return Iter->second;
+	}
 
-		Iter->second.Models.push_back(Model);
+	const uint32_t MaxConcurrentFrames = Context->GetMaxConcurrentFrames();
+
+	FInstancedDrawingInfo& DrawingInfo = InstancedDrawingMap[InMesh];
+	DrawingInfo.MaterialBatches.resize(InMesh->GetNumMaterialSlots());
+	DrawingInfo.DequantizationMatrix = InMesh->GetDequantizationMatrix();
+	DrawingInfo.CullBounds = InMesh->GetMeshAsset()->GetBounds().TransformBy(glm::inverse(DrawingInfo.DequantizationMatrix));
+	DrawingInfo.UploadedGenerations.resize(MaxConcurrentFrames);
+	DrawingInfo.InstanceBuffers.resize(MaxConcurrentFrames, nullptr);
+	DrawingInfo.VisibleInstanceBuffers.resize(MaxConcurrentFrames, nullptr);
+	DrawingInfo.IndirectBuffers.resize(MaxConcurrentFrames, nullptr);
+	DrawingInfo.InstanceCapacities.resize(MaxConcurrentFrames, 0);
+
+	for (uint32_t Slot = 0; Slot < DrawingInfo.MaterialBatches.size(); ++Slot)
+	{
+		CreateGraphicsPipeline(InMesh->GetMaterial(Slot), InMesh->GetVertexFormat(), DrawingInfo.MaterialBatches[Slot]);
 	}
+	CreateDescriptorSets(InMesh, DrawingInfo);
+
+	return DrawingInfo;
 }
 
 void FVulkanMeshRenderer::CreateRenderPass()
@@ -244,103 +423,95 @@ void FVulkanMeshRenderer::CreateDescriptorSetLayout()
 	VK_ASSERT(vkCreateDescriptorSetLayout(Device, &DescriptorSetLayoutCI, nullptr, &DescriptorSetLayout));
 }
 
-void FVulkanMeshRenderer::CreateGraphicsPipelines()
+void FVulkanMeshRenderer::CreateGraphicsPipeline(FVulkanMaterial* InMaterial, EVertexFormat InVertexFormat, FMaterialBatch& InMaterialBatch)
 {
-	VkDevice Device = Context->GetDevice();
-
-	for (auto& Pair : InstancedDrawingMap)
+	if (InMaterial == nullptr)
 	{
-		FVulkanMesh* Mesh = Pair.first;
-		FInstancedDrawingInfo& DrawingInfo = Pair.second;
-		std::vector<FVulkanBuffer*>& InstanceBuffers = DrawingInfo.InstanceBuffers;
-		std::vector<FVulkanModel*>& Models = DrawingInfo.Models;
-
-		FVulkanMaterial* Material = Mesh->GetMaterial();
-		if (Material == nullptr)
-		{
-			continue;
-		}
-
-		FVulkanPipeline* Pipeline = Context->CreateObject<FVulkanPipeline>();
+		return;
+	}
 
-		FVulkanShader* VS = Material->GetVS();
-		FVulkanShader* FS = Material->GetFS();
-		if (VS == nullptr || FS == nullptr)
-		{
-			continue;
-		}
+	FVulkanShader* VS = InMaterial->GetVS();
+	FVulkanShader* FS = InMaterial->GetFS();
+	if (VS == nullptr || FS == nullptr)
+	{
+		return;
+	}
 
-		Pipeline->SetVertexShader(VS);
-		Pipeline->SetFragmentShader(FS);
+	VkPipelineShaderStageCreateInfo VertexShaderStageCI{};
+	VertexShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	VertexShaderStageCI.stage = VK_SHADER_STAGE_VERTEX_BIT;
+	VertexShaderStageCI.module = VS->GetModule();
+	VertexShaderStageCI.pName = "main";
 
-		VkPipelineShaderStageCreateInfo VertexShaderStageCI{};
-		VertexShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		VertexShaderStageCI.stage = VK_SHADER_STAGE_VERTEX_BIT;
-		VertexShaderStageCI.module = VS->GetModule();
-		VertexShaderStageCI.pName = "main";
+	// Vertex shaders select how to decode their inputs with specialization constant 0.
+	uint32_t VertexFormatConstant = static_cast<uint32_t>(InVertexFormat);
+	VkSpecializationMapEntry SpecializationEntry{ 0, 0, sizeof(uint32_t) };
 
-		VkPipelineShaderStageCreateInfo FragmentShaderStageCI{};
-		FragmentShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		FragmentShaderStageCI.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-		FragmentShaderStageCI.module = FS->GetModule();
-		FragmentShaderStageCI.pName = "main";
+	VkSpecializationInfo SpecializationInfo{};
+	SpecializationInfo.mapEntryCount = 1;
+	SpecializationInfo.pMapEntries = &SpecializationEntry;
+	SpecializationInfo.dataSize = sizeof(uint32_t);
+	SpecializationInfo.pData = &VertexFormatConstant;
 
-		std::array<VkPipelineShaderStageCreateInfo, 2> ShaderStageCIs = { VertexShaderStageCI, FragmentShaderStageCI };
+	VertexShaderStageCI.pSpecializationInfo = &SpecializationInfo;
 
-		std::vector<VkVertexInputBindingDescription> VertexInputBindingDescs;
-		std::vector<VkVertexInputAttributeDescription> VertexInputAttributeDescs;
-		GetVertexInputBindings(VertexInputBindingDescs);
-		GetVertexInputAttributes(VertexInputAttributeDescs);
+	VkPipelineShaderStageCreateInfo FragmentShaderStageCI{};
+	FragmentShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	FragmentShaderStageCI.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	FragmentShaderStageCI.module = FS->GetModule();
+	FragmentShaderStageCI.pName = "main";
 
-		VkPipelineVertexInputStateCreateInfo VertexInputStateCI = Vk::GetVertexInputStateCI(VertexInputBindingDescs, VertexInputAttributeDescs);
-		VkPipelineInputAssemblyStateCreateInfo InputAssemblyStateCI = Vk::GetInputAssemblyStateCI();
-		VkPipelineViewportStateCreateInfo ViewportStateCI = Vk::GetViewportStateCI();
-		VkPipelineRasterizationStateCreateInfo RasterizerCI = Vk::GetRasterizationStateCI();
-		VkPipelineMultisampleStateCreateInfo MultisampleStateCI = Vk::GetMultisampleStateCI();
-		VkPipelineDepthStencilStateCreateInfo DepthStencilStateCI = Vk::GetDepthStencilStateCI();
+	std::array<VkPipelineShaderStageCreateInfo, 2> ShaderStageCIs = { VertexShaderStageCI, FragmentShaderStageCI };
 
-		VkPipelineColorBlendAttachmentState ColorBlendAttachmentState = Vk::GetColorBlendAttachment();
-		VkPipelineColorBlendStateCreateInfo ColorBlendStateCI = Vk::GetColorBlendStateCI();
-		ColorBlendStateCI.pAttachments = &ColorBlendAttachmentState;
+	std::vector<VkVertexInputBindingDescription> VertexInputBindingDescs;
+	std::vector<VkVertexInputAttributeDescription> VertexInputAttributeDescs;
+	GetVertexInputBindings(InVertexFormat, VertexInputBindingDescs);
+	GetVertexInputAttributes(InVertexFormat, VertexInputAttributeDescs);
 
-		std::vector<VkDynamicState> DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	VkPipelineVertexInputStateCreateInfo VertexInputStateCI = Vk::GetVertexInputStateCI(VertexInputBindingDescs, VertexInputAttributeDescs);
+	VkPipelineInputAssemblyStateCreateInfo InputAssemblyStateCI = Vk::GetInputAssemblyStateCI();
+	VkPipelineViewportStateCreateInfo ViewportStateCI = Vk::GetViewportStateCI();
+	VkPipelineRasterizationStateCreateInfo RasterizerCI = Vk::GetRasterizationStateCI();
+	VkPipelineMultisampleStateCreateInfo MultisampleStateCI = Vk::GetMultisampleStateCI();
+	VkPipelineDepthStencilStateCreateInfo DepthStencilStateCI = Vk::GetDepthStencilStateCI();
 
-		VkPipelineDynamicStateCreateInfo DynamicStateCI{};
-		DynamicStateCI.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-		DynamicStateCI.dynamicStateCount = static_cast<uint32_t>(DynamicStates.size());
-		DynamicStateCI.pDynamicStates = DynamicStates.data();
+	VkPipelineColorBlendAttachmentState ColorBlendAttachmentState = Vk::GetColorBlendAttachment();
+	VkPipelineColorBlendStateCreateInfo ColorBlendStateCI = Vk::GetColorBlendStateCI();
+	ColorBlendStateCI.pAttachments = &ColorBlendAttachmentState;
 
-		VkPipelineLayoutCreateInfo PipelineLayoutCI{};
-		PipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		PipelineLayoutCI.setLayoutCount = 1;
-		PipelineLayoutCI.pSetLayouts = &DescriptorSetLayout;
+	std::vector<VkDynamicState> DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
 
-		Pipeline->CreateLayout(PipelineLayoutCI);
+	VkPipelineDynamicStateCreateInfo DynamicStateCI{};
+	DynamicStateCI.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	DynamicStateCI.dynamicStateCount = static_cast<uint32_t>(DynamicStates.size());
+	DynamicStateCI.pDynamicStates = DynamicStates.data();
 
-		VkGraphicsPipelineCreateInfo PipelineCI{};
-		PipelineCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		PipelineCI.stageCount = static_cast<uint32_t>(ShaderStageCIs.size());
-		PipelineCI.pStages = ShaderStageCIs.data();
-		PipelineCI.pVertexInputState = &VertexInputStateCI;
-		PipelineCI.pInputAssemblyState = &InputAssemblyStateCI;
-		PipelineCI.pViewportState = &ViewportStateCI;
-		PipelineCI.pRasterizationState = &RasterizerCI;
-		PipelineCI.pDepthStencilState = &DepthStencilStateCI;
-		PipelineCI.pMultisampleState = &MultisampleStateCI;
-		PipelineCI.pColorBlendState = &ColorBlendStateCI;
-		PipelineCI.pDynamicState = &DynamicStateCI;
-		PipelineCI.layout = Pipeline->GetLayout();
-		PipelineCI.renderPass = RenderPass->GetHandle();
-		PipelineCI.subpass = 0;
-		PipelineCI.basePipelineHandle = VK_NULL_HANDLE;
+	VkPipelineLayoutCreateInfo PipelineLayoutCI{};
+	PipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	PipelineLayoutCI.setLayoutCount = 1;
+	PipelineLayoutCI.pSetLayouts = &DescriptorSetLayout;
 
-		Pipeline->CreatePipeline(PipelineCI);
+	VkGraphicsPipelineCreateInfo PipelineCI{};
+	PipelineCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	PipelineCI.stageCount = static_cast<uint32_t>(ShaderStageCIs.size());
+	PipelineCI.pStages = ShaderStageCIs.data();
+	PipelineCI.pVertexInputState = &VertexInputStateCI;
+	PipelineCI.pInputAssemblyState = &InputAssemblyStateCI;
+	PipelineCI.pViewportState = &ViewportStateCI;
+	PipelineCI.pRasterizationState = &RasterizerCI;
+	PipelineCI.pDepthStencilState = &DepthStencilStateCI;
+	PipelineCI.pMultisampleState = &MultisampleStateCI;
+	PipelineCI.pColorBlendState = &ColorBlendStateCI;
+	PipelineCI.pDynamicState = &DynamicStateCI;
+	PipelineCI.renderPass = RenderPass->GetHandle();
+	PipelineCI.subpass = 0;
+	PipelineCI.basePipelineHandle = VK_NULL_HANDLE;
 
-		DrawingInfo.Pipeline = Pipeline;
-	}
+	// Materials with the same shaders and state share this pipeline, so it is used as returned.
+	InMaterialBatch.Pipeline = Context->GetPipelineCache()->FindOrCreateGraphicsPipeline(PipelineLayoutCI, PipelineCI, { VS, FS });
 }
 
-void FVulkanMeshRenderer::CreateTBNPipeline()
+void FVulkanMeshRenderer::CreateTBNPipelines()
 {
 	VkDevice Device = Context->GetDevice();
 
@@ -354,37 +525,24 @@ void FVulkanMeshRenderer::CreateTBNPipeline()
 	FVulkanShader* FS = Context->CreateObject<FVulkanShader>();
 	FS->LoadFile(ShaderDirectory + "visualizeTBN.frag.spv");
 
-	TBNPipeline = Context->CreateObject<FVulkanPipeline>();
-	TBNPipeline->SetVertexShader(VS);
-	TBNPipeline->SetGeometryShader(GS);
-	TBNPipeline->SetFragmentShader(FS);
-
 	VkPipelineShaderStageCreateInfo VertexShaderStageCI{};
 	VertexShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	VertexShaderStageCI.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	VertexShaderStageCI.module = TBNPipeline->GetVertexShader()->GetModule();
+	VertexShaderStageCI.module = VS->GetModule();
 	VertexShaderStageCI.pName = "main";
 
 	VkPipelineShaderStageCreateInfo GeometryShaderStageCI{};
 	GeometryShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	GeometryShaderStageCI.stage = VK_SHADER_STAGE_GEOMETRY_BIT;
-	GeometryShaderStageCI.module = TBNPipeline->GetGeometryShader()->GetModule();
+	GeometryShaderStageCI.module = GS->GetModule();
 	GeometryShaderStageCI.pName = "main";
 
 	VkPipelineShaderStageCreateInfo FragmentShaderStageCI{};
 	FragmentShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	FragmentShaderStageCI.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	FragmentShaderStageCI.module = TBNPipeline->GetFragmentShader()->GetModule();
+	FragmentShaderStageCI.module = FS->GetModule();
 	FragmentShaderStageCI.pName = "main";
 
-	std::array<VkPipelineShaderStageCreateInfo, 3> ShaderStageCIs = { VertexShaderStageCI, GeometryShaderStageCI, FragmentShaderStageCI };
-
-	std::vector<VkVertexInputBindingDescription> VertexInputBindingDescs;
-	std::vector<VkVertexInputAttributeDescription> VertexInputAttributeDescs;
-	GetVertexInputBindings(VertexInputBindingDescs);
-	GetVertexInputAttributes(VertexInputAttributeDescs);
-
-	VkPipelineVertexInputStateCreateInfo VertexInputStateCI = Vk::GetVertexInputStateCI(VertexInputBindingDescs, VertexInputAttributeDescs);
 	VkPipelineInputAssemblyStateCreateInfo InputAssemblyStateCI = Vk::GetInputAssemblyStateCI();
 	VkPipelineViewportStateCreateInfo ViewportStateCI = Vk::GetViewportStateCI();
 	VkPipelineRasterizationStateCreateInfo RasterizerCI = Vk::GetRasterizationStateCI();
@@ -407,26 +565,127 @@ void FVulkanMeshRenderer::CreateTBNPipeline()
 	PipelineLayoutCI.setLayoutCount = 1;
 	PipelineLayoutCI.pSetLayouts = &DescriptorSetLayout;
 
-	TBNPipeline->CreateLayout(PipelineLayoutCI);
+	// One variant per vertex format; the format is also handed to the vertex shader as a specialization constant.
+	TBNPipelines.resize(static_cast<size_t>(EVertexFormat::Count));
+	for (uint32_t FormatIdx = 0; FormatIdx < TBNPipelines.size(); ++FormatIdx)
+	{
+		EVertexFormat VertexFormat = static_cast<EVertexFormat>(FormatIdx);
 
-	VkGraphicsPipelineCreateInfo PipelineCI{};
-	PipelineCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	PipelineCI.stageCount = static_cast<uint32_t>(ShaderStageCIs.size());
-	PipelineCI.pStages = ShaderStageCIs.data();
-	PipelineCI.pVertexInputState = &VertexInputStateCI;
-	PipelineCI.pInputAssemblyState = &InputAssemblyStateCI;
-	PipelineCI.pViewportState = &ViewportStateCI;
-	PipelineCI.pRasterizationState = &RasterizerCI;
-	PipelineCI.pDepthStencilState = &DepthStencilStateCI;
-	PipelineCI.pMultisampleState = &MultisampleStateCI;
-	PipelineCI.pColorBlendState = &ColorBlendStateCI;
-	PipelineCI.pDynamicState = &DynamicStateCI;
-	PipelineCI.layout = TBNPipeline->GetLayout();
-	PipelineCI.renderPass = RenderPass->GetHandle();
-	PipelineCI.subpass = 0;
+		VkSpecializationMapEntry SpecializationEntry{ 0, 0, sizeof(uint32_t) };
+
+		VkSpecializationInfo SpecializationInfo{};
+		SpecializationInfo.mapEntryCount = 1;
+		SpecializationInfo.pMapEntries = &SpecializationEntry;
+		SpecializationInfo.dataSize = sizeof(uint32_t);
+		SpecializationInfo.pData = &FormatIdx;
+
+		VkPipelineShaderStageCreateInfo SpecializedVertexShaderStageCI = VertexShaderStageCI;
+		SpecializedVertexShaderStageCI.pSpecializationInfo = &SpecializationInfo;
+
+		std::array<VkPipelineShaderStageCreateInfo, 3> ShaderStageCIs = { SpecializedVertexShaderStageCI, GeometryShaderStageCI, FragmentShaderStageCI };
+
+		std::vector<VkVertexInputBindingDescription> VertexInputBindingDescs;
+		std::vector<VkVertexInputAttributeDescription> VertexInputAttributeDescs;
+		GetVertexInputBindings(VertexFormat, VertexInputBindingDescs);
+		GetVertexInputAttributes(VertexFormat, VertexInputAttributeDescs);
+
+		VkPipelineVertexInputStateCreateInfo VertexInputStateCI = Vk::GetVertexInputStateCI(VertexInputBindingDescs, VertexInputAttributeDescs);
+
+		FVulkanPipeline* TBNPipeline = Context->CreateObject<FVulkanPipeline>();
+		TBNPipeline->SetVertexShader(VS);
+		TBNPipeline->SetGeometryShader(GS);
+		TBNPipeline->SetFragmentShader(FS);
+		TBNPipeline->CreateLayout(PipelineLayoutCI);
+
+		VkGraphicsPipelineCreateInfo PipelineCI{};
+		PipelineCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		PipelineCI.stageCount = static_cast<uint32_t>(ShaderStageCIs.size());
+		PipelineCI.pStages = ShaderStageCIs.data();
+		PipelineCI.pVertexInputState = &VertexInputStateCI;
+		PipelineCI.pInputAssemblyState = &InputAssemblyStateCI;
+		PipelineCI.pViewportState = &ViewportStateCI;
+		PipelineCI.pRasterizationState = &RasterizerCI;
+		PipelineCI.pDepthStencilState = &DepthStencilStateCI;
+		PipelineCI.pMultisampleState = &MultisampleStateCI;
+		PipelineCI.pColorBlendState = &ColorBlendStateCI;
+		PipelineCI.pDynamicState = &DynamicStateCI;
+		PipelineCI.layout = TBNPipeline->GetLayout();
+		PipelineCI.renderPass = RenderPass->GetHandle();
+		PipelineCI.subpass = 0;
+		PipelineCI.basePipelineHandle = VK_NULL_HANDLE;
+
+		TBNPipeline->CreatePipeline(PipelineCI);
+
+		TBNPipelines[FormatIdx] = TBNPipeline;
+	}
+}
+
+void FVulkanMeshRenderer::CreateCullDescriptorSetLayout()
+{
+	VkDevice Device = Context->GetDevice();
+
+	std::vector<VkDescriptorSetLayoutBinding> Bindings(3);
+	for (int Idx = 0; Idx < Bindings.size(); ++Idx)
+	{
+		Bindings[Idx].binding = Idx;
+		Bindings[Idx].descriptorCount = 1;
+		Bindings[Idx].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		Bindings[Idx].pImmutableSamplers = nullptr;
+		Bindings[Idx].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	}
+
+	VkDescriptorSetLayoutCreateInfo DescriptorSetLayoutCI{};
+	DescriptorSetLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	DescriptorSetLayoutCI.bindingCount = static_cast<uint32_t>(Bindings.size());
+	DescriptorSetLayoutCI.pBindings = Bindings.data();
+
+	VK_ASSERT(vkCreateDescriptorSetLayout(Device, &DescriptorSetLayoutCI, nullptr, &CullDescriptorSetLayout));
+}
+
+void FVulkanMeshRenderer::CreateCullPipeline()
+{
+	std::string ShaderDirectory;
+	GConfig->Get("ShaderDirectory", ShaderDirectory);
+
+	FVulkanShader* CS = Context->CreateObject<FVulkanShader>();
+	if (CS->LoadFile(ShaderDirectory + "cull.comp.spv") == false)
+	{
+		std::cerr << "Failed to load cull.comp.spv. Falling back to CPU frustum culling." << std::endl;
+		Context->DestroyObject(CS);
+		bEnableGPUCulling = false;
+		return;
+	}
+
+	VkPipelineShaderStageCreateInfo ComputeShaderStageCI{};
+	ComputeShaderStageCI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	ComputeShaderStageCI.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	ComputeShaderStageCI.module = CS->GetModule();
+	ComputeShaderStageCI.pName = "main";
+
+	VkPushConstantRange PushConstantRange{};
+	PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	PushConstantRange.offset = 0;
+	PushConstantRange.size = sizeof(FCullPushConstants);
+
+	VkPipelineLayoutCreateInfo PipelineLayoutCI{};
+	PipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	PipelineLayoutCI.setLayoutCount = 1;
+	PipelineLayoutCI.pSetLayouts = &CullDescriptorSetLayout;
+	PipelineLayoutCI.pushConstantRangeCount = 1;
+	PipelineLayoutCI.pPushConstantRanges = &PushConstantRange;
+
+	CullPipeline = Context->CreateObject<FVulkanPipeline>();
+	CullPipeline->CreateLayout(PipelineLayoutCI);
+
+	VkComputePipelineCreateInfo PipelineCI{};
+	PipelineCI.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	PipelineCI.stage = ComputeShaderStageCI;
+	PipelineCI.layout = CullPipeline->GetLayout();
 	PipelineCI.basePipelineHandle = VK_NULL_HANDLE;
 
-	TBNPipeline->CreatePipeline(PipelineCI);
+	CullPipeline->CreatePipeline(PipelineCI);
+
+	Context->DestroyObject(CS);
 }
 
 void FVulkanMeshRenderer::CreateTextureSampler()
@@ -449,7 +708,6 @@ void FVulkanMeshRenderer::CreateUniformBuffers()
 	{
 		{ sizeof(FTransformBufferObject), TransformBuffers },
 		{ sizeof(FLightBufferObject), LightBuffers },
-		{ sizeof(FMaterialBufferObject), MaterialBuffers },
 		{ sizeof(FDebugBufferObject), DebugBuffers }
 	};
 
@@ -469,68 +727,105 @@ void FVulkanMeshRenderer::CreateUniformBuffers()
 	}
 }
 
-void FVulkanMeshRenderer::CreateInstanceBuffers()
+void FVulkanMeshRenderer::ReserveInstanceBuffers(FVulkanMesh* InMesh, FInstancedDrawingInfo& InDrawingInfo, uint32_t InFrame)
 {
-	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
-	VkDevice Device = Context->GetDevice();
-
-	for (auto& Pair : InstancedDrawingMap)
+	if (InDrawingInfo.IndirectBuffers[InFrame] == nullptr)
 	{
-		FVulkanMesh* Mesh = Pair.first;
-		std::vector<FVulkanBuffer*>& InstanceBuffers = Pair.second.InstanceBuffers;
-		std::vector<FVulkanModel*>& Models = Pair.second.Models;
+		// Transfer usage lets the GPU cull pass copy the visible count of the first command into the others.
+		uint32_t NumCommands = std::max(InMesh->GetMeshAsset()->GetNumSubmeshes(), 1U);
+		InDrawingInfo.IndirectBuffers[InFrame] = CreateHostVisibleBuffer(
+			Context,
+			VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			sizeof(VkDrawIndexedIndirectCommand) * NumCommands);
+	}
 
-		uint32_t InstanceBufferSize = sizeof(FInstanceBuffer) * Models.size();
+	uint32_t RequiredCapacity = static_cast<uint32_t>(InDrawingInfo.Models.size());
+	uint32_t Capacity = InDrawingInfo.InstanceCapacities[InFrame];
+	if (RequiredCapacity <= Capacity)
+	{
+		return;
+	}
 
-		const uint32_t MaxConcurrentFrames = Context->GetMaxConcurrentFrames();
+	uint32_t NewCapacity = std::max(MinInstanceCapacity, Capacity * 2);
+	while (NewCapacity < RequiredCapacity)
+	{
+		NewCapacity *= 2;
+	}
 
-		InstanceBuffers.resize(MaxConcurrentFrames);
-		for (int Idx = 0; Idx < MaxConcurrentFrames; ++Idx)
-		{
-			InstanceBuffers[Idx] = Context->CreateObject<FVulkanBuffer>();
-			InstanceBuffers[Idx]->SetUsage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-			InstanceBuffers[Idx]->SetProperties(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-			InstanceBuffers[Idx]->Allocate(InstanceBufferSize);
-			InstanceBuffers[Idx]->Map();
-		}
+	// Only the buffers of the frame being recorded are known to be idle, so each frame grows its own copy.
+	if (InDrawingInfo.InstanceBuffers[InFrame] != nullptr)
+	{
+		Context->DestroyObject(InDrawingInfo.InstanceBuffers[InFrame]);
+	}
 
-		UpdateInstanceBuffer(Mesh);
+	if (InDrawingInfo.VisibleInstanceBuffers[InFrame] != nullptr)
+	{
+		Context->DestroyObject(InDrawingInfo.VisibleInstanceBuffers[InFrame]);
 	}
+
+	VkDeviceSize InstanceBufferSize = sizeof(FInstanceBuffer) * NewCapacity;
+	InDrawingInfo.InstanceBuffers[InFrame] = CreateHostVisibleBuffer(
+		Context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, InstanceBufferSize);
+	InDrawingInfo.VisibleInstanceBuffers[InFrame] = CreateHostVisibleBuffer(
+		Context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, InstanceBufferSize);
+	InDrawingInfo.InstanceCapacities[InFrame] = NewCapacity;
+
+	std::vector<uint64_t>& UploadedGenerations = InDrawingInfo.UploadedGenerations[InFrame];
+	std::fill(UploadedGenerations.begin(), UploadedGenerations.end(), InvalidGeneration);
+
+	UpdateCullDescriptorSet(InDrawingInfo, InFrame);
 }
 
-void FVulkanMeshRenderer::CreateDescriptorSets()
+void FVulkanMeshRenderer::CreateDescriptorSets(FVulkanMesh* InMesh, FInstancedDrawingInfo& InDrawingInfo)
 {
-	VkDevice Device = Context->GetDevice();
-	VkDescriptorPool DescriptorPool = Context->GetDescriptorPool();
+	FVulkanDescriptorAllocator* DescriptorAllocator = Context->GetDescriptorAllocator();
 
 	const uint32_t MaxConcurrentFrames = Context->GetMaxConcurrentFrames();
 
-	for (auto& Pair : InstancedDrawingMap)
+	// Sets that cannot be allocated stay empty; Draw skips their slots and culling falls back to the CPU.
+	for (uint32_t Slot = 0; Slot < InDrawingInfo.MaterialBatches.size(); ++Slot)
 	{
-		FVulkanMesh* Mesh = Pair.first;
-		std::vector<FVulkanModel*>& Models = Pair.second.Models;
-		std::vector<VkDescriptorSet>& DescriptorSets = Pair.second.DescriptorSets;
+		FMaterialBatch& MaterialBatch = InDrawingInfo.MaterialBatches[Slot];
+
+		MaterialBatch.DescriptorSets.resize(MaxConcurrentFrames);
+		if (DescriptorAllocator->Allocate(DescriptorSetLayout, MaxConcurrentFrames, MaterialBatch.DescriptorSets.data()) == false)
+		{
+			MaterialBatch.DescriptorSets.clear();
+		}
+
+		MaterialBatch.MaterialBuffers.resize(MaxConcurrentFrames);
+		for (uint32_t Frame = 0; Frame < MaxConcurrentFrames; ++Frame)
+		{
+			MaterialBatch.MaterialBuffers[Frame] = CreateHostVisibleBuffer(Context, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(FMaterialBufferObject));
+		}
 
-		std::vector<VkDescriptorSetLayout> Layouts(MaxConcurrentFrames, DescriptorSetLayout);
-		VkDescriptorSetAllocateInfo DescriptorSetAllocInfo{};
-		DescriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		DescriptorSetAllocInfo.descriptorPool = DescriptorPool;
-		DescriptorSetAllocInfo.descriptorSetCount = static_cast<uint32_t>(MaxConcurrentFrames);
-		DescriptorSetAllocInfo.pSetLayouts = Layouts.data();
+		MaterialBatch.BaseColorViews.assign(MaxConcurrentFrames, VK_NULL_HANDLE);
+		MaterialBatch.NormalViews.assign(MaxConcurrentFrames, VK_NULL_HANDLE);
+		for (uint32_t Frame = 0; Frame < MaxConcurrentFrames; ++Frame)
+		{
+			UpdateDescriptorSets(InMesh->GetMaterial(Slot), MaterialBatch, Frame);
+		}
+	}
 
-		DescriptorSets.resize(MaxConcurrentFrames);
-		VK_ASSERT(vkAllocateDescriptorSets(Device, &DescriptorSetAllocInfo, DescriptorSets.data()));
+	if (CullPipeline == nullptr)
+	{
+		return;
 	}
 
-	UpdateDescriptorSets();
+	InDrawingInfo.CullDescriptorSets.resize(MaxConcurrentFrames);
+	if (DescriptorAllocator->Allocate(CullDescriptorSetLayout, MaxConcurrentFrames, InDrawingInfo.CullDescriptorSets.data()) == false)
+	{
+		InDrawingInfo.CullDescriptorSets.clear();
+	}
 }
 
-void FVulkanMeshRenderer::GetVertexInputBindings(std::vector<VkVertexInputBindingDescription>& OutDescs)
+
+void FVulkanMeshRenderer::GetVertexInputBindings(EVertexFormat InVertexFormat, std::vector<VkVertexInputBindingDescription>& OutDescs)
 {
 	OutDescs.resize(2);
 
 	OutDescs[0].binding = 0;
-	OutDescs[0].stride = sizeof(FVertex);
+	OutDescs[0].stride = InVertexFormat == EVertexFormat::Packed ? sizeof(FPackedVertex) : sizeof(FVertex);
 	OutDescs[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
 	OutDescs[1].binding = 1;
@@ -538,28 +833,43 @@ void FVulkanMeshRenderer::GetVertexInputBindings(std::vector<VkVertexInputBindin
 	OutDescs[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 }
 
-void FVulkanMeshRenderer::GetVertexInputAttributes(std::vector<VkVertexInputAttributeDescription>& OutDescs)
+void FVulkanMeshRenderer::GetVertexInputAttributes(EVertexFormat InVertexFormat, std::vector<VkVertexInputAttributeDescription>& OutDescs)
 {
-	OutDescs.resize(16);
-	OutDescs[0].binding = 0;
-	OutDescs[0].location = 0;
-	OutDescs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-	OutDescs[0].offset = offsetof(FVertex, Position);
+	OutDescs.resize(12);
+	for (int Idx = 0; Idx < 4; ++Idx)
+	{
+		OutDescs[Idx].binding = 0;
+		OutDescs[Idx].location = Idx;
+	}
+
+	if (InVertexFormat == EVertexFormat::Packed)
+	{
+		OutDescs[0].format = VK_FORMAT_R16G16B16A16_SNORM;
+		OutDescs[0].offset = offsetof(FPackedVertex, Position);
+
+		OutDescs[1].format = VK_FORMAT_R16G16_SNORM;
+		OutDescs[1].offset = offsetof(FPackedVertex, Normal);
+
+		OutDescs[2].format = VK_FORMAT_R16G16_SFLOAT;
+		OutDescs[2].offset = offsetof(FPackedVertex, TexCoords);
 
-	OutDescs[1].binding = 0;
-	OutDescs[1].location = 1;
-	OutDescs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-	OutDescs[1].offset = offsetof(FVertex, Normal);
+		OutDescs[3].format = VK_FORMAT_R16G16_SNORM;
+		OutDescs[3].offset = offsetof(FPackedVertex, Tangent);
+	}
+	else
+	{
+		OutDescs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+		OutDescs[0].offset = offsetof(FVertex, Position);
 
-	OutDescs[2].binding = 0;
-	OutDescs[2].location = 2;
-	OutDescs[2].format = VK_FORMAT_R32G32_SFLOAT;
-	OutDescs[2].offset = offsetof(FVertex, TexCoords);
+		OutDescs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+		OutDescs[1].offset = offsetof(FVertex, Normal);
 
-	OutDescs[3].binding = 0;
-	OutDescs[3].location = 3;
-	OutDescs[3].format = VK_FORMAT_R32G32B32_SFLOAT;
-	OutDescs[3].offset = offsetof(FVertex, Tangent);
+		OutDescs[2].format = VK_FORMAT_R32G32_SFLOAT;
+		OutDescs[2].offset = offsetof(FVertex, TexCoords);
+
+		OutDescs[3].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		OutDescs[3].offset = offsetof(FVertex, Tangent);
+	}
 
 	for (int Idx = 0; Idx < 4; ++Idx)
 	{
@@ -574,15 +884,7 @@ void FVulkanMeshRenderer::GetVertexInputAttributes(std::vector<VkVertexInputAttr
 		OutDescs[8 + Idx].binding = 1;
 		OutDescs[8 + Idx].location = 8 + Idx;
 		OutDescs[8 + Idx].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-		OutDescs[8 + Idx].offset = offsetof(FInstanceBuffer, ModelView) + sizeof(glm::vec4) * Idx;
-	}
-
-	for (int Idx = 0; Idx < 4; ++Idx)
-	{
-		OutDescs[12 + Idx].binding = 1;
-		OutDescs[12 + Idx].location = 12 + Idx;
-		OutDescs[12 + Idx].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-		OutDescs[12 + Idx].offset = offsetof(FInstanceBuffer, NormalMatrix) + sizeof(glm::vec4) * Idx;
+		OutDescs[8 + Idx].offset = offsetof(FInstanceBuffer, NormalMatrix) + sizeof(glm::vec4) * Idx;
 	}
 }
 
@@ -607,6 +909,8 @@ void FVulkanMeshRenderer::UpdateUniformBuffer()
 	TBO.Projection = glm::perspective(FOVRadians, AspectRatio, Camera.Near, Camera.Far);
 	TBO.CameraPosition = Camera.Position;
 
+	ViewFrustum = FFrustum::FromMatrix(TBO.Projection * TBO.View);
+
 	FLightBufferObject LBO{};
 	if (Scene != nullptr)
 	{
@@ -640,207 +944,447 @@ void FVulkanMeshRenderer::UpdateUniformBuffer()
 	memcpy(DebugBuffers[CurrentFrame]->GetMappedAddress(), &DBO, sizeof(FDebugBufferObject));
 }
 
-void FVulkanMeshRenderer::UpdateMaterialBuffer(FVulkanMesh* InMesh)
+void FVulkanMeshRenderer::UpdateMaterialBuffers(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo)
 {
 	if (InMesh == nullptr)
 	{
 		return;
 	}
 
-	FVulkanMaterial* Material = InMesh->GetMaterial();
-	if (Material == nullptr)
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
+
+	for (uint32_t Slot = 0; Slot < InDrawingInfo.MaterialBatches.size(); ++Slot)
 	{
-		return;
+		FVulkanMaterial* Material = InMesh->GetMaterial(Slot);
+		if (Material == nullptr)
+		{
+			continue;
+		}
+
+		FMaterialBufferObject MBO{};
+		MBO.Ambient = glm::vec4(Material->GetAmbient().Vec3Param, 1.0);
+		MBO.Diffuse = glm::vec4(Material->GetDiffuse().Vec3Param, 1.0);
+		MBO.Specular = glm::vec4(Material->GetSpecular().Vec3Param, 1.0);
+
+		memcpy(InDrawingInfo.MaterialBatches[Slot].MaterialBuffers[CurrentFrame]->GetMappedAddress(), &MBO, sizeof(FMaterialBufferObject));
 	}
+}
 
-	FMaterialBufferObject MBO{};
-	MBO.Ambient = glm::vec4(Material->GetAmbient().Vec3Param, 1.0);
-	MBO.Diffuse = glm::vec4(Material->GetDiffuse().Vec3Param, 1.0);
-	MBO.Specular = glm::vec4(Material->GetSpecular().Vec3Param, 1.0);
+void FVulkanMeshRenderer::UpdateInstanceBuffer(FInstancedDrawingInfo& InDrawingInfo)
+{
+	const std::vector<FVulkanModel*>& Models = InDrawingInfo.Models;
 
 	uint32_t CurrentFrame = Context->GetCurrentFrame();
+	std::vector<uint64_t>& UploadedGenerations = InDrawingInfo.UploadedGenerations[CurrentFrame];
+	FInstanceBuffer* MappedData = (FInstanceBuffer*)InDrawingInfo.InstanceBuffers[CurrentFrame]->GetMappedAddress();
+
+	auto RefreshInstances = [&InDrawingInfo, &Models](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+		{
+			FVulkanModel* Model = Models[Idx];
+			if (Model != nullptr && InDrawingInfo.InstanceGenerations[Idx] != Model->GetGeneration())
+			{
+				// Dequantization is folded into the instance matrix; the normal matrix comes from the model matrix alone.
+				FInstanceBuffer& Instance = InDrawingInfo.InstanceData[Idx];
+				Instance.Model = Model->GetModelMatrix() * InDrawingInfo.DequantizationMatrix;
+				Instance.NormalMatrix = glm::transpose(glm::inverse(glm::mat3(Model->GetModelMatrix())));
+				InDrawingInfo.InstanceGenerations[Idx] = Model->GetGeneration();
+			}
+		}
+	};
+
+	// Small enough to spread large instance lists across workers, large enough that a handful of models stays on this thread.
+	constexpr uint32_t InstanceRefreshChunkSize = 256;
+
+	uint32_t NumModels = static_cast<uint32_t>(Models.size());
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelFor(NumModels, InstanceRefreshChunkSize, RefreshInstances);
+	}
+	else
+	{
+		RefreshInstances(0, NumModels);
+	}
+
+	// Each frame's buffer is brought up to date with the CPU copy by uploading only contiguous runs of instances that changed.
+	size_t DirtyBegin = Models.size();
+	for (size_t Idx = 0; Idx <= Models.size(); ++Idx)
+	{
+		bool bDirty = false;
+		if (Idx < Models.size())
+		{
+			bDirty = UploadedGenerations[Idx] != InDrawingInfo.InstanceGenerations[Idx];
+		}
 
-	memcpy(MaterialBuffers[CurrentFrame]->GetMappedAddress(), &MBO, sizeof(FMaterialBufferObject));
+		if (bDirty && DirtyBegin == Models.size())
+		{
+			DirtyBegin = Idx;
+		}
+		else if (bDirty == false && DirtyBegin != Models.size())
+		{
+			memcpy(MappedData + DirtyBegin, InDrawingInfo.InstanceData.data() + DirtyBegin, sizeof(FInstanceBuffer) * (Idx - DirtyBegin));
+			std::copy(InDrawingInfo.InstanceGenerations.begin() + DirtyBegin, InDrawingInfo.InstanceGenerations.begin() + Idx, UploadedGenerations.begin() + DirtyBegin);
+			DirtyBegin = Models.size();
+		}
+	}
 }
 
-void FVulkanMeshRenderer::UpdateInstanceBuffer(FVulkanMesh* InMesh)
+void FVulkanMeshRenderer::UpdateDescriptorSets(FVulkanMaterial* InMaterial, FMaterialBatch& InMaterialBatch, uint32_t InFrame)
 {
-	if (Scene == nullptr)
+	VkDevice Device = Context->GetDevice();
+
+	if (InMaterial == nullptr || InFrame >= InMaterialBatch.DescriptorSets.size())
 	{
 		return;
 	}
 
-	if (InMesh == nullptr)
+	// Until both textures have a view the set cannot be written, and Draw skips the slot for this frame.
+	VkImageView BaseColorView = GetTextureView(InMaterial->GetBaseColor().TexParam);
+	VkImageView NormalView = GetTextureView(InMaterial->GetNormal().TexParam);
+	if (BaseColorView == VK_NULL_HANDLE || NormalView == VK_NULL_HANDLE)
 	{
+		InMaterialBatch.BaseColorViews[InFrame] = VK_NULL_HANDLE;
+		InMaterialBatch.NormalViews[InFrame] = VK_NULL_HANDLE;
 		return;
 	}
 
-	auto Iter = InstancedDrawingMap.find(InMesh);
-	if (Iter == InstancedDrawingMap.end())
+	InMaterialBatch.BaseColorViews[InFrame] = BaseColorView;
+	InMaterialBatch.NormalViews[InFrame] = NormalView;
+
+	VkDescriptorBufferInfo TransformBufferInfo{};
+	TransformBufferInfo.buffer = TransformBuffers[InFrame]->GetHandle();
+	TransformBufferInfo.offset = 0;
+	TransformBufferInfo.range = sizeof(FTransformBufferObject);
+
+	VkWriteDescriptorSet TransformBufferDescriptor{};
+	TransformBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	TransformBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	TransformBufferDescriptor.pBufferInfo = &TransformBufferInfo;
+
+	VkDescriptorBufferInfo LightBufferInfo{};
+	LightBufferInfo.buffer = LightBuffers[InFrame]->GetHandle();
+	LightBufferInfo.offset = 0;
+	LightBufferInfo.range = sizeof(FLightBufferObject);
+
+	VkWriteDescriptorSet LightBufferDescriptor{};
+	LightBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	LightBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	LightBufferDescriptor.pBufferInfo = &LightBufferInfo;
+
+	VkDescriptorBufferInfo MaterialBufferInfo{};
+	MaterialBufferInfo.buffer = InMaterialBatch.MaterialBuffers[InFrame]->GetHandle();
+	MaterialBufferInfo.offset = 0;
+	MaterialBufferInfo.range = sizeof(FMaterialBufferObject);
+
+	VkWriteDescriptorSet MaterialBufferDescriptor{};
+	MaterialBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	MaterialBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	MaterialBufferDescriptor.pBufferInfo = &MaterialBufferInfo;
+
+	VkDescriptorBufferInfo DebugBufferInfo{};
+	DebugBufferInfo.buffer = DebugBuffers[InFrame]->GetHandle();
+	DebugBufferInfo.offset = 0;
+	DebugBufferInfo.range = sizeof(FDebugBufferObject);
+
+	VkWriteDescriptorSet DebugBufferDescriptor{};
+	DebugBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	DebugBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	DebugBufferDescriptor.pBufferInfo = &DebugBufferInfo;
+
+	VkDescriptorImageInfo BaseColorImageInfo{};
+	BaseColorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	BaseColorImageInfo.imageView = BaseColorView;
+	BaseColorImageInfo.sampler = Sampler->GetSampler();
+
+	VkWriteDescriptorSet BaseColorDescriptor{};
+	BaseColorDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	BaseColorDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	BaseColorDescriptor.pImageInfo = &BaseColorImageInfo;
+
+	VkDescriptorImageInfo NormalImageInfo{};
+	NormalImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	NormalImageInfo.imageView = NormalView;
+	NormalImageInfo.sampler = Sampler->GetSampler();
+
+	VkWriteDescriptorSet NormalDescriptor{};
+	NormalDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	NormalDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	NormalDescriptor.pImageInfo = &NormalImageInfo;
+
+	std::vector<VkWriteDescriptorSet> DescriptorWrites
+	{
+		TransformBufferDescriptor,
+		LightBufferDescriptor,
+		MaterialBufferDescriptor,
+		DebugBufferDescriptor,
+		BaseColorDescriptor,
+		NormalDescriptor
+	};
+
+	for (int j = 0; j < DescriptorWrites.size(); ++j)
+	{
+		DescriptorWrites[j].dstSet = InMaterialBatch.DescriptorSets[InFrame];
+		DescriptorWrites[j].dstArrayElement = 0;
+		DescriptorWrites[j].dstBinding = j;
+		DescriptorWrites[j].descriptorCount = 1;
+	}
+
+	vkUpdateDescriptorSets(Device, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
+}
+
+void FVulkanMeshRenderer::UpdateTextureBindings(FVulkanMesh* InMesh, FInstancedDrawingInfo& InDrawingInfo, uint32_t InFrame)
+{
+	for (uint32_t Slot = 0; Slot < InDrawingInfo.MaterialBatches.size(); ++Slot)
+	{
+		FVulkanMaterial* Material = InMesh->GetMaterial(Slot);
+		if (Material == nullptr)
+		{
+			continue;
+		}
+
+		FMaterialBatch& MaterialBatch = InDrawingInfo.MaterialBatches[Slot];
+		if (MaterialBatch.BaseColorViews[InFrame] != GetTextureView(Material->GetBaseColor().TexParam)
+			|| MaterialBatch.NormalViews[InFrame] != GetTextureView(Material->GetNormal().TexParam))
+		{
+			UpdateDescriptorSets(Material, MaterialBatch, InFrame);
+		}
+	}
+}
+
+void FVulkanMeshRenderer::UpdateCullDescriptorSet(const FInstancedDrawingInfo& InDrawingInfo, uint32_t InFrame)
+{
+	if (InFrame >= InDrawingInfo.CullDescriptorSets.size())
 	{
 		return;
 	}
 
-	static const glm::mat4 IdentityMatrix(1.0f);
+	VkDevice Device = Context->GetDevice();
 
-	FVulkanCamera Camera = Scene->GetCamera();
+	std::array<VkDescriptorBufferInfo, 3> BufferInfos{};
+	BufferInfos[0].buffer = InDrawingInfo.InstanceBuffers[InFrame]->GetHandle();
+	BufferInfos[0].offset = 0;
+	BufferInfos[0].range = VK_WHOLE_SIZE;
+	BufferInfos[1].buffer = InDrawingInfo.VisibleInstanceBuffers[InFrame]->GetHandle();
+	BufferInfos[1].offset = 0;
+	BufferInfos[1].range = VK_WHOLE_SIZE;
+	BufferInfos[2].buffer = InDrawingInfo.IndirectBuffers[InFrame]->GetHandle();
+	BufferInfos[2].offset = 0;
+	BufferInfos[2].range = VK_WHOLE_SIZE;
+
+	std::array<VkWriteDescriptorSet, 3> DescriptorWrites{};
+	for (int j = 0; j < DescriptorWrites.size(); ++j)
+	{
+		DescriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		DescriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		DescriptorWrites[j].pBufferInfo = &BufferInfos[j];
+		DescriptorWrites[j].dstSet = InDrawingInfo.CullDescriptorSets[InFrame];
+		DescriptorWrites[j].dstArrayElement = 0;
+		DescriptorWrites[j].dstBinding = j;
+		DescriptorWrites[j].descriptorCount = 1;
+	}
+
+	vkUpdateDescriptorSets(Device, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
+}
+
+void FVulkanMeshRenderer::CullInstances(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const FFrustum& InFrustum)
+{
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
+
+	const UMesh* MeshAsset = InMesh->GetMeshAsset();
+	const FSubmesh* Submeshes = MeshAsset->GetSubmeshes();
+
+	VkDrawIndexedIndirectCommand* Commands = (VkDrawIndexedIndirectCommand*)InDrawingInfo.IndirectBuffers[CurrentFrame]->GetMappedAddress();
+	for (uint32_t Idx = 0; Idx < MeshAsset->GetNumSubmeshes(); ++Idx)
+	{
+		Commands[Idx].indexCount = Submeshes[Idx].NumIndices;
+		Commands[Idx].instanceCount = static_cast<uint32_t>(InDrawingInfo.Models.size());
+		Commands[Idx].firstIndex = Submeshes[Idx].FirstIndex;
+		Commands[Idx].vertexOffset = static_cast<int32_t>(Submeshes[Idx].VertexOffset);
+		Commands[Idx].firstInstance = 0;
+	}
+
+	if (bEnableFrustumCulling == false)
+	{
+		return;
+	}
+
+	if (bEnableGPUCulling && CullPipeline != nullptr && InDrawingInfo.CullDescriptorSets.empty() == false)
+	{
+		CullInstancesOnGPU(InMesh, InDrawingInfo, InFrustum);
+	}
+	else
+	{
+		CullInstancesOnCPU(InMesh, InDrawingInfo, InFrustum);
+	}
+}
+
+void FVulkanMeshRenderer::CullInstancesOnCPU(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const FFrustum& InFrustum)
+{
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
+
+	const FBoundingSphere& LocalBounds = InDrawingInfo.CullBounds;
+	const std::vector<FVulkanModel*>& Models = InDrawingInfo.Models;
+
+	const FInstanceBuffer* SourceData = InDrawingInfo.InstanceData.data();
+	FInstanceBuffer* VisibleData = (FInstanceBuffer*)InDrawingInfo.VisibleInstanceBuffers[CurrentFrame]->GetMappedAddress();
 
-	glm::mat4 View = Camera.View;
+	// Each chunk culls its instances into its own range of the scratch arrays, so chunks can run on any worker.
+	constexpr uint32_t CullChunkSize = 1024;
 
-	FVulkanBuffer* InstanceBuffer = Iter->second.InstanceBuffers[Context->GetCurrentFrame()];
+	uint32_t NumModels = static_cast<uint32_t>(Models.size());
+	uint32_t NumChunks = (NumModels + CullChunkSize - 1) / CullChunkSize;
 
-	const std::vector<FVulkanModel*> Models = Iter->second.Models;
+	CullBounds.resize(NumModels);
+	CullSlots.resize(NumModels);
+	VisibleIndices.resize(NumModels);
+	CullChunkOffsets.assign(NumChunks + 1, 0);
+
+	auto CullChunks = [&](uint32_t InBegin, uint32_t InEnd)
 	{
-		std::vector<int> ModelIndices;
-		ModelIndices.resize(Models.size());
-		for (int Idx = 0; Idx < Models.size(); ++Idx)
+		for (uint32_t Chunk = InBegin; Chunk < InEnd; ++Chunk)
 		{
-			ModelIndices[Idx] = Idx;
+			uint32_t Begin = Chunk * CullChunkSize;
+			uint32_t End = std::min(Begin + CullChunkSize, NumModels);
+			uint32_t NumBounds = 0;
+
+			for (uint32_t Idx = Begin; Idx < End; ++Idx)
+			{
+				if (Models[Idx] != nullptr)
+				{
+					CullBounds[Begin + NumBounds] = LocalBounds.TransformBy(SourceData[Idx].Model);
+					CullSlots[Begin + NumBounds] = Idx;
+					++NumBounds;
+				}
+			}
+
+			CullChunkOffsets[Chunk + 1] = InFrustum.CullSpheres(&CullBounds[Begin], NumBounds, &VisibleIndices[Begin]);
 		}
+	};
 
-		std::for_each(std::execution::par, std::begin(ModelIndices), std::end(ModelIndices), [&View, &Models, &InstanceBuffer](int Idx)
+	// Packs the visible instances of each chunk behind those of the chunks before it, keeping instance order.
+	auto CopyChunks = [&](uint32_t InBegin, uint32_t InEnd)
+	{
+		for (uint32_t Chunk = InBegin; Chunk < InEnd; ++Chunk)
 		{
-			FVulkanModel* Model = Models[Idx];
-			if (Model == nullptr)
+			uint32_t Begin = Chunk * CullChunkSize;
+			uint32_t Offset = CullChunkOffsets[Chunk];
+			uint32_t NumChunkVisible = CullChunkOffsets[Chunk + 1] - Offset;
+
+			for (uint32_t Idx = 0; Idx < NumChunkVisible; ++Idx)
 			{
-				return;
+				VisibleData[Offset + Idx] = SourceData[CullSlots[Begin + VisibleIndices[Begin + Idx]]];
 			}
+		}
+	};
+
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelFor(NumChunks, 1, CullChunks);
+	}
+	else
+	{
+		CullChunks(0, NumChunks);
+	}
+
+	for (uint32_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+	{
+		CullChunkOffsets[Chunk + 1] += CullChunkOffsets[Chunk];
+	}
+
+	if (GJobSystem != nullptr)
+	{
+		GJobSystem->ParallelFor(NumChunks, 1, CopyChunks);
+	}
+	else
+	{
+		CopyChunks(0, NumChunks);
+	}
 
-			FInstanceBuffer* InstanceBufferData = (FInstanceBuffer*)InstanceBuffer->GetMappedAddress()  + Idx;
-			InstanceBufferData->Model = Model->GetModelMatrix();
-			InstanceBufferData->ModelView = View * InstanceBufferData->Model;
-			InstanceBufferData->NormalMatrix = glm::transpose(glm::inverse(glm::mat3(InstanceBufferData->ModelView)));
-		});
+	uint32_t NumVisible = CullChunkOffsets[NumChunks];
+
+	// Every submesh draws the same visible instances.
+	VkDrawIndexedIndirectCommand* Commands = (VkDrawIndexedIndirectCommand*)InDrawingInfo.IndirectBuffers[CurrentFrame]->GetMappedAddress();
+	for (uint32_t Idx = 0; Idx < InMesh->GetMeshAsset()->GetNumSubmeshes(); ++Idx)
+	{
+		Commands[Idx].instanceCount = NumVisible;
 	}
 }
 
-void FVulkanMeshRenderer::UpdateDescriptorSets()
+void FVulkanMeshRenderer::CullInstancesOnGPU(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const FFrustum& InFrustum)
 {
-	VkDevice Device = Context->GetDevice();
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
+	VkCommandBuffer CommandBuffer = Context->GetCommandBuffer();
+
+	VkDrawIndexedIndirectCommand* Command = (VkDrawIndexedIndirectCommand*)InDrawingInfo.IndirectBuffers[CurrentFrame]->GetMappedAddress();
+	Command->instanceCount = 0;
 
-	for (const auto& Pair : InstancedDrawingMap)
+	const FBoundingSphere& LocalBounds = InDrawingInfo.CullBounds;
+
+	FCullPushConstants PushConstants{};
+	for (int Idx = 0; Idx < FFrustum::NumPlanes; ++Idx)
 	{
-		FVulkanMesh* Mesh = static_cast<FVulkanMesh*>(Pair.first);
-		if (Mesh == nullptr)
-		{
-			continue;
-		}
+		PushConstants.Planes[Idx] = InFrustum.GetPlanes()[Idx];
+	}
+	PushConstants.BoundingSphere = glm::vec4(LocalBounds.Center, LocalBounds.Radius);
+	PushConstants.NumInstances = static_cast<uint32_t>(InDrawingInfo.Models.size());
 
-		FVulkanMaterial* Material = Mesh->GetMaterial();
-		if (Material == nullptr)
-		{
-			continue;
-		}
+	VkDescriptorSet DescriptorSet = InDrawingInfo.CullDescriptorSets[CurrentFrame];
 
-		UTexture* BaseColorTextureAsset = Material->GetBaseColor().TexParam;
-		if (BaseColorTextureAsset == nullptr)
-		{
-			continue;
-		}
+	vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, CullPipeline->GetPipeline());
+	vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, CullPipeline->GetLayout(), 0, 1, &DescriptorSet, 0, nullptr);
+	vkCmdPushConstants(CommandBuffer, CullPipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(FCullPushConstants), &PushConstants);
+	vkCmdDispatch(CommandBuffer, (PushConstants.NumInstances + CullWorkGroupSize - 1) / CullWorkGroupSize, 1, 1);
 
-		FVulkanTexture* BaseColorTexture = BaseColorTextureAsset->GetRenderTexture();
-		if (BaseColorTexture == nullptr)
-		{
-			continue;
-		}
+	VkPipelineStageFlags SrcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
-		UTexture* NormalTextureAsset = Material->GetNormal().TexParam;
-		if (NormalTextureAsset == nullptr)
-		{
-			continue;
-		}
+	VkMemoryBarrier Barrier{};
+	Barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	Barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	Barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
 
-		FVulkanTexture* NormalTexture = NormalTextureAsset->GetRenderTexture();
-		if (NormalTexture == nullptr)
+	// The shader only counts into the first command; the other submeshes copy its instance count.
+	uint32_t NumCommands = InMesh->GetMeshAsset()->GetNumSubmeshes();
+	if (NumCommands > 1)
+	{
+		VkMemoryBarrier CopyBarrier{};
+		CopyBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		CopyBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		CopyBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		vkCmdPipelineBarrier(
+			CommandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			1, &CopyBarrier,
+			0, nullptr,
+			0, nullptr);
+
+		CullCopyRegions.resize(NumCommands - 1);
+		for (uint32_t Idx = 1; Idx < NumCommands; ++Idx)
 		{
-			continue;
+			VkBufferCopy& Region = CullCopyRegions[Idx - 1];
+			Region.srcOffset = offsetof(VkDrawIndexedIndirectCommand, instanceCount);
+			Region.dstOffset = sizeof(VkDrawIndexedIndirectCommand) * Idx + offsetof(VkDrawIndexedIndirectCommand, instanceCount);
+			Region.size = sizeof(uint32_t);
 		}
 
-		const std::vector<VkDescriptorSet>& DescriptorSets = Pair.second.DescriptorSets;
-
-		for (int32_t i = 0; i < DescriptorSets.size(); ++i)
-		{
-			VkDescriptorBufferInfo TransformBufferInfo{};
-			TransformBufferInfo.buffer = TransformBuffers[i]->GetHandle();
-			TransformBufferInfo.offset = 0;
-			TransformBufferInfo.range = sizeof(FTransformBufferObject);
-
-			VkWriteDescriptorSet TransformBufferDescriptor{};
-			TransformBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			TransformBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			TransformBufferDescriptor.pBufferInfo = &TransformBufferInfo;
-
-			VkDescriptorBufferInfo LightBufferInfo{};
-			LightBufferInfo.buffer = LightBuffers[i]->GetHandle();
-			LightBufferInfo.offset = 0;
-			LightBufferInfo.range = sizeof(FLightBufferObject);
-
-			VkWriteDescriptorSet LightBufferDescriptor{};
-			LightBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			LightBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			LightBufferDescriptor.pBufferInfo = &LightBufferInfo;
-
-			VkDescriptorBufferInfo MaterialBufferInfo{};
-			MaterialBufferInfo.buffer = MaterialBuffers[i]->GetHandle();
-			MaterialBufferInfo.offset = 0;
-			MaterialBufferInfo.range = sizeof(FMaterialBufferObject);
-
-			VkWriteDescriptorSet MaterialBufferDescriptor{};
-			MaterialBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			MaterialBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			MaterialBufferDescriptor.pBufferInfo = &MaterialBufferInfo;
-
-			VkDescriptorBufferInfo DebugBufferInfo{};
-			DebugBufferInfo.buffer = DebugBuffers[i]->GetHandle();
-			DebugBufferInfo.offset = 0;
-			DebugBufferInfo.range = sizeof(FDebugBufferObject);
-
-			VkWriteDescriptorSet DebugBufferDescriptor{};
-			DebugBufferDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			DebugBufferDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			DebugBufferDescriptor.pBufferInfo = &DebugBufferInfo;
-
-			VkDescriptorImageInfo BaseColorImageInfo{};
-			BaseColorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			BaseColorImageInfo.imageView = BaseColorTexture->GetImage()->GetView();
-			BaseColorImageInfo.sampler = Sampler->GetSampler();
-
-			VkWriteDescriptorSet BaseColorDescriptor{};
-			BaseColorDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			BaseColorDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			BaseColorDescriptor.pImageInfo = &BaseColorImageInfo;
-
-			VkDescriptorImageInfo NormalImageInfo{};
-			NormalImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			NormalImageInfo.imageView = NormalTexture->GetImage()->GetView();
-			NormalImageInfo.sampler = Sampler->GetSampler();
-
-			VkWriteDescriptorSet NormalDescriptor{};
-			NormalDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			NormalDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			NormalDescriptor.pImageInfo = &NormalImageInfo;
-
-			std::vector<VkWriteDescriptorSet> DescriptorWrites
-			{
-				TransformBufferDescriptor,
-				LightBufferDescriptor,
-				MaterialBufferDescriptor,
-				DebugBufferDescriptor,
-				BaseColorDescriptor,
-				NormalDescriptor
-			};
-
-			for (int j = 0; j < DescriptorWrites.size(); ++j)
-			{
-				DescriptorWrites[j].dstSet = DescriptorSets[i];
-				DescriptorWrites[j].dstArrayElement = 0;
-				DescriptorWrites[j].dstBinding = j;
-				DescriptorWrites[j].descriptorCount = 1;
-			}
+		VkBuffer IndirectBuffer = InDrawingInfo.IndirectBuffers[CurrentFrame]->GetHandle();
+		vkCmdCopyBuffer(CommandBuffer, IndirectBuffer, IndirectBuffer, static_cast<uint32_t>(CullCopyRegions.size()), CullCopyRegions.data());
 
-			vkUpdateDescriptorSets(Device, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
-		}
+		SrcStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+		Barrier.srcAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
 	}
+
+	vkCmdPipelineBarrier(
+		CommandBuffer,
+		SrcStageMask,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		0,
+		1, &Barrier,
+		0, nullptr,
+		0, nullptr);
 }
 
 void FVulkanMeshRenderer::PreRender()
@@ -849,15 +1393,42 @@ void FVulkanMeshRenderer::PreRender()
 
 void FVulkanMeshRenderer::Render()
 {
-	if (bInitialized == false)
+	SyncSceneModels();
+
+	UpdateUniformBuffer();
+
+	if (TextureStreamer->IsEnabled())
+	{
+		TextureStreamer->Update(Scene, static_cast<float>(Context->GetSwapchain()->GetExtent().height));
+	}
+
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
+
+	DrawBatches.clear();
+
+	for (auto& Pair : InstancedDrawingMap)
 	{
-		GenerateInstancedDrawingInfo();
+		FVulkanMesh* Mesh = Pair.first;
+		FInstancedDrawingInfo& DrawingInfo = Pair.second;
+		if (Mesh == nullptr)
+		{
+			continue;
+		}
 
-		CreateGraphicsPipelines();
-		CreateInstanceBuffers();
-		CreateDescriptorSets();
+		// Also done for meshes without instances, so none of their sets outlives an image the streamer replaced.
+		UpdateTextureBindings(Mesh, DrawingInfo, CurrentFrame);
 
-		bInitialized = true;
+		if (DrawingInfo.ModelSlots.empty() || Mesh->GetMeshAsset() == nullptr)
+		{
+			continue;
+		}
+
+		ReserveInstanceBuffers(Mesh, DrawingInfo, CurrentFrame);
+		UpdateInstanceBuffer(DrawingInfo);
+		CullInstances(Mesh, DrawingInfo, ViewFrustum);
+		UpdateMaterialBuffers(Mesh, DrawingInfo);
+
+		DrawBatches.push_back({ Mesh, &DrawingInfo });
 	}
 
 	VkCommandBuffer CommandBuffer = Context->GetCommandBuffer();
@@ -873,8 +1444,9 @@ void FVulkanMeshRenderer::Render()
 	ClearValues[1].depthStencil = { 1.0f, 0 };
 
 	uint32_t CurrentImageIndex = Swapchain->GetCurrentImageIndex();
+	FVulkanFramebuffer* Framebuffer = Framebuffers[CurrentImageIndex];
 
-	RenderPass->Begin(CommandBuffer, Framebuffers[CurrentImageIndex], RenderArea, ClearValues);
+	RenderPass->Begin(CommandBuffer, Framebuffer, RenderArea, ClearValues, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
 	VkExtent2D SwapchainExtent = Context->GetSwapchain()->GetExtent();
 
@@ -890,69 +1462,103 @@ void FVulkanMeshRenderer::Render()
 	Scissor.offset = { 0, 0 };
 	Scissor.extent = SwapchainExtent;
 
-	UpdateUniformBuffer();
-
-	for (const auto& Pair : InstancedDrawingMap)
-	{
-		FVulkanMesh* Mesh = Pair.first;
-		const FInstancedDrawingInfo& DrawingInfo = Pair.second;
-
-		if (Mesh == nullptr)
+	VkCommandBufferInheritanceInfo InheritanceInfo{};
+	InheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	InheritanceInfo.renderPass = RenderPass->GetHandle();
+	InheritanceInfo.subpass = 0;
+	InheritanceInfo.framebuffer = Framebuffer->GetHandle();
+
+	// Batches are partitioned across the recorder's workers; everything they read was finalized above.
+	FVulkanCommandRecorder* CommandRecorder = Context->GetCommandRecorder();
+	CommandRecorder->Record(
+		static_cast<uint32_t>(DrawBatches.size()),
+		InheritanceInfo,
+		[this, &Viewport, &Scissor](VkCommandBuffer InCommandBuffer, uint32_t InBegin, uint32_t InEnd)
 		{
-			continue;
-		}
+			for (uint32_t Idx = InBegin; Idx < InEnd; ++Idx)
+			{
+				Draw(InCommandBuffer, DrawBatches[Idx].first, *DrawBatches[Idx].second, Viewport, Scissor);
+			}
+		},
+		SecondaryCommandBuffers);
 
-		UpdateMaterialBuffer(Mesh);
-		Draw(Mesh, DrawingInfo, Viewport, Scissor);
+	if (SecondaryCommandBuffers.empty() == false)
+	{
+		vkCmdExecuteCommands(CommandBuffer, static_cast<uint32_t>(SecondaryCommandBuffers.size()), SecondaryCommandBuffers.data());
 	}
 
 	RenderPass->End(CommandBuffer);
 }
 
 void FVulkanMeshRenderer::Draw(
+	VkCommandBuffer InCommandBuffer,
 	FVulkanMesh* InMesh,
 	const FInstancedDrawingInfo& InDrawingInfo,
-	VkViewport& InViewport,
-	VkRect2D& InScissor)
+	const VkViewport& InViewport,
+	const VkRect2D& InScissor) const
 {
 	if (InMesh == nullptr)
 	{
 		return;
 	}
 
-	FVulkanPipeline* Pipeline = InDrawingInfo.Pipeline;
-	if (Pipeline == nullptr)
+	const UMesh* MeshAsset = InMesh->GetMeshAsset();
+	if (MeshAsset == nullptr || InDrawingInfo.MaterialBatches.empty())
 	{
 		return;
 	}
 
-	uint32_t CurrentFrame = Context->GetCurrentFrame();
-	VkCommandBuffer CommandBuffer = Context->GetCommandBuffer();
+	const FSubmesh* Submeshes = MeshAsset->GetSubmeshes();
+	uint32_t NumSubmeshes = MeshAsset->GetNumSubmeshes();
+	uint32_t LastSlot = static_cast<uint32_t>(InDrawingInfo.MaterialBatches.size()) - 1;
 
-	vkCmdSetViewport(CommandBuffer, 0, 1, &InViewport);
-	vkCmdSetScissor(CommandBuffer, 0, 1, &InScissor);
+	uint32_t CurrentFrame = Context->GetCurrentFrame();
 
-	UpdateInstanceBuffer(InMesh);
+	vkCmdSetViewport(InCommandBuffer, 0, 1, &InViewport);
+	vkCmdSetScissor(InCommandBuffer, 0, 1, &InScissor);
 
-	FVulkanBuffer* InstanceBuffer = InDrawingInfo.InstanceBuffers[CurrentFrame];
-	VkDescriptorSet DescriptorSet = InDrawingInfo.DescriptorSets[CurrentFrame];
+	FVulkanBuffer* InstanceBuffer = bEnableFrustumCulling ? InDrawingInfo.VisibleInstanceBuffers[CurrentFrame] : InDrawingInfo.InstanceBuffers[CurrentFrame];
+	FVulkanBuffer* IndirectBuffer = InDrawingInfo.IndirectBuffers[CurrentFrame];
 
 	VkBuffer VertexBuffers[] = { InMesh->GetVertexBuffer()->GetHandle(), InstanceBuffer->GetHandle() };
 	VkDeviceSize Offsets[] = { 0, 0 };
-	vkCmdBindVertexBuffers(CommandBuffer, 0, 2, VertexBuffers, Offsets);
-	vkCmdBindIndexBuffer(CommandBuffer, InMesh->GetIndexBuffer()->GetHandle(), 0, VK_INDEX_TYPE_UINT32);
-
-	uint32_t NumIndices = static_cast<uint32_t>(InMesh->GetMeshAsset()->GetIndices().size());
-	uint32_t NumModels = static_cast<uint32_t>(InDrawingInfo.Models.size());
+	vkCmdBindVertexBuffers(InCommandBuffer, 0, 2, VertexBuffers, Offsets);
+	vkCmdBindIndexBuffer(InCommandBuffer, InMesh->GetIndexBuffer()->GetHandle(), 0, InMesh->GetIndexType());
 
-	if (bEnableTBNVisualization)
+	if (bEnableTBNVisualization && InDrawingInfo.MaterialBatches[0].IsDescriptorSetWritten(CurrentFrame))
 	{
-		vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, TBNPipeline->GetPipeline());
-		vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, TBNPipeline->GetLayout(), 0, 1, &DescriptorSet, 0, nullptr);
-		vkCmdDrawIndexed(CommandBuffer, NumIndices, NumModels, 0, 0, 0);
+		VkDescriptorSet DescriptorSet = InDrawingInfo.MaterialBatches[0].DescriptorSets[CurrentFrame];
+
+		FVulkanPipeline* TBNPipeline = TBNPipelines[static_cast<size_t>(InMesh->GetVertexFormat())];
+
+		vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, TBNPipeline->GetPipeline());
+		vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, TBNPipeline->GetLayout(), 0, 1, &DescriptorSet, 0, nullptr);
+		for (uint32_t Idx = 0; Idx < NumSubmeshes; ++Idx)
+		{
+			vkCmdDrawIndexedIndirect(InCommandBuffer, IndirectBuffer->GetHandle(), sizeof(VkDrawIndexedIndirectCommand) * Idx, 1, sizeof(VkDrawIndexedIndirectCommand));
+		}
 	}
 
-	vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetPipeline());
-	vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetLayout(), 0, 1, &DescriptorSet, 0, nullptr);
-	vkCmdDrawIndexed(CommandBuffer, NumIndices, NumModels, 0, 0, 0);
+	// Submeshes are sorted by material slot, so pipeline and descriptor set are bound once per slot.
+	// The device does not enable multiDrawIndirect, hence one indirect draw per submesh.
+	uint32_t BoundSlot = UINT32_MAX;
+	for (uint32_t Idx = 0; Idx < NumSubmeshes; ++Idx)
+	{
+		uint32_t Slot = std::min(Submeshes[Idx].MaterialSlot, LastSlot);
+		const FMaterialBatch& MaterialBatch = InDrawingInfo.MaterialBatches[Slot];
+		if (MaterialBatch.Pipeline == nullptr || MaterialBatch.IsDescriptorSetWritten(CurrentFrame) == false)
+		{
+			continue;
+		}
+
+		if (Slot != BoundSlot)
+		{
+			VkDescriptorSet DescriptorSet = MaterialBatch.DescriptorSets[CurrentFrame];
+			vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, MaterialBatch.Pipeline->GetPipeline());
+			vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, MaterialBatch.Pipeline->GetLayout(), 0, 1, &DescriptorSet, 0, nullptr);
+			BoundSlot = Slot;
+		}
+
+		vkCmdDrawIndexedIndirect(InCommandBuffer, IndirectBuffer->GetHandle(), sizeof(VkDrawIndexedIndirectCommand) * Idx, 1, sizeof(VkDrawIndexedIndirectCommand));
+	}
 }
@@ -11,10 +11,17 @@
 #include "glm/glm.hpp"
 
 #include "Vertex.h"
+#include "Frustum.h"
 
 #include <vector>
 #include <unordered_map>
 
+struct FInstanceBuffer
+{
+	alignas(16) glm::mat4 Model;
+	alignas(16) glm::mat4 NormalMatrix;
+};
+
 class FVulkanMeshRenderer : public FVulkanRenderer
 {
 public:
@@ -30,57 +37,115 @@ public:
 	void SetEnableAttenuation(bool bEnabled) { bEnableAttenuation = bEnabled; }
 	void SetEnableGammaCorrection(bool bEnabled) { bEnableGammaCorrection = bEnabled; }
 	void SetEnableToneMapping(bool bEnabled) { bEnableToneMapping = bEnabled; }
+	void SetEnableFrustumCulling(bool bEnabled) { bEnableFrustumCulling = bEnabled; }
+	void SetEnableGPUCulling(bool bEnabled) { bEnableGPUCulling = bEnabled && CullPipeline != nullptr; }
+
+	// Releases the per-mesh drawing resources before InMesh is destroyed. Frames in flight must not use the mesh anymore.
+	void RemoveMesh(FVulkanMesh* InMesh);
 
 protected:
-	void GenerateInstancedDrawingInfo();
+	void SyncSceneModels();
+	void AddModel(FVulkanModel* InModel);
+	void RemoveModel(FVulkanModel* InModel);
 
 	void CreateRenderPass();
 	void CreateFramebuffers();
 	void CreateDescriptorSetLayout();
-	void CreateGraphicsPipelines();
-	void CreateTBNPipeline();
+	void CreateTBNPipelines();
+	void CreateCullDescriptorSetLayout();
+	void CreateCullPipeline();
 	void CreateTextureSampler();
 	void CreateUniformBuffers();
-	void CreateInstanceBuffers();
-	void CreateDescriptorSets();
 
-	void GetVertexInputBindings(std::vector<VkVertexInputBindingDescription>& OutDescs);
-	void GetVertexInputAttributes(std::vector<VkVertexInputAttributeDescription>& OutDescs);
+	void GetVertexInputBindings(EVertexFormat InVertexFormat, std::vector<VkVertexInputBindingDescription>& OutDescs);
+	void GetVertexInputAttributes(EVertexFormat InVertexFormat, std::vector<VkVertexInputAttributeDescription>& OutDescs);
 
 	void UpdateUniformBuffer();
-	void UpdateMaterialBuffer(FVulkanMesh* InMesh);
-	void UpdateInstanceBuffer(FVulkanMesh* InMesh);
-	void UpdateDescriptorSets();
 
+	// Per material slot of a mesh. Submeshes using the slot share its pipeline, descriptor sets and material buffers.
+	struct FMaterialBatch
+	{
+		class FVulkanPipeline* Pipeline = nullptr;
+		std::vector<VkDescriptorSet> DescriptorSets;
+		std::vector<FVulkanBuffer*> MaterialBuffers;
+		// Texture views written into each frame's descriptor set. A streamed texture changes its view, and each
+		// frame's set is only rewritten once that frame is no longer in flight.
+		std::vector<VkImageView> BaseColorViews;
+		std::vector<VkImageView> NormalViews;
+
+		// Null views mean the frame's set has not been written yet, e.g. while its textures are still loading.
+		bool IsDescriptorSetWritten(uint32_t InFrame) const
+		{
+			return InFrame < DescriptorSets.size() && BaseColorViews[InFrame] != VK_NULL_HANDLE && NormalViews[InFrame] != VK_NULL_HANDLE;
+		}
+	};
+
+	// All submeshes of a mesh share the instance buffers; the indirect buffer holds one command per submesh.
 	struct FInstancedDrawingInfo
 	{
-		class FVulkanPipeline* Pipeline;
+		std::vector<FMaterialBatch> MaterialBatches;
+		glm::mat4 DequantizationMatrix;
+		// Mesh bounds in the space of the vertex buffer, i.e. before dequantization.
+		FBoundingSphere CullBounds;
 		std::vector<FVulkanModel*> Models;
+		std::unordered_map<FVulkanModel*, uint32_t> ModelSlots;
+		std::vector<uint32_t> FreeSlots;
+		std::vector<FInstanceBuffer> InstanceData;
+		std::vector<uint64_t> InstanceGenerations;
+		std::vector<std::vector<uint64_t>> UploadedGenerations;
 		std::vector<FVulkanBuffer*> InstanceBuffers;
-		std::vector<VkDescriptorSet> DescriptorSets;
+		std::vector<FVulkanBuffer*> VisibleInstanceBuffers;
+		std::vector<FVulkanBuffer*> IndirectBuffers;
+		std::vector<uint32_t> InstanceCapacities;
+		std::vector<VkDescriptorSet> CullDescriptorSets;
 	};
-	void Draw(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, VkViewport& InViewport, VkRect2D& InScissor);
+	FInstancedDrawingInfo& FindOrCreateDrawingInfo(FVulkanMesh* InMesh);
+	void CreateGraphicsPipeline(FVulkanMaterial* InMaterial, EVertexFormat InVertexFormat, FMaterialBatch& InMaterialBatch);
+	void CreateDescriptorSets(FVulkanMesh* InMesh, FInstancedDrawingInfo& InDrawingInfo);
+	void ReserveInstanceBuffers(FVulkanMesh* InMesh, FInstancedDrawingInfo& InDrawingInfo, uint32_t InFrame);
+	void UpdateInstanceBuffer(FInstancedDrawingInfo& InDrawingInfo);
+	void UpdateMaterialBuffers(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo);
+	void UpdateDescriptorSets(FVulkanMaterial* InMaterial, FMaterialBatch& InMaterialBatch, uint32_t InFrame);
+	void UpdateTextureBindings(FVulkanMesh* InMesh, FInstancedDrawingInfo& InDrawingInfo, uint32_t InFrame);
+	void UpdateCullDescriptorSet(const FInstancedDrawingInfo& InDrawingInfo, uint32_t InFrame);
+	void CullInstances(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const FFrustum& InFrustum);
+	void CullInstancesOnCPU(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const FFrustum& InFrustum);
+	void CullInstancesOnGPU(FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const FFrustum& InFrustum);
+	void Draw(VkCommandBuffer InCommandBuffer, FVulkanMesh* InMesh, const FInstancedDrawingInfo& InDrawingInfo, const VkViewport& InViewport, const VkRect2D& InScissor) const;
 
 protected:
 	std::vector<class FVulkanFramebuffer*> Framebuffers;
 
-	class FVulkanPipeline* TBNPipeline;
+	std::vector<class FVulkanPipeline*> TBNPipelines;
+	class FVulkanPipeline* CullPipeline;
 
 	VkDescriptorSetLayout DescriptorSetLayout;
+	VkDescriptorSetLayout CullDescriptorSetLayout;
 
 	std::unordered_map<FVulkanMesh*, FInstancedDrawingInfo> InstancedDrawingMap;
 
+	std::vector<std::pair<FVulkanMesh*, const FInstancedDrawingInfo*>> DrawBatches;
+	std::vector<VkCommandBuffer> SecondaryCommandBuffers;
+
 	std::vector<FVulkanBuffer*> TransformBuffers;
 	std::vector<FVulkanBuffer*> LightBuffers;
-	std::vector<FVulkanBuffer*> MaterialBuffers;
 	std::vector<FVulkanBuffer*> DebugBuffers;
 
 	class FVulkanSampler* Sampler;
+	class FVulkanTextureStreamer* TextureStreamer;
+
+	FFrustum ViewFrustum;
+	std::vector<FBoundingSphere> CullBounds;
+	std::vector<uint32_t> CullSlots;
+	std::vector<uint32_t> VisibleIndices;
+	std::vector<uint32_t> CullChunkOffsets;
+	std::vector<VkBufferCopy> CullCopyRegions;
 
-	bool bInitialized;
 	bool bEnableTBNVisualization;
 	bool bEnableAttenuation;
 	bool bEnableGammaCorrection;
 	bool bEnableToneMapping;
+	bool bEnableFrustumCulling;
+	bool bEnableGPUCulling;
 };
 
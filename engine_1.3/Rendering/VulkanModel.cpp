@@ -8,5 +8,6 @@ FVulkanModel::FVulkanModel(class FVulkanContext* InContext)
 	: FVulkanObject(InContext)
 	, Mesh(nullptr)
 	, Model(1.0f)
+	, Generation(1)
 {
 }
@@ -15,10 +15,13 @@ public:
 	void SetMesh(class FVulkanMesh* InMesh) { Mesh = InMesh; }
 
 	glm::mat4 GetModelMatrix() const { return Model; }
-	void SetModelMatrix(const glm::mat4& InModel) { Model = InModel; }
+	void SetModelMatrix(const glm::mat4& InModel) { Model = InModel; ++Generation; }
+
+	uint64_t GetGeneration() const { return Generation; }
 
 protected:
 	class FVulkanMesh* Mesh;
 
 	glm::mat4 Model;
+	uint64_t Generation;
 };
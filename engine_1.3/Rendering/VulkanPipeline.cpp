@@ -1,6 +1,7 @@
 #include "VulkanPipeline.h"
 #include "VulkanContext.h"
 #include "VulkanHelpers.h"
+#include "VulkanPipelineCache.h"
 
 FVulkanPipeline::FVulkanPipeline(FVulkanContext* InContext)
 	: FVulkanObject(InContext)
@@ -39,5 +40,18 @@ void FVulkanPipeline::CreatePipeline(const VkGraphicsPipelineCreateInfo& CI)
 {
 	VkDevice Device = Context->GetDevice();
 
-	VK_ASSERT(vkCreateGraphicsPipelines(Device, VK_NULL_HANDLE, 1, &CI, nullptr, &Pipeline));
+	FVulkanPipelineCache* PipelineCache = Context->GetPipelineCache();
+	VkPipelineCache Cache = PipelineCache != nullptr ? PipelineCache->GetHandle() : VK_NULL_HANDLE;
+
+	VK_ASSERT(vkCreateGraphicsPipelines(Device, Cache, 1, &CI, nullptr, &Pipeline));
+}
+
+void FVulkanPipeline::CreatePipeline(const VkComputePipelineCreateInfo& CI)
+{
+	VkDevice Device = Context->GetDevice();
+
+	FVulkanPipelineCache* PipelineCache = Context->GetPipelineCache();
+	VkPipelineCache Cache = PipelineCache != nullptr ? PipelineCache->GetHandle() : VK_NULL_HANDLE;
+
+	VK_ASSERT(vkCreateComputePipelines(Device, Cache, 1, &CI, nullptr, &Pipeline));
 }
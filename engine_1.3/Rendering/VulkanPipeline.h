@@ -23,6 +23,7 @@ public:
 
 	void CreateLayout(const VkPipelineLayoutCreateInfo& CI);
 	void CreatePipeline(const VkGraphicsPipelineCreateInfo& CI);
+	void CreatePipeline(const VkComputePipelineCreateInfo& CI);
 
 private:
 	VkPipelineLayout Layout;
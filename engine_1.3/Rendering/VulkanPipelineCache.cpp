@@ -0,0 +1,378 @@
+#include "VulkanPipelineCache.h"
+#include "VulkanContext.h"
+#include "VulkanHelpers.h"
+#include "VulkanPipeline.h"
+#include "VulkanShader.h"
+
+#include "Utils.h"
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+FVulkanPipelineCache::FVulkanPipelineCache(FVulkanContext* InContext)
+	: FVulkanObject(InContext)
+	, Cache(VK_NULL_HANDLE)
+{
+
+}
+
+void FVulkanPipelineCache::Destroy()
+{
+	VkDevice Device = Context->GetDevice();
+
+	if (Cache != VK_NULL_HANDLE)
+	{
+		Save();
+		vkDestroyPipelineCache(Device, Cache, nullptr);
+		Cache = VK_NULL_HANDLE;
+	}
+
+	GraphicsPipelines.clear();
+}
+
+static bool IsCompatibleCacheData(VkPhysicalDevice InPhysicalDevice, const std::vector<char>& InData)
+{
+	if (InData.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+	{
+		return false;
+	}
+
+	VkPipelineCacheHeaderVersionOne Header;
+	memcpy(&Header, InData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+	VkPhysicalDeviceProperties Properties;
+	vkGetPhysicalDeviceProperties(InPhysicalDevice, &Properties);
+
+	return Header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+		&& Header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		&& Header.vendorID == Properties.vendorID
+		&& Header.deviceID == Properties.deviceID
+		&& memcmp(Header.pipelineCacheUUID, Properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void FVulkanPipelineCache::Load(const std::string& InFilename)
+{
+	VkDevice Device = Context->GetDevice();
+
+	if (Cache != VK_NULL_HANDLE)
+	{
+		vkDestroyPipelineCache(Device, Cache, nullptr);
+		Cache = VK_NULL_HANDLE;
+	}
+
+	Filename = InFilename;
+
+	std::vector<char> InitialData;
+	if (Filename.empty() == false && ReadFile(Filename, InitialData))
+	{
+		if (IsCompatibleCacheData(Context->GetPhysicalDevice(), InitialData) == false)
+		{
+			std::cerr << "Discarding incompatible pipeline cache " << Filename << std::endl;
+			InitialData.clear();
+		}
+	}
+
+	VkPipelineCacheCreateInfo PipelineCacheCI{};
+	PipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	PipelineCacheCI.initialDataSize = InitialData.size();
+	PipelineCacheCI.pInitialData = InitialData.empty() ? nullptr : InitialData.data();
+
+	VK_ASSERT(vkCreatePipelineCache(Device, &PipelineCacheCI, nullptr, &Cache));
+}
+
+bool FVulkanPipelineCache::Save() const
+{
+	if (Cache == VK_NULL_HANDLE || Filename.empty())
+	{
+		return false;
+	}
+
+	VkDevice Device = Context->GetDevice();
+
+	size_t DataSize = 0;
+	if (vkGetPipelineCacheData(Device, Cache, &DataSize, nullptr) != VK_SUCCESS || DataSize == 0)
+	{
+		return false;
+	}
+
+	std::vector<char> Data(DataSize);
+	if (vkGetPipelineCacheData(Device, Cache, &DataSize, Data.data()) != VK_SUCCESS)
+	{
+		return false;
+	}
+	Data.resize(DataSize);
+
+	return WriteFile(Filename, Data);
+}
+
+FVulkanPipeline* FVulkanPipelineCache::FindOrCreateGraphicsPipeline(
+	const VkPipelineLayoutCreateInfo& InLayoutCI,
+	const VkGraphicsPipelineCreateInfo& InPipelineCI,
+	const std::vector<const FVulkanShader*>& InStageShaders)
+{
+	if (InStageShaders.size() != InPipelineCI.stageCount)
+	{
+		return nullptr;
+	}
+
+	for (const FVulkanShader* Shader : InStageShaders)
+	{
+		if (Shader == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	FGraphicsPipelineKey Key = MakeGraphicsPipelineKey(InLayoutCI, InPipelineCI, InStageShaders);
+
+	auto Iter = GraphicsPipelines.find(Key);
+	if (Iter != GraphicsPipelines.end() && Context->IsValidObject(Iter->second))
+	{
+		return Iter->second;
+	}
+
+	FVulkanPipeline* Pipeline = Context->CreateObject<FVulkanPipeline>();
+	Pipeline->CreateLayout(InLayoutCI);
+
+	VkGraphicsPipelineCreateInfo PipelineCI = InPipelineCI;
+	PipelineCI.layout = Pipeline->GetLayout();
+
+	Pipeline->CreatePipeline(PipelineCI);
+
+	GraphicsPipelines[std::move(Key)] = Pipeline;
+
+	return Pipeline;
+}
+
+namespace
+{
+	class FKeyWriter
+	{
+	public:
+		explicit FKeyWriter(std::vector<uint8_t>& InBytes)
+			: Bytes(InBytes)
+		{
+		}
+
+		template <typename T>
+		void Write(const T& InValue)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Key fields are written as raw bytes.");
+			WriteBytes(&InValue, sizeof(T));
+		}
+
+		// Length prefixed, so adjacent variable-length fields cannot be confused.
+		void WriteArray(const void* InData, size_t InSize)
+		{
+			Write(static_cast<uint64_t>(InSize));
+			WriteBytes(InData, InSize);
+		}
+
+	private:
+		void WriteBytes(const void* InData, size_t InSize)
+		{
+			if (InSize == 0)
+			{
+				return;
+			}
+
+			const uint8_t* Data = static_cast<const uint8_t*>(InData);
+			Bytes.insert(Bytes.end(), Data, Data + InSize);
+		}
+
+		std::vector<uint8_t>& Bytes;
+	};
+}
+
+FGraphicsPipelineKey FVulkanPipelineCache::MakeGraphicsPipelineKey(
+	const VkPipelineLayoutCreateInfo& InLayoutCI,
+	const VkGraphicsPipelineCreateInfo& InPipelineCI,
+	const std::vector<const FVulkanShader*>& InStageShaders)
+{
+	FGraphicsPipelineKey Key;
+	FKeyWriter Writer(Key.Bytes);
+
+	Writer.Write(InLayoutCI.setLayoutCount);
+	for (uint32_t Idx = 0; Idx < InLayoutCI.setLayoutCount; ++Idx)
+	{
+		Writer.Write(InLayoutCI.pSetLayouts[Idx]);
+	}
+
+	Writer.Write(InLayoutCI.pushConstantRangeCount);
+	for (uint32_t Idx = 0; Idx < InLayoutCI.pushConstantRangeCount; ++Idx)
+	{
+		const VkPushConstantRange& Range = InLayoutCI.pPushConstantRanges[Idx];
+		Writer.Write(Range.stageFlags);
+		Writer.Write(Range.offset);
+		Writer.Write(Range.size);
+	}
+
+	Writer.Write(InPipelineCI.stageCount);
+	for (uint32_t Idx = 0; Idx < InPipelineCI.stageCount; ++Idx)
+	{
+		const VkPipelineShaderStageCreateInfo& Stage = InPipelineCI.pStages[Idx];
+		const FVulkanShader* Shader = Idx < InStageShaders.size() ? InStageShaders[Idx] : nullptr;
+
+		Writer.Write(Stage.stage);
+		Writer.Write(Shader != nullptr ? Shader->GetCodeHash() : 0);
+		Writer.Write(static_cast<uint64_t>(Shader != nullptr ? Shader->GetCodeSize() : 0));
+
+		const char* EntryPoint = Stage.pName != nullptr ? Stage.pName : "";
+		Writer.WriteArray(EntryPoint, strlen(EntryPoint));
+
+		const VkSpecializationInfo* Specialization = Stage.pSpecializationInfo;
+		Writer.Write(Specialization != nullptr ? Specialization->mapEntryCount : 0);
+		if (Specialization != nullptr)
+		{
+			for (uint32_t EntryIdx = 0; EntryIdx < Specialization->mapEntryCount; ++EntryIdx)
+			{
+				const VkSpecializationMapEntry& Entry = Specialization->pMapEntries[EntryIdx];
+				Writer.Write(Entry.constantID);
+				Writer.Write(Entry.offset);
+				Writer.Write(static_cast<uint64_t>(Entry.size));
+			}
+
+			Writer.WriteArray(Specialization->pData, Specialization->dataSize);
+		}
+	}
+
+	const VkPipelineVertexInputStateCreateInfo* VertexInput = InPipelineCI.pVertexInputState;
+	Writer.Write(VertexInput != nullptr);
+	if (VertexInput != nullptr)
+	{
+		Writer.Write(VertexInput->vertexBindingDescriptionCount);
+		for (uint32_t Idx = 0; Idx < VertexInput->vertexBindingDescriptionCount; ++Idx)
+		{
+			const VkVertexInputBindingDescription& Binding = VertexInput->pVertexBindingDescriptions[Idx];
+			Writer.Write(Binding.binding);
+			Writer.Write(Binding.stride);
+			Writer.Write(Binding.inputRate);
+		}
+
+		Writer.Write(VertexInput->vertexAttributeDescriptionCount);
+		for (uint32_t Idx = 0; Idx < VertexInput->vertexAttributeDescriptionCount; ++Idx)
+		{
+			const VkVertexInputAttributeDescription& Attribute = VertexInput->pVertexAttributeDescriptions[Idx];
+			Writer.Write(Attribute.location);
+			Writer.Write(Attribute.binding);
+			Writer.Write(Attribute.format);
+			Writer.Write(Attribute.offset);
+		}
+	}
+
+	const VkPipelineInputAssemblyStateCreateInfo* InputAssembly = InPipelineCI.pInputAssemblyState;
+	Writer.Write(InputAssembly != nullptr);
+	if (InputAssembly != nullptr)
+	{
+		Writer.Write(InputAssembly->topology);
+		Writer.Write(InputAssembly->primitiveRestartEnable);
+	}
+
+	const VkPipelineViewportStateCreateInfo* ViewportState = InPipelineCI.pViewportState;
+	Writer.Write(ViewportState != nullptr);
+	if (ViewportState != nullptr)
+	{
+		Writer.Write(ViewportState->viewportCount);
+		Writer.Write(ViewportState->scissorCount);
+	}
+
+	const VkPipelineRasterizationStateCreateInfo* Rasterization = InPipelineCI.pRasterizationState;
+	Writer.Write(Rasterization != nullptr);
+	if (Rasterization != nullptr)
+	{
+		Writer.Write(Rasterization->depthClampEnable);
+		Writer.Write(Rasterization->rasterizerDiscardEnable);
+		Writer.Write(Rasterization->polygonMode);
+		Writer.Write(Rasterization->cullMode);
+		Writer.Write(Rasterization->frontFace);
+		Writer.Write(Rasterization->depthBiasEnable);
+		Writer.Write(Rasterization->depthBiasConstantFactor);
+		Writer.Write(Rasterization->depthBiasClamp);
+		Writer.Write(Rasterization->depthBiasSlopeFactor);
+		Writer.Write(Rasterization->lineWidth);
+	}
+
+	const VkPipelineMultisampleStateCreateInfo* Multisample = InPipelineCI.pMultisampleState;
+	Writer.Write(Multisample != nullptr);
+	if (Multisample != nullptr)
+	{
+		Writer.Write(Multisample->rasterizationSamples);
+		Writer.Write(Multisample->sampleShadingEnable);
+		Writer.Write(Multisample->minSampleShading);
+		Writer.Write(Multisample->alphaToCoverageEnable);
+		Writer.Write(Multisample->alphaToOneEnable);
+	}
+
+	const VkPipelineDepthStencilStateCreateInfo* DepthStencil = InPipelineCI.pDepthStencilState;
+	Writer.Write(DepthStencil != nullptr);
+	if (DepthStencil != nullptr)
+	{
+		Writer.Write(DepthStencil->depthTestEnable);
+		Writer.Write(DepthStencil->depthWriteEnable);
+		Writer.Write(DepthStencil->depthCompareOp);
+		Writer.Write(DepthStencil->depthBoundsTestEnable);
+		Writer.Write(DepthStencil->stencilTestEnable);
+
+		for (const VkStencilOpState& StencilOp : { DepthStencil->front, DepthStencil->back })
+		{
+			Writer.Write(StencilOp.failOp);
+			Writer.Write(StencilOp.passOp);
+			Writer.Write(StencilOp.depthFailOp);
+			Writer.Write(StencilOp.compareOp);
+			Writer.Write(StencilOp.compareMask);
+			Writer.Write(StencilOp.writeMask);
+			Writer.Write(StencilOp.reference);
+		}
+
+		Writer.Write(DepthStencil->minDepthBounds);
+		Writer.Write(DepthStencil->maxDepthBounds);
+	}
+
+	const VkPipelineColorBlendStateCreateInfo* ColorBlend = InPipelineCI.pColorBlendState;
+	Writer.Write(ColorBlend != nullptr);
+	if (ColorBlend != nullptr)
+	{
+		Writer.Write(ColorBlend->logicOpEnable);
+		Writer.Write(ColorBlend->logicOp);
+
+		Writer.Write(ColorBlend->attachmentCount);
+		for (uint32_t Idx = 0; Idx < ColorBlend->attachmentCount; ++Idx)
+		{
+			const VkPipelineColorBlendAttachmentState& Attachment = ColorBlend->pAttachments[Idx];
+			Writer.Write(Attachment.blendEnable);
+			Writer.Write(Attachment.srcColorBlendFactor);
+			Writer.Write(Attachment.dstColorBlendFactor);
+			Writer.Write(Attachment.colorBlendOp);
+			Writer.Write(Attachment.srcAlphaBlendFactor);
+			Writer.Write(Attachment.dstAlphaBlendFactor);
+			Writer.Write(Attachment.alphaBlendOp);
+			Writer.Write(Attachment.colorWriteMask);
+		}
+
+		for (float BlendConstant : ColorBlend->blendConstants)
+		{
+			Writer.Write(BlendConstant);
+		}
+	}
+
+	const VkPipelineDynamicStateCreateInfo* DynamicState = InPipelineCI.pDynamicState;
+	Writer.Write(DynamicState != nullptr);
+	if (DynamicState != nullptr)
+	{
+		Writer.Write(DynamicState->dynamicStateCount);
+		for (uint32_t Idx = 0; Idx < DynamicState->dynamicStateCount; ++Idx)
+		{
+			Writer.Write(DynamicState->pDynamicStates[Idx]);
+		}
+	}
+
+	Writer.Write(InPipelineCI.renderPass);
+	Writer.Write(InPipelineCI.subpass);
+
+	Key.Hash = HashBytes(Key.Bytes.data(), Key.Bytes.size());
+
+	return Key;
+}
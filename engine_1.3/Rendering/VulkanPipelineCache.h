@@ -0,0 +1,64 @@
+#pragma once
+
+#include "VulkanObject.h"
+
+#include "vulkan/vulkan.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Everything a graphics pipeline is created from, serialized field by field with the length of every list. Shader
+// stages contribute the hash and size of their SPIR-V rather than the module handle, so materials loading the same
+// shaders share a pipeline and a module handle reused after its shader was destroyed cannot alias it.
+struct FGraphicsPipelineKey
+{
+	std::vector<uint8_t> Bytes;
+	uint64_t Hash = 0;
+
+	bool operator==(const FGraphicsPipelineKey& RHS) const { return Hash == RHS.Hash && Bytes == RHS.Bytes; }
+};
+
+namespace std
+{
+	template<> struct hash<FGraphicsPipelineKey>
+	{
+		size_t operator()(const FGraphicsPipelineKey& InKey) const { return static_cast<size_t>(InKey.Hash); }
+	};
+}
+
+class FVulkanPipelineCache : public FVulkanObject
+{
+public:
+	FVulkanPipelineCache(class FVulkanContext* InContext);
+
+	virtual void Destroy() override;
+
+	VkPipelineCache GetHandle() const { return Cache; }
+
+	// Creates the VkPipelineCache, seeded from InFilename when the file was written by the same device and driver.
+	// The cache is written back to the same file on Save and Destroy.
+	void Load(const std::string& InFilename);
+	bool Save() const;
+
+	// Returns the pipeline previously created with identical shaders, descriptor set layouts and fixed-function state,
+	// or creates it (and its layout) if this state has not been seen yet. InStageShaders holds the shader of each
+	// entry of InPipelineCI.pStages; null is returned if they do not match. InPipelineCI.layout is ignored.
+	// The pipeline may be shared and must not be modified.
+	class FVulkanPipeline* FindOrCreateGraphicsPipeline(
+		const VkPipelineLayoutCreateInfo& InLayoutCI,
+		const VkGraphicsPipelineCreateInfo& InPipelineCI,
+		const std::vector<const class FVulkanShader*>& InStageShaders);
+
+	static FGraphicsPipelineKey MakeGraphicsPipelineKey(
+		const VkPipelineLayoutCreateInfo& InLayoutCI,
+		const VkGraphicsPipelineCreateInfo& InPipelineCI,
+		const std::vector<const class FVulkanShader*>& InStageShaders);
+
+private:
+	VkPipelineCache Cache;
+	std::string Filename;
+
+	std::unordered_map<FGraphicsPipelineKey, class FVulkanPipeline*> GraphicsPipelines;
+};
@@ -168,7 +168,8 @@ void FVulkanRenderPass::Begin(
 	VkCommandBuffer InCommandBuffer,
 	FVulkanFramebuffer* InFramebuffer,
 	VkRect2D InRenderArea,
-	const std::vector<VkClearValue>& InClearValues)
+	const std::vector<VkClearValue>& InClearValues,
+	VkSubpassContents InContents)
 {
 	VkRenderPassBeginInfo RenderPassBeginInfo{};
 	RenderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -178,7 +179,7 @@ void FVulkanRenderPass::Begin(
 	RenderPassBeginInfo.clearValueCount = static_cast<uint32_t>(InClearValues.size());
 	RenderPassBeginInfo.pClearValues = InClearValues.data();
 
-	vkCmdBeginRenderPass(InCommandBuffer, &RenderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(InCommandBuffer, &RenderPassBeginInfo, InContents);
 }
 
 void FVulkanRenderPass::End(VkCommandBuffer InCommandBuffer)
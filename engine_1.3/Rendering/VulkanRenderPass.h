@@ -25,7 +25,8 @@ public:
 		VkCommandBuffer InCommandBuffer,
 		class FVulkanFramebuffer* InFramebuffer,
 		VkRect2D InRenderArea,
-		const std::vector<VkClearValue>& InClearValues);
+		const std::vector<VkClearValue>& InClearValues,
+		VkSubpassContents InContents = VK_SUBPASS_CONTENTS_INLINE);
 	void End(VkCommandBuffer InCommandBuffer);
 
 private:
@@ -26,6 +26,8 @@ FVulkanSampler::FVulkanSampler(class FVulkanContext* InContext)
 	SamplerCI.compareEnable = VK_FALSE;
 	SamplerCI.compareOp = VK_COMPARE_OP_ALWAYS;
 	SamplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	SamplerCI.minLod = 0.0f;
+	SamplerCI.maxLod = VK_LOD_CLAMP_NONE;
 
 	VK_ASSERT(vkCreateSampler(Device, &SamplerCI, nullptr, &Sampler));
 }
@@ -15,7 +15,14 @@ void FVulkanScene::AddModel(FVulkanModel* InModel)
 		return;
 	}
 
+	if (ModelIndices.find(InModel) != ModelIndices.end())
+	{
+		return;
+	}
+
+	ModelIndices.insert({ InModel, Models.size() });
 	Models.push_back(InModel);
+	AddedModels.push_back(InModel);
 }
 
 void FVulkanScene::RemoveModel(FVulkanModel* InModel)
@@ -25,24 +32,41 @@ void FVulkanScene::RemoveModel(FVulkanModel* InModel)
 		return;
 	}
 
-	for (auto Itr = Models.begin(); Itr != Models.end(); ++Itr)
+	auto Iter = ModelIndices.find(InModel);
+	if (Iter == ModelIndices.end())
+	{
+		return;
+	}
+
+	size_t Index = Iter->second;
+	ModelIndices.erase(Iter);
+
+	if (Index != Models.size() - 1)
 	{
-		if (*Itr == InModel)
-		{
-			Context->DestroyObject(*Itr);
-			Models.erase(Itr);
-			break;
-		}
+		Models[Index] = Models.back();
+		ModelIndices[Models[Index]] = Index;
 	}
+	Models.pop_back();
+
+	RemovedModels.push_back(InModel);
 }
 
 void FVulkanScene::ClearModels()
 {
-	for (FVulkanModel* Model : Models)
+	RemovedModels.insert(RemovedModels.end(), Models.begin(), Models.end());
+
+	Models.clear();
+	ModelIndices.clear();
+}
+
+void FVulkanScene::ClearPendingChanges()
+{
+	for (FVulkanModel* Model : RemovedModels)
 	{
 		Context->DestroyObject(Model);
 	}
 
-	Models.clear();
+	AddedModels.clear();
+	RemovedModels.clear();
 }
 
@@ -6,6 +6,7 @@
 #include "VulkanModel.h"
 
 #include <vector>
+#include <unordered_map>
 
 #include "glm/glm.hpp"
 
@@ -19,6 +20,11 @@ public:
 	void RemoveModel(class FVulkanModel* InModel);
 	void ClearModels();
 
+	// Models added or removed since the last ClearPendingChanges call. Removed models stay alive until then.
+	const std::vector<class FVulkanModel*>& GetAddedModels() const { return AddedModels; }
+	const std::vector<class FVulkanModel*>& GetRemovedModels() const { return RemovedModels; }
+	void ClearPendingChanges();
+
 	FVulkanModel* GetSky() const { return Sky; }
 	void SetSky(FVulkanModel* InMesh) { Sky = InMesh; }
 
@@ -33,6 +39,9 @@ public:
 
 private:
 	std::vector<class FVulkanModel*> Models;
+	std::unordered_map<class FVulkanModel*, size_t> ModelIndices;
+	std::vector<class FVulkanModel*> AddedModels;
+	std::vector<class FVulkanModel*> RemovedModels;
 	FVulkanModel* Sky;
 
 	FVulkanCamera Camera;
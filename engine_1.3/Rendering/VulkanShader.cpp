@@ -7,6 +7,8 @@
 FVulkanShader::FVulkanShader(FVulkanContext* InContext)
 	: FVulkanObject(InContext)
 	, ShaderModule(VK_NULL_HANDLE)
+	, CodeHash(0)
+	, CodeSize(0)
 {
 
 }
@@ -46,5 +48,8 @@ bool FVulkanShader::LoadBytes(const std::vector<char>& InBytes)
 	ShaderModuleCI.codeSize = InBytes.size();
 	ShaderModuleCI.pCode = reinterpret_cast<const uint32_t*>(InBytes.data());
 
+	CodeHash = HashBytes(InBytes.data(), InBytes.size());
+	CodeSize = InBytes.size();
+
 	return vkCreateShaderModule(Device, &ShaderModuleCI, nullptr, &ShaderModule) == VK_SUCCESS;
 }
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include "VulkanObject.h"
 
@@ -19,6 +20,13 @@ public:
 
 	VkShaderModule GetModule() const { return ShaderModule;  }
 
+	// Identify the SPIR-V the module was created from, so modules of different shader objects can be matched by content.
+	uint64_t GetCodeHash() const { return CodeHash; }
+	size_t GetCodeSize() const { return CodeSize; }
+
 private:
 	VkShaderModule ShaderModule;
+
+	uint64_t CodeHash;
+	size_t CodeSize;
 };
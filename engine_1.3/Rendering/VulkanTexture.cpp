@@ -2,112 +2,110 @@
 #include "VulkanContext.h"
 #include "VulkanHelpers.h"
 #include "VulkanImage.h"
+#include "VulkanUploader.h"
 
 #include "Texture2D.h"
 #include "TextureCube.h"
 
 #include <array>
 
+static bool SupportsLinearBlit(VkPhysicalDevice InPhysicalDevice, VkFormat InFormat)
+{
+	VkFormatProperties FormatProperties;
+	vkGetPhysicalDeviceFormatProperties(InPhysicalDevice, InFormat, &FormatProperties);
+
+	VkFormatFeatureFlags RequiredFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+	return (FormatProperties.optimalTilingFeatures & RequiredFeatures) == RequiredFeatures;
+}
+
 FVulkanTexture::FVulkanTexture(FVulkanContext* InContext)
 	: FVulkanObject(InContext)
 	, Image(nullptr)
 	, Width(0)
 	, Height(0)
 	, Channel(4U)
+	, Depth(1U)
+	, FirstMip(0)
 	, Format(VK_FORMAT_R8G8B8A8_SRGB)
 {
 }
 
+VkFormat FVulkanTexture::GetVulkanFormat(ETextureFormat InFormat, bool bInSRGB)
+{
+	switch (InFormat)
+	{
+	case ETextureFormat::BC1:
+		return bInSRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+	case ETextureFormat::BC3:
+		return bInSRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+	case ETextureFormat::BC5:
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	case ETextureFormat::BC7:
+		return bInSRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+	default:
+		return bInSRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+	}
+}
+
 void FVulkanTexture::Destroy()
 {
 	Unload();
 }
 
-void FVulkanTexture::Load(UTexture2D* InTexture)
+void FVulkanTexture::Load(UTexture2D* InTexture, uint32_t InFirstMip)
 {
 	if (InTexture == nullptr)
 	{
 		return;
 	}
 
-	if (InTexture->GetWidth() <= 0 || InTexture->GetHeight() <= 0)
+	if (InTexture->GetWidth() <= 0 || InTexture->GetHeight() <= 0 || InFirstMip >= InTexture->GetNumMips())
 	{
 		return;
 	}
 
-	Width = static_cast<uint32_t>(InTexture->GetWidth());
-	Height = static_cast<uint32_t>(InTexture->GetHeight());
+	const std::vector<FTextureMip>& Mips = InTexture->GetMips();
+	const FTextureMip& FirstLevel = Mips[InFirstMip];
+
+	FirstMip = InFirstMip;
+	Width = FirstLevel.Width;
+	Height = FirstLevel.Height;
 	Depth = 1U;
 	Channel = 4U;
 
-	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
-	VkDevice Device = Context->GetDevice();
-	VkQueue GfxQueue = Context->GetGfxQueue();
-	VkCommandPool CommandPool = Context->GetCommandPool();
+	uint32_t MipLevels = static_cast<uint32_t>(Mips.size()) - InFirstMip;
+	VkImageUsageFlags Usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
-	VkDeviceSize ImageSize = Width * Height * Channel;
-
-	VkBuffer StagingBuffer = VK_NULL_HANDLE;
-	VkDeviceMemory StagingBufferMemory = VK_NULL_HANDLE;
-	Vk::CreateBuffer(
-		PhysicalDevice,
-		Device,
-		ImageSize,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		StagingBuffer,
-		StagingBufferMemory);
-
-	void* Data = nullptr;
+	// Textures imported without their mips get the rest of the chain blitted on the GPU when the format allows it.
+	uint32_t FullMipLevels = FMipGenerator::GetNumMipLevels(Width, Height);
+	if (MipLevels < FullMipLevels && SupportsLinearBlit(Context->GetPhysicalDevice(), Format))
+	{
+		MipLevels = FullMipLevels;
+		Usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
 
-	VK_ASSERT(vkMapMemory(Device, StagingBufferMemory, 0, ImageSize, 0, &Data));
-	memcpy(Data, InTexture->GetPixels(), static_cast<size_t>(ImageSize));
-	vkUnmapMemory(Device, StagingBufferMemory);
+	// Offsets are rebased so the upload only copies the levels that become resident.
+	std::vector<VkDeviceSize> MipOffsets;
+	MipOffsets.reserve(Mips.size() - InFirstMip);
+	for (size_t Level = InFirstMip; Level < Mips.size(); ++Level)
+	{
+		MipOffsets.push_back(Mips[Level].Offset - FirstLevel.Offset);
+	}
 
 	Image = Context->CreateObject<FVulkanImage>();
 	Image->CreateImage(
 		{ Width, Height, Depth },
-		1,
+		MipLevels,
 		1,
 		Format,
 		VK_IMAGE_TYPE_2D,
 		VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		Usage,
 		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	Image->CreateView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT);
 
-	Vk::TransitionImageLayout(
-		Device,
-		CommandPool,
-		GfxQueue,
-		Image->GetImage(),
-		1,
-		1,
-		Format,
-		VK_IMAGE_LAYOUT_UNDEFINED,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	Vk::CopyBufferToImage(
-		Device,
-		CommandPool,
-		GfxQueue,
-		StagingBuffer,
-		Image->GetImage(),
-		0,
-		1,
-		{ Width, Height, Depth });
-	Vk::TransitionImageLayout(
-		Device,
-		CommandPool,
-		GfxQueue,
-		Image->GetImage(),
-		1,
-		1,
-		Format,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-	vkDestroyBuffer(Device, StagingBuffer, nullptr);
-	vkFreeMemory(Device, StagingBufferMemory, nullptr);
+	FVulkanUploader* Uploader = Context->GetUploader();
+	Uploader->UploadImageMips(Image, InTexture->GetMipData() + FirstLevel.Offset, InTexture->GetMipDataSize() - FirstLevel.Offset, MipOffsets);
 }
 
 void FVulkanTexture::Load(UTextureCube* InTexture)
@@ -124,41 +122,9 @@ void FVulkanTexture::Load(UTextureCube* InTexture)
 
 	uint32_t ArrayLayers = 6;
 
-	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
-	VkDevice Device = Context->GetDevice();
-	VkQueue GfxQueue = Context->GetGfxQueue();
-	VkCommandPool CommandPool = Context->GetCommandPool();
-
 	VkDeviceSize SliceSize = Width * Height * Depth * Channel;
-	VkDeviceSize ImageSize = SliceSize * ArrayLayers;
-
-	VkBuffer StagingBuffer = VK_NULL_HANDLE;
-	VkDeviceMemory StagingBufferMemory = VK_NULL_HANDLE;
-	Vk::CreateBuffer(
-		PhysicalDevice,
-		Device,
-		ImageSize,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		StagingBuffer,
-		StagingBufferMemory);
-
-	void* Data = nullptr;
-
-	const std::array<uint8_t*, 6>& Images = InTexture->GetImages();
-
-	VK_ASSERT(vkMapMemory(Device, StagingBufferMemory, 0, ImageSize, 0, &Data));
-	for (int Idx = 0; Idx < ArrayLayers; ++Idx)
-	{
-		uint8_t* Pixels = Images[Idx];
-		if (Pixels == nullptr)
-		{
-			continue;
-		}
 
-		memcpy((uint8_t*)Data + SliceSize * Idx, Pixels, static_cast<size_t>(SliceSize));
-	}
-	vkUnmapMemory(Device, StagingBufferMemory);
+	std::array<const uint8_t*, 6> Images = InTexture->GetImages();
 
 	Image = Context->CreateObject<FVulkanImage>();
 	Image->CreateImage(
@@ -173,38 +139,16 @@ void FVulkanTexture::Load(UTextureCube* InTexture)
 		VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 	Image->CreateView(VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_ASPECT_COLOR_BIT);
 
-	Vk::TransitionImageLayout(
-		Device,
-		CommandPool,
-		GfxQueue,
-		Image->GetImage(),
-		1,
-		ArrayLayers,
-		Format,
-		VK_IMAGE_LAYOUT_UNDEFINED,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	Vk::CopyBufferToImage(
-		Device,
-		CommandPool,
-		GfxQueue,
-		StagingBuffer,
-		Image->GetImage(),
-		0,
-		ArrayLayers,
-		{ Width, Height, Depth });
-	Vk::TransitionImageLayout(
-		Device,
-		CommandPool,
-		GfxQueue,
-		Image->GetImage(),
-		1,
-		ArrayLayers,
-		Format,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	FVulkanUploader* Uploader = Context->GetUploader();
+	Uploader->UploadImage(Image, std::vector<const uint8_t*>(Images.begin(), Images.end()), SliceSize);
+}
+
+FVulkanImage* FVulkanTexture::ReleaseImage()
+{
+	FVulkanImage* ReleasedImage = Image;
+	Image = nullptr;
 
-	vkDestroyBuffer(Device, StagingBuffer, nullptr);
-	vkFreeMemory(Device, StagingBufferMemory, nullptr);
+	return ReleasedImage;
 }
 
 void FVulkanTexture::Unload()
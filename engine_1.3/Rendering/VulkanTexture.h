@@ -3,6 +3,8 @@
 #include "VulkanObject.h"
 #include "VulkanImage.h"
 
+#include "TextureCompressor.h"
+
 #include "vulkan/vulkan.h"
 
 #include <vector>
@@ -14,7 +16,8 @@ public:
 
 	virtual void Destroy() override;
 
-	void Load(class UTexture2D* InTexture);
+	// Uploads levels InFirstMip and below of the texture's mip data. The image's largest level is InFirstMip.
+	void Load(class UTexture2D* InTexture, uint32_t InFirstMip = 0);
 	void Load(class UTextureCube* InTexture);
 
 	void Unload();
@@ -23,9 +26,16 @@ public:
 	uint32_t GetHeight() const { return Height; }
 	VkFormat GetFormat() const { return Format; }
 	FVulkanImage* GetImage() const { return Image; }
+	uint32_t GetFirstMip() const { return FirstMip; }
+	VkDeviceSize GetMemorySize() const { return Image != nullptr ? Image->GetMemorySize() : 0; }
 
 	void SetFormat(VkFormat InFormat) { Format = InFormat; }
 
+	// Hands the image over to the caller, which destroys it once no frame in flight samples it anymore.
+	FVulkanImage* ReleaseImage();
+
+	static VkFormat GetVulkanFormat(ETextureFormat InFormat, bool bInSRGB);
+
 private:
 	class FVulkanImage* Image;
 
@@ -33,5 +43,6 @@ private:
 	uint32_t Height;
 	uint32_t Channel;
 	uint32_t Depth;
+	uint32_t FirstMip;
 	VkFormat Format;
 };
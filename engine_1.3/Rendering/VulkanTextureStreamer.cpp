@@ -0,0 +1,203 @@
+#include "VulkanTextureStreamer.h"
+#include "VulkanContext.h"
+#include "VulkanTexture.h"
+#include "VulkanImage.h"
+#include "VulkanScene.h"
+#include "VulkanModel.h"
+#include "VulkanMesh.h"
+#include "VulkanMaterial.h"
+
+#include "Config.h"
+#include "Mesh.h"
+#include "Texture2D.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+
+FVulkanTextureStreamer::FVulkanTextureStreamer(FVulkanContext* InContext)
+	: FVulkanObject(InContext)
+	, bEnabled(false)
+	, MaxUpdatesPerFrame(4)
+	, FrameNumber(0)
+	, WantedSize(0)
+{
+	int32_t BudgetMB = 0;
+	int32_t StreamOutDelay = static_cast<int32_t>(Settings.StreamOutDelay);
+
+	if (GConfig != nullptr)
+	{
+		GConfig->Get("TextureStreaming", bEnabled);
+		GConfig->Get("TextureStreamingBudgetMB", BudgetMB);
+		GConfig->Get("TextureStreamingOutDelay", StreamOutDelay);
+		GConfig->Get("TextureStreamingMipBias", Settings.MipBias);
+		GConfig->Get("TextureStreamingUpdatesPerFrame", MaxUpdatesPerFrame);
+	}
+
+	Settings.BudgetBytes = static_cast<uint64_t>(std::max(BudgetMB, 0)) * 1024 * 1024;
+	Settings.StreamOutDelay = static_cast<uint32_t>(std::max(StreamOutDelay, 0));
+}
+
+void FVulkanTextureStreamer::Destroy()
+{
+	DestroyRetiredImages(true);
+}
+
+void FVulkanTextureStreamer::Update(const FVulkanScene* InScene, float InViewportHeight)
+{
+	++FrameNumber;
+	DestroyRetiredImages(false);
+
+	if (bEnabled == false || InScene == nullptr)
+	{
+		return;
+	}
+
+	GatherTextures(InScene, InViewportHeight);
+
+	WantedSize = FTextureStreamingPolicy::Update(StreamingTextures, Settings);
+
+	Updates.clear();
+	for (size_t Idx = 0; Idx < StreamingTextures.size(); ++Idx)
+	{
+		if (StreamingTextures[Idx].WantedMip != StreamingTextures[Idx].ResidentMip)
+		{
+			Updates.push_back(Idx);
+		}
+	}
+
+	// Streaming out frees memory for the textures streamed in; among those, the largest on screen go first.
+	std::sort(Updates.begin(), Updates.end(), [this](size_t A, size_t B)
+	{
+		const FStreamingTexture& TextureA = StreamingTextures[A];
+		const FStreamingTexture& TextureB = StreamingTextures[B];
+
+		bool bStreamOutA = TextureA.WantedMip > TextureA.ResidentMip;
+		bool bStreamOutB = TextureB.WantedMip > TextureB.ResidentMip;
+		if (bStreamOutA != bStreamOutB)
+		{
+			return bStreamOutA;
+		}
+
+		return TextureA.ScreenSize > TextureB.ScreenSize;
+	});
+
+	size_t NumUpdates = std::min(Updates.size(), static_cast<size_t>(std::max(MaxUpdatesPerFrame, 1)));
+	for (size_t UpdateIdx = 0; UpdateIdx < NumUpdates; ++UpdateIdx)
+	{
+		size_t Idx = Updates[UpdateIdx];
+		StreamTexture(Textures[Idx], StreamingTextures[Idx].WantedMip);
+	}
+}
+
+void FVulkanTextureStreamer::GatherTextures(const FVulkanScene* InScene, float InViewportHeight)
+{
+	PrevStreamingTextures.swap(StreamingTextures);
+	PrevTextureIndices.swap(TextureIndices);
+
+	Textures.clear();
+	StreamingTextures.clear();
+	TextureIndices.clear();
+
+	FVulkanCamera Camera = InScene->GetCamera();
+	float FOVRadians = glm::radians(Camera.FOV);
+
+	for (FVulkanModel* Model : InScene->GetModels())
+	{
+		FVulkanMesh* Mesh = Model != nullptr ? Model->GetMesh() : nullptr;
+		if (Mesh == nullptr || Mesh->GetMeshAsset() == nullptr)
+		{
+			continue;
+		}
+
+		// Textures are assumed to span their mesh once, so the mesh's projected size is the texture's.
+		FBoundingSphere Bounds = Mesh->GetMeshAsset()->GetBounds().TransformBy(Model->GetModelMatrix());
+		float Distance = glm::length(Bounds.Center - Camera.Position);
+		float ScreenSize = FTextureStreamingPolicy::GetScreenSize(Bounds.Radius, Distance, FOVRadians, InViewportHeight);
+
+		for (uint32_t Slot = 0; Slot < Mesh->GetNumMaterialSlots(); ++Slot)
+		{
+			FVulkanMaterial* Material = Mesh->GetMaterial(Slot);
+			if (Material == nullptr)
+			{
+				continue;
+			}
+
+			AddTexture(Material->GetBaseColor().TexParam, ScreenSize);
+			AddTexture(Material->GetNormal().TexParam, ScreenSize);
+		}
+	}
+}
+
+void FVulkanTextureStreamer::AddTexture(UTexture* InTexture, float InScreenSize)
+{
+	UTexture2D* Texture = Cast<UTexture2D>(InTexture);
+	if (Texture == nullptr || Texture->IsStreamable() == false)
+	{
+		return;
+	}
+
+	FVulkanTexture* RenderTexture = Texture->GetRenderTexture();
+	if (RenderTexture == nullptr || RenderTexture->GetImage() == nullptr)
+	{
+		return;
+	}
+
+	auto Result = TextureIndices.emplace(Texture, StreamingTextures.size());
+	if (Result.second)
+	{
+		FStreamingTexture StreamingTexture;
+		StreamingTexture.Mips = Texture->GetMips().data();
+		StreamingTexture.NumMips = Texture->GetNumMips();
+		StreamingTexture.ResidentMip = RenderTexture->GetFirstMip();
+
+		auto PrevIter = PrevTextureIndices.find(Texture);
+		if (PrevIter != PrevTextureIndices.end())
+		{
+			StreamingTexture.StreamOutFrames = PrevStreamingTextures[PrevIter->second].StreamOutFrames;
+		}
+
+		StreamingTextures.push_back(StreamingTexture);
+		Textures.push_back(Texture);
+	}
+
+	FStreamingTexture& StreamingTexture = StreamingTextures[Result.first->second];
+	StreamingTexture.ScreenSize = std::max(StreamingTexture.ScreenSize, InScreenSize);
+}
+
+void FVulkanTextureStreamer::StreamTexture(UTexture2D* InTexture, uint32_t InFirstMip)
+{
+	FVulkanTexture* RenderTexture = InTexture->GetRenderTexture();
+
+	// Descriptor sets of frames in flight still point at the old image; the mesh renderer rebinds each frame's set
+	// before recording it.
+	FVulkanImage* OldImage = RenderTexture->ReleaseImage();
+	RenderTexture->Load(InTexture, InFirstMip);
+
+	if (OldImage != nullptr)
+	{
+		RetiredImages.push_back({ OldImage, FrameNumber });
+	}
+}
+
+void FVulkanTextureStreamer::DestroyRetiredImages(bool bInForce)
+{
+	const uint64_t FrameDelay = Context->GetMaxConcurrentFrames();
+
+	auto Iter = std::remove_if(RetiredImages.begin(), RetiredImages.end(), [this, bInForce, FrameDelay](const FRetiredImage& InRetiredImage)
+	{
+		if (bInForce == false && InRetiredImage.Frame + FrameDelay > FrameNumber)
+		{
+			return false;
+		}
+
+		// The context may already have destroyed the image while shutting down.
+		if (Context->IsValidObject(InRetiredImage.Image))
+		{
+			Context->DestroyObject(InRetiredImage.Image);
+		}
+		return true;
+	});
+
+	RetiredImages.erase(Iter, RetiredImages.end());
+}
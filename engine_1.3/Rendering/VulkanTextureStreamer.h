@@ -0,0 +1,57 @@
+#pragma once
+
+#include "VulkanObject.h"
+
+#include "TextureStreaming.h"
+
+#include <vector>
+#include <unordered_map>
+
+// Keeps only the mip levels of 2D textures that the scene needs resident. Each frame the screen size of every model
+// picks the levels its textures need, and textures whose levels change are uploaded again from their mip data.
+// Models outside the view frustum still count, so turning the camera does not stream textures back in.
+class FVulkanTextureStreamer : public FVulkanObject
+{
+public:
+	FVulkanTextureStreamer(class FVulkanContext* InContext);
+
+	virtual void Destroy() override;
+
+	bool IsEnabled() const { return bEnabled; }
+
+	// Called once per frame on the render thread, after the fence of the frame being recorded was waited on.
+	// Replaced images are destroyed once every frame in flight that may sample them has finished.
+	void Update(const class FVulkanScene* InScene, float InViewportHeight);
+
+	// Size of the levels the policy wanted resident in the last update.
+	uint64_t GetWantedSize() const { return WantedSize; }
+
+private:
+	void GatherTextures(const class FVulkanScene* InScene, float InViewportHeight);
+	void AddTexture(class UTexture* InTexture, float InScreenSize);
+	void StreamTexture(class UTexture2D* InTexture, uint32_t InFirstMip);
+	void DestroyRetiredImages(bool bInForce);
+
+	struct FRetiredImage
+	{
+		class FVulkanImage* Image;
+		uint64_t Frame;
+	};
+
+	bool bEnabled;
+	int32_t MaxUpdatesPerFrame;
+	FTextureStreamingSettings Settings;
+
+	// Rebuilt every frame; the previous frame's copies carry the hysteresis counters over.
+	std::vector<class UTexture2D*> Textures;
+	std::vector<FStreamingTexture> StreamingTextures;
+	std::unordered_map<class UTexture2D*, size_t> TextureIndices;
+	std::vector<FStreamingTexture> PrevStreamingTextures;
+	std::unordered_map<class UTexture2D*, size_t> PrevTextureIndices;
+
+	std::vector<size_t> Updates;
+	std::vector<FRetiredImage> RetiredImages;
+
+	uint64_t FrameNumber;
+	uint64_t WantedSize;
+};
@@ -0,0 +1,521 @@
+#include "VulkanUploader.h"
+#include "VulkanContext.h"
+#include "VulkanHelpers.h"
+#include "VulkanImage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static VkDeviceSize AlignUp(VkDeviceSize InValue, VkDeviceSize InAlignment)
+{
+	return (InValue + InAlignment - 1) / InAlignment * InAlignment;
+}
+
+static VkExtent3D GetMipExtent(VkExtent3D InExtent, uint32_t InMipLevel)
+{
+	return { std::max(InExtent.width >> InMipLevel, 1U), std::max(InExtent.height >> InMipLevel, 1U), std::max(InExtent.depth >> InMipLevel, 1U) };
+}
+
+FVulkanUploader::FVulkanUploader(FVulkanContext* InContext)
+	: FVulkanObject(InContext)
+	, CommandPool(VK_NULL_HANDLE)
+	, CurrentBatch(0)
+	, bRecording(false)
+	, RingBuffer(VK_NULL_HANDLE)
+	, RingMemory(VK_NULL_HANDLE)
+	, RingMapped(nullptr)
+	, RingSize(0)
+	, RingHead(0)
+	, RingTail(0)
+	, NumSubmittedBatches(0)
+{
+
+}
+
+void FVulkanUploader::Destroy()
+{
+	VkDevice Device = Context->GetDevice();
+
+	if (CommandPool != VK_NULL_HANDLE)
+	{
+		FlushAndWait();
+	}
+
+	for (FBatch& Batch : Batches)
+	{
+		if (Batch.Fence != VK_NULL_HANDLE)
+		{
+			vkDestroyFence(Device, Batch.Fence, nullptr);
+			Batch.Fence = VK_NULL_HANDLE;
+		}
+		Batch.CommandBuffer = VK_NULL_HANDLE;
+	}
+
+	if (CommandPool != VK_NULL_HANDLE)
+	{
+		vkDestroyCommandPool(Device, CommandPool, nullptr);
+		CommandPool = VK_NULL_HANDLE;
+	}
+
+	if (RingMemory != VK_NULL_HANDLE)
+	{
+		vkUnmapMemory(Device, RingMemory);
+		RingMapped = nullptr;
+	}
+
+	if (RingBuffer != VK_NULL_HANDLE)
+	{
+		vkDestroyBuffer(Device, RingBuffer, nullptr);
+		RingBuffer = VK_NULL_HANDLE;
+	}
+
+	if (RingMemory != VK_NULL_HANDLE)
+	{
+		vkFreeMemory(Device, RingMemory, nullptr);
+		RingMemory = VK_NULL_HANDLE;
+	}
+}
+
+void FVulkanUploader::Initialize(VkDeviceSize InRingSize)
+{
+	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
+	VkDevice Device = Context->GetDevice();
+
+	uint32_t GraphicsFamily = -1;
+	uint32_t PresentFamily = -1;
+	Vk::FindQueueFamilies(PhysicalDevice, Context->GetSurface(), GraphicsFamily, PresentFamily);
+
+	VkCommandPoolCreateInfo CommandPoolCI{};
+	CommandPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	CommandPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	CommandPoolCI.queueFamilyIndex = GraphicsFamily;
+
+	VK_ASSERT(vkCreateCommandPool(Device, &CommandPoolCI, nullptr, &CommandPool));
+
+	VkCommandBufferAllocateInfo CommandBufferAllocInfo{};
+	CommandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	CommandBufferAllocInfo.commandPool = CommandPool;
+	CommandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	CommandBufferAllocInfo.commandBufferCount = 1;
+
+	VkFenceCreateInfo FenceCI{};
+	FenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	for (FBatch& Batch : Batches)
+	{
+		VK_ASSERT(vkAllocateCommandBuffers(Device, &CommandBufferAllocInfo, &Batch.CommandBuffer));
+		VK_ASSERT(vkCreateFence(Device, &FenceCI, nullptr, &Batch.Fence));
+	}
+
+	RingSize = AlignUp(InRingSize, DefaultAlignment);
+
+	Vk::CreateBuffer(
+		PhysicalDevice,
+		Device,
+		RingSize,
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		RingBuffer,
+		RingMemory);
+
+	VK_ASSERT(vkMapMemory(Device, RingMemory, 0, RingSize, 0, reinterpret_cast<void**>(&RingMapped)));
+}
+
+FVulkanStagingAllocation FVulkanUploader::Allocate(VkDeviceSize InSize, VkDeviceSize InAlignment)
+{
+	if (InSize > RingSize)
+	{
+		return AllocateDedicated(InSize);
+	}
+
+	BeginBatch();
+
+	while (true)
+	{
+		if (RingHead == RingTail && InFlightBatches.empty())
+		{
+			RingHead = 0;
+			RingTail = 0;
+			Batches[CurrentBatch].RingEnd = 0;
+		}
+
+		VkDeviceSize Offset = RingHead % RingSize;
+		VkDeviceSize AlignedOffset = AlignUp(Offset, InAlignment);
+
+		uint64_t Start = RingHead + (AlignedOffset - Offset);
+		if (AlignedOffset + InSize > RingSize)
+		{
+			Start = RingHead + (RingSize - Offset);
+		}
+
+		if (Start + InSize - RingTail <= RingSize)
+		{
+			RingHead = Start + InSize;
+			Batches[CurrentBatch].RingEnd = RingHead;
+
+			FVulkanStagingAllocation Allocation;
+			Allocation.Buffer = RingBuffer;
+			Allocation.Offset = Start % RingSize;
+			Allocation.Mapped = RingMapped + Allocation.Offset;
+			return Allocation;
+		}
+
+		if (InFlightBatches.empty())
+		{
+			// The batch being recorded holds the rest of the ring.
+			Flush();
+			RetireOldestBatch();
+			BeginBatch();
+		}
+		else
+		{
+			RetireOldestBatch();
+		}
+	}
+}
+
+FVulkanStagingAllocation FVulkanUploader::AllocateDedicated(VkDeviceSize InSize)
+{
+	VkPhysicalDevice PhysicalDevice = Context->GetPhysicalDevice();
+	VkDevice Device = Context->GetDevice();
+
+	BeginBatch();
+
+	VkBuffer Buffer = VK_NULL_HANDLE;
+	VkDeviceMemory Memory = VK_NULL_HANDLE;
+	Vk::CreateBuffer(
+		PhysicalDevice,
+		Device,
+		InSize,
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		Buffer,
+		Memory);
+
+	Batches[CurrentBatch].DedicatedBuffers.push_back({ Buffer, Memory });
+
+	FVulkanStagingAllocation Allocation;
+	Allocation.Buffer = Buffer;
+	Allocation.Offset = 0;
+	VK_ASSERT(vkMapMemory(Device, Memory, 0, InSize, 0, reinterpret_cast<void**>(&Allocation.Mapped)));
+
+	return Allocation;
+}
+
+VkCommandBuffer FVulkanUploader::GetCommandBuffer()
+{
+	BeginBatch();
+
+	return Batches[CurrentBatch].CommandBuffer;
+}
+
+void FVulkanUploader::UploadBuffer(VkBuffer InDstBuffer, VkDeviceSize InDstOffset, const void* InData, VkDeviceSize InSize)
+{
+	if (InDstBuffer == VK_NULL_HANDLE || InData == nullptr || InSize == 0)
+	{
+		return;
+	}
+
+	FVulkanStagingAllocation Allocation = Allocate(InSize);
+	memcpy(Allocation.Mapped, InData, static_cast<size_t>(InSize));
+
+	VkBufferCopy CopyRegion{};
+	CopyRegion.srcOffset = Allocation.Offset;
+	CopyRegion.dstOffset = InDstOffset;
+	CopyRegion.size = InSize;
+	vkCmdCopyBuffer(GetCommandBuffer(), Allocation.Buffer, InDstBuffer, 1, &CopyRegion);
+}
+
+void FVulkanUploader::UploadImage(FVulkanImage* InImage, const std::vector<const uint8_t*>& InLayers, VkDeviceSize InLayerSize)
+{
+	if (InImage == nullptr || InLayers.empty() || InLayerSize == 0)
+	{
+		return;
+	}
+
+	uint32_t ArrayLayers = static_cast<uint32_t>(InLayers.size());
+
+	FVulkanStagingAllocation Allocation = Allocate(InLayerSize * ArrayLayers);
+	for (uint32_t Idx = 0; Idx < ArrayLayers; ++Idx)
+	{
+		uint8_t* Dst = Allocation.Mapped + InLayerSize * Idx;
+		if (InLayers[Idx] != nullptr)
+		{
+			memcpy(Dst, InLayers[Idx], static_cast<size_t>(InLayerSize));
+		}
+		else
+		{
+			memset(Dst, 0, static_cast<size_t>(InLayerSize));
+		}
+	}
+
+	VkCommandBuffer CommandBuffer = GetCommandBuffer();
+
+	Vk::CmdTransitionImageLayout(
+		CommandBuffer,
+		InImage->GetImage(),
+		InImage->GetMipLevels(),
+		ArrayLayers,
+		VK_IMAGE_LAYOUT_UNDEFINED,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	Vk::CmdCopyBufferToImage(
+		CommandBuffer,
+		Allocation.Buffer,
+		Allocation.Offset,
+		InImage->GetImage(),
+		0,
+		ArrayLayers,
+		InImage->GetExtent());
+	Vk::CmdTransitionImageLayout(
+		CommandBuffer,
+		InImage->GetImage(),
+		InImage->GetMipLevels(),
+		ArrayLayers,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void FVulkanUploader::UploadImageMips(FVulkanImage* InImage, const uint8_t* InData, VkDeviceSize InSize, const std::vector<VkDeviceSize>& InMipOffsets)
+{
+	if (InImage == nullptr || InData == nullptr || InSize == 0 || InMipOffsets.empty())
+	{
+		return;
+	}
+
+	uint32_t MipLevels = InImage->GetMipLevels();
+	uint32_t NumUploadedMips = std::min(static_cast<uint32_t>(InMipOffsets.size()), MipLevels);
+
+	FVulkanStagingAllocation Allocation = Allocate(InSize);
+	memcpy(Allocation.Mapped, InData, static_cast<size_t>(InSize));
+
+	VkExtent3D Extent = InImage->GetExtent();
+
+	std::vector<VkBufferImageCopy> CopyRegions(NumUploadedMips);
+	for (uint32_t Level = 0; Level < NumUploadedMips; ++Level)
+	{
+		VkBufferImageCopy& CopyRegion = CopyRegions[Level];
+		CopyRegion.bufferOffset = Allocation.Offset + InMipOffsets[Level];
+		CopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		CopyRegion.imageSubresource.mipLevel = Level;
+		CopyRegion.imageSubresource.baseArrayLayer = 0;
+		CopyRegion.imageSubresource.layerCount = 1;
+		CopyRegion.imageExtent = GetMipExtent(Extent, Level);
+	}
+
+	VkCommandBuffer CommandBuffer = GetCommandBuffer();
+	VkImage Image = InImage->GetImage();
+
+	Vk::CmdTransitionImageLayout(
+		CommandBuffer,
+		Image,
+		MipLevels,
+		1,
+		VK_IMAGE_LAYOUT_UNDEFINED,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+	vkCmdCopyBufferToImage(
+		CommandBuffer,
+		Allocation.Buffer,
+		Image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<uint32_t>(CopyRegions.size()),
+		CopyRegions.data());
+
+	for (uint32_t Level = NumUploadedMips; Level < MipLevels; ++Level)
+	{
+		Vk::CmdTransitionImageLayout(
+			CommandBuffer,
+			Image,
+			Level - 1,
+			1,
+			1,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+		VkExtent3D SrcExtent = GetMipExtent(Extent, Level - 1);
+		VkExtent3D DstExtent = GetMipExtent(Extent, Level);
+
+		VkImageBlit Blit{};
+		Blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Level - 1, 0, 1 };
+		Blit.srcOffsets[1] = { static_cast<int32_t>(SrcExtent.width), static_cast<int32_t>(SrcExtent.height), 1 };
+		Blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Level, 0, 1 };
+		Blit.dstOffsets[1] = { static_cast<int32_t>(DstExtent.width), static_cast<int32_t>(DstExtent.height), 1 };
+
+		vkCmdBlitImage(
+			CommandBuffer,
+			Image,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			Image,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			1,
+			&Blit,
+			VK_FILTER_LINEAR);
+	}
+
+	if (NumUploadedMips == MipLevels)
+	{
+		Vk::CmdTransitionImageLayout(
+			CommandBuffer,
+			Image,
+			MipLevels,
+			1,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		return;
+	}
+
+	// Every level that was a blit source is in TRANSFER_SRC_OPTIMAL; the others are still in TRANSFER_DST_OPTIMAL.
+	uint32_t FirstBlitSource = NumUploadedMips - 1;
+
+	if (FirstBlitSource > 0)
+	{
+		Vk::CmdTransitionImageLayout(
+			CommandBuffer,
+			Image,
+			0,
+			FirstBlitSource,
+			1,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
+	Vk::CmdTransitionImageLayout(
+		CommandBuffer,
+		Image,
+		FirstBlitSource,
+		MipLevels - 1 - FirstBlitSource,
+		1,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	Vk::CmdTransitionImageLayout(
+		CommandBuffer,
+		Image,
+		MipLevels - 1,
+		1,
+		1,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void FVulkanUploader::Flush()
+{
+	if (bRecording == false)
+	{
+		RetireCompletedBatches(false);
+		return;
+	}
+
+	FBatch& Batch = Batches[CurrentBatch];
+
+	// Make the transfers visible to everything submitted after this batch on the same queue.
+	VkMemoryBarrier MemoryBarrier{};
+	MemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	MemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	MemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+	vkCmdPipelineBarrier(
+		Batch.CommandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		1, &MemoryBarrier,
+		0, nullptr,
+		0, nullptr);
+
+	VK_ASSERT(vkEndCommandBuffer(Batch.CommandBuffer));
+
+	VkSubmitInfo SubmitInfo{};
+	SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	SubmitInfo.commandBufferCount = 1;
+	SubmitInfo.pCommandBuffers = &Batch.CommandBuffer;
+
+	VK_ASSERT(vkQueueSubmit(Context->GetGfxQueue(), 1, &SubmitInfo, Batch.Fence));
+
+	InFlightBatches.push_back(CurrentBatch);
+	CurrentBatch = (CurrentBatch + 1) % NumBatches;
+	bRecording = false;
+	++NumSubmittedBatches;
+
+	RetireCompletedBatches(false);
+}
+
+void FVulkanUploader::FlushAndWait()
+{
+	Flush();
+	RetireCompletedBatches(true);
+}
+
+void FVulkanUploader::BeginBatch()
+{
+	if (bRecording)
+	{
+		return;
+	}
+
+	while (InFlightBatches.size() >= NumBatches)
+	{
+		RetireOldestBatch();
+	}
+
+	VkDevice Device = Context->GetDevice();
+	FBatch& Batch = Batches[CurrentBatch];
+
+	VK_ASSERT(vkResetFences(Device, 1, &Batch.Fence));
+	VK_ASSERT(vkResetCommandBuffer(Batch.CommandBuffer, 0));
+
+	VkCommandBufferBeginInfo CommandBufferBeginInfo{};
+	CommandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	CommandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(Batch.CommandBuffer, &CommandBufferBeginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to begin upload command buffer.");
+	}
+
+	Batch.RingEnd = RingHead;
+	bRecording = true;
+}
+
+void FVulkanUploader::RetireCompletedBatches(bool bInWait)
+{
+	VkDevice Device = Context->GetDevice();
+
+	while (InFlightBatches.empty() == false)
+	{
+		if (bInWait == false && vkGetFenceStatus(Device, Batches[InFlightBatches.front()].Fence) != VK_SUCCESS)
+		{
+			break;
+		}
+
+		RetireOldestBatch();
+	}
+}
+
+void FVulkanUploader::RetireOldestBatch()
+{
+	if (InFlightBatches.empty())
+	{
+		return;
+	}
+
+	VkDevice Device = Context->GetDevice();
+	FBatch& Batch = Batches[InFlightBatches.front()];
+
+	vkWaitForFences(Device, 1, &Batch.Fence, VK_TRUE, UINT64_MAX);
+
+	if (Batch.RingEnd > RingTail)
+	{
+		RingTail = Batch.RingEnd;
+	}
+
+	for (const auto& [Buffer, Memory] : Batch.DedicatedBuffers)
+	{
+		vkDestroyBuffer(Device, Buffer, nullptr);
+		vkFreeMemory(Device, Memory, nullptr);
+	}
+	Batch.DedicatedBuffers.clear();
+
+	InFlightBatches.pop_front();
+}
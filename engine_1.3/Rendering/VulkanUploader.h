@@ -0,0 +1,87 @@
+#pragma once
+
+#include "VulkanObject.h"
+
+#include "vulkan/vulkan.h"
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+struct FVulkanStagingAllocation
+{
+	VkBuffer Buffer = VK_NULL_HANDLE;
+	VkDeviceSize Offset = 0;
+	uint8_t* Mapped = nullptr;
+};
+
+// Owns a persistently mapped staging ring and records uploads into shared transfer command buffers.
+// Recorded uploads are submitted together on Flush and the ring space is reclaimed once their fence signals.
+class FVulkanUploader : public FVulkanObject
+{
+public:
+	FVulkanUploader(class FVulkanContext* InContext);
+
+	virtual void Destroy() override;
+
+	void Initialize(VkDeviceSize InRingSize);
+
+	// Reserves staging memory that stays valid until the batch it was recorded in completes.
+	FVulkanStagingAllocation Allocate(VkDeviceSize InSize, VkDeviceSize InAlignment = DefaultAlignment);
+
+	// Returns the command buffer of the batch currently being recorded.
+	VkCommandBuffer GetCommandBuffer();
+
+	void UploadBuffer(VkBuffer InDstBuffer, VkDeviceSize InDstOffset, const void* InData, VkDeviceSize InSize);
+
+	// Uploads the first mip of every array layer and leaves the image in SHADER_READ_ONLY_OPTIMAL.
+	// Null entries in InLayers are zero filled.
+	void UploadImage(class FVulkanImage* InImage, const std::vector<const uint8_t*>& InLayers, VkDeviceSize InLayerSize);
+
+	// Uploads the levels of a single layer image stored back to back in InData, all in one staging transfer.
+	// Levels beyond InMipOffsets are blitted from the last uploaded one, which needs a format with linear blit support.
+	// Leaves the image in SHADER_READ_ONLY_OPTIMAL.
+	void UploadImageMips(class FVulkanImage* InImage, const uint8_t* InData, VkDeviceSize InSize, const std::vector<VkDeviceSize>& InMipOffsets);
+
+	// Submits the recorded uploads without waiting for them.
+	void Flush();
+	void FlushAndWait();
+
+	bool HasPendingUploads() const { return bRecording; }
+	VkDeviceSize GetRingSize() const { return RingSize; }
+	uint32_t GetNumSubmittedBatches() const { return NumSubmittedBatches; }
+
+private:
+	struct FBatch
+	{
+		VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+		VkFence Fence = VK_NULL_HANDLE;
+		uint64_t RingEnd = 0;
+		std::vector<std::pair<VkBuffer, VkDeviceMemory>> DedicatedBuffers;
+	};
+
+	void BeginBatch();
+	void RetireCompletedBatches(bool bInWait);
+	void RetireOldestBatch();
+	FVulkanStagingAllocation AllocateDedicated(VkDeviceSize InSize);
+
+	static constexpr VkDeviceSize DefaultAlignment = 16;
+	static constexpr uint32_t NumBatches = 4;
+
+	VkCommandPool CommandPool;
+	FBatch Batches[NumBatches];
+	std::deque<uint32_t> InFlightBatches;
+	uint32_t CurrentBatch;
+	bool bRecording;
+
+	VkBuffer RingBuffer;
+	VkDeviceMemory RingMemory;
+	uint8_t* RingMapped;
+	VkDeviceSize RingSize;
+
+	// Monotonic byte counters; the physical offset is the counter modulo RingSize.
+	uint64_t RingHead;
+	uint64_t RingTail;
+
+	uint32_t NumSubmittedBatches;
+};